@@ -0,0 +1,67 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include "Allocation.h"
+#include "ExtraTypes.h"
+
+#define MIX_SCALE 16
+
+class ColorTable : public Allocation
+{
+private:
+	DWORD pitch;
+	DWORD height;
+	DWORD depth;
+	FpsMode format;
+	DWORD red;
+	DWORD blue;
+
+	Adjustment colors;
+	DWORD flags;
+	BOOL isFull;
+	FLOAT exponent[4];
+
+	WORD* table;
+	BYTE curve[3][256];
+	INT mix[3][3];
+	BYTE* ramp;
+	DWORD rampSize;
+	INT low;
+
+	BYTE* buffer;
+
+	FLOAT Level(FLOAT, DWORD, DWORD, DWORD, DWORD);
+	VOID Mix(FLOAT*);
+	VOID Grade(FLOAT*);
+	VOID Adjust(FLOAT*);
+	VOID Build();
+	VOID Convert(const BYTE*, BYTE*);
+
+public:
+	ColorTable(DWORD, DWORD, FpsMode);
+	~ColorTable();
+
+	VOID* Apply(VOID*, const RECT*);
+};
\ No newline at end of file
@@ -24,6 +24,8 @@
 
 #include "stdafx.h"
 #include "Config.h"
+#include "Ini.h"
+#include "Prefetch.h"
 #include "intrin.h"
 
 ConfigItems config;
@@ -125,18 +127,16 @@ namespace Config
 		return 0.001f * min(1000, max(0, Config::Get(CONFIG_COLORS, name, 500)));
 	}
 
-	VOID Load(HMODULE hModule, const AddressSpace* hookSpace)
+	VOID Open(HMODULE hModule)
 	{
 		GetModuleFileName(hModule, config.file, MAX_PATH);
 		StrCopy(StrLastChar(config.file, '\\') + 1, "config.ini");
 
-		FILE* file = FileOpen(config.file, "rb");
-		if (file)
-		{
-			config.isExist = TRUE;
-			FileClose(file);
-		}
+		config.isExist = Ini::Load(config.file);
+	}
 
+	VOID Load(HMODULE hModule, const AddressSpace* hookSpace)
+	{
 		config.cursor = LoadCursor(NULL, IDC_ARROW);
 		config.icon = LoadIcon(hModule, MAKEINTRESOURCE(RESOURCE_ICON));
 		config.font = (HFONT)CreateFont(16, 0, 0, 0, FW_DONTCARE, FALSE, FALSE, FALSE, ANSI_CHARSET,
@@ -179,14 +179,26 @@ namespace Config
 			config.renderer = RendererAuto;
 			Config::Set(CONFIG_WRAPPER, "Renderer", *(INT*)&config.renderer);
 
-			config.updateMode = UpdateSSE;
+			config.updateMode = UpdateAuto;
 			Config::Set(CONFIG_WRAPPER, "UpdateMode", *(INT*)&config.updateMode);
 
+			config.frameLatency = 2;
+			Config::Set(CONFIG_WRAPPER, "FrameLatency", config.frameLatency);
+
+			config.snapshot = SnapshotPng;
+			Config::Set(CONFIG_WRAPPER, "Snapshot", *(INT*)&config.snapshot);
+
+			Config::Set(CONFIG_WRAPPER, "Record", config.record);
+
+			config.prefetch = 4;
+			Config::Set(CONFIG_WRAPPER, "Prefetch", config.prefetch);
+
 			config.coldCPU = TRUE;
 			Config::Set(CONFIG_WRAPPER, "ColdCPU", config.coldCPU);
 
 			config.smooth.scroll = TRUE;
 			Config::Set(CONFIG_WRAPPER, "SmoothScroll", config.smooth.scroll);
+			Config::Set(CONFIG_WRAPPER, "ScrollOffset", config.smooth.offset);
 
 			config.smooth.move = TRUE;
 			Config::Set(CONFIG_WRAPPER, "SmoothMove", config.smooth.move);
@@ -291,7 +303,12 @@ namespace Config
 
 			config.coldCPU = (BOOL)Config::Get(CONFIG_WRAPPER, "ColdCPU", TRUE);
 			config.smooth.scroll = (BOOL)Config::Get(CONFIG_WRAPPER, "SmoothScroll", TRUE);
+			config.smooth.offset = (BOOL)Config::Get(CONFIG_WRAPPER, "ScrollOffset", FALSE);
 			config.smooth.move = (BOOL)Config::Get(CONFIG_WRAPPER, "SmoothMove", TRUE);
+
+			config.prefetch = Config::Get(CONFIG_WRAPPER, "Prefetch", 4);
+			if (config.prefetch > PREFETCH_MAX)
+				config.prefetch = PREFETCH_MAX;
 		}
 
 		if (!config.isDDraw)
@@ -303,17 +320,28 @@ namespace Config
 				if (config.renderer < RendererAuto || config.renderer > RendererOpenGL3)
 					config.renderer = RendererAuto;
 
-				value = Config::Get(CONFIG_WRAPPER, "UpdateMode", UpdateSSE);
+				value = Config::Get(CONFIG_WRAPPER, "UpdateMode", UpdateAuto);
 				config.updateMode = *(UpdateMode*)&value;
-				if (config.updateMode < UpdateNone || config.updateMode > UpdateASM)
-					config.updateMode = UpdateSSE;
+				if (config.updateMode < UpdateNone || config.updateMode > UpdateAuto)
+					config.updateMode = UpdateAuto;
+
+				config.frameLatency = Config::Get(CONFIG_WRAPPER, "FrameLatency", 2);
+				if (config.frameLatency < 1 || config.frameLatency > 3)
+					config.frameLatency = 2;
+
+				value = Config::Get(CONFIG_WRAPPER, "Snapshot", SnapshotPng);
+				config.snapshot = *(SnapshotType*)&value;
+				if (config.snapshot < SnapshotClipboard || config.snapshot > SnapshotQoi)
+					config.snapshot = SnapshotPng;
+
+				config.record = (BOOL)Config::Get(CONFIG_WRAPPER, "Record", FALSE);
 
 				config.image.aspect = (BOOL)Config::Get(CONFIG_WRAPPER, "ImageAspect", TRUE);
 				config.image.vSync = (BOOL)Config::Get(CONFIG_WRAPPER, "ImageVSync", TRUE);
 
 				value = Config::Get(CONFIG_WRAPPER, "FpsCounter", FpsDisabled);
 				config.fps = *(FpsState*)&value;
-				if (config.fps < FpsDisabled || config.fps > FpsBenchmark)
+				if (config.fps < FpsDisabled || config.fps > FpsIdle)
 					config.fps = FpsDisabled;
 
 				value = Config::Get(CONFIG_WRAPPER, "Interpolation", InterpolateHermite);
@@ -403,25 +431,27 @@ namespace Config
 			config.updateMode = UpdateCPP;
 	}
 
-	INT Get(const CHAR* app, const CHAR* key, INT default)
+	INT Get(const CHAR* app, const CHAR* key, INT defValue)
 	{
-		return GetPrivateProfileInt(app, key, (INT) default, config.file);
+		return Ini::Get(app, key, defValue);
 	}
 
-	DWORD Get(const CHAR* app, const CHAR* key, const CHAR* default, CHAR* returnString, DWORD nSize)
+	DWORD Get(const CHAR* app, const CHAR* key, const CHAR* defValue, CHAR* returnString, DWORD nSize)
 	{
-		return GetPrivateProfileString(app, key, default, returnString, nSize, config.file);
+		return Ini::Get(app, key, defValue, returnString, nSize);
 	}
 
 	BOOL Set(const CHAR* app, const CHAR* key, INT value)
 	{
 		CHAR res[20];
 		StrFromInt(value, res, 10);
-		return WritePrivateProfileString(app, key, res, config.file);
+		Ini::Set(app, key, res);
+		return TRUE;
 	}
 
 	BOOL Set(const CHAR* app, const CHAR* key, CHAR* value)
 	{
-		return WritePrivateProfileString(app, key, value, config.file);
+		Ini::Set(app, key, value);
+		return TRUE;
 	}
 }
\ No newline at end of file
@@ -0,0 +1,209 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "Deflate.h"
+#include "intrin.h"
+
+namespace Deflate
+{
+	DWORD crcTable[256];
+
+	const WORD lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	const BYTE lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	const WORD distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	const BYTE distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	struct BitStream {
+		BYTE* ptr;
+		DWORD bits;
+		DWORD count;
+	};
+
+	VOID PutBits(BitStream* stream, DWORD value, DWORD count)
+	{
+		stream->bits |= value << stream->count;
+		stream->count += count;
+		while (stream->count >= 8)
+		{
+			*stream->ptr++ = LOBYTE(stream->bits);
+			stream->bits >>= 8;
+			stream->count -= 8;
+		}
+	}
+
+	VOID PutCode(BitStream* stream, DWORD code, DWORD count)
+	{
+		DWORD reversed = 0;
+		for (DWORD i = 0; i < count; ++i, code >>= 1)
+			reversed = (reversed << 1) | (code & 1);
+
+		PutBits(stream, reversed, count);
+	}
+
+	VOID PutSymbol(BitStream* stream, DWORD symbol)
+	{
+		if (symbol < 144)
+			PutCode(stream, 0x30 + symbol, 8);
+		else if (symbol < 256)
+			PutCode(stream, 0x190 + symbol - 144, 9);
+		else if (symbol < 280)
+			PutCode(stream, symbol - 256, 7);
+		else
+			PutCode(stream, 0xC0 + symbol - 280, 8);
+	}
+
+	VOID PutMatch(BitStream* stream, DWORD length, DWORD distance)
+	{
+		DWORD code = 28;
+		while (lengthBase[code] > length)
+			--code;
+
+		PutSymbol(stream, 257 + code);
+		if (lengthExtra[code])
+			PutBits(stream, length - lengthBase[code], lengthExtra[code]);
+
+		code = 29;
+		while (distanceBase[code] > distance)
+			--code;
+
+		PutCode(stream, code, 5);
+		if (distanceExtra[code])
+			PutBits(stream, distance - distanceBase[code], distanceExtra[code]);
+	}
+
+	DWORD Hash(const BYTE* data)
+	{
+		return ((data[0] << 10) ^ (data[1] << 5) ^ data[2]) & (DEFLATE_WINDOW - 1);
+	}
+
+	VOID Create()
+	{
+		for (DWORD i = 0; i < 256; ++i)
+		{
+			DWORD crc = i;
+			DWORD count = 8;
+			do
+				crc = (crc & 1) ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+			while (--count);
+
+			crcTable[i] = crc;
+		}
+	}
+
+	DWORD Bound(DWORD size)
+	{
+		return 2 + size + (size >> 3) + 16 + 4;
+	}
+
+	// zlib stream with a single fixed-Huffman block and a one-probe hash LZ77
+	BYTE* Compress(BYTE* dst, const BYTE* src, DWORD size, DWORD* head)
+	{
+		MemoryZero(head, DEFLATE_WINDOW * sizeof(DWORD));
+
+		*dst++ = 0x78;
+		*dst++ = 0x01;
+
+		BitStream stream = { dst, 0, 0 };
+		PutBits(&stream, 1, 1);
+		PutBits(&stream, 1, 2);
+
+		DWORD pos = 0;
+		while (pos < size)
+		{
+			DWORD length = 0;
+			DWORD distance = 0;
+
+			if (pos + 3 <= size)
+			{
+				DWORD* entry = &head[Hash(src + pos)];
+				DWORD candidate = *entry;
+				*entry = pos + 1;
+
+				if (candidate && pos - --candidate <= DEFLATE_WINDOW)
+				{
+					DWORD max = size - pos;
+					if (max > 258)
+						max = 258;
+
+					const BYTE* a = src + candidate;
+					const BYTE* b = src + pos;
+					while (length < max && a[length] == b[length])
+						++length;
+
+					distance = pos - candidate;
+				}
+			}
+
+			if (length >= 3)
+			{
+				PutMatch(&stream, length, distance);
+
+				DWORD end = pos + length;
+				for (++pos; pos < end; ++pos)
+					if (pos + 3 <= size)
+						head[Hash(src + pos)] = pos + 1;
+			}
+			else
+				PutSymbol(&stream, src[pos++]);
+		}
+
+		PutSymbol(&stream, 256);
+		if (stream.count)
+			*stream.ptr++ = LOBYTE(stream.bits);
+
+		dst = stream.ptr;
+		*(DWORD*)dst = _byteswap_ulong(Adler32(src, size));
+
+		return dst + sizeof(DWORD);
+	}
+
+	DWORD Adler32(const BYTE* data, DWORD size)
+	{
+		DWORD a = 1, b = 0;
+		while (size)
+		{
+			DWORD count = size < 5552 ? size : 5552;
+			size -= count;
+			do
+			{
+				a += *data++;
+				b += a;
+			} while (--count);
+
+			a %= 65521;
+			b %= 65521;
+		}
+
+		return (b << 16) | a;
+	}
+
+	DWORD Crc32(const BYTE* data, DWORD size, DWORD crc)
+	{
+		while (size--)
+			crc = crcTable[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+		return crc;
+	}
+}
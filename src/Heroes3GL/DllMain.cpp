@@ -31,6 +31,11 @@
 #include "Window.h"
 #include "Resource.h"
 #include "Mods.h"
+#include "Snapshot.h"
+#include "Recorder.h"
+#include "Prefetch.h"
+#include "Ini.h"
+#include "Registry.h"
 
 BOOL __stdcall DllMain(HMODULE hModule, DWORD fdwReason, LPVOID lpReserved)
 {
@@ -57,9 +62,14 @@ BOOL __stdcall DllMain(HMODULE hModule, DWORD fdwReason, LPVOID lpReserved)
 		hDllModule = hModule;
 		if (Hooks::Load())
 		{
+			Registry::Create();
+			Prefetch::Create();
+
 			if (!config.isDDraw)
 			{
 				Mods::Load();
+				Snapshot::Create();
+				Recorder::Create();
 
 				Window::SetCaptureKeys(TRUE);
 
@@ -107,6 +117,15 @@ BOOL __stdcall DllMain(HMODULE hModule, DWORD fdwReason, LPVOID lpReserved)
 	case DLL_PROCESS_DETACH:
 		if (hDllModule)
 		{
+			Hooks::Release();
+			Prefetch::Release();
+
+			if (!config.isDDraw)
+				Snapshot::Release();
+
+			Ini::Release();
+			AlignedRelease();
+
 			timeEndPeriod(1);
 
 			if (hActCtx && hActCtx != INVALID_HANDLE_VALUE)
@@ -55,6 +55,27 @@ struct Frame
 	TexSize tSize;
 };
 
+struct ScrollState
+{
+	BOOL isActive;
+	RECT rect;
+	SIZE size;
+	POINT origin;
+	POINT shift;
+};
+
+struct ScrollQuad
+{
+	FLOAT left;
+	FLOAT top;
+	FLOAT right;
+	FLOAT bottom;
+	FLOAT texLeft;
+	FLOAT texTop;
+	FLOAT texRight;
+	FLOAT texBottom;
+};
+
 struct Viewport
 {
 	BOOL refresh;
@@ -159,14 +180,27 @@ union LevelColorsFloat
 	FLOAT chanel[3];
 };
 
+struct CanvasTap {
+	DWORD index;
+	FLOAT weight[4];
+};
+
 struct LevelsData {
 	HDC hDc;
 	HBITMAP hBmp;
 	DWORD* data;
 	DWORD bmpData[100 * 516];
 	LevelColorsFloat colors[256];
+	LONG version;
 	FLOAT delta;
 	Adjustment values;
+	Adjustment toneValues;
+	BYTE tone[3][256];
+	BOOL isTone;
+	CanvasTap* taps;
+	DWORD interval;
+	DWORD drawTick;
+	BOOL isPending;
 };
 
 struct MoveObject {
@@ -200,12 +234,40 @@ struct AddressSpace
 
 struct TrackInfo
 {
-	TrackInfo* last;
+	TrackInfo* chain;
+	DWORD hash;
 	DWORD position;
 	CHAR* group;
 	CHAR* path;
 };
 
+struct MusicFolder
+{
+	MusicFolder* next;
+	HANDLE hNotify;
+	DWORD stamp;
+	CHAR* path;
+};
+
+struct MusicGroup
+{
+	MusicGroup* chain;
+	DWORD hash;
+	MusicFolder* folder;
+	DWORD stamp;
+	DWORD count;
+	DWORD capacity;
+	DWORD next;
+	CHAR** tracks;
+	CHAR* name;
+};
+
+struct PrefetchSlot
+{
+	DWORD hash;
+	DWORD size;
+};
+
 struct VideoInfo
 {
 	CHAR* fileName;
@@ -222,11 +284,32 @@ struct VideoFile
 	DWORD stride;
 };
 
+struct VideoEntry
+{
+	CHAR name[40];
+	DWORD stride;
+	BOOL isBink;
+};
+
+struct VideoIndex
+{
+	VideoIndex* next;
+	DWORD hash;
+	DWORD size;
+	FILETIME time;
+	DWORD count;
+	VideoEntry* entries;
+	DWORD* chains;
+	DWORD* buckets;
+};
+
 enum FpsState
 {
 	FpsDisabled = 0,
 	FpsNormal,
-	FpsBenchmark
+	FpsBenchmark,
+	FpsLatency,
+	FpsIdle
 };
 
 struct FpsItem {
@@ -246,7 +329,62 @@ enum UpdateMode
 	UpdateNone = 0,
 	UpdateSSE = 1,
 	UpdateCPP = 2,
-	UpdateASM = 3
+	UpdateASM = 3,
+	UpdateAuto = 4
+};
+
+enum SnapshotType
+{
+	SnapshotClipboard = 0,
+	SnapshotPng = 1,
+	SnapshotQoi = 2
+};
+
+struct SnapshotFrame
+{
+	SnapshotFrame* next;
+	DWORD width;
+	DWORD height;
+	DWORD capacity;
+	BOOL isFlipped;
+	DWORD* data;
+};
+
+enum RecordType : BYTE
+{
+	RecordTrack = 1,
+	RecordFrame = 2
+};
+
+struct IniLine
+{
+	IniLine* next;
+	IniLine* chain;
+	IniLine* section;
+	IniLine* tail;
+	DWORD hash;
+	CHAR* key;
+	CHAR* value;
+	CHAR* text;
+};
+
+struct RegValue
+{
+	RegValue* chain;
+	DWORD hash;
+	CHAR* name;
+	DWORD type;
+	DWORD size;
+	BYTE* data;
+	BOOL isLegacy;
+};
+
+struct RecordChunk
+{
+	RecordChunk* next;
+	DWORD capacity;
+	DWORD size;
+	BYTE* data;
 };
 
 struct ConfigItems
@@ -263,6 +401,10 @@ struct ConfigItems
 	BOOL isSSE2;
 	RendererType renderer;
 	UpdateMode updateMode;
+	DWORD frameLatency;
+	SnapshotType snapshot;
+	BOOL record;
+	DWORD prefetch;
 
 	struct {
 		LCID current;
@@ -271,6 +413,7 @@ struct ConfigItems
 
 	struct {
 		BOOL scroll;
+		BOOL offset;
 		BOOL move;
 	} smooth;
 
@@ -25,260 +25,8 @@
 #include "stdafx.h"
 #include "FpsCounter.h"
 #include "timeapi.h"
-
-const WORD counters[10][FPS_HEIGHT] = {
-	{ // 0
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC
-	}, { // 1
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000
-	}, { // 2
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0x003C,
-		0x003C,
-		0x003C,
-		0x003C,
-		0x003C,
-		0x003C,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC
-	}, { // 3
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC
-	}, { // 4
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000
-	}, { // 5
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0x003C,
-		0x003C,
-		0x003C,
-		0x003C,
-		0x003C,
-		0x003C,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC
-	}, { // 6
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0x003C,
-		0x003C,
-		0x003C,
-		0x003C,
-		0x003C,
-		0x003C,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC
-	}, { // 7
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000
-	}, { // 8
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC
-	}, { // 9
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xF03C,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xF000,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC,
-		0xFFFC
-	}
-};
+#include "Digits.h"
+#include "Convert.h"
 
 FpsCounter::FpsCounter(FpsMode mode, DWORD texWidth, DWORD accuracy)
 {
@@ -287,12 +35,21 @@ FpsCounter::FpsCounter(FpsMode mode, DWORD texWidth, DWORD accuracy)
 	this->accuracy = accuracy;
 	this->count = accuracy * 10;
 	this->tickQueue = (FpsItem*)MemoryAlloc(this->count * sizeof(FpsItem));
+	this->elided = 0;
+	this->draws = 0;
+	this->changes = 0;
 	this->Reset();
 }
 
 FpsCounter::~FpsCounter()
 {
 	MemoryFree(this->tickQueue);
+
+#ifdef _DEBUG
+	CHAR message[128];
+	StrPrint(message, "Fps: %u frames elided, %u draw calls, %u state changes\n", this->elided, this->draws, this->changes);
+	OutputDebugString(message);
+#endif
 }
 
 VOID FpsCounter::Reset()
@@ -302,6 +59,9 @@ VOID FpsCounter::Reset()
 	this->summary = 0;
 	this->lastTick = 0;
 	this->value = 0;
+	this->latency = 0;
+	this->idle = 0;
+	this->idleLatency = 0;
 	MemoryZero(this->tickQueue, this->count * sizeof(FpsItem));
 }
 
@@ -372,67 +132,25 @@ VOID FpsCounter::Draw(FpsState state, VOID* frameBuffer)
 	if (state == FpsDisabled)
 		return;
 
-	DWORD fps = this->value;
-	DWORD digCount = 0;
-	DWORD current = fps;
-	do
-	{
-		++digCount;
-		current = current / 10;
-	} while (current);
-
-	DWORD pitch = texWidth - FPS_WIDTH;
+	// Idle mode shows the governor's idle share in percent and, below it, the wake up delay it adds in microseconds
+	DWORD fps = state == FpsIdle ? this->idle : (state == FpsLatency ? this->latency : this->value);
+	DWORD offset = texWidth * 10 + 10;
+	DWORD below = offset + texWidth * (DIGIT_HEIGHT + 4);
 	if (this->mode == FpsRgb)
 	{
-		WORD color = state == FpsBenchmark ? 0xFFE0 : 0xFFFF;
-		WORD* ptr = (WORD*)frameBuffer + texWidth * 10 + 10;
-		do
-		{
-			WORD* pix = ptr + FPS_WIDTH * (digCount - 1);
-			WORD* lpDig = (WORD*)counters[fps % 10];
-			for (DWORD y = 0; y < FPS_HEIGHT; ++y, pix += pitch)
-			{
-				WORD check = *lpDig++;
-				DWORD width = FPS_WIDTH;
-				do
-				{
-					if (check & 1)
-						*pix = color;
-
-					++pix;
-					check >>= 1;
-				} while (--width);
-			}
-
-			fps /= 10;
-		} while (--digCount);
+		WORD color = state == FpsBenchmark ? 0xFFE0 : (state == FpsLatency ? 0x07FF : (state == FpsIdle ? 0x07E0 : 0xFFFF));
+		DrawDigits((uint16_t*)frameBuffer + offset, texWidth, fps, color);
+		if (state == FpsIdle)
+			DrawDigits((uint16_t*)frameBuffer + below, texWidth, this->idleLatency, color);
 	}
 	else
 	{
-		DWORD color = state == FpsBenchmark ? 0xFF00FFFF : 0xFFFFFFFF;
+		DWORD color = state == FpsBenchmark ? 0xFF00FFFF : (state == FpsLatency ? 0xFFFFFF00 : (state == FpsIdle ? 0xFF00FF00 : 0xFFFFFFFF));
 		if (this->mode == FpsBgra)
-			color = _byteswap_ulong(_rotl(color, 8));
-
-		DWORD* ptr = (DWORD*)frameBuffer + texWidth * 10 + 10;
-		do
-		{
-			DWORD* pix = ptr + FPS_WIDTH * (digCount - 1);
-			WORD* lpDig = (WORD*)counters[fps % 10];
-			for (DWORD y = 0; y < FPS_HEIGHT; ++y, pix += pitch)
-			{
-				WORD check = *lpDig++;
-				DWORD width = FPS_WIDTH;
-				do
-				{
-					if (check & 1)
-						*pix = color;
-
-					++pix;
-					check >>= 1;
-				} while (--width);
-			}
+			SwapRedBlue((const uint32_t*)&color, (uint32_t*)&color, 1);
 
-			fps /= 10;
-		} while (--digCount);
+		DrawDigits((uint32_t*)frameBuffer + offset, texWidth, fps, color);
+		if (state == FpsIdle)
+			DrawDigits((uint32_t*)frameBuffer + below, texWidth, this->idleLatency, color);
 	}
-}
+}
\ No newline at end of file
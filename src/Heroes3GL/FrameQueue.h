@@ -0,0 +1,67 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include "Allocation.h"
+
+#define FRAME_SLOTS 3
+#define FRAME_FRESH 0x80000000
+#define FRAME_INDEX 0x0000000F
+
+class FrameQueue : public Allocation
+{
+private:
+	RECT bounds;
+	DWORD pitch;
+	DWORD depth;
+	VOID* slots[FRAME_SLOTS];
+	RECT dirty[FRAME_SLOTS];
+	RECT changes[FRAME_SLOTS];
+	RECT hidden;
+	RECT changed;
+	DWORD write;
+	DWORD read;
+	volatile LONG ready;
+	LONGLONG stamps[FRAME_SLOTS];
+	LONGLONG stamp;
+
+#ifdef _DEBUG
+	LONGLONG latency;
+	DWORD published;
+	DWORD acquired;
+	DWORD dropped;
+#endif
+
+	FrameQueue(DWORD, DWORD, DWORD, DWORD);
+
+public:
+	static FrameQueue* Create(DWORD, DWORD, DWORD, DWORD);
+	~FrameQueue();
+
+	VOID Publish(const VOID*, const RECT* = NULL);
+	VOID Invalidate(const RECT* = NULL);
+	VOID* Acquire();
+	LONGLONG GetStamp();
+	const RECT* GetChanged();
+};
\ No newline at end of file
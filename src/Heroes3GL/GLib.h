@@ -25,7 +25,7 @@
 #pragma once
 
 #include "windows.h"
-#include "GL\gl.h"
+#include "GL/gl.h"
 
 #ifndef ptrdiff_t
 #ifdef _WIN64
@@ -38,6 +38,8 @@ typedef _W64 int ptrdiff_t;
 typedef ptrdiff_t GLintptr;
 typedef ptrdiff_t GLsizeiptr;
 typedef char GLchar;
+typedef unsigned __int64 GLuint64;
+typedef struct __GLsync* GLsync;
 
 #define GL_VER_1_1 0x01010000
 #define GL_VER_1_2 0x01020000
@@ -83,6 +85,8 @@ typedef char GLchar;
 
 #define GL_TEXTURE0 0x84C0
 #define GL_TEXTURE1 0x84C1
+#define GL_TEXTURE2 0x84C2
+#define GL_TEXTURE3 0x84C3
 #define GL_TEXTURE_BASE_LEVEL 0x813C
 #define GL_TEXTURE_MAX_LEVEL 0x813D
 
@@ -94,6 +98,9 @@ typedef char GLchar;
 #define GL_STREAM_DRAW                    0x88E0
 
 #define GL_UNSIGNED_SHORT_5_6_5 0x8363
+#define GL_HALF_FLOAT 0x140B
+#define GL_RGBA32F 0x8814
+#define GL_RGBA16F 0x881A
 
 #define ERROR_INVALID_VERSION_ARB 0x2095
 #define ERROR_INVALID_PROFILE_ARB 0x2096
@@ -101,6 +108,11 @@ typedef char GLchar;
 #define GL_COLOR_ATTACHMENT0              0x8CE0
 #define GL_DRAW_FRAMEBUFFER               0x8CA9
 
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_WAIT_FAILED 0x911D
+
 typedef HGLRC(__stdcall *WGLCREATECONTEXTATTRIBS)(HDC hDC, HGLRC hshareContext, const DWORD *attribList);
 typedef BOOL(__stdcall *WGLCHOOSEPIXELFORMAT) (HDC hDC, const INT* piAttribIList, const FLOAT *pfAttribFList, UINT nMaxFormats, INT *piFormats, UINT *nNumFormats);
 typedef const CHAR*(__stdcall* WGLGETEXTENSIONSSTRING)();
@@ -108,6 +120,7 @@ typedef BOOL(__stdcall *WGLSWAPINTERVAL)(INT interval);
 
 typedef const GLubyte* (__stdcall *GLGETSTRING)(GLenum name);
 typedef VOID(__stdcall *GLVERTEX2S)(GLshort x, GLshort y);
+typedef VOID(__stdcall *GLVERTEX2F)(GLfloat x, GLfloat y);
 typedef VOID(__stdcall *GLTEXCOORD2F)(GLfloat s, GLfloat t);
 typedef VOID(__stdcall *GLBEGIN)(GLenum mode);
 typedef VOID(__stdcall *GLEND)();
@@ -116,12 +129,17 @@ typedef VOID(__stdcall *GLMATRIXMODE)(GLenum mode);
 typedef VOID(__stdcall *GLLOADIDENTITY)();
 typedef VOID(__stdcall *GLORTHO)(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar);
 typedef VOID(__stdcall *GLFINISH)();
+typedef GLsync(__stdcall *GLFENCESYNC)(GLenum condition, GLbitfield flags);
+typedef GLenum(__stdcall *GLCLIENTWAITSYNC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+typedef VOID(__stdcall *GLDELETESYNC)(GLsync sync);
+typedef VOID(__stdcall *GLADDSWAPHINTRECT)(GLint x, GLint y, GLsizei width, GLsizei height);
 typedef VOID(__stdcall *GLENABLE)(GLenum cap);
 typedef VOID(__stdcall *GLBINDTEXTURE)(GLenum target, GLuint texture);
 typedef VOID(__stdcall *GLDELETETEXTURES)(GLsizei n, const GLuint *textures);
 typedef VOID(__stdcall *GLTEXPARAMETERI)(GLenum target, GLenum pname, GLint param);
 typedef VOID(__stdcall *GLTEXENVI)(GLenum target, GLenum pname, GLint param);
 typedef VOID(__stdcall *GLGETTEXIMAGE)(GLenum target, GLint level, GLenum format, GLenum type, GLvoid* pixels);
+typedef VOID(__stdcall *GLTEXIMAGE1D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLint border, GLenum format, GLenum type, const GLvoid* pixels);
 typedef VOID(__stdcall *GLTEXIMAGE2D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels);
 typedef VOID(__stdcall *GLTEXSUBIMAGE2D)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels);
 typedef GLenum(__stdcall *GLGENTEXTURES)(GLsizei n, GLuint* textures);
@@ -129,6 +147,11 @@ typedef VOID(__stdcall *GLGETINTEGERV)(GLenum pname, GLint* data);
 typedef VOID(__stdcall *GLCLEAR)(GLbitfield mask);
 typedef VOID(__stdcall *GLCLEARCOLOR)(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
 typedef VOID(__stdcall* GLPIXELSTOREI)(GLenum pname, GLint param);
+typedef GLuint(__stdcall *GLGENLISTS)(GLsizei range);
+typedef VOID(__stdcall *GLDELETELISTS)(GLuint list, GLsizei range);
+typedef VOID(__stdcall *GLNEWLIST)(GLuint list, GLenum mode);
+typedef VOID(__stdcall *GLENDLIST)();
+typedef VOID(__stdcall *GLCALLLIST)(GLuint list);
 
 #ifdef _DEBUG
 typedef GLenum(__stdcall *GLGETERROR)();
@@ -182,6 +205,7 @@ extern WGLSWAPINTERVAL WGLSwapInterval;
 
 extern GLGETSTRING GLGetString;
 extern GLVERTEX2S GLVertex2s;
+extern GLVERTEX2F GLVertex2f;
 extern GLTEXCOORD2F GLTexCoord2f;
 extern GLBEGIN GLBegin;
 extern GLEND GLEnd;
@@ -190,12 +214,17 @@ extern GLMATRIXMODE GLMatrixMode;
 extern GLLOADIDENTITY GLLoadIdentity;
 extern GLORTHO GLOrtho;
 extern GLFINISH GLFinish;
+extern GLFENCESYNC GLFenceSync;
+extern GLCLIENTWAITSYNC GLClientWaitSync;
+extern GLDELETESYNC GLDeleteSync;
+extern GLADDSWAPHINTRECT GLAddSwapHintRect;
 extern GLENABLE GLEnable;
 extern GLBINDTEXTURE GLBindTexture;
 extern GLDELETETEXTURES GLDeleteTextures;
 extern GLTEXPARAMETERI GLTexParameteri;
 extern GLTEXENVI GLTexEnvi;
 extern GLGETTEXIMAGE GLGetTexImage;
+extern GLTEXIMAGE1D GLTexImage1D;
 extern GLTEXIMAGE2D GLTexImage2D;
 extern GLTEXSUBIMAGE2D GLTexSubImage2D;
 extern GLGENTEXTURES GLGenTextures;
@@ -203,6 +232,11 @@ extern GLGETINTEGERV GLGetIntegerv;
 extern GLCLEAR GLClear;
 extern GLCLEARCOLOR GLClearColor;
 extern GLPIXELSTOREI GLPixelStorei;
+extern GLGENLISTS GLGenLists;
+extern GLDELETELISTS GLDeleteLists;
+extern GLNEWLIST GLNewList;
+extern GLENDLIST GLEndList;
+extern GLCALLLIST GLCallList;
 
 #ifdef _DEBUG
 extern GLGETERROR GLGetError;
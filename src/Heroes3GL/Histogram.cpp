@@ -0,0 +1,298 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "Histogram.h"
+#include "Config.h"
+#include "intrin.h"
+
+Histogram::Histogram()
+{
+	InitializeCriticalSection(&this->section);
+
+	this->isEnabled = FALSE;
+	this->version = 0;
+	this->width = 0;
+	this->height = 0;
+	this->depth = 0;
+	this->format = FpsRgb;
+	this->shadow = NULL;
+	this->next = 0;
+	SetRectEmpty(&this->dirty);
+}
+
+Histogram::~Histogram()
+{
+	if (this->shadow)
+		MemoryFree(this->shadow);
+
+	DeleteCriticalSection(&this->section);
+}
+
+VOID Histogram::Reset(DWORD width, DWORD height, FpsMode format)
+{
+	if (this->shadow)
+		MemoryFree(this->shadow);
+
+	this->width = width;
+	this->height = height;
+	this->format = format;
+	this->depth = format == FpsRgb ? sizeof(WORD) : sizeof(DWORD);
+
+	DWORD size = width * height * this->depth;
+	this->shadow = (BYTE*)MemoryAlloc(size);
+	MemoryZero(this->shadow, size);
+
+	MemoryZero(this->levels, sizeof(this->levels));
+	this->levels[0].red = this->levels[0].green = this->levels[0].blue = width * height;
+
+	InterlockedIncrement(&this->version);
+}
+
+DWORD Histogram::Sample(const BYTE* src, BYTE* dst, DWORD count)
+{
+	DWORD changed = 0;
+	LevelColors* levels = this->levels;
+
+	if (this->format == FpsRgb)
+	{
+		if (config.isSSE2)
+		{
+			__m128i maskRB = _mm_set1_epi16(0xF8);
+			__m128i maskG = _mm_set1_epi16(0xFC);
+
+			for (; count >= 8; count -= 8, src += 16, dst += 16)
+			{
+				__m128i pNew = _mm_loadu_si128((const __m128i*)src);
+				__m128i pOld = _mm_loadu_si128((const __m128i*)dst);
+
+				INT mask = _mm_movemask_epi8(_mm_cmpeq_epi16(pNew, pOld));
+				if (mask == 0xFFFF)
+					continue;
+
+				_mm_storeu_si128((__m128i*)dst, pNew);
+
+				WORD unpacked[2][3][8];
+				_mm_storeu_si128((__m128i*)unpacked[0][0], _mm_and_si128(_mm_srli_epi16(pOld, 8), maskRB));
+				_mm_storeu_si128((__m128i*)unpacked[0][1], _mm_and_si128(_mm_srli_epi16(pOld, 3), maskG));
+				_mm_storeu_si128((__m128i*)unpacked[0][2], _mm_and_si128(_mm_slli_epi16(pOld, 3), maskRB));
+				_mm_storeu_si128((__m128i*)unpacked[1][0], _mm_and_si128(_mm_srli_epi16(pNew, 8), maskRB));
+				_mm_storeu_si128((__m128i*)unpacked[1][1], _mm_and_si128(_mm_srli_epi16(pNew, 3), maskG));
+				_mm_storeu_si128((__m128i*)unpacked[1][2], _mm_and_si128(_mm_slli_epi16(pNew, 3), maskRB));
+
+				for (DWORD i = 0; i < 8; ++i, mask >>= 2)
+				{
+					if (!(mask & 1))
+					{
+						--levels[unpacked[0][0][i]].red;
+						--levels[unpacked[0][1][i]].green;
+						--levels[unpacked[0][2][i]].blue;
+
+						++levels[unpacked[1][0][i]].red;
+						++levels[unpacked[1][1][i]].green;
+						++levels[unpacked[1][2][i]].blue;
+
+						++changed;
+					}
+				}
+			}
+		}
+
+		const WORD* pNew = (const WORD*)src;
+		WORD* pOld = (WORD*)dst;
+		for (; count; --count, ++pNew, ++pOld)
+		{
+			WORD p = *pOld;
+			WORD n = *pNew;
+			if (p != n)
+			{
+				--levels[(p >> 8) & 0xF8].red;
+				--levels[(p >> 3) & 0xFC].green;
+				--levels[(p << 3) & 0xF8].blue;
+
+				++levels[(n >> 8) & 0xF8].red;
+				++levels[(n >> 3) & 0xFC].green;
+				++levels[(n << 3) & 0xF8].blue;
+
+				*pOld = n;
+				++changed;
+			}
+		}
+	}
+	else
+	{
+		DWORD r, b;
+		if (this->format == FpsBgra)
+		{
+			r = 2;
+			b = 0;
+		}
+		else
+		{
+			r = 0;
+			b = 2;
+		}
+
+		if (config.isSSE2)
+		{
+			for (; count >= 4; count -= 4, src += 16, dst += 16)
+			{
+				__m128i pNew = _mm_loadu_si128((const __m128i*)src);
+				INT mask = _mm_movemask_epi8(_mm_cmpeq_epi32(pNew, _mm_loadu_si128((const __m128i*)dst)));
+				if (mask == 0xFFFF)
+					continue;
+
+				for (DWORD i = 0; i < 16; i += 4, mask >>= 4)
+				{
+					if (!(mask & 1))
+					{
+						--levels[dst[i + r]].red;
+						--levels[dst[i + 1]].green;
+						--levels[dst[i + b]].blue;
+
+						++levels[src[i + r]].red;
+						++levels[src[i + 1]].green;
+						++levels[src[i + b]].blue;
+
+						++changed;
+					}
+				}
+
+				_mm_storeu_si128((__m128i*)dst, pNew);
+			}
+		}
+
+		for (; count; --count, src += 4, dst += 4)
+		{
+			if (*(DWORD*)src != *(DWORD*)dst)
+			{
+				--levels[dst[r]].red;
+				--levels[dst[1]].green;
+				--levels[dst[b]].blue;
+
+				++levels[src[r]].red;
+				++levels[src[1]].green;
+				++levels[src[b]].blue;
+
+				*(DWORD*)dst = *(DWORD*)src;
+				++changed;
+			}
+		}
+	}
+
+	return changed;
+}
+
+VOID Histogram::Enable(BOOL state)
+{
+	EnterCriticalSection(&this->section);
+	{
+		this->isEnabled = state;
+		if (!state && this->shadow)
+		{
+			MemoryFree(this->shadow);
+			this->shadow = NULL;
+		}
+	}
+	LeaveCriticalSection(&this->section);
+}
+
+VOID Histogram::Update(const VOID* frame, DWORD width, DWORD height, DWORD pitch, FpsMode format, const RECT* rect)
+{
+	if (!this->isEnabled)
+		return;
+
+	if (rect)
+		UnionRect(&this->dirty, &this->dirty, rect);
+	else
+		SetRect(&this->dirty, 0, 0, width, height);
+
+	DWORD tick = GetTickCount();
+	if (INT(tick - this->next) < 0)
+		return;
+
+	EnterCriticalSection(&this->section);
+	{
+		if (this->isEnabled)
+		{
+			if (!this->shadow || this->width != width || this->height != height || this->format != format)
+			{
+				this->Reset(width, height, format);
+				SetRect(&this->dirty, 0, 0, width, height);
+			}
+
+			RECT bounds = { 0, 0, *(LONG*)&width, *(LONG*)&height };
+			RECT rc;
+			if (IntersectRect(&rc, &this->dirty, &bounds))
+			{
+				DWORD changed = 0;
+				DWORD count = rc.right - rc.left;
+				DWORD linePitch = width * this->depth;
+
+				const BYTE* src = (const BYTE*)frame + rc.top * pitch + rc.left * this->depth;
+				BYTE* dst = this->shadow + rc.top * linePitch + rc.left * this->depth;
+				for (LONG y = rc.top; y < rc.bottom; ++y, src += pitch, dst += linePitch)
+					changed += this->Sample(src, dst, count);
+
+				if (changed)
+					InterlockedIncrement(&this->version);
+			}
+		}
+	}
+	LeaveCriticalSection(&this->section);
+
+	SetRectEmpty(&this->dirty);
+	this->next = tick + HISTOGRAM_INTERVAL;
+}
+
+BOOL Histogram::Get(LevelColorsFloat* colors, LONG* version)
+{
+	if (*version == this->version)
+		return FALSE;
+
+	EnterCriticalSection(&this->section);
+	{
+		*version = this->version;
+
+		FLOAT total = FLOAT(this->width * this->height);
+		if (total)
+		{
+			LevelColors* src = this->levels;
+			LevelColorsFloat* dst = colors;
+			DWORD count = 256;
+			do
+			{
+				dst->red = (FLOAT)src->red / total;
+				dst->green = (FLOAT)src->green / total;
+				dst->blue = (FLOAT)src->blue / total;
+
+				++src;
+				++dst;
+			} while (--count);
+		}
+	}
+	LeaveCriticalSection(&this->section);
+
+	return TRUE;
+}
\ No newline at end of file
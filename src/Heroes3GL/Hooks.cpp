@@ -32,6 +32,12 @@
 #include "Window.h"
 #include "hooker.h"
 #include "Mods.h"
+#include "Registry.h"
+#include "Playlist.h"
+#include "Prefetch.h"
+#include "Ini.h"
+#include "Videos.h"
+#include "Pacing.h"
 
 #define STYLE_FULL_OLD (WS_VISIBLE | WS_POPUP)
 #define STYLE_FULL_NEW (WS_VISIBLE | WS_POPUP | WS_SYSMENU | WS_CLIPSIBLINGS)
@@ -41,6 +47,10 @@
 
 #define STYLE_DIALOG (DS_MODALFRAME | WS_POPUP)
 
+#define SPACE_NONE 0
+#define SPACE_DEFAULT 1
+#define SPACE_EQUAL 2
+
 const AddressSpace addressArray[] = {
 // === RUS ======================================================================================================================================
 #pragma region RUS
@@ -513,6 +523,15 @@ namespace Hooks
 			Sleep(dwMilliseconds);
 	}
 
+	VOID __stdcall ExitProcessHook(UINT uExitCode)
+	{
+		// Workers are joined here, DllMain runs under the loader lock
+		Prefetch::Stop();
+		Ini::Stop();
+
+		ExitProcess(uExitCode);
+	}
+
 	BOOL __stdcall EnumChildProc(HWND hDlg, LPARAM lParam)
 	{
 		if ((GetWindowLong(hDlg, GWL_STYLE) & SS_ICON) == SS_ICON)
@@ -579,7 +598,7 @@ namespace Hooks
 	AIL_OPEN_STREAM AIL_open_stream;
 	AIL_STREAM_POSITION AIL_stream_position;
 	AIL_SET_STREAM_POSITION AIL_set_stream_position;
-	TrackInfo *tracksList, *trackInfo;
+	TrackInfo* trackInfo;
 
 	DWORD __stdcall AIL_waveOutOpenHook(LPVOID driver, DWORD a1, DWORD a2, LPPCMWAVEFORMAT pcmFormat)
 	{
@@ -595,103 +614,16 @@ namespace Hooks
 		return AIL_waveOutOpen(driver, a1, a2, pcmFormat);
 	}
 
-	LPVOID OpenTrack(LPVOID driver, CHAR* group, CHAR* path, DWORD unknown)
-	{
-		trackInfo = tracksList;
-		while (trackInfo)
-		{
-			if (!StrCompare(trackInfo->path, path))
-				goto lbl_return;
-
-			trackInfo = trackInfo->last;
-		}
-
-		trackInfo = (TrackInfo*)MemoryAlloc(sizeof(TrackInfo));
-		trackInfo->last = tracksList;
-		tracksList = trackInfo;
-
-		trackInfo->position = 0;
-		trackInfo->group = StrDuplicate(group);
-		trackInfo->path = StrDuplicate(path);
-
-	lbl_return:
-		return AIL_open_stream(driver, trackInfo->path, unknown);
-	}
-
 	LPVOID __stdcall AIL_open_streamHook(LPVOID driver, CHAR* path, DWORD unknown)
 	{
 		if (trackInfo && !StrCompare(trackInfo->group, path))
 			return AIL_open_stream(driver, trackInfo->path, unknown);
 
-		if (StrLastChar(path, '.'))
-		{
-			DWORD total = 0;
-			CHAR filePath[MAX_PATH];
-
-			static const CHAR* audioExtList[] = { "*.wav", "*.mp3" };
-			StrCopy(filePath, path);
-			CHAR* p = StrLastChar(filePath, '.');
-
-			const CHAR** extension = audioExtList;
-			DWORD count = sizeof(audioExtList) / sizeof(CHAR*);
-			do
-			{
-				StrCopy(p, *extension);
-
-				WIN32_FIND_DATA findData = {};
-
-				HANDLE hFind = FindFirstFile(filePath, &findData);
-				if (hFind != INVALID_HANDLE_VALUE)
-				{
-					do
-						++total;
-					while (FindNextFile(hFind, &findData));
-					FindClose(hFind);
-				}
-				++extension;
-			} while (--count);
-
-			if (total)
-			{
-				DWORD random;
-				if (total != 1)
-				{
-					SeedRandom(timeGetTime());
-					random = Random() % total;
-				}
-				else
-					random = 0;
-
-				DWORD index = 0;
-				extension = audioExtList;
-				count = sizeof(audioExtList) / sizeof(CHAR*);
-				do
-				{
-					StrCopy(p, *extension);
-
-					WIN32_FIND_DATA findData;
-					HANDLE hFind = FindFirstFile(filePath, &findData);
-					if (hFind != INVALID_HANDLE_VALUE)
-					{
-						do
-						{
-							if (index++ == random)
-							{
-								FindClose(hFind);
-
-								StrCopy(StrLastChar(filePath, '\\') + 1, findData.cFileName);
-								return OpenTrack(driver, path, filePath, unknown);
-							}
-						} while (FindNextFile(hFind, &findData));
-						FindClose(hFind);
-					}
+		const CHAR* track = StrLastChar(path, '.') ? Playlist::Select(path) : NULL;
+		trackInfo = Playlist::Find(path, track ? track : path);
+		Prefetch::Check(trackInfo->path);
 
-					++extension;
-				} while (--count);
-			}
-		}
-
-		return OpenTrack(driver, path, path, unknown);
+		return AIL_open_stream(driver, trackInfo->path, unknown);
 	}
 
 	DWORD __stdcall AIL_stream_positionHook(LPVOID stream)
@@ -707,14 +639,16 @@ namespace Hooks
 
 #pragma endregion
 
-	BOOL notSleep;
+	IdleGovernor* idleGovernor;
 	BOOL __stdcall PeekMessageHook(LPMSG lpMsg, HWND hWnd, UINT wMsgFilterMin, UINT wMsgFilterMax, UINT wRemoveMsg)
 	{
 		if (PeekMessage(lpMsg, hWnd, wMsgFilterMin, wMsgFilterMax, wRemoveMsg))
 			return TRUE;
 
-		if (!notSleep)
-			Sleep(config.coldCPU);
+		if (config.coldCPU)
+			idleGovernor->Wait();
+		else
+			Sleep(0);
 
 		return FALSE;
 	}
@@ -726,53 +660,12 @@ namespace Hooks
 		if (hFile && hFile != INVALID_HANDLE_VALUE)
 		{
 			CHAR* p = StrLastChar((CHAR*)lpFileName, '.');
-			if (p && !StrCompareInsensitive(p, ".vid"))
+			if (p && !StrCompareInsensitive(p, ".bik"))
+				Prefetch::Check(lpFileName);
+			else if (p && !StrCompareInsensitive(p, ".vid"))
 			{
-				DWORD countInFile, readed;
-				if (ReadFile(hFile, &countInFile, sizeof(DWORD), &readed, NULL) && readed && countInFile)
-				{
-					VideoFile* infoList = (VideoFile*)MemoryAlloc(sizeof(VideoFile) * countInFile);
-					if (ReadFile(hFile, infoList, sizeof(VideoFile) * countInFile, &readed, NULL))
-					{
-						CHAR name[40];
-						{
-							VideoInfo* gameInfo = (VideoInfo*)(hookSpace->video_address + GetBaseOffset(hooker));
-							DWORD countInGame = hookSpace->video_count;
-
-							do
-							{
-								if (!gameInfo->bink)
-								{
-									StrCopy(name, gameInfo->fileName);
-									StrCat(name, ".bik");
-
-									VideoFile* fileInfo = infoList;
-
-									DWORD count = countInFile;
-									do
-									{
-										if (!StrCompareInsensitive(name, fileInfo->name))
-										{
-											SetFilePointer(hFile, fileInfo->stride, 0, FILE_BEGIN);
-											DWORD signature;
-											if (ReadFile(hFile, &signature, 4, &readed, NULL))
-												gameInfo->bink = signature == 'bKIB';
-
-											break;
-										}
-
-										++fileInfo;
-									} while (--count);
-								}
-
-								++gameInfo;
-							} while (--countInGame);
-						}
-					}
-					MemoryFree(infoList);
-				}
-
-				SetFilePointer(hFile, 0, 0, FILE_BEGIN);
+				Prefetch::Check(lpFileName);
+				Videos::Load(hFile, lpFileName, (VideoInfo*)(hookSpace->video_address + GetBaseOffset(hooker)), hookSpace->video_count);
 			}
 		}
 
@@ -781,14 +674,13 @@ namespace Hooks
 #pragma endregion
 
 #pragma region Move Hero
-	DWORD moveCounter;
 	VOID __fastcall CalcRunPos(DWORD* obj, DWORD idx)
 	{
 		if (config.smooth.move)
 		{
-			// legs correction
-			static DWORD posIndex;
-			if (posIndex % moveCounter)
+			// legs correction, one leg frame per 50 ms at any refresh rate
+			static DOUBLE legTime;
+			if (!Pacing::Elapse(&legTime, 50.0))
 			{
 				DWORD* pos = &obj[128];
 				if (*pos)
@@ -797,8 +689,6 @@ namespace Hooks
 					*pos = 7;
 			}
 
-			++posIndex;
-
 			// position correction
 			if (idx == 1)
 			{
@@ -844,13 +734,9 @@ namespace Hooks
 	DWORD cursorTime = 16;
 	VOID CheckRefreshRate()
 	{
-		DEVMODE devMode = {};
-		devMode.dmSize = sizeof(DEVMODE);
+		Pacing::Load();
 
-		if (EnumDisplaySettings(NULL, ENUM_CURRENT_SETTINGS, &devMode) && devMode.dmDisplayFrequency)
-			cursorTime = 1000 / devMode.dmDisplayFrequency;
-		else
-			cursorTime = 16;
+		cursorTime = Pacing::Interval();
 
 		// ==========================================================
 		PatchByte(hooker, hookSpace->cursor_time_1 + 2, (BYTE)cursorTime);
@@ -860,9 +746,7 @@ namespace Hooks
 		// ==========================================================
 		if (config.smooth.move)
 		{
-			moveCounter = DWORD(50.0f / cursorTime);
-
-			FLOAT dist = 0.02f * cursorTime;
+			FLOAT dist = 0.02f * (FLOAT)Pacing::period;
 			MoveObject moveObject = {
 				2, DWORD(dist * 8), DWORD(dist * 10), DWORD(dist * 16), 32,
 				100, cursorTime, cursorTime, cursorTime, 100,
@@ -902,6 +786,33 @@ namespace Hooks
 		}
 	}
 
+	MapScroll* GetMapScroll(const RECT* rc, LONG stepX, LONG stepY)
+	{
+		if (!config.smooth.offset || config.isDDraw || !drawList)
+			return NULL;
+
+		OpenDraw* ddraw = (OpenDraw*)drawList;
+		OpenDrawSurface* surface = ddraw->attachedSurface;
+		if (!surface || !surface->indexBuffer || rc->left < 0 || rc->top < 0 || rc->right > (LONG)surface->mode.width || rc->bottom > (LONG)surface->mode.height
+			|| !ddraw->mapScroll->Begin(rc, surface->mode.bpp >> 3, stepX, stepY))
+			return NULL;
+
+		ddraw->mapScroll->Load(surface->indexBuffer, surface->pitch, TRUE);
+		return ddraw->mapScroll;
+	}
+
+	VOID DrawMapTile(DWORD object, DWORD mapObject, RECT rc, POINT pos, LONG unk)
+	{
+		POINT* shift = (POINT*)(mapObject + 244);
+		POINT keep = *shift;
+		*shift = {};
+
+		((VOID(__thiscall*)(DWORD, POINT, LONG, DWORD, DWORD))sub_SetMapCenter)(mapObject, pos, unk, 0, 1);
+		((VOID(__thiscall*)(DWORD, RECT))sub_DrawSizedRect_2)(object, rc);
+
+		*shift = keep;
+	}
+
 	VOID __fastcall DrawMapRect(DWORD object, DWORD mapObject, RECT rc)
 	{
 		MapPosition* newCenter = (MapPosition*)(mapObject + 228);
@@ -921,7 +832,8 @@ namespace Hooks
 				POINTFLOAT start = { (FLOAT)speed.x, (FLOAT)speed.y };
 				POINTFLOAT offset = { (FLOAT)start.x, (FLOAT)start.y };
 
-				FLOAT mult = (FLOAT)cursorTime / 70;
+				DOUBLE timeline = 0.0;
+				FLOAT mult = (FLOAT)Pacing::period / 70;
 				POINTFLOAT diff = { 0.0f, 0.0f };
 				POINT step = { 0, 0 };
 
@@ -947,6 +859,16 @@ namespace Hooks
 					diff.y = mult * speed.y;
 				}
 
+				// The game redraws the map only on tile boundaries, sub-tile steps move the texture coordinates of the map overlay
+				MapScroll* scroll = speed.x && speed.y ? NULL : GetMapScroll(&rc, step.x, step.y);
+				OpenDrawSurface* surface = scroll ? ((OpenDraw*)drawList)->attachedSurface : NULL;
+				POINT tile = oldc;
+				if (scroll)
+				{
+					((OpenDraw*)drawList)->scrollRect = rc;
+					((OpenDraw*)drawList)->isScrolling = TRUE;
+				}
+
 				POINT* shift = (POINT*)(mapObject + 244);
 				POINT pos = oldc;
 				do
@@ -989,18 +911,48 @@ namespace Hooks
 						shift->y = (LONG)(offset.y * 32.0f) % 32;
 					}
 
-					((VOID(__thiscall*)(DWORD, POINT, LONG, DWORD, DWORD))sub_SetMapCenter)(mapObject, pos, newUnk, 0, 1);
-					((VOID(__thiscall*)(DWORD, RECT))sub_DrawSizedRect_2)(object, rc);
+					if (scroll)
+					{
+						if (pos.x != tile.x || pos.y != tile.y)
+						{
+							POINT back = { pos.x - step.x, pos.y - step.y };
+							if (back.x != tile.x || back.y != tile.y)
+								DrawMapTile(object, mapObject, rc, back, newUnk);
+
+							scroll->Load(surface->indexBuffer, surface->pitch, FALSE);
+							DrawMapTile(object, mapObject, rc, pos, newUnk);
+							scroll->Load(surface->indexBuffer, surface->pitch, TRUE);
+							tile = pos;
+						}
 
-					notSleep = TRUE;
+						scroll->Shift(shift->x, shift->y);
+						SetEvent(((OpenDraw*)drawList)->hDrawEvent);
+					}
+					else
 					{
-						sleep += cursorTime;
-						((VOID(__thiscall*)(DWORD))hookSpace->move_lifeCycle)(sleep);
+						((VOID(__thiscall*)(DWORD, POINT, LONG, DWORD, DWORD))sub_SetMapCenter)(mapObject, pos, newUnk, 0, 1);
+						((VOID(__thiscall*)(DWORD, RECT))sub_DrawSizedRect_2)(object, rc);
 					}
-					notSleep = FALSE;
+
+					sleep += Pacing::Next(&timeline);
+					idleGovernor->SetDeadline(sleep);
+					((VOID(__thiscall*)(DWORD))hookSpace->move_lifeCycle)(sleep);
+					idleGovernor->ResetDeadline();
 				} while (TRUE);
 
-				if (shift->x || shift->y || pos.x != newc.x || pos.x != newc.x)
+				if (scroll)
+				{
+					((OpenDraw*)drawList)->isScrolling = FALSE;
+
+					*shift = {};
+					((VOID(__thiscall*)(DWORD, POINT, LONG, DWORD, DWORD))sub_SetMapCenter)(mapObject, newc, newUnk, 0, 1);
+					((VOID(__thiscall*)(DWORD, RECT))sub_DrawSizedRect_2)(object, rc);
+
+					((OpenDraw*)drawList)->Publish(surface->indexBuffer, &rc);
+					scroll->End();
+					SetEvent(((OpenDraw*)drawList)->hDrawEvent);
+				}
+				else if (shift->x || shift->y || pos.x != newc.x || pos.y != newc.y)
 				{
 					*shift = {};
 					goto lbl_set_center;
@@ -1049,45 +1001,47 @@ namespace Hooks
 
 	LSTATUS __stdcall RegQueryValueExHook(HKEY hKey, LPCSTR lpValueName, LPDWORD lpReserved, LPDWORD lpType, LPBYTE lpData, LPDWORD lpcbData)
 	{
-		DWORD size = *lpcbData;
-
 		if (!config.isExist)
 		{
-			LSTATUS res = RegQueryValueEx(hKey, lpValueName, lpReserved, lpType, lpData, lpcbData);
+			DWORD type;
+			LSTATUS res = RegQueryValueEx(hKey, lpValueName, lpReserved, &type, lpData, lpcbData);
+			if (lpType)
+				*lpType = type;
 
-			if (size == sizeof(DWORD))
-				Config::Set(CONFIG_APP, lpValueName, *(INT*)lpData);
-			else
-				Config::Set(CONFIG_APP, lpValueName, (CHAR*)lpData);
+			if (!res && lpData && lpcbData)
+				Registry::Set(lpValueName, type, lpData, *lpcbData);
 
 			return res;
 		}
 		else
 		{
-			if (size == sizeof(DWORD))
-			{
-				*(INT*)lpData = Config::Get(CONFIG_APP, lpValueName, *(INT*)lpData);
-				if (lpType)
-					*lpType = REG_DWORD;
-			}
-			else
+			LSTATUS res = Registry::Query(lpValueName, lpType, lpData, lpcbData);
+			if (res == ERROR_FILE_NOT_FOUND)
 			{
-				Config::Get(CONFIG_APP, lpValueName, "", (CHAR*)lpData, *lpcbData);
-				if (lpType)
-					*lpType = *lpcbData ? REG_BINARY : REG_SZ;
+				if (lpcbData && *lpcbData == sizeof(DWORD))
+				{
+					if (lpType)
+						*lpType = REG_DWORD;
+				}
+				else
+				{
+					if (lpData && lpcbData && *lpcbData)
+						*lpData = NULL;
+
+					if (lpType)
+						*lpType = REG_SZ;
+				}
+
+				res = ERROR_SUCCESS;
 			}
 
-			return ERROR_SUCCESS;
+			return res;
 		}
 	}
 
 	LSTATUS __stdcall RegSetValueExHook(HKEY hKey, LPCSTR lpValueName, DWORD Reserved, DWORD dwType, const BYTE* lpData, DWORD cbData)
 	{
-		if (dwType == REG_DWORD)
-			Config::Set(CONFIG_APP, lpValueName, *(INT*)lpData);
-		else
-			Config::Set(CONFIG_APP, lpValueName, (CHAR*)lpData);
-
+		Registry::Set(lpValueName, dwType, lpData, cbData);
 		return ERROR_SUCCESS;
 	}
 #pragma endregion
@@ -1166,37 +1120,80 @@ namespace Hooks
 	}
 #pragma endregion
 
+#pragma region Image index
+	BOOL GetImageKey(HMODULE hModule, CHAR* key)
+	{
+		PIMAGE_DOS_HEADER headDos = (PIMAGE_DOS_HEADER)hModule;
+		if (headDos->e_magic != IMAGE_DOS_SIGNATURE)
+			return FALSE;
+
+		PIMAGE_NT_HEADERS headNT = (PIMAGE_NT_HEADERS)((BYTE*)hModule + headDos->e_lfanew);
+		if (headNT->Signature != IMAGE_NT_SIGNATURE)
+			return FALSE;
+
+		StrPrint(key, "%08X%08X%08X", headNT->FileHeader.TimeDateStamp, headNT->OptionalHeader.SizeOfImage, headNT->OptionalHeader.AddressOfEntryPoint);
+		return TRUE;
+	}
+
+	DWORD CheckSpace(const AddressSpace* space)
+	{
+		DWORD check1, check2, equal;
+		if (ReadDWord(hooker, space->check_1 + 1, &check1) && check1 == STYLE_FULL_OLD && ReadDWord(hooker, space->check_2 + 1, &check2) && check2 == STYLE_FULL_OLD)
+		{
+			if (!space->equal_address)
+				return SPACE_DEFAULT;
+			else if (ReadDWord(hooker, space->equal_address, &equal) && equal == space->equal_value)
+				return SPACE_EQUAL;
+		}
+
+		return SPACE_NONE;
+	}
+#pragma endregion
+
 #pragma optimize("s", on)
 	BOOL Load()
 	{
-		const AddressSpace* defaultSpace = NULL;
-		const AddressSpace* equalSpace = NULL;
-
 		hooker = CreateHooker(GetModuleHandle(NULL));
 
-		hookSpace = addressArray;
+		HMODULE hModule = GetHookerModule(hooker);
+		Config::Open(hModule);
+
+		// Known executables are matched by their PE header, only the remembered entry is probed
+		CHAR imageKey[32];
+		BOOL isImage = GetImageKey(hModule, imageKey);
 		DWORD hookCount = sizeof(addressArray) / sizeof(AddressSpace);
-		do
+		DWORD index = isImage ? Config::Get(CONFIG_IMAGES, imageKey, 0) : 0;
+		if (index && index <= hookCount && CheckSpace(addressArray + index - 1))
+			hookSpace = addressArray + index - 1;
+		else
 		{
-			DWORD check1, check2, equal;
-			if (ReadDWord(hooker, hookSpace->check_1 + 1, &check1) && check1 == STYLE_FULL_OLD && ReadDWord(hooker, hookSpace->check_2 + 1, &check2) && check2 == STYLE_FULL_OLD)
+			const AddressSpace* defaultSpace = NULL;
+			const AddressSpace* equalSpace = NULL;
+
+			hookSpace = addressArray;
+			do
 			{
-				if (!hookSpace->equal_address)
+				DWORD space = CheckSpace(hookSpace);
+				if (space == SPACE_DEFAULT)
 					defaultSpace = hookSpace;
-				else if (ReadDWord(hooker, hookSpace->equal_address, &equal) && equal == hookSpace->equal_value)
+				else if (space == SPACE_EQUAL)
 				{
 					equalSpace = hookSpace;
 					break;
 				}
-			}
 
-			++hookSpace;
-		} while (--hookCount);
+				++hookSpace;
+			} while (--hookCount);
+
+			hookSpace = equalSpace ? equalSpace : defaultSpace;
+			if (hookSpace && isImage && !config.isDDraw)
+				Config::Set(CONFIG_IMAGES, imageKey, (INT)(hookSpace - addressArray) + 1);
+		}
 
-		hookSpace = equalSpace ? equalSpace : defaultSpace;
 		if (hookSpace)
 		{
-			Config::Load(GetHookerModule(hooker), hookSpace);
+			Config::Load(hModule, hookSpace);
+			idleGovernor = new IdleGovernor();
 
 			HOOKER user = CreateHooker(GetModuleHandle("USER32.dll"));
 			if (user)
@@ -1221,6 +1218,7 @@ namespace Hooks
 				PatchImportByName(hooker, "EnableMenuItem", EnableMenuItemHook);
 
 				PatchImportByName(hooker, "Sleep", SleepHook);
+				PatchImportByName(hooker, "ExitProcess", ExitProcessHook);
 
 				PatchImportByName(hooker, "RegCreateKeyA", RegCreateKeyHook);
 				PatchImportByName(hooker, "RegOpenKeyExA", RegOpenKeyExHook);
@@ -1292,5 +1290,11 @@ namespace Hooks
 
 		return FALSE;
 	}
+
+	VOID Release()
+	{
+		if (idleGovernor)
+			delete idleGovernor;
+	}
 #pragma optimize("", on)
 }
\ No newline at end of file
@@ -24,12 +24,17 @@
 
 #pragma once
 
+#include "IdleGovernor.h"
+
 namespace Hooks
 {
+	extern IdleGovernor* idleGovernor;
+
 	INT_PTR __stdcall DialogBoxParamHook(HINSTANCE, LPCSTR, HWND, DLGPROC, LPARAM);
 	INT __stdcall MessageBoxHook(HWND, LPCSTR, LPCSTR, UINT);
 
 	BOOL __stdcall EnumChildProc(HWND, LPARAM);
 	VOID CheckRefreshRate();
 	BOOL Load();
+	VOID Release();
 }
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include "Allocation.h"
+
+#define GOVERNOR_WORK 500
+#define GOVERNOR_MARGIN 1000
+#define GOVERNOR_LIMIT 100000
+#define GOVERNOR_WINDOW 1000000
+#define GOVERNOR_RELEARN 4
+#define GOVERNOR_FALLBACK 1
+
+// Clock and message queue of the governor, a test replaces them with a simulation
+class IdleSource : public Allocation
+{
+private:
+	LONGLONG frequency;
+
+public:
+	IdleSource();
+	virtual ~IdleSource();
+
+	virtual LONGLONG Now();
+	virtual DWORD Time();
+	virtual BOOL Wait(DWORD);
+};
+
+class IdleGovernor : public Allocation
+{
+private:
+	IdleSource* source;
+	LONGLONG released;
+	LONGLONG work;
+	LONGLONG cadence;
+	LONGLONG next;
+	LONGLONG deadline;
+	LONGLONG target;
+	LONGLONG average;
+	LONGLONG overshoot;
+	LONGLONG windowStart;
+	LONGLONG windowIdle;
+	BOOL woken;
+	BOOL missing;
+	DWORD late;
+	DWORD misses;
+	DWORD waits;
+	DWORD signaled;
+	DWORD missed;
+
+	VOID Relearn();
+	VOID Learn(LONGLONG);
+	DWORD Plan(LONGLONG);
+	VOID Account(LONGLONG, LONGLONG, DWORD, BOOL);
+
+public:
+	DWORD idle;
+	DWORD latency;
+	DWORD period;
+
+	IdleGovernor(IdleSource* = NULL);
+	~IdleGovernor();
+
+	VOID SetDeadline(DWORD);
+	VOID ResetDeadline();
+	VOID Wait();
+};
\ No newline at end of file
@@ -0,0 +1,287 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "MapScroll.h"
+#include "Config.h"
+
+/*
+	Sub-tile map scrolling. The game thread keeps the tile aligned map image extended by the
+	neighbour tile strip the scroll is moving towards, the render thread keeps it in a texture and
+	draws the map rectangle from it with the texture coordinates moved by the current sub-tile shift.
+*/
+
+MapScroll::MapScroll()
+{
+	InitializeCriticalSection(&this->section);
+	this->capacity = 0;
+	this->images[0] = NULL;
+	this->images[1] = NULL;
+	this->front = 0;
+	this->version = 0;
+	this->isActive = FALSE;
+	MemoryZero(&this->state, sizeof(ScrollState));
+
+	this->textureId = 0;
+	this->texSize = 0;
+	this->uploaded = 0;
+	MemoryZero(&this->drawn, sizeof(ScrollState));
+	this->maxSize = 0;
+}
+
+MapScroll::~MapScroll()
+{
+	if (this->capacity)
+	{
+		AlignedFree(this->images[0]);
+		AlignedFree(this->images[1]);
+	}
+
+	DeleteCriticalSection(&this->section);
+}
+
+BOOL MapScroll::Begin(const RECT* rect, DWORD depth, LONG stepX, LONG stepY)
+{
+	LONG width = rect->right - rect->left;
+	LONG height = rect->bottom - rect->top;
+
+	SIZE size = { width + (stepX ? SCROLL_TILE : 0), height + (stepY ? SCROLL_TILE : 0) };
+	if (width <= SCROLL_TILE || height <= SCROLL_TILE || size.cx > (LONG)this->maxSize || size.cy > (LONG)this->maxSize)
+		return FALSE;
+
+	DWORD pitch = (size.cx * depth + 3) & ~3;
+	if (this->capacity < pitch * size.cy)
+	{
+		BYTE* first = (BYTE*)AlignedAlloc(pitch * size.cy);
+		BYTE* second = first ? (BYTE*)AlignedAlloc(pitch * size.cy) : NULL;
+		if (!second)
+		{
+			if (first)
+				AlignedFree(first);
+
+			return FALSE;
+		}
+
+		EnterCriticalSection(&this->section);
+		{
+			if (this->capacity)
+			{
+				AlignedFree(this->images[0]);
+				AlignedFree(this->images[1]);
+			}
+
+			this->images[0] = first;
+			this->images[1] = second;
+			this->capacity = pitch * size.cy;
+		}
+		LeaveCriticalSection(&this->section);
+	}
+
+	EnterCriticalSection(&this->section);
+	{
+		this->depth = depth;
+		this->pitch = pitch;
+		this->isActive = FALSE;
+
+		this->state.rect = *rect;
+		this->state.size = size;
+		this->state.origin.x = stepX > 0 ? SCROLL_TILE : 0;
+		this->state.origin.y = stepY > 0 ? SCROLL_TILE : 0;
+		this->state.shift.x = 0;
+		this->state.shift.y = 0;
+
+		this->strip.x = stepX < 0 ? width : 0;
+		this->strip.y = stepY < 0 ? height : 0;
+	}
+	LeaveCriticalSection(&this->section);
+
+	return TRUE;
+}
+
+// Copies the map rectangle of the surface into the hidden image: the neighbour strip first, then the tile aligned image which publishes it
+VOID MapScroll::Load(const BYTE* buffer, DWORD pitch, BOOL isCurrent)
+{
+	BYTE* image = this->images[!this->front];
+	RECT* rect = &this->state.rect;
+
+	LONG width = rect->right - rect->left;
+	LONG height = rect->bottom - rect->top;
+
+	const BYTE* src = buffer + rect->top * pitch + rect->left * this->depth;
+	BYTE* dst = image;
+	if (isCurrent)
+		dst += this->state.origin.y * this->pitch + this->state.origin.x * this->depth;
+	else
+	{
+		dst += this->strip.y * this->pitch + this->strip.x * this->depth;
+		if (this->state.size.cx != width)
+		{
+			src += (this->strip.x ? width - SCROLL_TILE : 0) * this->depth;
+			width = SCROLL_TILE;
+		}
+		else
+		{
+			src += (this->strip.y ? height - SCROLL_TILE : 0) * pitch;
+			height = SCROLL_TILE;
+		}
+	}
+
+	do
+	{
+		MemoryCopy(dst, src, width * this->depth);
+		src += pitch;
+		dst += this->pitch;
+	} while (--height);
+
+	if (isCurrent)
+	{
+		EnterCriticalSection(&this->section);
+		{
+			this->front = !this->front;
+			this->isActive = TRUE;
+			++this->version;
+		}
+		LeaveCriticalSection(&this->section);
+	}
+}
+
+VOID MapScroll::Shift(LONG x, LONG y)
+{
+	EnterCriticalSection(&this->section);
+	{
+		this->state.shift.x = x;
+		this->state.shift.y = y;
+	}
+	LeaveCriticalSection(&this->section);
+}
+
+VOID MapScroll::End()
+{
+	EnterCriticalSection(&this->section);
+	{
+		this->isActive = FALSE;
+	}
+	LeaveCriticalSection(&this->section);
+}
+
+VOID MapScroll::Create(DWORD size, GLenum internalFormat, GLenum format, GLenum type)
+{
+	this->format = format;
+	this->type = type;
+	this->filter = GL_LINEAR;
+	this->uploaded = this->version - 1;
+	MemoryZero(&this->drawn, sizeof(ScrollState));
+
+	GLGenTextures(1, &this->textureId);
+	GLBindTexture(GL_TEXTURE_2D, this->textureId);
+	GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, config.gl.caps.clampToEdge);
+	GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, config.gl.caps.clampToEdge);
+	GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+	GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	GLTexImage2D(GL_TEXTURE_2D, 0, internalFormat, size, size, GL_NONE, format, type, NULL);
+
+	this->texSize = size;
+	this->maxSize = size;
+}
+
+VOID MapScroll::Release()
+{
+	this->texSize = 0;
+	this->maxSize = 0;
+	this->End();
+
+	GLDeleteTextures(1, &this->textureId);
+	this->textureId = 0;
+}
+
+// Renderer paths that cannot draw the overlay turn it off, the game then redraws every scroll step itself
+VOID MapScroll::Enable(BOOL isEnabled)
+{
+	this->maxSize = isEnabled ? this->texSize : 0;
+}
+
+// Uploads a newly loaded image and reports whether the overlay has to be drawn again
+BOOL MapScroll::Update(GLuint restore)
+{
+	BOOL isChanged;
+	EnterCriticalSection(&this->section);
+	{
+		ScrollState current = this->state;
+		current.isActive = this->isActive && this->maxSize;
+
+		if (current.isActive && this->uploaded != this->version)
+		{
+			this->uploaded = this->version;
+
+			GLBindTexture(GL_TEXTURE_2D, this->textureId);
+			GLPixelStorei(GL_UNPACK_ROW_LENGTH, this->pitch / this->depth);
+			GLTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, current.size.cx, current.size.cy, this->format, this->type, this->images[this->front]);
+			GLPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+			GLBindTexture(GL_TEXTURE_2D, restore);
+
+			isChanged = TRUE;
+		}
+		else
+			isChanged = current.isActive != this->drawn.isActive
+				|| current.isActive && (current.shift.x != this->drawn.shift.x || current.shift.y != this->drawn.shift.y);
+
+		this->drawn = current;
+	}
+	LeaveCriticalSection(&this->section);
+
+	return isChanged;
+}
+
+BOOL MapScroll::GetQuad(FLOAT scale, ScrollQuad* quad)
+{
+	ScrollState* state = &this->drawn;
+	if (!state->isActive)
+		return FALSE;
+
+	quad->left = state->rect.left / scale;
+	quad->top = state->rect.top / scale;
+	quad->right = state->rect.right / scale;
+	quad->bottom = state->rect.bottom / scale;
+
+	FLOAT size = (FLOAT)this->texSize;
+	quad->texLeft = (state->origin.x - state->shift.x) / size;
+	quad->texTop = (state->origin.y - state->shift.y) / size;
+	quad->texRight = quad->texLeft + (state->rect.right - state->rect.left) / size;
+	quad->texBottom = quad->texTop + (state->rect.bottom - state->rect.top) / size;
+
+	return TRUE;
+}
+
+VOID MapScroll::Bind(GLint filter)
+{
+	GLBindTexture(GL_TEXTURE_2D, this->textureId);
+	if (this->filter != filter)
+	{
+		this->filter = filter;
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	}
+}
@@ -0,0 +1,70 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include "Allocation.h"
+#include "ExtraTypes.h"
+
+#define SCROLL_TILE 32
+
+class MapScroll : public Allocation
+{
+private:
+	CRITICAL_SECTION section;
+	DWORD depth;
+	DWORD pitch;
+	DWORD capacity;
+	BYTE* images[2];
+	DWORD front;
+	volatile LONG version;
+	BOOL isActive;
+	ScrollState state;
+	POINT strip;
+
+	GLuint textureId;
+	DWORD texSize;
+	GLenum format;
+	GLenum type;
+	GLint filter;
+	LONG uploaded;
+	ScrollState drawn;
+
+public:
+	volatile DWORD maxSize;
+
+	MapScroll();
+	~MapScroll();
+
+	BOOL Begin(const RECT*, DWORD, LONG, LONG);
+	VOID Load(const BYTE*, DWORD, BOOL);
+	VOID Shift(LONG, LONG);
+	VOID End();
+
+	VOID Create(DWORD, GLenum, GLenum, GLenum);
+	VOID Release();
+	VOID Enable(BOOL);
+	BOOL Update(GLuint);
+	BOOL GetQuad(FLOAT, ScrollQuad*);
+	VOID Bind(GLint);
+};
\ No newline at end of file
@@ -33,6 +33,13 @@
 #include "ShaderGroup.h"
 #include "PixelBuffer.h"
 #include "FpsCounter.h"
+#include "FramePacer.h"
+#include "Resampler.h"
+#include "ColorTable.h"
+#include "Snapshot.h"
+#include "Recorder.h"
+#include "Ini.h"
+#include "Convert.h"
 
 DWORD GetPow2(DWORD value)
 {
@@ -42,6 +49,24 @@ DWORD GetPow2(DWORD value)
 	return res;
 }
 
+// Map scroll overlay vertices in the clip space of the shader renderers
+VOID SetScrollQuad(FLOAT buffer[4][8], const ScrollQuad* quad, DWORD width, DWORD height)
+{
+	FLOAT left = quad->left * 2.0f / width - 1.0f;
+	FLOAT right = quad->right * 2.0f / width - 1.0f;
+	FLOAT top = 1.0f - quad->top * 2.0f / height;
+	FLOAT bottom = 1.0f - quad->bottom * 2.0f / height;
+
+	FLOAT vertices[4][8] = {
+		{ left, top, -1.0f, 1.0f, quad->texLeft, quad->texTop, 0.0f, 0.0f },
+		{ right, top, -1.0f, 1.0f, quad->texRight, quad->texTop, 0.0f, 0.0f },
+		{ right, bottom, -1.0f, 1.0f, quad->texRight, quad->texBottom, 0.0f, 0.0f },
+		{ left, bottom, -1.0f, 1.0f, quad->texLeft, quad->texBottom, 0.0f, 0.0f }
+	};
+
+	MemoryCopy(buffer, vertices, sizeof(vertices));
+}
+
 DWORD __stdcall RenderThread(LPVOID lpParameter)
 {
 	OpenDraw* ddraw = (OpenDraw*)lpParameter;
@@ -212,6 +237,17 @@ VOID OpenDraw::RenderOld()
 			}
 		}
 
+		BOOL isDirectUpdate = this->mode.bpp == 32 && !config.gl.caps.bgra || this->mode.bpp == 16 && config.gl.version.value <= GL_VER_1_1;
+
+		// The map scroll overlay has its own texture, the converting upload path has no room for it
+		DWORD scrollSize = GetPow2((this->mode.width > this->mode.height ? this->mode.width : this->mode.height) + SCROLL_TILE);
+		if (isDirectUpdate || scrollSize > glMaxTexSize)
+			scrollSize = 0;
+		else if (this->mode.bpp == 16)
+			this->mapScroll->Create(scrollSize, GL_RGB, GL_RGB, GL_UNSIGNED_SHORT_5_6_5);
+		else
+			this->mapScroll->Create(scrollSize, GL_RGBA, GL_BGRA_EXT, GL_UNSIGNED_BYTE);
+
 		GLMatrixMode(GL_PROJECTION);
 		GLLoadIdentity();
 		GLOrtho(0.0, (GLdouble)this->mode.width, (GLdouble)this->mode.height, 0.0, 0.0, 1.0);
@@ -225,11 +261,19 @@ VOID OpenDraw::RenderOld()
 		if (WGLSwapInterval)
 			WGLSwapInterval(0);
 
-		DWORD clear = 0;
+		// All tiles are drawn from one display list, rebuilt when the scale moves the texture coordinates
+		GLuint frameList = GLGenLists(1);
+		GLuint bound = frames[frameCount - 1].id;
+		FLOAT listScale = 0.0f;
 
-		BOOL isDirectUpdate = this->mode.bpp == 32 && !config.gl.caps.bgra || this->mode.bpp == 16 && config.gl.version.value <= GL_VER_1_1;
+		FLOAT oldScale = 1.0f;
+		DWORD clear = 0;
+		GLint scrollFilter = GL_LINEAR;
 		FpsCounter* fpsCounter = new FpsCounter(isDirectUpdate ? FpsRgba : (this->mode.bpp == 32 ? FpsBgra : FpsRgb), this->textureWidth);
-		PixelBuffer* pixelBuffer = new PixelBuffer(this->textureWidth, this->mode.height, isDirectUpdate || this->mode.bpp == 32, isDirectUpdate ? GL_RGBA : (this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB), config.updateMode);
+		FramePacer* pacer = new FramePacer(config.frameLatency);
+		UpdateMode updateMode = PixelBuffer::Tune(this->textureWidth, this->mode.height, isDirectUpdate || this->mode.bpp == 32, isDirectUpdate ? GL_RGBA : (this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB));
+		PixelBuffer* pixelBuffer = new PixelBuffer(this->textureWidth, this->mode.height, isDirectUpdate || this->mode.bpp == 32, isDirectUpdate ? GL_RGBA : (this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB), updateMode);
+		ColorTable* colorTable = new ColorTable(this->pitch, this->mode.height, this->mode.bpp == 32 ? FpsBgra : FpsRgb);
 		{
 			do
 			{
@@ -258,7 +302,10 @@ VOID OpenDraw::RenderOld()
 				FilterState state = this->filterState;
 				this->filterState.flags = FALSE;
 				if (state.flags)
+				{
 					glFilter = state.interpolation == InterpolateNearest ? GL_NEAREST : GL_LINEAR;
+					scrollFilter = glFilter;
+				}
 
 				BOOL isSnapshot = this->isTakeSnapshot;
 				this->isTakeSnapshot = FALSE;
@@ -266,18 +313,30 @@ VOID OpenDraw::RenderOld()
 					clear = 0;
 
 				FLOAT currScale = surface->scale;
+				if (oldScale != currScale)
+				{
+					oldScale = currScale;
+					clear = 0;
+				}
+
 				if (this->CheckView())
 				{
 					GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
 					clear = 0;
 				}
 
-				if (clear++ <= 1)
+				BOOL isRedraw = clear++ <= 1;
+				if (isRedraw)
 					GLClear(GL_COLOR_BUFFER_BIT);
 
+				VOID* frameData = this->frames->Acquire();
+				VOID* drawData = colorTable->Apply(frameData, this->frames->GetChanged());
+				if (scrollSize)
+					this->mapScroll->Enable(drawData == frameData);
+
 				if (isDirectUpdate)
 				{
-					BYTE* srcData = surface->indexBuffer;
+					BYTE* srcData = (BYTE*)drawData;
 					DWORD* dstData = (DWORD*)pixelBuffer->GetBuffer();
 
 					DWORD copyHeight = this->mode.height;
@@ -285,102 +344,174 @@ VOID OpenDraw::RenderOld()
 					{
 						do
 						{
-							DWORD* src = (DWORD*)srcData;
+							SwapRedBlue((const uint32_t*)srcData, (uint32_t*)dstData, this->mode.width);
 							srcData += this->pitch;
-
-							DWORD* dst = dstData;
 							dstData += textureWidth;
-
-							DWORD count = this->mode.width;
-							do
-								*dst++ = _byteswap_ulong(_rotl(*src++, 8));
-							while (--count);
 						} while (--copyHeight);
 					}
 					else
 					{
 						do
 						{
-							WORD* src = (WORD*)srcData;
+							Rgb565ToRgba((const uint16_t*)srcData, (uint32_t*)dstData, this->mode.width);
 							srcData += this->pitch;
-
-							DWORD* dst = dstData;
 							dstData += textureWidth;
-
-							DWORD count = this->mode.width;
-							do
-							{
-								WORD px = *src++;
-								*dst++ = ((px & 0xF800) >> 8) | ((px & 0x07E0) << 5) | ((px & 0x001F) << 19);
-							} while (--count);
 						} while (--copyHeight);
 					}
 				}
 				else
-					pixelBuffer->Copy(surface->indexBuffer);
+					pixelBuffer->Copy(drawData);
 
+				fpsCounter->latency = pacer->latency;
+				if (Hooks::idleGovernor)
+				{
+					fpsCounter->idle = Hooks::idleGovernor->idle;
+					fpsCounter->idleLatency = Hooks::idleGovernor->latency;
+				}
 				fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
 
-				DWORD count = frameCount;
-				frame = frames;
-				while (count--)
+				BOOL isDamaged = FALSE;
+				if (frameCount == 1)
+				{
+					if (glFilter)
+					{
+						GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glFilter);
+						GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glFilter);
+						fpsCounter->changes += 2;
+					}
+
+					isDamaged = pixelBuffer->Update();
+				}
+				else
 				{
-					if (frameCount == 1)
+					DWORD count = frameCount;
+					frame = frames;
+					while (count--)
 					{
 						if (glFilter)
 						{
+							GLBindTexture(GL_TEXTURE_2D, frame->id);
 							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glFilter);
 							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glFilter);
+							fpsCounter->changes += 3;
+							bound = frame->id;
+						}
+
+						// Clean tiles skip both the bind and the upload
+						if (pixelBuffer->Update(&frame->align, frame->id != bound ? frame->id : 0))
+						{
+							if (frame->id != bound)
+							{
+								bound = frame->id;
+								++fpsCounter->changes;
+							}
+
+							isDamaged = TRUE;
 						}
 
-						pixelBuffer->Update();
+						++frame;
 					}
-					else
-					{
-						GLBindTexture(GL_TEXTURE_2D, frame->id);
+				}
 
-						if (glFilter)
+				BOOL isScrolled = scrollSize && this->mapScroll->Update(frameCount == 1 ? frames->id : bound);
+
+				RECT damage = *pixelBuffer->GetDamage();
+				this->histogram->Update(frameData, this->mode.width, this->mode.height, this->pitch, this->mode.bpp == 32 ? FpsBgra : FpsRgb, &damage);
+				pixelBuffer->SwapBuffers();
+
+				if (isRedraw || isDamaged || isScrolled || config.fps == FpsBenchmark)
+				{
+					if (listScale != currScale)
+					{
+						listScale = currScale;
+						GLNewList(frameList, GL_COMPILE);
 						{
-							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glFilter);
-							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glFilter);
+							DWORD count = frameCount;
+							frame = frames;
+							while (count--)
+							{
+								if (frameCount != 1)
+									GLBindTexture(GL_TEXTURE_2D, frame->id);
+
+								GLBegin(GL_TRIANGLE_FAN);
+								{
+									FLOAT texX = frame->tSize.width * currScale;
+									FLOAT texY = frame->tSize.height * currScale;
+
+									GLTexCoord2f(0.0f, 0.0f);
+									GLVertex2s(frame->rect.x, frame->rect.y);
+
+									GLTexCoord2f(texX, 0.0f);
+									GLVertex2s(frame->vSize.width, frame->rect.y);
+
+									GLTexCoord2f(texX, texY);
+									GLVertex2s(frame->vSize.width, frame->vSize.height);
+
+									GLTexCoord2f(0.0f, texY);
+									GLVertex2s(frame->rect.x, frame->vSize.height);
+								}
+								GLEnd();
+								++frame;
+							}
 						}
+						GLEndList();
+					}
 
-						pixelBuffer->Update(&frame->align);
+					GLCallList(frameList);
+					++fpsCounter->draws;
+					if (frameCount != 1)
+					{
+						fpsCounter->changes += frameCount;
+						bound = frames[frameCount - 1].id;
 					}
 
-					GLBegin(GL_TRIANGLE_FAN);
+					ScrollQuad quad;
+					BOOL isOverlay = scrollSize && this->mapScroll->GetQuad(currScale, &quad);
+					if (isOverlay)
 					{
-						FLOAT texX = frame->tSize.width * currScale;
-						FLOAT texY = frame->tSize.height * currScale;
+						this->mapScroll->Bind(scrollFilter);
+						GLBegin(GL_TRIANGLE_FAN);
+						{
+							GLTexCoord2f(quad.texLeft, quad.texTop);
+							GLVertex2f(quad.left, quad.top);
 
-						GLTexCoord2f(0.0f, 0.0f);
-						GLVertex2s(frame->rect.x, frame->rect.y);
+							GLTexCoord2f(quad.texRight, quad.texTop);
+							GLVertex2f(quad.right, quad.top);
 
-						GLTexCoord2f(texX, 0.0f);
-						GLVertex2s(frame->vSize.width, frame->rect.y);
+							GLTexCoord2f(quad.texRight, quad.texBottom);
+							GLVertex2f(quad.right, quad.bottom);
 
-						GLTexCoord2f(texX, texY);
-						GLVertex2s(frame->vSize.width, frame->vSize.height);
+							GLTexCoord2f(quad.texLeft, quad.texBottom);
+							GLVertex2f(quad.left, quad.bottom);
+						}
+						GLEnd();
 
-						GLTexCoord2f(0.0f, texY);
-						GLVertex2s(frame->rect.x, frame->vSize.height);
+						GLBindTexture(GL_TEXTURE_2D, frames[frameCount - 1].id);
+						fpsCounter->changes += 2;
 					}
-					GLEnd();
-					++frame;
-				}
 
-				if (isSnapshot)
-					surface->TakeSnapshot();
+					if (isSnapshot)
+						surface->TakeSnapshot();
+
+					this->Present(isRedraw || isOverlay || isScrolled || currScale != 1.0f ? NULL : &damage);
+					pacer->Submit(this->frames->GetStamp());
+				}
+				else
+					++fpsCounter->elided;
 
-				pixelBuffer->SwapBuffers();
-				SwapBuffers(this->hDc);
 				if (clear > 1 && config.fps != FpsBenchmark)
 					WaitForSingleObject(this->hDrawEvent, INFINITE);
-				GLFinish();
 			} while (!this->isFinish);
 		}
 		delete pixelBuffer;
+		delete colorTable;
 		delete fpsCounter;
+		delete pacer;
+
+		if (scrollSize)
+			this->mapScroll->Release();
+
+		GLDeleteLists(frameList, 1);
 
 		frame = frames;
 		DWORD count = frameCount;
@@ -422,7 +553,7 @@ VOID OpenDraw::RenderMid()
 		{
 			GLBindBuffer(GL_ARRAY_BUFFER, bufferName);
 			{
-				FLOAT buffer[4][8] = {
+				FLOAT buffer[8][8] = {
 					{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
 					{ (FLOAT)this->mode.width, 0.0f, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
 					{ (FLOAT)this->mode.width, (FLOAT)this->mode.height, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
@@ -461,6 +592,11 @@ VOID OpenDraw::RenderMid()
 					GLVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 32, (GLvoid*)16);
 				}
 
+				if (this->mode.bpp == 32)
+					this->mapScroll->Create(maxTexSize, GL_RGBA, GL_BGRA_EXT, GL_UNSIGNED_BYTE);
+				else
+					this->mapScroll->Create(maxTexSize, GL_RGB, GL_RGB, GL_UNSIGNED_SHORT_5_6_5);
+
 				GLuint textureId;
 				GLGenTextures(1, &textureId);
 				{
@@ -487,9 +623,12 @@ VOID OpenDraw::RenderMid()
 
 					FLOAT oldScale = 1.0f;
 					DWORD clear = 0;
+					GLint scrollFilter = GL_LINEAR;
 
 					FpsCounter* fpsCounter = new FpsCounter(this->mode.bpp == 32 ? FpsBgra : FpsRgb, this->textureWidth);
-					PixelBuffer* pixelBuffer = new PixelBuffer(this->textureWidth, this->mode.height, this->mode.bpp == 32, this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB, config.updateMode);
+					FramePacer* pacer = new FramePacer(config.frameLatency);
+					UpdateMode updateMode = PixelBuffer::Tune(this->textureWidth, this->mode.height, this->mode.bpp == 32, this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB);
+					PixelBuffer* pixelBuffer = new PixelBuffer(this->textureWidth, this->mode.height, this->mode.bpp == 32, this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB, updateMode);
 					{
 						do
 						{
@@ -526,6 +665,8 @@ VOID OpenDraw::RenderMid()
 								clear = 0;
 
 							FLOAT currScale = surface->scale;
+							if (oldScale != currScale)
+								clear = 0;
 
 							if (this->CheckView())
 							{
@@ -533,7 +674,8 @@ VOID OpenDraw::RenderMid()
 								clear = 0;
 							}
 
-							if (clear++ <= 1)
+							BOOL isRedraw = clear++ <= 1;
+							if (isRedraw)
 								GLClear(GL_COLOR_BUFFER_BIT);
 
 							if (state.flags)
@@ -560,15 +702,27 @@ VOID OpenDraw::RenderMid()
 								GLBindTexture(GL_TEXTURE_2D, textureId);
 								GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
 								GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+								scrollFilter = filter;
 							}
 
 							// NEXT UNCHANGED
+							VOID* frameData = this->frames->Acquire();
+							pixelBuffer->Copy(frameData);
+							fpsCounter->latency = pacer->latency;
+							if (Hooks::idleGovernor)
+							{
+								fpsCounter->idle = Hooks::idleGovernor->idle;
+								fpsCounter->idleLatency = Hooks::idleGovernor->latency;
+							}
+							fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
+							BOOL isDamaged = pixelBuffer->Update();
+							BOOL isScrolled = this->mapScroll->Update(textureId);
+							RECT damage = *pixelBuffer->GetDamage();
+							this->histogram->Update(frameData, this->mode.width, this->mode.height, this->pitch, this->mode.bpp == 32 ? FpsBgra : FpsRgb, &damage);
+							pixelBuffer->SwapBuffers();
+
+							if (isRedraw || isDamaged || isScrolled || config.fps == FpsBenchmark)
 							{
-								pixelBuffer->Copy(surface->indexBuffer);
-								fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
-								pixelBuffer->Update();
-								pixelBuffer->SwapBuffers();
-
 								if (oldScale != currScale)
 								{
 									oldScale = currScale;
@@ -584,21 +738,38 @@ VOID OpenDraw::RenderMid()
 								}
 
 								GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-							}
 
-							if (isSnapshot)
-								surface->TakeSnapshot();
+								ScrollQuad quad;
+								BOOL isOverlay = this->mapScroll->GetQuad(currScale, &quad);
+								if (isOverlay)
+								{
+									SetScrollQuad(&buffer[4], &quad, this->mode.width, this->mode.height);
+									GLBufferSubData(GL_ARRAY_BUFFER, sizeof(buffer[0]) * 4, sizeof(buffer[0]) * 4, &buffer[4]);
+
+									this->mapScroll->Bind(scrollFilter);
+									GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
+									GLBindTexture(GL_TEXTURE_2D, textureId);
+								}
+
+								if (isSnapshot)
+									surface->TakeSnapshot();
+
+								this->Present(isRedraw || isOverlay || isScrolled || currScale != 1.0f ? NULL : &damage);
+								pacer->Submit(this->frames->GetStamp());
+							}
+							else
+								++fpsCounter->elided;
 
-							SwapBuffers(this->hDc);
 							if (clear > 1 && config.fps != FpsBenchmark)
 								WaitForSingleObject(this->hDrawEvent, INFINITE);
-							GLFinish();
 						} while (!this->isFinish);
 					}
 					delete pixelBuffer;
 					delete fpsCounter;
+					delete pacer;
 				}
 				GLDeleteTextures(1, &textureId);
+				this->mapScroll->Release();
 			}
 			GLBindBuffer(GL_ARRAY_BUFFER, NULL);
 		}
@@ -628,11 +799,14 @@ VOID OpenDraw::RenderNew()
 		ShaderGroup* hermite;
 		ShaderGroup* cubic;
 		ShaderGroup* lanczos;
+		ShaderGroup* cubic_h;
+		ShaderGroup* lanczos_h;
 		ShaderGroup* xBRz_2x;
 		ShaderGroup* xBRz_3x;
 		ShaderGroup* xBRz_4x;
 		ShaderGroup* xBRz_5x;
 		ShaderGroup* xBRz_6x;
+		ShaderGroup* xBRz_edge;
 		ShaderGroup* scaleHQ_2x;
 		ShaderGroup* scaleHQ_4x;
 		ShaderGroup* xSal_2x;
@@ -642,13 +816,16 @@ VOID OpenDraw::RenderNew()
 	} shaders = {
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LINEAR_FRAGMENT, SHADER_LEVELS),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_HERMITE_FRAGMENT, SHADER_TEXSIZE | SHADER_LEVELS),
-		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_CUBIC_FRAGMENT, SHADER_TEXSIZE | SHADER_LEVELS),
-		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LANCZOS_FRAGMENT, SHADER_TEXSIZE | SHADER_LEVELS),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_CUBIC_FRAGMENT_VERTICAL, SHADER_TEXSIZE | SHADER_LEVELS),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LANCZOS_FRAGMENT_VERTICAL, SHADER_TEXSIZE | SHADER_LEVELS),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_CUBIC_FRAGMENT_HORIZONTAL, SHADER_TEXSIZE),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LANCZOS_FRAGMENT_HORIZONTAL, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_2X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_3X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_4X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_5X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_6X, SHADER_TEXSIZE),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_EDGE, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_SCALEHQ_FRAGMENT_2X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_SCALEHQ_FRAGMENT_4X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XSAL_FRAGMENT, SHADER_TEXSIZE),
@@ -659,6 +836,7 @@ VOID OpenDraw::RenderNew()
 
 	ShaderGroup* program = NULL;
 	ShaderGroup* upscaleProgram = NULL;
+	ShaderGroup* passProgram = NULL;
 	{
 		GLuint arrayName;
 		GLGenVertexArrays(1, &arrayName);
@@ -670,7 +848,7 @@ VOID OpenDraw::RenderNew()
 				{
 					GLBindBuffer(GL_ARRAY_BUFFER, bufferName);
 					{
-						FLOAT buffer[8][8] = {
+						FLOAT buffer[24][8] = {
 							{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
 							{ (FLOAT)this->mode.width, 0.0f, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
 							{ (FLOAT)this->mode.width, (FLOAT)this->mode.height, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
@@ -679,7 +857,22 @@ VOID OpenDraw::RenderNew()
 							{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f },
 							{ (FLOAT)this->mode.width, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
 							{ (FLOAT)this->mode.width, (FLOAT)this->mode.height, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f },
-							{ 0.0f, (FLOAT)this->mode.height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f }
+							{ 0.0f, (FLOAT)this->mode.height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+
+							{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, texHeight, 0.0f, 0.0f },
+							{ (FLOAT)this->mode.width, 0.0f, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
+							{ (FLOAT)this->mode.width, (FLOAT)this->mode.height, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
+							{ 0.0f, (FLOAT)this->mode.height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+
+							{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, texHeight, 0.0f, 0.0f },
+							{ (FLOAT)this->mode.width, 0.0f, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
+							{ (FLOAT)this->mode.width, (FLOAT)this->mode.height, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
+							{ 0.0f, (FLOAT)this->mode.height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+
+							{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+							{ (FLOAT)this->mode.width, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+							{ (FLOAT)this->mode.width, (FLOAT)this->mode.height, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
+							{ 0.0f, (FLOAT)this->mode.height, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f }
 						};
 
 						{
@@ -690,7 +883,7 @@ VOID OpenDraw::RenderNew()
 								{ -1.0f, 1.0f, -1.0f, 1.0f }
 							};
 
-							for (DWORD i = 0; i < 8; ++i)
+							for (DWORD i = 0; i < 20; ++i)
 							{
 								FLOAT* vector = &buffer[i][0];
 								for (DWORD j = 0; j < 4; ++j)
@@ -718,8 +911,14 @@ VOID OpenDraw::RenderNew()
 							GLuint primary;
 							GLuint secondary;
 							GLuint buffer;
+							GLuint edge;
 						} texId;
 
+						if (this->mode.bpp == 32)
+							this->mapScroll->Create(maxTexSize, GL_RGBA, GL_BGRA_EXT, GL_UNSIGNED_BYTE);
+						else
+							this->mapScroll->Create(maxTexSize, GL_RGB, GL_RGB, GL_UNSIGNED_SHORT_5_6_5);
+
 						GLGenTextures(1, &texId.primary);
 						{
 							GLActiveTexture(GL_TEXTURE0);
@@ -744,11 +943,16 @@ VOID OpenDraw::RenderNew()
 
 							FLOAT oldScale = 1.0f;
 							DWORD clear = 0;
+							GLint scrollFilter = GL_LINEAR;
 
 							FpsCounter* fpsCounter = new FpsCounter(this->mode.bpp == 32 ? FpsBgra : FpsRgb, this->textureWidth);
-							PixelBuffer* firstBuffer = new PixelBuffer(this->textureWidth, this->mode.height, this->mode.bpp == 32, this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB, config.updateMode);
+							FramePacer* pacer = new FramePacer(config.frameLatency);
+							Resampler* resampler = NULL;
+							UpdateMode updateMode = PixelBuffer::Tune(this->textureWidth, this->mode.height, this->mode.bpp == 32, this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB);
+							PixelBuffer* firstBuffer = new PixelBuffer(this->textureWidth, this->mode.height, this->mode.bpp == 32, this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB, updateMode);
 							{
 								GLuint fboId = 0;
+								GLuint edgeId = 0;
 								DWORD viewSize;
 								BOOL activeIndex;
 								VOID* emptyBuffer;
@@ -788,8 +992,19 @@ VOID OpenDraw::RenderNew()
 									if (state.flags || isFps || isSnapshot)
 										clear = 0;
 
+									// Only the separable kernels render through the resampler, release its targets once another filter is chosen
+									if (state.flags && resampler && state.interpolation != InterpolateCubic && state.interpolation != InterpolateLanczos)
+									{
+										delete resampler;
+										resampler = NULL;
+									}
+
 									FLOAT currScale = surface->scale;
+									if (oldScale != currScale)
+										clear = 0;
+
 									PixelBuffer* pixelBuffer;
+									BOOL isRedraw = TRUE;
 
 									if (state.upscaling)
 									{
@@ -859,7 +1074,7 @@ VOID OpenDraw::RenderNew()
 												viewSize = MAKELONG(this->mode.width * state.value, this->mode.height * state.value);
 												activeIndex = TRUE;
 												firstBuffer->Reset();
-												secondBuffer = new PixelBuffer(this->textureWidth, this->mode.height, this->mode.bpp == 32, this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB, config.updateMode);
+												secondBuffer = new PixelBuffer(this->textureWidth, this->mode.height, this->mode.bpp == 32, this->mode.bpp == 32 ? GL_BGRA_EXT : GL_RGB, updateMode);
 
 												DWORD size = this->pitch * this->mode.height;
 												emptyBuffer = AlignedAlloc(size);
@@ -933,6 +1148,42 @@ VOID OpenDraw::RenderNew()
 													GLTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, LOWORD(viewSize), HIWORD(viewSize), GL_NONE, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 												}
 											}
+
+											// Edge classification targets exist only while xBRZ reads them
+											if (state.upscaling == UpscaleXRBZ)
+											{
+												if (!edgeId)
+												{
+													GLGenTextures(1, &texId.edge);
+													GLBindTexture(GL_TEXTURE_2D, texId.edge);
+													{
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+														GLTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->mode.width, this->mode.height, GL_NONE, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+													}
+
+													// Edge classes stay bound on unit 2 for the xBRZ scaling pass
+													GLActiveTexture(GL_TEXTURE2);
+													GLBindTexture(GL_TEXTURE_2D, texId.edge);
+													GLActiveTexture(GL_TEXTURE0);
+
+													GLGenFramebuffers(1, &edgeId);
+													GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, edgeId);
+													GLFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texId.edge, 0);
+
+													GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
+												}
+											}
+											else if (edgeId)
+											{
+												GLDeleteTextures(1, &texId.edge);
+												GLDeleteFramebuffers(1, &edgeId);
+												edgeId = 0;
+											}
 										}
 										else
 											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
@@ -966,7 +1217,8 @@ VOID OpenDraw::RenderNew()
 											clear = 0;
 										}
 
-										if (clear++ <= 1)
+										isRedraw = clear++ <= 1;
+										if (isRedraw)
 											GLClear(GL_COLOR_BUFFER_BIT);
 
 										if (state.flags)
@@ -976,6 +1228,13 @@ VOID OpenDraw::RenderNew()
 												GLBindTexture(GL_TEXTURE_2D, texId.primary);
 												GLDeleteTextures(2, &texId.secondary);
 												GLDeleteFramebuffers(1, &fboId);
+												if (edgeId)
+												{
+													GLDeleteTextures(1, &texId.edge);
+													GLDeleteFramebuffers(1, &edgeId);
+													edgeId = 0;
+												}
+
 												AlignedFree(emptyBuffer);
 
 												firstBuffer->Reset();
@@ -988,15 +1247,19 @@ VOID OpenDraw::RenderNew()
 											{
 											case InterpolateHermite:
 												program = shaders.hermite;
+												passProgram = NULL;
 												break;
 											case InterpolateCubic:
 												program = shaders.cubic;
+												passProgram = shaders.cubic_h;
 												break;
 											case InterpolateLanczos:
 												program = shaders.lanczos;
+												passProgram = shaders.lanczos_h;
 												break;
 											default:
 												program = shaders.linear;
+												passProgram = NULL;
 												break;
 											}
 
@@ -1005,18 +1268,33 @@ VOID OpenDraw::RenderNew()
 											DWORD filter = state.interpolation == InterpolateLinear || state.interpolation == InterpolateHermite ? GL_LINEAR : GL_NEAREST;
 											GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
 											GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+											scrollFilter = filter;
 										}
 
 										pixelBuffer = firstBuffer;
 									}
 
+									// The scroll overlay is drawn in the single pass paths only, upscalers and separable kernels let the game redraw
+									this->mapScroll->Enable(!state.upscaling && !passProgram);
+
 									// NEXT UNCHANGED
+									VOID* frameData = this->frames->Acquire();
+									pixelBuffer->Copy(frameData);
+									fpsCounter->latency = pacer->latency;
+									if (Hooks::idleGovernor)
+									{
+										fpsCounter->idle = Hooks::idleGovernor->idle;
+										fpsCounter->idleLatency = Hooks::idleGovernor->latency;
+									}
+									fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
+									BOOL isDamaged = pixelBuffer->Update();
+									BOOL isScrolled = this->mapScroll->Update(texId.primary);
+									RECT damage = *pixelBuffer->GetDamage();
+									this->histogram->Update(frameData, this->mode.width, this->mode.height, this->pitch, this->mode.bpp == 32 ? FpsBgra : FpsRgb, &damage);
+									pixelBuffer->SwapBuffers();
+
+									if (isRedraw || isDamaged || isScrolled || config.fps == FpsBenchmark)
 									{
-										pixelBuffer->Copy(surface->indexBuffer);
-										fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
-										pixelBuffer->Update();
-										pixelBuffer->SwapBuffers();
-
 										if (oldScale != currScale)
 										{
 											oldScale = currScale;
@@ -1028,107 +1306,163 @@ VOID OpenDraw::RenderNew()
 
 											buffer[3][5] = texHeight * currScale;
 
-											GLBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(buffer) >> 1, buffer);
+											buffer[13][4] = texWidth * currScale;
+											buffer[14][4] = texWidth * currScale;
+
+											buffer[18][5] = currScale;
+											buffer[19][5] = currScale;
+
+											GLBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(buffer), buffer);
 										}
 
-										GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-									}
+										if (state.upscaling == UpscaleXRBZ)
+										{
+											// Classify edges once per source pixel, the scaling pass only blends
+											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, edgeId);
+											GLViewport(0, 0, this->mode.width, this->mode.height);
+											shaders.xBRz_edge->Use(texSize);
+											GLDrawArrays(GL_TRIANGLE_FAN, 8, 4);
 
-									// Draw from FBO
-									if (state.upscaling)
-									{
-										GLFinish();
-										GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, NULL);
+											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
+											GLViewport(0, 0, LOWORD(viewSize), HIWORD(viewSize));
+											upscaleProgram->Use(texSize);
+										}
 
-										GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
+										if (!state.upscaling && passProgram)
+										{
+											// Separable kernel: source rows at output width, then columns
+											if (!resampler)
+												resampler = new Resampler();
+											resampler->Begin(state.interpolation, this->viewport.rectangle.width, this->mode.height);
+											passProgram->Use(texSize);
+											GLDrawArrays(GL_TRIANGLE_FAN, 12, 4);
+
+											DWORD passSize = resampler->End();
+											GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
+											program->Use(passSize);
+											GLDrawArrays(GL_TRIANGLE_FAN, 16, 4);
 
-										if (clear++ <= 1)
-											GLClear(GL_COLOR_BUFFER_BIT);
+											GLBindTexture(GL_TEXTURE_2D, texId.primary);
+										}
+										else
+											GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 
-										switch (state.interpolation)
+										ScrollQuad quad;
+										BOOL isOverlay = this->mapScroll->GetQuad(currScale, &quad);
+										if (isOverlay)
 										{
-										case InterpolateHermite:
-											program = shaders.hermite;
-											break;
-										case InterpolateCubic:
-											program = shaders.cubic;
-											break;
-										case InterpolateLanczos:
-											program = shaders.lanczos;
-											break;
-										default:
-											program = shaders.linear;
-											break;
+											SetScrollQuad(&buffer[20], &quad, this->mode.width, this->mode.height);
+											GLBufferSubData(GL_ARRAY_BUFFER, sizeof(buffer[0]) * 20, sizeof(buffer[0]) * 4, &buffer[20]);
+
+											this->mapScroll->Bind(scrollFilter);
+											GLDrawArrays(GL_TRIANGLE_FAN, 20, 4);
+											GLBindTexture(GL_TEXTURE_2D, texId.primary);
 										}
 
-										program->Use(viewSize);
+										// Draw from FBO
+										if (state.upscaling)
+										{
+											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, NULL);
+
+											GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
 
-										GLBindTexture(GL_TEXTURE_2D, texId.buffer);
+											if (clear++ <= 1)
+												GLClear(GL_COLOR_BUFFER_BIT);
 
-										DWORD filter = state.interpolation == InterpolateLinear || state.interpolation == InterpolateHermite ? GL_LINEAR : GL_NEAREST;
-										GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-										GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+											switch (state.interpolation)
+											{
+											case InterpolateHermite:
+												program = shaders.hermite;
+												passProgram = NULL;
+												break;
+											case InterpolateCubic:
+												program = shaders.cubic;
+												passProgram = shaders.cubic_h;
+												break;
+											case InterpolateLanczos:
+												program = shaders.lanczos;
+												passProgram = shaders.lanczos_h;
+												break;
+											default:
+												program = shaders.linear;
+												passProgram = NULL;
+												break;
+											}
 
-										GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
+											GLBindTexture(GL_TEXTURE_2D, texId.buffer);
 
-										if (isSnapshot && OpenClipboard(NULL))
-										{
-											EmptyClipboard();
+											DWORD filter = state.interpolation == InterpolateLinear || state.interpolation == InterpolateHermite ? GL_LINEAR : GL_NEAREST;
+											GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+											GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
 
-											DWORD size = LOWORD(viewSize) * HIWORD(viewSize) * 3;
-											DWORD slice = sizeof(BITMAPINFOHEADER);
-											HGLOBAL hMemory = GlobalAlloc(GMEM_MOVEABLE, slice + size);
-											if (hMemory)
+											if (passProgram)
 											{
-												VOID* data = GlobalLock(hMemory);
-												if (data)
-												{
-													BITMAPINFOHEADER* bmi = (BITMAPINFOHEADER*)data;
-													bmi->biSize = sizeof(BITMAPINFOHEADER);
-													bmi->biWidth = LOWORD(viewSize);
-													bmi->biHeight = HIWORD(viewSize);
-													bmi->biPlanes = 1;
-													bmi->biBitCount = 24;
-													bmi->biCompression = BI_RGB;
-													bmi->biSizeImage = size;
-													bmi->biXPelsPerMeter = 1;
-													bmi->biYPelsPerMeter = 1;
-													bmi->biClrUsed = 0;
-													bmi->biClrImportant = 0;
-
-													GLGetTexImage(GL_TEXTURE_2D, 0, GL_BGR_EXT, GL_UNSIGNED_BYTE, (BYTE*)data + slice);
-
-													GlobalUnlock(hMemory);
-													SetClipboardData(CF_DIB, hMemory);
-												}
+												if (!resampler)
+													resampler = new Resampler();
+												resampler->Begin(state.interpolation, this->viewport.rectangle.width, HIWORD(viewSize));
+												passProgram->Use(viewSize);
+												GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
+
+												DWORD passSize = resampler->End();
+												GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
+												program->Use(passSize);
+												GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
 
-												GlobalFree(hMemory);
+												GLBindTexture(GL_TEXTURE_2D, texId.buffer);
+											}
+											else
+											{
+												program->Use(viewSize);
+												GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
 											}
 
-											CloseClipboard();
+											if (isSnapshot)
+											{
+												SnapshotFrame* frame = Snapshot::Acquire(LOWORD(viewSize), HIWORD(viewSize));
+												if (frame)
+												{
+													frame->isFlipped = TRUE;
+													GLGetTexImage(GL_TEXTURE_2D, 0, GL_BGRA_EXT, GL_UNSIGNED_BYTE, frame->data);
+													Snapshot::Commit(frame);
+												}
+											}
 										}
+										else if (isSnapshot)
+											surface->TakeSnapshot();
+
+										this->Present(isRedraw || isOverlay || isScrolled || currScale != 1.0f ? NULL : &damage);
+										pacer->Submit(this->frames->GetStamp());
 									}
-									else if (isSnapshot)
-										surface->TakeSnapshot();
+									else
+										++fpsCounter->elided;
 
-									SwapBuffers(this->hDc);
 									if (clear > 1 && config.fps != FpsBenchmark)
 										WaitForSingleObject(this->hDrawEvent, INFINITE);
-									GLFinish();
 								} while (!this->isFinish);
 
 								if (fboId)
 								{
 									GLDeleteTextures(2, &texId.secondary);
 									GLDeleteFramebuffers(1, &fboId);
+									if (edgeId)
+									{
+										GLDeleteTextures(1, &texId.edge);
+										GLDeleteFramebuffers(1, &edgeId);
+										edgeId = 0;
+									}
+
 									AlignedFree(emptyBuffer);
 									delete secondBuffer;
 								}
 							}
 							delete firstBuffer;
 							delete fpsCounter;
+							delete pacer;
+							if (resampler)
+								delete resampler;
 						}
 						GLDeleteTextures(1, &texId.primary);
+						this->mapScroll->Release();
 					}
 					GLBindBuffer(GL_ARRAY_BUFFER, NULL);
 				}
@@ -1241,6 +1575,13 @@ VOID OpenDraw::RenderStart()
 	this->viewport.refresh = TRUE;
 	this->isFpsChanged = TRUE;
 
+	this->ResetFrames();
+	if (!this->frames)
+	{
+		this->RenderStop();
+		return;
+	}
+
 	DWORD threadId;
 	SECURITY_ATTRIBUTES sAttribs = { sizeof(SECURITY_ATTRIBUTES), NULL, FALSE };
 	this->hDrawThread = CreateThread(&sAttribs, NULL, RenderThread, this, NORMAL_PRIORITY_CLASS, &threadId);
@@ -1253,9 +1594,15 @@ VOID OpenDraw::RenderStop()
 
 	this->isFinish = TRUE;
 	SetEvent(this->hDrawEvent);
-	WaitForSingleObject(this->hDrawThread, INFINITE);
-	CloseHandle(this->hDrawThread);
-	this->hDrawThread = NULL;
+	if (this->hDrawThread)
+	{
+		WaitForSingleObject(this->hDrawThread, INFINITE);
+		CloseHandle(this->hDrawThread);
+		this->hDrawThread = NULL;
+	}
+
+	delete this->frames;
+	this->frames = NULL;
 
 	if (this->hDraw != this->hWnd)
 	{
@@ -1271,6 +1618,58 @@ VOID OpenDraw::RenderStop()
 	Window::CheckMenu(this->hWnd);
 }
 
+VOID OpenDraw::ResetFrames()
+{
+	delete this->frames;
+	this->frames = FrameQueue::Create(this->mode.width, this->mode.height, this->pitch, this->mode.bpp >> 3);
+
+	OpenDrawSurface* surface = this->attachedSurface;
+	if (this->frames && surface && surface->indexBuffer)
+		this->frames->Publish(surface->indexBuffer);
+}
+
+VOID OpenDraw::Publish(const VOID* buffer, const RECT* rect)
+{
+	if (this->frames)
+	{
+		// Blits under the map scroll overlay are not shown, they go out with the redraw that ends the scroll
+		RECT rc;
+		if (this->isScrolling && (!rect || IntersectRect(&rc, rect, &this->scrollRect)))
+			this->frames->Invalidate(rect);
+		else
+		{
+			this->frames->Publish(buffer, rect);
+			SetEvent(this->hDrawEvent);
+		}
+	}
+}
+
+// Damage tracking skips unchanged frames, anything the window system painted over needs a full frame again
+VOID OpenDraw::Redraw()
+{
+	this->viewport.refresh = TRUE;
+	SetEvent(this->hDrawEvent);
+}
+
+VOID OpenDraw::Present(const RECT* damage)
+{
+	if (damage && GLAddSwapHintRect)
+	{
+		FLOAT fx = this->viewport.clipFactor.x;
+		FLOAT fy = this->viewport.clipFactor.y;
+		INT top = this->viewport.rectangle.y + this->viewport.rectangle.height;
+
+		INT left = this->viewport.rectangle.x + (INT)MathFloor((damage->left - PRESENT_BORDER) * fx);
+		INT right = this->viewport.rectangle.x + (INT)MathCeil((damage->right + PRESENT_BORDER) * fx);
+		INT bottom = top - (INT)MathCeil((damage->bottom + PRESENT_BORDER) * fy);
+		top -= (INT)MathFloor((damage->top - PRESENT_BORDER) * fy);
+
+		GLAddSwapHintRect(left, bottom, right - left, top - bottom);
+	}
+
+	SwapBuffers(this->hDc);
+}
+
 BOOL OpenDraw::CheckView()
 {
 	if (this->viewport.refresh)
@@ -1369,7 +1768,12 @@ OpenDraw::OpenDraw(IDraw** last)
 	this->textureWidth = this->pitch / (this->mode.bpp >> 3);
 
 	this->isTakeSnapshot = FALSE;
+	this->isScrolling = FALSE;
+	SetRectEmpty(&this->scrollRect);
 	this->isFinish = TRUE;
+	this->frames = NULL;
+	this->histogram = new Histogram();
+	this->mapScroll = new MapScroll();
 
 	this->hDrawEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
 }
@@ -1377,6 +1781,11 @@ OpenDraw::OpenDraw(IDraw** last)
 OpenDraw::~OpenDraw()
 {
 	this->RenderStop();
+	delete this->histogram;
+	delete this->mapScroll;
+	Snapshot::Stop();
+	Recorder::Release();
+	Ini::Stop();
 	CloseHandle(this->hDrawEvent);
 	ClipCursor(NULL);
 }
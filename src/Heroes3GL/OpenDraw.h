@@ -26,6 +26,11 @@
 #include "IDraw.h"
 #include "ExtraTypes.h"
 #include "OpenDrawSurface.h"
+#include "FrameQueue.h"
+#include "Histogram.h"
+#include "MapScroll.h"
+
+#define PRESENT_BORDER 4
 
 class OpenDraw : public IDraw
 {
@@ -52,6 +57,12 @@ public:
 	FilterState filterState;
 	BOOL isTakeSnapshot;
 	BOOL isFpsChanged;
+	BOOL isScrolling;
+	RECT scrollRect;
+
+	FrameQueue* frames;
+	Histogram* histogram;
+	MapScroll* mapScroll;
 
 	OpenDraw(IDraw**);
 	~OpenDraw();
@@ -61,6 +72,10 @@ public:
 
 	VOID RenderStart();
 	VOID RenderStop();
+	VOID Present(const RECT*);
+	VOID Redraw();
+	VOID ResetFrames();
+	VOID Publish(const VOID*, const RECT* = NULL);
 
 	VOID RenderOld();
 	VOID RenderMid();
@@ -28,6 +28,9 @@
 #include "OpenDrawSurface.h"
 #include "OpenDraw.h"
 #include "Config.h"
+#include "Snapshot.h"
+#include "Convert.h"
+#include "Blit.h"
 
 OpenDrawSurface::OpenDrawSurface(IDraw* lpDD, DWORD index)
 {
@@ -93,92 +96,19 @@ VOID OpenDrawSurface::ReleaseBuffer()
 
 VOID OpenDrawSurface::TakeSnapshot()
 {
-	if (OpenClipboard(NULL))
-	{
-		EmptyClipboard();
-
-		DWORD texWidth = DWORD(this->scale * this->mode.width);
-		DWORD texHeight = DWORD(this->scale * this->mode.height);
+	DWORD texWidth = DWORD(this->scale * this->mode.width);
+	DWORD texHeight = DWORD(this->scale * this->mode.height);
 
-		DWORD pitch = texWidth * (this->mode.bpp == 16 ? 2 : 3);
-		if (pitch & 3)
-			pitch = (pitch & 0xFFFFFFFC) + 4;
+	SnapshotFrame* frame = Snapshot::Acquire(texWidth, texHeight);
+	if (!frame)
+		return;
 
-		DWORD size = pitch * texHeight;
-		DWORD slice = sizeof(BITMAPINFOHEADER) + (this->mode.bpp == 16 ? 12 : 0);
-		HGLOBAL hMemory = GlobalAlloc(GMEM_MOVEABLE, slice + size);
-		if (hMemory)
-		{
-			VOID* data = GlobalLock(hMemory);
-			if (data)
-			{
-				BITMAPV5HEADER* bmi = (BITMAPV5HEADER*)data;
-				bmi->bV5Size = sizeof(BITMAPINFOHEADER);
-				bmi->bV5Width = texWidth;
-				bmi->bV5Height = texHeight;
-				bmi->bV5Planes = 1;
-				bmi->bV5SizeImage = size;
-				bmi->bV5XPelsPerMeter = 1;
-				bmi->bV5YPelsPerMeter = 1;
-				bmi->bV5ClrUsed = 0;
-				bmi->bV5ClrImportant = 0;
-
-				BYTE* dstData = (BYTE*)data + slice + size - pitch;
-				if (this->mode.bpp == 16)
-				{
-					bmi->bV5BitCount = 16;
-					bmi->bV5Compression = BI_BITFIELDS;
-					bmi->bV5RedMask = 0xF800;
-					bmi->bV5GreenMask = 0x07E0;
-					bmi->bV5BlueMask = 0x001F;
-
-					WORD* src = (WORD*)this->indexBuffer;
-					DWORD height = texHeight;
-					do
-					{
-						WORD* dst = (WORD*)dstData;
-						DWORD width = texWidth;
-						do
-							*dst++ = *src++;
-						while (--width);
-
-						dstData -= pitch;
-					} while (--height);
-				}
-				else
-				{
-					bmi->bV5BitCount = 24;
-					bmi->bV5Compression = BI_RGB;
-
-					BYTE* src = (BYTE*)this->indexBuffer;
-					DWORD height = texHeight;
-					do
-					{
-						BYTE* dst = dstData;
-						DWORD width = texWidth;
-						do
-						{
-							DWORD count = 3;
-							do
-								*dst++ = *src++;
-							while (--count);
-
-							++src;
-						} while (--width);
-
-						dstData -= pitch;
-					} while (--height);
-				}
-
-				GlobalUnlock(hMemory);
-				SetClipboardData(CF_DIB, hMemory);
-			}
-
-			GlobalFree(hMemory);
-		}
+	if (this->mode.bpp == 16)
+		Rgb565ToBgra((const uint16_t*)this->indexBuffer, (uint32_t*)frame->data, texWidth * texHeight);
+	else
+		MemoryCopy(frame->data, this->indexBuffer, texWidth * texHeight * sizeof(DWORD));
 
-		CloseClipboard();
-	}
+	Snapshot::Commit(frame);
 }
 
 ULONG __stdcall OpenDrawSurface::AddRef()
@@ -219,6 +149,14 @@ HRESULT __stdcall OpenDrawSurface::Lock(LPRECT lpDestRect, LPDDSURFACEDESC lpDDS
 	return DD_OK;
 }
 
+HRESULT __stdcall OpenDrawSurface::Unlock(LPVOID lpRect)
+{
+	if (((OpenDraw*)this->ddraw)->attachedSurface == this)
+		((OpenDraw*)this->ddraw)->Publish(this->indexBuffer);
+
+	return DD_OK;
+}
+
 HRESULT __stdcall OpenDrawSurface::SetClipper(LPDIRECTDRAWCLIPPER lpDDClipper)
 {
 	OpenDrawClipper* old = this->attachedClipper;
@@ -286,6 +224,9 @@ HRESULT __stdcall OpenDrawSurface::Blt(LPRECT lpDestRect, LPDIRECTDRAWSURFACE lp
 				*dest++ = color;
 			while (--count);
 		}
+
+		if (((OpenDraw*)this->ddraw)->attachedSurface == this)
+			((OpenDraw*)this->ddraw)->Publish(this->indexBuffer);
 	}
 	else
 	{
@@ -328,6 +269,7 @@ HRESULT __stdcall OpenDrawSurface::Blt(LPRECT lpDestRect, LPDIRECTDRAWSURFACE lp
 
 		LONG width = rcSrc.right - rcSrc.left;
 		LONG height = rcSrc.bottom - rcSrc.top;
+		RECT rcUpdate = { rcDst.left, rcDst.top, rcDst.left + width, rcDst.top + height };
 
 		if (this->mode.bpp == 32)
 		{
@@ -339,127 +281,10 @@ HRESULT __stdcall OpenDrawSurface::Blt(LPRECT lpDestRect, LPDIRECTDRAWSURFACE lp
 
 			if (surface->colorKey)
 			{
-				DWORD key = surface->colorKey;
-
 				if (config.isSSE2)
-				{
-					DWORD count = width >> 2;
-					if (count)
-					{
-						DWORD sStep = (sPitch >> 2) - count;
-						DWORD dStep = (dPitch >> 2) - count;
-
-						__m128i* s = (__m128i*)src;
-						__m128i* d = (__m128i*)dst;
-						__m128i k = _mm_set1_epi32(key);
-						DWORD h = height;
-						if ((DWORD)s & 0xF)
-						{
-							if ((DWORD)d & 0xF)
-								do
-								{
-									DWORD w = count;
-									do
-									{
-										__m128i a = _mm_loadu_si128(s);
-										__m128i mask = _mm_cmpeq_epi32(a, k);
-										if (_mm_movemask_epi8(mask) != 0xFFFF)
-											_mm_storeu_si128(d, _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, _mm_loadu_si128(d))));
-
-										++s;
-										++d;
-									} while (--w);
-
-									s += sStep;
-									d += dStep;
-								} while (--h);
-							else
-								do
-								{
-									DWORD w = count;
-									do
-									{
-										__m128i a = _mm_loadu_si128(s);
-										__m128i mask = _mm_cmpeq_epi32(a, k);
-										if (_mm_movemask_epi8(mask) != 0xFFFF)
-											_mm_store_si128(d, _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, _mm_load_si128(d))));
-
-										++s;
-										++d;
-									} while (--w);
-
-									s += sStep;
-									d += dStep;
-								} while (--h);
-						}
-						else
-						{
-							if ((DWORD)d & 0xF)
-								do
-								{
-									DWORD w = count;
-									do
-									{
-										__m128i a = _mm_load_si128(s);
-										__m128i mask = _mm_cmpeq_epi32(a, k);
-										if (_mm_movemask_epi8(mask) != 0xFFFF)
-											_mm_storeu_si128(d, _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, _mm_loadu_si128(d))));
-
-										++s;
-										++d;
-									} while (--w);
-
-									s += sStep;
-									d += dStep;
-								} while (--h);
-							else
-								do
-								{
-									DWORD w = count;
-									do
-									{
-										__m128i a = _mm_load_si128(s);
-										__m128i mask = _mm_cmpeq_epi32(a, k);
-										if (_mm_movemask_epi8(mask) != 0xFFFF)
-											_mm_store_si128(d, _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, _mm_load_si128(d))));
-
-										++s;
-										++d;
-									} while (--w);
-
-									s += sStep;
-									d += dStep;
-								} while (--h);
-						}
-
-						count <<= 2;
-						width -= count;
-						if (!width)
-							goto lbl_end;
-
-						src += count;
-						dst += count;
-					}
-				}
-
-				sPitch -= width;
-				dPitch -= width;
-
-				do
-				{
-					DWORD count = width;
-					do
-					{
-						if (*src != key)
-							*dst = *src;
-
-						++src;
-						++dst;
-					} while (--count);
-
-					src += sPitch;
-					dst += dPitch;
-				} while (--height);
+					SSE::KeyBlit((const uint32_t*)src, sPitch, (uint32_t*)dst, dPitch, width, height, surface->colorKey);
+				else
+					CPP::KeyBlit((const uint32_t*)src, sPitch, (uint32_t*)dst, dPitch, width, height, surface->colorKey);
 			}
 			else
 			{
@@ -482,126 +307,10 @@ HRESULT __stdcall OpenDrawSurface::Blt(LPRECT lpDestRect, LPDIRECTDRAWSURFACE lp
 
 			if (LOWORD(surface->colorKey))
 			{
-				WORD key = LOWORD(surface->colorKey);
 				if (config.isSSE2)
-				{
-					DWORD count = width >> 3;
-					if (count)
-					{
-						DWORD sStep = (sPitch >> 3) - count;
-						DWORD dStep = (dPitch >> 3) - count;
-
-						__m128i* s = (__m128i*)src;
-						__m128i* d = (__m128i*)dst;
-						__m128i k = _mm_set1_epi16(key);
-						DWORD h = height;
-						if ((DWORD)s & 0xF)
-						{
-							if ((DWORD)d & 0xF)
-								do
-								{
-									DWORD w = count;
-									do
-									{
-										__m128i a = _mm_loadu_si128(s);
-										__m128i mask = _mm_cmpeq_epi16(a, k);
-										if (_mm_movemask_epi8(mask) != 0xFFFF)
-											_mm_storeu_si128(d, _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, _mm_loadu_si128(d))));
-
-										++s;
-										++d;
-									} while (--w);
-
-									s += sStep;
-									d += dStep;
-								} while (--h);
-							else
-								do
-								{
-									DWORD w = count;
-									do
-									{
-										__m128i a = _mm_loadu_si128(s);
-										__m128i mask = _mm_cmpeq_epi16(a, k);
-										if (_mm_movemask_epi8(mask) != 0xFFFF)
-											_mm_store_si128(d, _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, _mm_load_si128(d))));
-
-										++s;
-										++d;
-									} while (--w);
-
-									s += sStep;
-									d += dStep;
-								} while (--h);
-						}
-						else
-						{
-							if ((DWORD)d & 0xF)
-								do
-								{
-									DWORD w = count;
-									do
-									{
-										__m128i a = _mm_load_si128(s);
-										__m128i mask = _mm_cmpeq_epi16(a, k);
-										if (_mm_movemask_epi8(mask) != 0xFFFF)
-											_mm_storeu_si128(d, _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, _mm_loadu_si128(d))));
-
-										++s;
-										++d;
-									} while (--w);
-
-									s += sStep;
-									d += dStep;
-								} while (--h);
-							else
-								do
-								{
-									DWORD w = count;
-									do
-									{
-										__m128i a = _mm_load_si128(s);
-										__m128i mask = _mm_cmpeq_epi16(a, k);
-										if (_mm_movemask_epi8(mask) != 0xFFFF)
-											_mm_store_si128(d, _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, _mm_load_si128(d))));
-
-										++s;
-										++d;
-									} while (--w);
-
-									s += sStep;
-									d += dStep;
-								} while (--h);
-						}
-
-						count <<= 3;
-						width -= count;
-						if (!width)
-							goto lbl_end;
-
-						src += count;
-						dst += count;
-					}
-				}
-
-				sPitch -= width;
-				dPitch -= width;
-
-				do
-				{
-					DWORD w = width;
-					do
-					{
-						if (*src != key)
-							*dst = *src;
-
-						++src;
-						++dst;
-					} while (--w);
-
-					src += sPitch;
-					dst += dPitch;
-				} while (--height);
+					SSE::KeyBlit((const uint16_t*)src, sPitch, (uint16_t*)dst, dPitch, width, height, LOWORD(surface->colorKey));
+				else
+					CPP::KeyBlit((const uint16_t*)src, sPitch, (uint16_t*)dst, dPitch, width, height, LOWORD(surface->colorKey));
 			}
 			else
 			{
@@ -615,15 +324,11 @@ HRESULT __stdcall OpenDrawSurface::Blt(LPRECT lpDestRect, LPDIRECTDRAWSURFACE lp
 			}
 		}
 
-	lbl_end:
 		if (this->scale != currScale)
 			this->scale = currScale;
 
 		if (((OpenDraw*)this->ddraw)->attachedSurface == this)
-		{
-			SetEvent(((OpenDraw*)this->ddraw)->hDrawEvent);
-			Sleep(0);
-		}
+			((OpenDraw*)this->ddraw)->Publish(this->indexBuffer, &rcUpdate);
 	}
 
 	return DD_OK;
@@ -58,6 +58,7 @@ public:
 	HRESULT __stdcall GetPixelFormat(LPDDPIXELFORMAT);
 	HRESULT __stdcall GetSurfaceDesc(LPDDSURFACEDESC);
 	HRESULT __stdcall Lock(LPRECT, LPDDSURFACEDESC, DWORD, HANDLE);
+	HRESULT __stdcall Unlock(LPVOID);
 	HRESULT __stdcall SetClipper(LPDIRECTDRAWCLIPPER);
 	HRESULT __stdcall SetColorKey(DWORD, LPDDCOLORKEY);
 };
@@ -0,0 +1,99 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "dwmapi.h"
+#include "Pacing.h"
+
+typedef HRESULT(__stdcall* DWMGETCOMPOSITIONTIMINGINFO)(HWND hWnd, DWM_TIMING_INFO* pTimingInfo);
+
+namespace Pacing
+{
+	DOUBLE period = 1000.0 / PACING_DEFAULT;
+
+	DOUBLE GetRefreshRate()
+	{
+		// DWM reports the exact ratio (59.94, 143.856), display settings only the truncated integer
+		DOUBLE rate = 0.0;
+
+		HMODULE hLibrary = LoadLibrary("DWMAPI.dll");
+		if (hLibrary)
+		{
+			DWMGETCOMPOSITIONTIMINGINFO DwmGetCompositionTimingInfoC = (DWMGETCOMPOSITIONTIMINGINFO)GetProcAddress(hLibrary, "DwmGetCompositionTimingInfo");
+			if (DwmGetCompositionTimingInfoC)
+			{
+				DWM_TIMING_INFO info = {};
+				info.cbSize = sizeof(DWM_TIMING_INFO);
+				if (DwmGetCompositionTimingInfoC(NULL, &info) == S_OK && info.rateRefresh.uiNumerator && info.rateRefresh.uiDenominator)
+					rate = (DOUBLE)info.rateRefresh.uiNumerator / info.rateRefresh.uiDenominator;
+			}
+
+			FreeLibrary(hLibrary);
+		}
+
+		if (rate < 1.0)
+		{
+			DEVMODE devMode = {};
+			devMode.dmSize = sizeof(DEVMODE);
+
+			if (EnumDisplaySettings(NULL, ENUM_CURRENT_SETTINGS, &devMode) && devMode.dmDisplayFrequency > 1)
+				rate = devMode.dmDisplayFrequency;
+			else
+				rate = PACING_DEFAULT;
+		}
+
+		return rate;
+	}
+
+	VOID Load()
+	{
+		period = 1000.0 / GetRefreshRate();
+	}
+
+	DWORD Interval()
+	{
+		// the game timers take whole milliseconds, round instead of truncating
+		return DWORD(period + 0.5);
+	}
+
+	DWORD Next(DOUBLE* timeline)
+	{
+		*timeline += period;
+
+		DWORD step = (DWORD)*timeline;
+		*timeline -= step;
+
+		return step;
+	}
+
+	BOOL Elapse(DOUBLE* timeline, DOUBLE interval)
+	{
+		*timeline += period;
+		if (*timeline < interval)
+			return FALSE;
+
+		*timeline -= interval;
+		return TRUE;
+	}
+}
@@ -0,0 +1,222 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "timeapi.h"
+#include "Playlist.h"
+#include "Prefetch.h"
+
+namespace Playlist
+{
+	MusicFolder* foldersList;
+	MusicGroup* groups[PLAYLIST_BUCKETS];
+	TrackInfo* tracks[PLAYLIST_BUCKETS];
+
+	const CHAR* audioExtList[] = { "*.wav", "*.mp3" };
+
+	DWORD Hash(const CHAR* name)
+	{
+		DWORD hash = 2166136261;
+		while (*name)
+		{
+			CHAR ch = *name++;
+			if (ch >= 'A' && ch <= 'Z')
+				ch += 'a' - 'A';
+
+			hash = (hash ^ (BYTE)ch) * 16777619;
+		}
+
+		return hash;
+	}
+
+	MusicFolder* GetFolder(const CHAR* group)
+	{
+		CHAR path[MAX_PATH];
+		StrCopy(path, group);
+		CHAR* p = StrLastChar(path, '\\');
+		if (p)
+			*p = NULL;
+		else
+			StrCopy(path, ".");
+
+		MusicFolder* folder = foldersList;
+		while (folder)
+		{
+			if (!StrCompareInsensitive(folder->path, path))
+				return folder;
+
+			folder = folder->next;
+		}
+
+		folder = (MusicFolder*)MemoryAlloc(sizeof(MusicFolder));
+		folder->next = foldersList;
+		foldersList = folder;
+
+		folder->stamp = 0;
+		folder->path = StrDuplicate(path);
+		folder->hNotify = FindFirstChangeNotification(path, FALSE, FILE_NOTIFY_CHANGE_FILE_NAME);
+
+		return folder;
+	}
+
+	VOID Poll(MusicFolder* folder)
+	{
+		// Shares without change notifications are enumerated on every open, as before
+		if (folder->hNotify == INVALID_HANDLE_VALUE)
+			++folder->stamp;
+		else if (WaitForSingleObject(folder->hNotify, 0) == WAIT_OBJECT_0)
+		{
+			++folder->stamp;
+			if (!FindNextChangeNotification(folder->hNotify))
+			{
+				FindCloseChangeNotification(folder->hNotify);
+				folder->hNotify = INVALID_HANDLE_VALUE;
+			}
+		}
+	}
+
+	VOID Scan(MusicGroup* group)
+	{
+		while (group->count)
+			MemoryFree(group->tracks[--group->count]);
+
+		CHAR filePath[MAX_PATH];
+		StrCopy(filePath, group->name);
+		CHAR* p = StrLastChar(filePath, '.');
+		CHAR* name = StrLastChar(filePath, '\\');
+		name = name ? name + 1 : filePath;
+
+		const CHAR** extension = audioExtList;
+		DWORD count = sizeof(audioExtList) / sizeof(CHAR*);
+		do
+		{
+			StrCopy(p, *extension);
+
+			WIN32_FIND_DATA findData;
+			HANDLE hFind = FindFirstFile(filePath, &findData);
+			if (hFind != INVALID_HANDLE_VALUE)
+			{
+				do
+				{
+					if (group->count == group->capacity)
+					{
+						group->capacity = group->capacity ? group->capacity << 1 : 8;
+						CHAR** list = (CHAR**)MemoryAlloc(group->capacity * sizeof(CHAR*));
+						if (group->tracks)
+						{
+							MemoryCopy(list, group->tracks, group->count * sizeof(CHAR*));
+							MemoryFree(group->tracks);
+						}
+
+						group->tracks = list;
+					}
+
+					StrCopy(name, findData.cFileName);
+					group->tracks[group->count++] = StrDuplicate(filePath);
+				} while (FindNextFile(hFind, &findData));
+				FindClose(hFind);
+			}
+
+			++extension;
+		} while (--count);
+	}
+
+	const CHAR* Select(const CHAR* path)
+	{
+		DWORD hash = Hash(path);
+		MusicGroup** bucket = &groups[hash & (PLAYLIST_BUCKETS - 1)];
+
+		MusicGroup* group = *bucket;
+		while (group)
+		{
+			if (group->hash == hash && !StrCompareInsensitive(group->name, path))
+				break;
+
+			group = group->chain;
+		}
+
+		if (!group)
+		{
+			group = (MusicGroup*)MemoryAlloc(sizeof(MusicGroup));
+			MemoryZero(group, sizeof(MusicGroup));
+			group->chain = *bucket;
+			*bucket = group;
+
+			group->hash = hash;
+			group->name = StrDuplicate(path);
+			group->folder = GetFolder(path);
+			group->stamp = group->folder->stamp - 1;
+			group->next = INFINITE;
+		}
+
+		Poll(group->folder);
+		if (group->stamp != group->folder->stamp)
+		{
+			group->stamp = group->folder->stamp;
+			Scan(group);
+		}
+
+		if (!group->count)
+			return NULL;
+
+		if (group->count == 1)
+			return *group->tracks;
+
+		SeedRandom(timeGetTime());
+		DWORD index = group->next < group->count ? group->next : Random() % group->count;
+
+		// The following track is chosen now, so it can be read ahead while this one plays
+		group->next = Random() % group->count;
+		if (group->next != index)
+			Prefetch::Request(group->tracks[group->next]);
+
+		return group->tracks[index];
+	}
+
+	TrackInfo* Find(const CHAR* group, const CHAR* path)
+	{
+		DWORD hash = Hash(path);
+		TrackInfo** bucket = &tracks[hash & (PLAYLIST_BUCKETS - 1)];
+
+		TrackInfo* trackInfo = *bucket;
+		while (trackInfo)
+		{
+			if (trackInfo->hash == hash && !StrCompareInsensitive(trackInfo->path, path))
+				return trackInfo;
+
+			trackInfo = trackInfo->chain;
+		}
+
+		trackInfo = (TrackInfo*)MemoryAlloc(sizeof(TrackInfo));
+		trackInfo->chain = *bucket;
+		*bucket = trackInfo;
+
+		trackInfo->hash = hash;
+		trackInfo->position = 0;
+		trackInfo->group = StrDuplicate(group);
+		trackInfo->path = StrDuplicate(path);
+
+		return trackInfo;
+	}
+}
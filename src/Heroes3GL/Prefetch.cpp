@@ -0,0 +1,299 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "Prefetch.h"
+#include "Config.h"
+
+#ifndef THREAD_MODE_BACKGROUND_BEGIN
+#define THREAD_MODE_BACKGROUND_BEGIN 0x00010000
+#endif
+
+namespace Prefetch
+{
+	CRITICAL_SECTION section;
+	HANDLE hEvent;
+	HANDLE hThread;
+	BOOL isFinish;
+
+	DWORD hits;
+	DWORD misses;
+
+	struct {
+		CHAR paths[PREFETCH_QUEUE][MAX_PATH];
+		DWORD first;
+		DWORD count;
+	} queue;
+
+	struct {
+		PrefetchSlot slots[PREFETCH_SLOTS];
+		DWORD first;
+		DWORD count;
+		DWORD size;
+	} warm;
+
+	const CHAR* videoExtList[] = { "Data\\*.vid", "Data\\*.bik" };
+
+	DWORD Hash(const CHAR* path)
+	{
+		CHAR fullPath[MAX_PATH];
+		if (GetFullPathName(path, MAX_PATH, fullPath, NULL))
+			path = fullPath;
+
+		DWORD hash = 2166136261;
+		while (*path)
+		{
+			CHAR ch = *path++;
+			if (ch >= 'A' && ch <= 'Z')
+				ch += 'a' - 'A';
+
+			hash = (hash ^ (BYTE)ch) * 16777619;
+		}
+
+		return hash;
+	}
+
+	BOOL IsWarm(DWORD hash)
+	{
+		BOOL res = FALSE;
+		EnterCriticalSection(&section);
+		{
+			DWORD index = warm.first;
+			DWORD count = warm.count;
+			while (count--)
+			{
+				if (warm.slots[index].hash == hash)
+				{
+					res = TRUE;
+					break;
+				}
+
+				index = (index + 1) % PREFETCH_SLOTS;
+			}
+		}
+		LeaveCriticalSection(&section);
+
+		return res;
+	}
+
+	VOID AddWarm(DWORD hash, DWORD size)
+	{
+		EnterCriticalSection(&section);
+		{
+			// Oldest files are assumed evicted from the cache once the budget is spent
+			while (warm.count && (warm.count == PREFETCH_SLOTS || warm.size + size > PREFETCH_BUDGET))
+			{
+				warm.size -= warm.slots[warm.first].size;
+				warm.first = (warm.first + 1) % PREFETCH_SLOTS;
+				--warm.count;
+			}
+
+			PrefetchSlot* slot = &warm.slots[(warm.first + warm.count) % PREFETCH_SLOTS];
+			slot->hash = hash;
+			slot->size = size;
+
+			++warm.count;
+			warm.size += size;
+		}
+		LeaveCriticalSection(&section);
+	}
+
+	VOID Warm(const CHAR* path, BYTE* buffer)
+	{
+		DWORD hash = Hash(path);
+		if (IsWarm(hash))
+			return;
+
+		HANDLE hFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (hFile != INVALID_HANDLE_VALUE)
+		{
+			DWORD total = 0;
+			DWORD limit = config.prefetch << 20;
+
+			DWORD readed;
+			while (total < limit && !isFinish && ReadFile(hFile, buffer, PREFETCH_BLOCK, &readed, NULL) && readed)
+				total += readed;
+
+			CloseHandle(hFile);
+
+			if (total)
+				AddWarm(hash, total);
+		}
+	}
+
+	DWORD __stdcall PrefetchThread(LPVOID lpParameter)
+	{
+		// Background mode also lowers I/O priority, older systems only get the lower CPU priority
+		if (!SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN))
+			SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+		BYTE* buffer = (BYTE*)MemoryAlloc(PREFETCH_BLOCK);
+		if (!buffer)
+			return NULL;
+
+		// Video containers are opened right after start
+		{
+			CHAR path[MAX_PATH];
+			StrCopy(path, config.file);
+			CHAR* p = StrLastChar(path, '\\') + 1;
+
+			const CHAR** extension = videoExtList;
+			DWORD count = sizeof(videoExtList) / sizeof(CHAR*);
+			do
+			{
+				StrCopy(p, *extension);
+				CHAR* name = StrLastChar(p, '\\') + 1;
+
+				WIN32_FIND_DATA findData;
+				HANDLE hFind = FindFirstFile(path, &findData);
+				if (hFind != INVALID_HANDLE_VALUE)
+				{
+					do
+					{
+						StrCopy(name, findData.cFileName);
+						Warm(path, buffer);
+					} while (!isFinish && FindNextFile(hFind, &findData));
+					FindClose(hFind);
+				}
+
+				++extension;
+			} while (--count);
+		}
+
+		while (!isFinish)
+		{
+			WaitForSingleObject(hEvent, INFINITE);
+
+			while (!isFinish)
+			{
+				CHAR path[MAX_PATH];
+				BOOL isEmpty;
+				EnterCriticalSection(&section);
+				{
+					isEmpty = !queue.count;
+					if (!isEmpty)
+					{
+						StrCopy(path, queue.paths[queue.first]);
+						queue.first = (queue.first + 1) % PREFETCH_QUEUE;
+						--queue.count;
+					}
+				}
+				LeaveCriticalSection(&section);
+
+				if (isEmpty)
+					break;
+
+				Warm(path, buffer);
+			}
+		}
+
+		MemoryFree(buffer);
+
+		return NULL;
+	}
+
+	VOID Create()
+	{
+		if (!config.prefetch)
+			return;
+
+		InitializeCriticalSection(&section);
+		hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+		isFinish = FALSE;
+
+		DWORD threadId;
+		SECURITY_ATTRIBUTES sAttribs = { sizeof(SECURITY_ATTRIBUTES), NULL, FALSE };
+		hThread = CreateThread(&sAttribs, NULL, PrefetchThread, NULL, NORMAL_PRIORITY_CLASS, &threadId);
+	}
+
+	VOID Stop()
+	{
+		if (!hEvent)
+			return;
+
+		if (hThread)
+		{
+			isFinish = TRUE;
+			SetEvent(hEvent);
+			WaitForSingleObject(hThread, INFINITE);
+			CloseHandle(hThread);
+			hThread = NULL;
+
+#ifdef _DEBUG
+			CHAR message[64];
+			StrPrint(message, "Prefetch: %d hits, %d misses\n", hits, misses);
+			OutputDebugString(message);
+#endif
+		}
+
+		CloseHandle(hEvent);
+		hEvent = NULL;
+
+		DeleteCriticalSection(&section);
+	}
+
+	VOID Release()
+	{
+		// Loader lock is held here, a worker not yet joined by Stop is only signalled
+		if (hThread)
+		{
+			isFinish = TRUE;
+			SetEvent(hEvent);
+		}
+	}
+
+	VOID Request(const CHAR* path)
+	{
+		if (!hThread)
+			return;
+
+		EnterCriticalSection(&section);
+		{
+			if (queue.count < PREFETCH_QUEUE)
+			{
+				StrCopy(queue.paths[(queue.first + queue.count) % PREFETCH_QUEUE], path);
+				++queue.count;
+			}
+		}
+		LeaveCriticalSection(&section);
+
+		SetEvent(hEvent);
+	}
+
+	BOOL Check(const CHAR* path)
+	{
+		if (!hThread)
+			return FALSE;
+
+		if (IsWarm(Hash(path)))
+		{
+			++hits;
+			return TRUE;
+		}
+
+		++misses;
+		return FALSE;
+	}
+}
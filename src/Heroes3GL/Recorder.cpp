@@ -0,0 +1,417 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "timeapi.h"
+#include "Recorder.h"
+#include "Deflate.h"
+#include "Config.h"
+
+namespace Recorder
+{
+	CRITICAL_SECTION section;
+	HANDLE hEvent;
+	HANDLE hThread;
+	HANDLE hFile;
+	BOOL isFinish;
+	BOOL isFailed;
+
+	RecordChunk* freeList;
+	DWORD allocated;
+
+	struct {
+		RecordChunk* first;
+		RecordChunk* last;
+	} queue;
+
+	RecordChunk* current;
+	DWORD frameSize;
+	DWORD trackIndex;
+	BYTE trackBpp[256];
+
+	struct {
+		BYTE* header;
+		DWORD count;
+		BOOL isOverflow;
+	} frame;
+
+	VOID Recycle(RecordChunk* chunk)
+	{
+		EnterCriticalSection(&section);
+		{
+			chunk->next = freeList;
+			freeList = chunk;
+		}
+		LeaveCriticalSection(&section);
+	}
+
+	RecordChunk* Acquire(DWORD size)
+	{
+		RecordChunk* chunk;
+		EnterCriticalSection(&section);
+		{
+			chunk = freeList;
+			if (chunk)
+				freeList = chunk->next;
+			else if (allocated < RECORD_POOL)
+			{
+				chunk = (RecordChunk*)MemoryAlloc(sizeof(RecordChunk));
+				if (chunk)
+				{
+					chunk->capacity = 0;
+					chunk->data = NULL;
+					++allocated;
+				}
+			}
+		}
+		LeaveCriticalSection(&section);
+
+		if (chunk)
+		{
+			if (chunk->capacity < size)
+			{
+				if (chunk->data)
+					AlignedFree(chunk->data);
+
+				chunk->data = (BYTE*)AlignedAlloc(size);
+				if (!chunk->data)
+				{
+					EnterCriticalSection(&section);
+					{
+						--allocated;
+					}
+					LeaveCriticalSection(&section);
+
+					MemoryFree(chunk);
+					return NULL;
+				}
+
+				chunk->capacity = size;
+			}
+
+			chunk->next = NULL;
+			chunk->size = 0;
+		}
+
+		return chunk;
+	}
+
+	VOID Seal()
+	{
+		RecordChunk* chunk = current;
+		current = NULL;
+
+		if (!chunk->size)
+		{
+			Recycle(chunk);
+			return;
+		}
+
+		EnterCriticalSection(&section);
+		{
+			if (queue.last)
+				queue.last->next = chunk;
+			else
+				queue.first = chunk;
+			queue.last = chunk;
+		}
+		LeaveCriticalSection(&section);
+
+		SetEvent(hEvent);
+	}
+
+	BOOL Reserve(DWORD size)
+	{
+		if (current && current->capacity - current->size < size)
+			Seal();
+
+		if (!current)
+			current = Acquire(RECORD_CHUNK + frameSize + RECORD_SLACK);
+
+		return current != NULL;
+	}
+
+	DWORD __stdcall RecordThread(LPVOID lpParameter)
+	{
+		DWORD capacity = 0;
+		BYTE* packed = NULL;
+		DWORD* head = (DWORD*)MemoryAlloc(DEFLATE_WINDOW * sizeof(DWORD));
+
+		do
+		{
+			WaitForSingleObject(hEvent, INFINITE);
+
+			do
+			{
+				RecordChunk* chunk;
+				EnterCriticalSection(&section);
+				{
+					chunk = queue.first;
+					if (chunk)
+					{
+						queue.first = chunk->next;
+						if (!queue.first)
+							queue.last = NULL;
+					}
+				}
+				LeaveCriticalSection(&section);
+
+				if (!chunk)
+					break;
+
+				DWORD bound = Deflate::Bound(chunk->size) + 2 * sizeof(DWORD);
+				if (capacity < bound)
+				{
+					if (packed)
+						MemoryFree(packed);
+
+					capacity = bound;
+					packed = (BYTE*)MemoryAlloc(capacity);
+				}
+
+				if (packed && head)
+				{
+					DWORD* header = (DWORD*)packed;
+					header[0] = chunk->size;
+					header[1] = Deflate::Compress((BYTE*)(header + 2), chunk->data, chunk->size, head) - (BYTE*)(header + 2);
+
+					DWORD written;
+					WriteFile(hFile, packed, header[1] + 2 * sizeof(DWORD), &written, NULL);
+				}
+
+				Recycle(chunk);
+			} while (TRUE);
+		} while (!isFinish);
+
+		if (packed)
+			MemoryFree(packed);
+
+		if (head)
+			MemoryFree(head);
+
+		return NULL;
+	}
+
+	BOOL Start()
+	{
+		CHAR path[MAX_PATH];
+		StrCopy(path, config.file);
+		CHAR* p = StrLastChar(path, '\\') + 1;
+		StrCopy(p, RECORD_DIR);
+		CreateDirectory(path, NULL);
+
+		SYSTEMTIME time;
+		GetLocalTime(&time);
+		StrPrint(p + sizeof(RECORD_DIR) - 1, "\\%04d%02d%02d_%02d%02d%02d.hrec",
+			time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond);
+
+		hFile = CreateFile(path, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (hFile == INVALID_HANDLE_VALUE)
+		{
+			hFile = NULL;
+			return FALSE;
+		}
+
+		DWORD header[2] = { 'CERH', RECORD_VERSION };
+		DWORD written;
+		WriteFile(hFile, header, sizeof(header), &written, NULL);
+
+		isFinish = FALSE;
+
+		DWORD threadId;
+		SECURITY_ATTRIBUTES sAttribs = { sizeof(SECURITY_ATTRIBUTES), NULL, FALSE };
+		hThread = CreateThread(&sAttribs, NULL, RecordThread, NULL, NORMAL_PRIORITY_CLASS, &threadId);
+		if (!hThread)
+		{
+			CloseHandle(hFile);
+			hFile = NULL;
+			return FALSE;
+		}
+
+		SetThreadPriority(hThread, THREAD_PRIORITY_BELOW_NORMAL);
+		return TRUE;
+	}
+
+	VOID Create()
+	{
+		InitializeCriticalSection(&section);
+		hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	}
+
+	VOID Release()
+	{
+		if (current)
+			Seal();
+
+		if (hThread)
+		{
+			isFinish = TRUE;
+			SetEvent(hEvent);
+			WaitForSingleObject(hThread, INFINITE);
+			CloseHandle(hThread);
+			hThread = NULL;
+		}
+
+		if (hFile)
+		{
+			CloseHandle(hFile);
+			hFile = NULL;
+		}
+
+		while (freeList)
+		{
+			RecordChunk* chunk = freeList;
+			freeList = chunk->next;
+
+			AlignedFree(chunk->data);
+			MemoryFree(chunk);
+		}
+
+		allocated = 0;
+		frameSize = 0;
+		frame.header = NULL;
+	}
+
+	DWORD Open(DWORD width, DWORD height, BOOL isTrue, GLenum format, GLenum type)
+	{
+		if (!config.record || isFailed)
+			return 0;
+
+		if (!hFile && !Start())
+		{
+			isFailed = TRUE;
+			return 0;
+		}
+
+		DWORD bpp = isTrue ? sizeof(DWORD) : sizeof(WORD);
+		DWORD size = width * height * bpp;
+		if (frameSize < size)
+			frameSize = size;
+
+		if (!Reserve(6 * sizeof(DWORD)))
+			return 0;
+
+		trackIndex = trackIndex % 255 + 1;
+		trackBpp[trackIndex] = LOBYTE(bpp);
+
+		BYTE* ptr = current->data + current->size;
+		ptr[0] = RecordTrack;
+		ptr[1] = LOBYTE(trackIndex);
+		*(WORD*)(ptr + 2) = 0;
+
+		DWORD* data = (DWORD*)(ptr + 4);
+		data[0] = width;
+		data[1] = height;
+		data[2] = format;
+		data[3] = type;
+
+		current->size += 5 * sizeof(DWORD);
+
+		return trackIndex;
+	}
+
+	BOOL Begin(DWORD track)
+	{
+		if (frame.isOverflow)
+			return FALSE;
+
+		if (!frame.header)
+		{
+			if (!Reserve(frameSize + RECORD_SLACK))
+			{
+				frame.isOverflow = TRUE;
+				return FALSE;
+			}
+
+			frame.header = current->data + current->size;
+			frame.header[0] = RecordFrame;
+			frame.header[1] = LOBYTE(track);
+			frame.count = 0;
+
+			current->size += 2 * sizeof(DWORD);
+		}
+
+		return TRUE;
+	}
+
+	VOID AddRect(DWORD track, const Rect* rect, const VOID* data, DWORD pitch)
+	{
+		if (!rect->width || !rect->height || !Begin(track))
+			return;
+
+		DWORD bpp = trackBpp[track];
+		DWORD length = rect->width * bpp;
+		DWORD size = 4 * sizeof(WORD) + length * rect->height;
+		if (current->capacity - current->size < size || frame.count == 0xFFFF)
+		{
+			frame.isOverflow = TRUE;
+			return;
+		}
+
+		WORD* header = (WORD*)(current->data + current->size);
+		header[0] = LOWORD(rect->x);
+		header[1] = LOWORD(rect->y);
+		header[2] = LOWORD(rect->width);
+		header[3] = LOWORD(rect->height);
+
+		BYTE* dst = (BYTE*)(header + 4);
+		const BYTE* src = (const BYTE*)data;
+		DWORD stride = pitch * sizeof(DWORD);
+		DWORD height = rect->height;
+		do
+		{
+			MemoryCopy(dst, src, length);
+			dst += length;
+			src += stride;
+		} while (--height);
+
+		current->size += size;
+		++frame.count;
+	}
+
+	BOOL Commit(DWORD track)
+	{
+		Begin(track);
+
+		BOOL isOverflow = frame.isOverflow;
+		if (isOverflow)
+		{
+			if (frame.header)
+				current->size = frame.header - current->data;
+
+			frame.isOverflow = FALSE;
+		}
+		else
+		{
+			*(WORD*)(frame.header + 2) = LOWORD(frame.count);
+			*(DWORD*)(frame.header + 4) = timeGetTime();
+
+			if (current->size >= RECORD_CHUNK)
+				Seal();
+		}
+
+		frame.header = NULL;
+		return isOverflow;
+	}
+}
@@ -0,0 +1,55 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include "ExtraTypes.h"
+
+#define RECORD_POOL 3
+#define RECORD_CHUNK 0x400000
+#define RECORD_SLACK 0x10000
+#define RECORD_DIR "Records"
+#define RECORD_VERSION 1
+
+/*
+	File: DWORD 'HREC', DWORD version, then chunks of
+		DWORD rawSize, DWORD packedSize, BYTE zlib[packedSize]
+
+	Chunk data is a sequence of records:
+		BYTE RecordTrack, BYTE track, WORD 0, DWORD width, DWORD height, DWORD format, DWORD type
+		BYTE RecordFrame, BYTE track, WORD count, DWORD tick,
+			count * { WORD x, WORD y, WORD width, WORD height, pixels[width * height] }
+
+	Each track is an independent canvas: the frame rectangles are patches
+	against the previous frame of the same track only.
+*/
+
+namespace Recorder
+{
+	VOID Create();
+	VOID Release();
+
+	DWORD Open(DWORD width, DWORD height, BOOL isTrue, GLenum format, GLenum type);
+	VOID AddRect(DWORD track, const Rect* rect, const VOID* data, DWORD pitch);
+	BOOL Commit(DWORD track);
+}
\ No newline at end of file
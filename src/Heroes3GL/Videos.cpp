@@ -0,0 +1,271 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "Videos.h"
+#include "Config.h"
+
+/*
+	Cache file layout, one per container:
+		DWORD signature 'XDIV', DWORD version,
+		DWORD size, FILETIME lastWrite, DWORD count,
+		VideoEntry[count]
+*/
+
+namespace Videos
+{
+	VideoIndex* indexList;
+
+	DWORD Hash(const CHAR* name)
+	{
+		DWORD hash = 2166136261;
+		while (*name)
+		{
+			CHAR ch = *name++;
+			if (ch >= 'A' && ch <= 'Z')
+				ch += 'a' - 'A';
+
+			hash = (hash ^ (BYTE)ch) * 16777619;
+		}
+
+		return hash;
+	}
+
+	VOID GetCachePath(const CHAR* path, DWORD hash, CHAR* cachePath)
+	{
+		StrCopy(cachePath, config.file);
+		CHAR* p = StrLastChar(cachePath, '\\') + 1;
+		StrCopy(p, VIDEO_DIR "\\");
+
+		// Containers with the same name in different folders get their own cache
+		const CHAR* name = StrLastChar(path, '\\');
+		StrCat(p, name ? name + 1 : path);
+		StrPrint(p + StrLength(p), ".%08X.idx", hash);
+	}
+
+	BOOL ReadCache(VideoIndex* index, const CHAR* cachePath)
+	{
+		BOOL res = FALSE;
+
+		HANDLE hCache = CreateFile(cachePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (hCache != INVALID_HANDLE_VALUE)
+		{
+			DWORD header[6], readed;
+			if (ReadFile(hCache, header, sizeof(header), &readed, NULL) && readed == sizeof(header)
+				&& header[0] == 'XDIV' && header[1] == VIDEO_VERSION && header[2] == index->size
+				&& header[3] == index->time.dwLowDateTime && header[4] == index->time.dwHighDateTime && header[5])
+			{
+				index->count = header[5];
+				index->entries = (VideoEntry*)MemoryAlloc(index->count * sizeof(VideoEntry));
+				if (index->entries)
+				{
+					if (ReadFile(hCache, index->entries, index->count * sizeof(VideoEntry), &readed, NULL) && readed == index->count * sizeof(VideoEntry))
+						res = TRUE;
+					else
+					{
+						MemoryFree(index->entries);
+						index->entries = NULL;
+					}
+				}
+			}
+
+			CloseHandle(hCache);
+		}
+
+		return res;
+	}
+
+	VOID WriteCache(const VideoIndex* index, const CHAR* cachePath)
+	{
+		CHAR path[MAX_PATH];
+		StrCopy(path, cachePath);
+		*StrLastChar(path, '\\') = NULL;
+		CreateDirectory(path, NULL);
+
+		HANDLE hCache = CreateFile(cachePath, GENERIC_WRITE, NULL, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (hCache != INVALID_HANDLE_VALUE)
+		{
+			DWORD header[6] = { 'XDIV', VIDEO_VERSION, index->size, index->time.dwLowDateTime, index->time.dwHighDateTime, index->count };
+
+			DWORD written;
+			if (!WriteFile(hCache, header, sizeof(header), &written, NULL) || !WriteFile(hCache, index->entries, index->count * sizeof(VideoEntry), &written, NULL))
+			{
+				CloseHandle(hCache);
+				DeleteFile(cachePath);
+				return;
+			}
+
+			CloseHandle(hCache);
+		}
+	}
+
+	BOOL Build(VideoIndex* index, HANDLE hFile)
+	{
+		DWORD countInFile, readed;
+		if (!ReadFile(hFile, &countInFile, sizeof(DWORD), &readed, NULL) || !readed || !countInFile)
+			return FALSE;
+
+		VideoFile* infoList = (VideoFile*)MemoryAlloc(sizeof(VideoFile) * countInFile);
+		if (!infoList)
+			return FALSE;
+
+		if (ReadFile(hFile, infoList, sizeof(VideoFile) * countInFile, &readed, NULL) && readed == sizeof(VideoFile) * countInFile)
+		{
+			index->count = countInFile;
+			index->entries = (VideoEntry*)MemoryAlloc(countInFile * sizeof(VideoEntry));
+			if (index->entries)
+			{
+				VideoFile* fileInfo = infoList;
+				VideoEntry* entry = index->entries;
+				do
+				{
+					MemoryCopy(entry->name, fileInfo->name, sizeof(entry->name));
+					entry->name[sizeof(entry->name) - 1] = NULL;
+					entry->stride = fileInfo->stride;
+					entry->isBink = FALSE;
+
+					// Only names the game may look up as bink need their signature checked
+					CHAR* p = StrLastChar(entry->name, '.');
+					if (p && !StrCompareInsensitive(p, ".bik"))
+					{
+						SetFilePointer(hFile, fileInfo->stride, 0, FILE_BEGIN);
+
+						DWORD signature;
+						if (ReadFile(hFile, &signature, 4, &readed, NULL) && readed == 4)
+							entry->isBink = signature == 'bKIB';
+					}
+
+					++entry;
+					++fileInfo;
+				} while (--countInFile);
+			}
+		}
+
+		MemoryFree(infoList);
+
+		return index->entries != NULL;
+	}
+
+	VOID Link(VideoIndex* index)
+	{
+		index->buckets = (DWORD*)MemoryAlloc((VIDEO_BUCKETS + index->count) * sizeof(DWORD));
+		index->chains = index->buckets + VIDEO_BUCKETS;
+		MemoryZero(index->buckets, VIDEO_BUCKETS * sizeof(DWORD));
+
+		VideoEntry* entry = index->entries;
+		for (DWORD i = 0; i < index->count; ++i, ++entry)
+		{
+			entry->name[sizeof(entry->name) - 1] = NULL;
+
+			DWORD* bucket = &index->buckets[Hash(entry->name) & (VIDEO_BUCKETS - 1)];
+			index->chains[i] = *bucket;
+			*bucket = i + 1;
+		}
+	}
+
+	const VideoEntry* Find(const VideoIndex* index, const CHAR* name)
+	{
+		DWORD i = index->buckets[Hash(name) & (VIDEO_BUCKETS - 1)];
+		while (i)
+		{
+			const VideoEntry* entry = &index->entries[i - 1];
+			if (!StrCompareInsensitive(entry->name, name))
+				return entry;
+
+			i = index->chains[i - 1];
+		}
+
+		return NULL;
+	}
+
+	VOID Load(HANDLE hFile, const CHAR* path, VideoInfo* gameInfo, DWORD countInGame)
+	{
+		CHAR fullPath[MAX_PATH];
+		if (!GetFullPathName(path, MAX_PATH, fullPath, NULL))
+			StrCopy(fullPath, path);
+
+		DWORD hash = Hash(fullPath);
+		DWORD size = GetFileSize(hFile, NULL);
+		FILETIME time;
+		if (!GetFileTime(hFile, NULL, NULL, &time))
+			MemoryZero(&time, sizeof(FILETIME));
+
+		VideoIndex* index = indexList;
+		while (index)
+		{
+			if (index->hash == hash && index->size == size && !MemoryCompare(&index->time, &time, sizeof(FILETIME)))
+				break;
+
+			index = index->next;
+		}
+
+		if (!index)
+		{
+			index = (VideoIndex*)MemoryAlloc(sizeof(VideoIndex));
+			MemoryZero(index, sizeof(VideoIndex));
+			index->hash = hash;
+			index->size = size;
+			index->time = time;
+
+			CHAR cachePath[MAX_PATH];
+			GetCachePath(fullPath, hash, cachePath);
+			if (!ReadCache(index, cachePath))
+			{
+				BOOL isBuilt = Build(index, hFile);
+				SetFilePointer(hFile, 0, 0, FILE_BEGIN);
+
+				if (!isBuilt)
+				{
+					if (index->entries)
+						MemoryFree(index->entries);
+					MemoryFree(index);
+					return;
+				}
+
+				WriteCache(index, cachePath);
+			}
+
+			Link(index);
+
+			index->next = indexList;
+			indexList = index;
+		}
+
+		CHAR name[40];
+		do
+		{
+			if (!gameInfo->bink)
+			{
+				StrCopy(name, gameInfo->fileName);
+				StrCat(name, ".bik");
+
+				const VideoEntry* entry = Find(index, name);
+				if (entry)
+					gameInfo->bink = (BYTE)entry->isBink;
+			}
+
+			++gameInfo;
+		} while (--countInGame);
+	}
+}
@@ -0,0 +1,155 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+
+struct AlignedHeader {
+	VOID* base;
+	size_t capacity;
+};
+
+struct {
+	volatile LONG lock;
+	DWORD count;
+	size_t pooled;
+	VOID* slots[ALIGNED_SLOTS];
+#ifdef _DEBUG
+	size_t live;
+	size_t peak;
+#endif
+} alignedPool;
+
+VOID AlignedLock()
+{
+	while (InterlockedExchange(&alignedPool.lock, TRUE))
+		Sleep(0);
+}
+
+VOID AlignedUnlock()
+{
+	InterlockedExchange(&alignedPool.lock, FALSE);
+}
+
+AlignedHeader* AlignedGetHeader(VOID* block)
+{
+	return (AlignedHeader*)block - 1;
+}
+
+VOID* AlignedAlloc(size_t size)
+{
+	size_t capacity = size >= ALIGNED_CLASS ? (size + ALIGNED_CLASS - 1) & ~(ALIGNED_CLASS - 1) : size;
+
+	VOID* block = NULL;
+	AlignedLock();
+	{
+		if (capacity >= ALIGNED_CLASS)
+		{
+			for (DWORD i = 0; i < alignedPool.count; ++i)
+			{
+				VOID* slot = alignedPool.slots[i];
+				if (AlignedGetHeader(slot)->capacity == capacity)
+				{
+					alignedPool.slots[i] = alignedPool.slots[--alignedPool.count];
+					alignedPool.pooled -= capacity;
+					block = slot;
+					break;
+				}
+			}
+		}
+
+#ifdef _DEBUG
+		alignedPool.live += capacity;
+		if (alignedPool.peak < alignedPool.live)
+			alignedPool.peak = alignedPool.live;
+#endif
+	}
+	AlignedUnlock();
+
+	if (!block)
+	{
+		VOID* base = MemoryAlloc(sizeof(AlignedHeader) + ALIGNED_BOUNDARY - 1 + capacity);
+		if (!base)
+		{
+#ifdef _DEBUG
+			AlignedLock();
+			alignedPool.live -= capacity;
+			AlignedUnlock();
+#endif
+			return NULL;
+		}
+
+		block = (VOID*)((ULONG_PTR((BYTE*)base + sizeof(AlignedHeader)) + ALIGNED_BOUNDARY - 1) & ~ULONG_PTR(ALIGNED_BOUNDARY - 1));
+
+		AlignedHeader* header = AlignedGetHeader(block);
+		header->base = base;
+		header->capacity = capacity;
+	}
+
+	return block;
+}
+
+VOID AlignedFree(VOID* block)
+{
+	if (!block)
+		return;
+
+	AlignedHeader* header = AlignedGetHeader(block);
+	size_t capacity = header->capacity;
+
+	AlignedLock();
+	{
+#ifdef _DEBUG
+		alignedPool.live -= capacity;
+#endif
+
+		if (capacity >= ALIGNED_CLASS && alignedPool.count != ALIGNED_SLOTS && alignedPool.pooled + capacity <= ALIGNED_LIMIT)
+		{
+			alignedPool.slots[alignedPool.count++] = block;
+			alignedPool.pooled += capacity;
+			block = NULL;
+		}
+	}
+	AlignedUnlock();
+
+	if (block)
+		MemoryFree(header->base);
+}
+
+VOID AlignedRelease()
+{
+	AlignedLock();
+	{
+		while (alignedPool.count)
+			MemoryFree(AlignedGetHeader(alignedPool.slots[--alignedPool.count])->base);
+
+		alignedPool.pooled = 0;
+
+#ifdef _DEBUG
+		CHAR message[64];
+		StrPrint(message, "Aligned: live %u, peak %u\n", alignedPool.live, alignedPool.peak);
+		OutputDebugString(message);
+#endif
+	}
+	AlignedUnlock();
+}
@@ -24,6 +24,7 @@
 
 #include "stdafx.h"
 #include "Config.h"
+#include "Ini.h"
 #include "intrin.h"
 #include "Mmsystem.h"
 
@@ -90,8 +91,6 @@ const Adjustment defaultColors = {
 	1.0f
 };
 
-CHAR keysBuffer[4096];
-
 namespace Config
 {
 	BYTE LoadKey(const CHAR* name)
@@ -128,18 +127,16 @@ namespace Config
 		return 0.001f * min(1000, max(0, Config::Get(CONFIG_COLORS, name, 500)));
 	}
 
-	VOID Load(HMODULE hModule, const AddressSpace* hookSpace)
+	VOID Open(HMODULE hModule)
 	{
 		GetModuleFileName(hModule, config.file, MAX_PATH);
 		StrCopy(StrLastChar(config.file, '\\') + 1, "config.ini");
 
-		FILE* file = FileOpen(config.file, "rb");
-		if (file)
-		{
-			config.isExist = TRUE;
-			FileClose(file);
-		}
+		config.isExist = Ini::Load(config.file);
+	}
 
+	VOID Load(HMODULE hModule, const AddressSpace* hookSpace)
+	{
 		config.dialog = hookSpace->resDialog;
 		config.cursor = LoadCursor(NULL, IDC_ARROW);
 		config.icon = LoadIcon(hModule, MAKEINTRESOURCE(RESOURCE_ICON));
@@ -183,9 +180,17 @@ namespace Config
 			config.renderer = RendererAuto;
 			Config::Set(CONFIG_WRAPPER, "Renderer", *(INT*)&config.renderer);
 
-			config.updateMode = UpdateSSE;
+			config.updateMode = UpdateAuto;
 			Config::Set(CONFIG_WRAPPER, "UpdateMode", *(INT*)&config.updateMode);
 
+			config.frameLatency = 2;
+			Config::Set(CONFIG_WRAPPER, "FrameLatency", config.frameLatency);
+
+			config.snapshot = SnapshotPng;
+			Config::Set(CONFIG_WRAPPER, "Snapshot", *(INT*)&config.snapshot);
+
+			Config::Set(CONFIG_WRAPPER, "Record", config.record);
+
 			Config::Set(CONFIG_WRAPPER, "ColdCPU", config.coldCPU);
 
 			Config::Set(CONFIG_WRAPPER, "SingleCPU", config.singleCore.enabled);
@@ -302,17 +307,28 @@ namespace Config
 				if (config.renderer < RendererAuto || config.renderer > RendererOpenGL3)
 					config.renderer = RendererAuto;
 
-				value = Config::Get(CONFIG_WRAPPER, "UpdateMode", UpdateSSE);
+				value = Config::Get(CONFIG_WRAPPER, "UpdateMode", UpdateAuto);
 				config.updateMode = *(UpdateMode*)&value;
-				if (config.updateMode < UpdateNone || config.updateMode > UpdateASM)
-					config.updateMode = UpdateSSE;
+				if (config.updateMode < UpdateNone || config.updateMode > UpdateAuto)
+					config.updateMode = UpdateAuto;
+
+				config.frameLatency = Config::Get(CONFIG_WRAPPER, "FrameLatency", 2);
+				if (config.frameLatency < 1 || config.frameLatency > 3)
+					config.frameLatency = 2;
+
+				value = Config::Get(CONFIG_WRAPPER, "Snapshot", SnapshotPng);
+				config.snapshot = *(SnapshotType*)&value;
+				if (config.snapshot < SnapshotClipboard || config.snapshot > SnapshotQoi)
+					config.snapshot = SnapshotPng;
+
+				config.record = (BOOL)Config::Get(CONFIG_WRAPPER, "Record", FALSE);
 
 				config.image.aspect = (BOOL)Config::Get(CONFIG_WRAPPER, "ImageAspect", TRUE);
 				config.image.vSync = (BOOL)Config::Get(CONFIG_WRAPPER, "ImageVSync", TRUE);
 
 				value = Config::Get(CONFIG_WRAPPER, "FpsCounter", FpsDisabled);
 				config.fps = *(FpsState*)&value;
-				if (config.fps < FpsDisabled || config.fps > FpsBenchmark)
+				if (config.fps < FpsDisabled || config.fps > FpsIdle)
 					config.fps = FpsDisabled;
 
 				value = Config::Get(CONFIG_WRAPPER, "Interpolation", InterpolateHermite);
@@ -411,47 +427,28 @@ namespace Config
 		}
 	}
 
-	BOOL Check(const CHAR* app, const CHAR* key)
-	{
-		if (GetPrivateProfileString(app, NULL, NULL, keysBuffer, sizeof(keysBuffer), config.file))
-		{
-			CHAR* ptr = keysBuffer;
-			while (*ptr)
-			{
-				if (!StrCompareInsensitive(ptr, key))
-					return TRUE;
-
-				ptr = StrChar(ptr, NULL);
-				if (!ptr)
-					return FALSE;
-
-				++ptr;
-			}
-		}
-
-		return FALSE;
-	}
-
-	INT Get(const CHAR* app, const CHAR* key, INT default)
+	INT Get(const CHAR* app, const CHAR* key, INT defValue)
 	{
-		return GetPrivateProfileInt(app, key, (INT) default, config.file);
+		return Ini::Get(app, key, defValue);
 	}
 
-	DWORD Get(const CHAR* app, const CHAR* key, const CHAR* default, CHAR* returnString, DWORD nSize)
+	DWORD Get(const CHAR* app, const CHAR* key, const CHAR* defValue, CHAR* returnString, DWORD nSize)
 	{
-		return GetPrivateProfileString(app, key, default, returnString, nSize, config.file);
+		return Ini::Get(app, key, defValue, returnString, nSize);
 	}
 
 	BOOL Set(const CHAR* app, const CHAR* key, INT value)
 	{
 		CHAR res[20];
 		StrFromInt(value, res, 10);
-		return WritePrivateProfileString(app, key, res, config.file);
+		Ini::Set(app, key, res);
+		return TRUE;
 	}
 
 	BOOL Set(const CHAR* app, const CHAR* key, CHAR* value)
 	{
-		return WritePrivateProfileString(app, key, value, config.file);
+		Ini::Set(app, key, value);
+		return TRUE;
 	}
 
 	VOID SetProcessMask()
@@ -31,6 +31,11 @@
 #include "Window.h"
 #include "Resource.h"
 #include "Mods.h"
+#include "Snapshot.h"
+#include "Recorder.h"
+#include "Ini.h"
+#include "Registry.h"
+#include "Gdi.h"
 
 BOOL __stdcall DllMain(HMODULE hModule, DWORD fdwReason, LPVOID lpReserved)
 {
@@ -56,9 +61,14 @@ BOOL __stdcall DllMain(HMODULE hModule, DWORD fdwReason, LPVOID lpReserved)
 		hDllModule = hModule;
 		if (Hooks::Load())
 		{
+			Registry::Create();
+
 			if (!config.isDDraw)
 			{
 				Mods::Load();
+				Snapshot::Create();
+				Recorder::Create();
+				Gdi::Create();
 
 				Window::SetCaptureKeys(TRUE);
 
@@ -106,6 +116,17 @@ BOOL __stdcall DllMain(HMODULE hModule, DWORD fdwReason, LPVOID lpReserved)
 	case DLL_PROCESS_DETACH:
 		if (hDllModule)
 		{
+			Hooks::Release();
+
+			if (!config.isDDraw)
+			{
+				Gdi::Release();
+				Snapshot::Release();
+			}
+
+			Ini::Release();
+			AlignedRelease();
+
 			timeEndPeriod(1);
 
 			if (hActCtx && hActCtx != INVALID_HANDLE_VALUE)
@@ -159,14 +159,27 @@ union LevelColorsFloat
 	FLOAT chanel[3];
 };
 
+struct CanvasTap {
+	DWORD index;
+	FLOAT weight[4];
+};
+
 struct LevelsData {
 	HDC hDc;
 	HBITMAP hBmp;
 	DWORD* data;
 	DWORD bmpData[100 * 516];
 	LevelColorsFloat colors[256];
+	LONG version;
 	FLOAT delta;
 	Adjustment values;
+	Adjustment toneValues;
+	BYTE tone[3][256];
+	BOOL isTone;
+	CanvasTap* taps;
+	DWORD interval;
+	DWORD drawTick;
+	BOOL isPending;
 };
 
 struct AddressSpace
@@ -200,7 +213,9 @@ enum FpsState
 {
 	FpsDisabled = 0,
 	FpsNormal,
-	FpsBenchmark
+	FpsBenchmark,
+	FpsLatency,
+	FpsIdle
 };
 
 struct FpsItem {
@@ -220,7 +235,62 @@ enum UpdateMode
 	UpdateNone = 0,
 	UpdateSSE = 1,
 	UpdateCPP = 2,
-	UpdateASM = 3
+	UpdateASM = 3,
+	UpdateAuto = 4
+};
+
+enum SnapshotType
+{
+	SnapshotClipboard = 0,
+	SnapshotPng = 1,
+	SnapshotQoi = 2
+};
+
+struct SnapshotFrame
+{
+	SnapshotFrame* next;
+	DWORD width;
+	DWORD height;
+	DWORD capacity;
+	BOOL isFlipped;
+	DWORD* data;
+};
+
+enum RecordType : BYTE
+{
+	RecordTrack = 1,
+	RecordFrame = 2
+};
+
+struct IniLine
+{
+	IniLine* next;
+	IniLine* chain;
+	IniLine* section;
+	IniLine* tail;
+	DWORD hash;
+	CHAR* key;
+	CHAR* value;
+	CHAR* text;
+};
+
+struct RegValue
+{
+	RegValue* chain;
+	DWORD hash;
+	CHAR* name;
+	DWORD type;
+	DWORD size;
+	BYTE* data;
+	BOOL isLegacy;
+};
+
+struct RecordChunk
+{
+	RecordChunk* next;
+	DWORD capacity;
+	DWORD size;
+	BYTE* data;
 };
 
 struct ConfigItems
@@ -238,6 +308,9 @@ struct ConfigItems
 	BOOL isSSE2;
 	RendererType renderer;
 	UpdateMode updateMode;
+	DWORD frameLatency;
+	SnapshotType snapshot;
+	BOOL record;
 	
 	struct {
 		BOOL allowed;
@@ -312,13 +385,19 @@ enum MenuType
 	MenuLanguage
 };
 
+class OpenDrawSurface;
 struct RenderBuffer {
+	RenderBuffer* last;
 	DWORD width;
 	DWORD height;
 	WORD* data;
+	OpenDrawSurface* alias;
+	RenderBuffer* nextAlias;
+	BOOL isPaged;
 };
 
 struct RenderDC {
+	RenderDC* last;
 	RenderBuffer* buffer;
 };
 
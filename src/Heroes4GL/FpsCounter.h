@@ -28,13 +28,9 @@
 
 #define FPS_X 3
 #define FPS_Y 5
-#define FPS_WIDTH 16
-#define FPS_HEIGHT 24
 #define FPS_COUNT 120
 #define FPS_ACCURACY 2000
 
-extern const WORD counters[10][FPS_HEIGHT];
-
 class FpsCounter : public Allocation
 {
 private:
@@ -50,6 +46,12 @@ private:
 
 public:
 	DWORD value;
+	DWORD latency;
+	DWORD idle;
+	DWORD idleLatency;
+	DWORD elided;
+	DWORD draws;
+	DWORD changes;
 
 	FpsCounter(FpsMode, DWORD, DWORD = FPS_ACCURACY);
 	~FpsCounter();
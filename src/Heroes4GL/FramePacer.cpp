@@ -0,0 +1,92 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "FramePacer.h"
+
+FramePacer::FramePacer(DWORD depth)
+{
+	this->depth = depth < 1 ? 1 : (depth > PACER_DEPTH ? PACER_DEPTH : depth);
+	this->first = 0;
+	this->count = 0;
+	this->average = 0;
+	this->latency = 0;
+
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	this->frequency = freq.QuadPart;
+}
+
+FramePacer::~FramePacer()
+{
+	while (this->count)
+		this->Retire(TRUE);
+}
+
+BOOL FramePacer::Retire(BOOL wait)
+{
+	GLsync fence = this->fences[this->first];
+	if (GLClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? PACER_TIMEOUT : 0) == GL_TIMEOUT_EXPIRED && !wait)
+		return FALSE;
+
+	GLDeleteSync(fence);
+	this->Measure(this->stamps[this->first]);
+
+	this->first = (this->first + 1) % PACER_DEPTH;
+	--this->count;
+
+	return TRUE;
+}
+
+VOID FramePacer::Measure(LONGLONG stamp)
+{
+	if (!stamp)
+		return;
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	LONGLONG span = (now.QuadPart - stamp) * 1000000 / this->frequency;
+	this->average = this->average ? (this->average * 7 + span) >> 3 : span;
+	this->latency = DWORD((this->average + 500) / 1000);
+}
+
+VOID FramePacer::Submit(LONGLONG stamp)
+{
+	if (GLFenceSync)
+	{
+		DWORD index = (this->first + this->count) % PACER_DEPTH;
+		this->fences[index] = GLFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		this->stamps[index] = stamp;
+		++this->count;
+
+		// Completed frames are collected as they come, the oldest one is waited for only above the allowed depth
+		while (this->count && this->Retire(this->count >= this->depth));
+	}
+	else
+	{
+		GLFinish();
+		this->Measure(stamp);
+	}
+}
@@ -0,0 +1,391 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "intrin.h"
+#include "Gdi.h"
+#include "OpenDraw.h"
+#include "Config.h"
+
+namespace Gdi
+{
+	CRITICAL_SECTION section;
+	PVOID hHandler;
+
+	RenderBuffer* bufferPool;
+	RenderBuffer* aliasList;
+	RenderDC* dcPool;
+	DWORD bufferCount;
+
+	VOID CopyBlock(WORD* dst, DWORD dPitch, const WORD* src, DWORD sPitch, DWORD width, DWORD height)
+	{
+		if (config.isSSE2 && width >= 8)
+		{
+			DWORD count = width >> 3;
+			DWORD tail = width & 7;
+			do
+			{
+				const __m128i* s = (const __m128i*)src;
+				__m128i* d = (__m128i*)dst;
+
+				DWORD left = count;
+				do
+					_mm_storeu_si128(d++, _mm_loadu_si128(s++));
+				while (--left);
+
+				if (tail)
+					MemoryCopy(d, s, tail * sizeof(WORD));
+
+				src += sPitch;
+				dst += dPitch;
+			} while (--height);
+		}
+		else
+		{
+			width *= sizeof(WORD);
+			do
+			{
+				MemoryCopy(dst, src, width);
+				src += sPitch;
+				dst += dPitch;
+			} while (--height);
+		}
+	}
+
+	VOID FillBlock(WORD* dst, DWORD dPitch, WORD color, DWORD width, DWORD height)
+	{
+		do
+		{
+			WORD* d = dst;
+			DWORD left = width;
+			do
+				*d++ = color;
+			while (--left);
+
+			dst += dPitch;
+		} while (--height);
+	}
+
+	DWORD GetSize(const RenderBuffer* buffer)
+	{
+		return buffer->width * buffer->height * sizeof(WORD);
+	}
+
+	// The first write into an aliased section lands here while its pages are still read-only:
+	// the surface takes a copy of what was blitted, then the write is retried on writable pages
+	LONG __stdcall WriteHandler(EXCEPTION_POINTERS* exceptionInfo)
+	{
+		EXCEPTION_RECORD* record = exceptionInfo->ExceptionRecord;
+		if (aliasList && record->ExceptionCode == EXCEPTION_ACCESS_VIOLATION && record->NumberParameters >= 2 && record->ExceptionInformation[0] == 1)
+		{
+			BYTE* address = (BYTE*)record->ExceptionInformation[1];
+
+			OpenDrawSurface* surface = NULL;
+			EnterCriticalSection(&section);
+			{
+				RenderBuffer* buffer = aliasList;
+				while (buffer)
+				{
+					if (address >= (BYTE*)buffer->data && address < (BYTE*)buffer->data + GetSize(buffer))
+					{
+						surface = buffer->alias;
+						break;
+					}
+
+					buffer = buffer->nextAlias;
+				}
+			}
+			LeaveCriticalSection(&section);
+
+			if (surface)
+			{
+				Detach(surface);
+				return EXCEPTION_CONTINUE_EXECUTION;
+			}
+		}
+
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+
+	VOID Create()
+	{
+		InitializeCriticalSection(&section);
+		if (AddVectoredExceptionHandlerC)
+			hHandler = AddVectoredExceptionHandlerC(TRUE, WriteHandler);
+	}
+
+	VOID Release()
+	{
+		if (hHandler)
+		{
+			RemoveVectoredExceptionHandlerC(hHandler);
+			hHandler = NULL;
+		}
+
+		DeleteCriticalSection(&section);
+	}
+
+	HBITMAP CreateSection(const BITMAPINFO* lpbmi, VOID** ppvBits)
+	{
+		*ppvBits = NULL;
+
+		DWORD width = (DWORD)lpbmi->bmiHeader.biWidth;
+		DWORD height = (DWORD)-lpbmi->bmiHeader.biHeight;
+
+		DWORD pitch = width * sizeof(WORD);
+		if (pitch & 3)
+			pitch = (pitch & 0xFFFFFFFC) + 4;
+		width = pitch / sizeof(WORD);
+
+		RenderBuffer* buffer;
+		RenderBuffer** link = &bufferPool;
+		while ((buffer = *link) != NULL)
+		{
+			if (buffer->width == width && buffer->height == height)
+			{
+				*link = buffer->last;
+				--bufferCount;
+				break;
+			}
+
+			link = &buffer->last;
+		}
+
+		if (!buffer)
+		{
+			buffer = (RenderBuffer*)MemoryAlloc(sizeof(RenderBuffer));
+			if (!buffer)
+				return NULL;
+
+			buffer->width = width;
+			buffer->height = height;
+
+			// Sections large enough to cover a surface get pages of their own, so they can be write-protected while aliased
+			DWORD size = pitch * height;
+			buffer->isPaged = hHandler && size >= GDI_PAGED;
+			buffer->data = buffer->isPaged
+				? (WORD*)VirtualAlloc(NULL, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE)
+				: (WORD*)AlignedAlloc(size);
+
+			if (!buffer->data)
+			{
+				MemoryFree(buffer);
+				return NULL;
+			}
+		}
+
+		buffer->last = NULL;
+		buffer->alias = NULL;
+		buffer->nextAlias = NULL;
+
+		*ppvBits = buffer->data;
+		return (HBITMAP)buffer;
+	}
+
+	VOID DeleteSection(RenderBuffer* buffer)
+	{
+		if (!buffer)
+			return;
+
+		if (buffer->alias)
+			Detach(buffer->alias);
+
+		if (bufferCount != GDI_POOL)
+		{
+			buffer->last = bufferPool;
+			bufferPool = buffer;
+			++bufferCount;
+		}
+		else
+		{
+			if (buffer->isPaged)
+				VirtualFree(buffer->data, 0, MEM_RELEASE);
+			else
+				AlignedFree(buffer->data);
+
+			MemoryFree(buffer);
+		}
+	}
+
+	HDC CreateContext()
+	{
+		RenderDC* dc = dcPool;
+		if (dc)
+			dcPool = dc->last;
+		else
+		{
+			dc = (RenderDC*)MemoryAlloc(sizeof(RenderDC));
+			if (!dc)
+				return NULL;
+		}
+
+		dc->last = NULL;
+		dc->buffer = NULL;
+		return (HDC)dc;
+	}
+
+	VOID DeleteContext(RenderDC* dc)
+	{
+		dc->last = dcPool;
+		dcPool = dc;
+	}
+
+	BOOL Attach(OpenDrawSurface* surface, RenderBuffer* buffer)
+	{
+		BOOL res = FALSE;
+		EnterCriticalSection(&section);
+		{
+			DWORD old;
+			if (VirtualProtect(buffer->data, GetSize(buffer), PAGE_READONLY, &old))
+			{
+				surface->ownBuffer = surface->indexBuffer;
+				surface->indexBuffer = buffer->data;
+				surface->alias = buffer;
+
+				buffer->alias = surface;
+				buffer->nextAlias = aliasList;
+				aliasList = buffer;
+
+				res = TRUE;
+			}
+		}
+		LeaveCriticalSection(&section);
+
+		return res;
+	}
+
+	VOID Detach(OpenDrawSurface* surface)
+	{
+		if (!surface->alias)
+			return;
+
+		EnterCriticalSection(&section);
+		{
+			RenderBuffer* buffer = surface->alias;
+			if (buffer)
+			{
+				RenderBuffer** link = &aliasList;
+				while (*link != buffer)
+					link = &(*link)->nextAlias;
+				*link = buffer->nextAlias;
+
+				// Nothing could write the section since it was blitted, it still holds exactly that image
+				DWORD old;
+				VirtualProtect(buffer->data, GetSize(buffer), PAGE_READWRITE, &old);
+				MemoryCopy(surface->ownBuffer, buffer->data, surface->pitch * surface->height);
+
+				surface->indexBuffer = surface->ownBuffer;
+				surface->ownBuffer = NULL;
+				surface->alias = NULL;
+
+				buffer->alias = NULL;
+				buffer->nextAlias = NULL;
+			}
+		}
+		LeaveCriticalSection(&section);
+	}
+
+	VOID Blit(OpenDrawSurface* surface, INT x, INT y, INT cx, INT cy, RenderBuffer* buffer, INT x1, INT y1, DWORD rop)
+	{
+		if (!surface->indexBuffer)
+			return;
+
+		BOOL isFill = rop == BLACKNESS || rop == WHITENESS;
+		if (!isFill && !buffer)
+			return;
+
+		if (x < 0)
+		{
+			x1 -= x;
+			cx += x;
+			x = 0;
+		}
+
+		if (y < 0)
+		{
+			y1 -= y;
+			cy += y;
+			y = 0;
+		}
+
+		if (x + cx > (INT)surface->width)
+			cx = (INT)surface->width - x;
+
+		if (y + cy > (INT)surface->height)
+			cy = (INT)surface->height - y;
+
+		if (!isFill)
+		{
+			if (x1 < 0)
+			{
+				x -= x1;
+				cx += x1;
+				x1 = 0;
+			}
+
+			if (y1 < 0)
+			{
+				y -= y1;
+				cy += y1;
+				y1 = 0;
+			}
+
+			if (x1 + cx > (INT)buffer->width)
+				cx = (INT)buffer->width - x1;
+
+			if (y1 + cy > (INT)buffer->height)
+				cy = (INT)buffer->height - y1;
+		}
+
+		if (cx <= 0 || cy <= 0)
+			return;
+
+		DWORD dPitch = surface->pitch / sizeof(WORD);
+		if (isFill)
+		{
+			Detach(surface);
+			FillBlock(surface->indexBuffer + y * dPitch + x, dPitch, rop == WHITENESS ? 0xFFFF : 0x0000, cx, cy);
+		}
+		else
+		{
+			// Other raster operations are not emulated, they copy like SRCCOPY as the original hook did
+			BOOL isCover = rop == SRCCOPY && buffer->isPaged
+				&& !x && !y && !x1 && !y1
+				&& cx == (INT)surface->width && cy == (INT)surface->height
+				&& buffer->height == surface->height && buffer->width * sizeof(WORD) == surface->pitch;
+
+			if (!isCover || surface->alias != buffer)
+			{
+				Detach(surface);
+
+				// The attached surface is read by presentation and always keeps its own pixels
+				if (!isCover || buffer->alias || ((OpenDraw*)surface->ddraw)->attachedSurface == surface || !Attach(surface, buffer))
+					CopyBlock(surface->indexBuffer + y * dPitch + x, dPitch, buffer->data + y1 * buffer->width + x1, buffer->width, cx, cy);
+			}
+		}
+
+		RECT rc = { x, y, x + cx, y + cy };
+		surface->Damage(&rc);
+	}
+}
\ No newline at end of file
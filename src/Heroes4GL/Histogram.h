@@ -0,0 +1,57 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include "Allocation.h"
+#include "ExtraTypes.h"
+
+#define HISTOGRAM_INTERVAL 100
+
+class Histogram : public Allocation
+{
+private:
+	CRITICAL_SECTION section;
+	volatile BOOL isEnabled;
+	volatile LONG version;
+	LevelColors levels[256];
+
+	DWORD width;
+	DWORD height;
+	DWORD depth;
+	FpsMode format;
+	BYTE* shadow;
+	RECT dirty;
+	DWORD next;
+
+	VOID Reset(DWORD, DWORD, FpsMode);
+	DWORD Sample(const BYTE*, BYTE*, DWORD);
+
+public:
+	Histogram();
+	~Histogram();
+
+	VOID Enable(BOOL);
+	VOID Update(const VOID*, DWORD, DWORD, DWORD, FpsMode, const RECT*);
+	BOOL Get(LevelColorsFloat*, LONG*);
+};
\ No newline at end of file
@@ -30,6 +30,8 @@
 #include "Window.h"
 #include "Hooker.h"
 #include "Mods.h"
+#include "Registry.h"
+#include "Gdi.h"
 
 #define STYLE_FULL_OLD (WS_VISIBLE | WS_POPUP)
 #define STYLE_FULL_NEW (WS_VISIBLE | WS_POPUP | WS_SYSMENU | WS_CLIPSIBLINGS)
@@ -37,6 +39,10 @@
 #define STYLE_WIN_OLD (WS_VISIBLE | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX)
 #define STYLE_WIN_NEW (WS_VISIBLE | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX | WS_MAXIMIZEBOX | WS_SIZEBOX)
 
+#define SPACE_NONE 0
+#define SPACE_DEFAULT 1
+#define SPACE_EQUAL 2
+
 const AddressSpace addressArray[] = {
 // === RUS ======================================================================================================================================
 #pragma region RUS
@@ -382,12 +388,16 @@ namespace Hooks
 		return FALSE;
 	}
 
+	IdleGovernor* idleGovernor;
 	BOOL __stdcall PeekMessageHook(LPMSG lpMsg, HWND hWnd, UINT wMsgFilterMin, UINT wMsgFilterMax, UINT wRemoveMsg)
 	{
 		if (PeekMessage(lpMsg, hWnd, wMsgFilterMin, wMsgFilterMax, wRemoveMsg))
 			return TRUE;
 
-		Sleep(config.coldCPU);
+		if (config.coldCPU)
+			idleGovernor->Wait();
+		else
+			Sleep(0);
 
 		return FALSE;
 	}
@@ -395,42 +405,24 @@ namespace Hooks
 #pragma region GDI hooks
 	HBITMAP __stdcall CreateDIBSectionHook(HDC hdc, const BITMAPINFO* lpbmi, UINT usage, VOID** ppvBits, HANDLE hSection, DWORD offset)
 	{
-		RenderBuffer* buffer = (RenderBuffer*)MemoryAlloc(sizeof(RenderBuffer));
-		{
-			buffer->width = (DWORD)lpbmi->bmiHeader.biWidth;
-			buffer->height = (DWORD)-lpbmi->bmiHeader.biHeight;
-
-			DWORD pitch = buffer->width * sizeof(WORD);
-			if (pitch & 3)
-				pitch = (pitch & 0xFFFFFFFC) + 4;
-			buffer->width = pitch / sizeof(WORD);
-
-			DWORD size = buffer->width * buffer->height * sizeof(WORD);
-			*ppvBits = buffer->data = (WORD*)AlignedAlloc(size);
-		}
-		return (HBITMAP)buffer;
+		return Gdi::CreateSection(lpbmi, ppvBits);
 	}
 
 	BOOL __stdcall DeleteObjectHook(HGDIOBJ ho)
 	{
-		RenderBuffer* buffer = (RenderBuffer*)ho;
-		AlignedFree(buffer->data);
-		MemoryFree(buffer);
-
+		Gdi::DeleteSection((RenderBuffer*)ho);
 		return TRUE;
 	}
 
 	HDC __stdcall CreateCompatibleDCHook(HDC hdc)
 	{
-		RenderDC* res = (RenderDC*)MemoryAlloc(sizeof(RenderDC));
-		res->buffer = NULL;
-		return (HDC)res;
+		return Gdi::CreateContext();
 	}
 
 	BOOL __stdcall DeleteDCHook(HDC hdc)
 	{
 		if (hdc)
-			MemoryFree(hdc);
+			Gdi::DeleteContext((RenderDC*)hdc);
 		return TRUE;
 	}
 
@@ -443,38 +435,16 @@ namespace Hooks
 
 	BOOL __stdcall BitBltHook(OpenDrawSurface* hdc, INT x, INT y, INT cx, INT cy, HDC hdcSrc, INT x1, INT y1, DWORD rop)
 	{
-		OpenDrawSurface* surface = (OpenDrawSurface*)hdc;
-		RenderBuffer* buffer = ((RenderDC*)hdcSrc)->buffer;
-
-		DWORD sPitch = buffer->width * sizeof(WORD);
-		if (sPitch & 3)
-			sPitch = (sPitch & 0xFFFFFFFC) + 4;
-		sPitch /= sizeof(WORD);
-		DWORD dPitch = surface->pitch / sizeof(WORD);
-
-		INT width = cx;
-		INT height = cy;
-
-		WORD* source = buffer->data + y1 * sPitch + x1;
-		WORD* destination = surface->indexBuffer + y * dPitch + x;
-
-		DWORD copyHeight = height;
-		do
-		{
-			MemoryCopy(destination, source, width << 1);
-			source += sPitch;
-			destination += dPitch;
-		} while (--copyHeight);
-
+		Gdi::Blit(hdc, x, y, cx, cy, hdcSrc ? ((RenderDC*)hdcSrc)->buffer : NULL, x1, y1, rop);
 		return TRUE;
 	}
+
 #pragma endregion
 
 #pragma region Registry
 	struct {
 		BOOL type;
 		HKEY path;
-		BOOL calc;
 		CHAR sub[256];
 		CHAR cls[16];
 	} regKey;
@@ -505,71 +475,33 @@ namespace Hooks
 
 	LSTATUS __stdcall RegQueryValueExHook(HKEY hKey, LPCSTR lpValueName, LPDWORD lpReserved, LPDWORD lpType, LPBYTE lpData, LPDWORD lpcbData)
 	{
-		DWORD size = *lpcbData;
-
-		if (!Config::Check(CONFIG_APP, lpValueName))
+		LSTATUS res = Registry::Query(lpValueName, lpType, lpData, lpcbData);
+		if (res == ERROR_FILE_NOT_FOUND)
 		{
 			DWORD dwDisposition;
 
-			LSTATUS res = regKey.type ? RegCreateKeyEx(regKey.path, regKey.sub, NULL, regKey.cls, REG_OPTION_NON_VOLATILE, KEY_ALL_ACCESS, NULL, &hKey, &dwDisposition) : RegOpenKeyEx(regKey.path, regKey.sub, NULL, KEY_EXECUTE, &hKey);
+			res = regKey.type ? RegCreateKeyEx(regKey.path, regKey.sub, NULL, regKey.cls, REG_OPTION_NON_VOLATILE, KEY_ALL_ACCESS, NULL, &hKey, &dwDisposition) : RegOpenKeyEx(regKey.path, regKey.sub, NULL, KEY_EXECUTE, &hKey);
 
 			if (!res)
 			{
-				res = RegQueryValueEx(hKey, lpValueName, lpReserved, lpType, lpData, lpcbData);
+				DWORD type;
+				res = RegQueryValueEx(hKey, lpValueName, lpReserved, &type, lpData, lpcbData);
 				RegCloseKey(hKey);
 
-				if (size)
-				{
-					if (size == sizeof(DWORD))
-						Config::Set(CONFIG_APP, lpValueName, *(INT*)lpData);
-					else
-						Config::Set(CONFIG_APP, lpValueName, (CHAR*)lpData);
-				}
-			}
-
-			return res;
-		}
-		else
-		{
-			if (!size)
-			{
-				*lpType = REG_SZ;
+				if (lpType)
+					*lpType = type;
 
-				CHAR buff[256];
-				Config::Get(CONFIG_APP, lpValueName, "", buff, sizeof(buff));
-				*lpcbData = StrLength(buff) + 1;
-
-				regKey.calc = TRUE;
+				if (!res && lpData && lpcbData)
+					Registry::Set(lpValueName, type, lpData, *lpcbData);
 			}
-			else
-			{
-				if (!regKey.calc && size == sizeof(DWORD))
-				{
-					*(INT*)lpData = Config::Get(CONFIG_APP, lpValueName, *(INT*)lpData);
-					if (lpType)
-						*lpType = REG_DWORD;
-				}
-				else
-				{
-					Config::Get(CONFIG_APP, lpValueName, "", (CHAR*)lpData, *lpcbData);
-					if (lpType)
-						*lpType = *lpcbData ? REG_BINARY : REG_SZ;
-				}
-
-				regKey.calc = FALSE;
-			}
-
-			return ERROR_SUCCESS;
 		}
+
+		return res;
 	}
 
 	LSTATUS __stdcall RegSetValueExHook(HKEY hKey, LPCSTR lpValueName, DWORD Reserved, DWORD dwType, const BYTE* lpData, DWORD cbData)
 	{
-		if (dwType == REG_DWORD)
-			Config::Set(CONFIG_APP, lpValueName, *(INT*)lpData);
-		else
-			Config::Set(CONFIG_APP, lpValueName, (CHAR*)lpData);
-
+		Registry::Set(lpValueName, dwType, lpData, cbData);
 		return ERROR_SUCCESS;
 	}
 #pragma endregion
@@ -600,40 +532,83 @@ namespace Hooks
 	BOOL __stdcall ReleaseCaptureHook() { return FALSE; }
 #pragma endregion
 
+#pragma region Image index
+	BOOL GetImageKey(HMODULE hModule, CHAR* key)
+	{
+		PIMAGE_DOS_HEADER headDos = (PIMAGE_DOS_HEADER)hModule;
+		if (headDos->e_magic != IMAGE_DOS_SIGNATURE)
+			return FALSE;
+
+		PIMAGE_NT_HEADERS headNT = (PIMAGE_NT_HEADERS)((BYTE*)hModule + headDos->e_lfanew);
+		if (headNT->Signature != IMAGE_NT_SIGNATURE)
+			return FALSE;
+
+		StrPrint(key, "%08X%08X%08X", headNT->FileHeader.TimeDateStamp, headNT->OptionalHeader.SizeOfImage, headNT->OptionalHeader.AddressOfEntryPoint);
+		return TRUE;
+	}
+
+	DWORD CheckSpace(HOOKER hooker, const AddressSpace* space)
+	{
+		DWORD check[3];
+		if (ReadDWord(hooker, space->check[0] + 1, &check[0]) && check[0] == STYLE_FULL_OLD && ReadDWord(hooker, space->check[1] + 1, &check[1]) && check[1] == STYLE_FULL_OLD)
+		{
+			if (!space->equal.address)
+				return SPACE_DEFAULT;
+			else if (ReadDWord(hooker, space->equal.address, &check[2]) && check[2] == space->equal.value)
+				return SPACE_EQUAL;
+		}
+
+		return SPACE_NONE;
+	}
+#pragma endregion
+
 #pragma optimize("s", on)
 	BOOL Load()
 	{
 		BOOL res = FALSE;
 
-		const AddressSpace* defaultSpace = NULL;
-		const AddressSpace* equalSpace = NULL;
-
 		HOOKER hooker = CreateHooker(GetModuleHandle(NULL));
 		if (hooker)
 		{
-			hookSpace = addressArray;
+			HMODULE hModule = GetHookerModule(hooker);
+			Config::Open(hModule);
+
+			// Known executables are matched by their PE header, only the remembered entry is probed
+			CHAR imageKey[32];
+			BOOL isImage = GetImageKey(hModule, imageKey);
 			DWORD hookCount = sizeof(addressArray) / sizeof(AddressSpace);
-			do
+			DWORD index = isImage ? Config::Get(CONFIG_IMAGES, imageKey, 0) : 0;
+			if (index && index <= hookCount && CheckSpace(hooker, addressArray + index - 1))
+				hookSpace = addressArray + index - 1;
+			else
 			{
-				DWORD check[3];
-				if (ReadDWord(hooker, hookSpace->check[0] + 1, &check[0]) && check[0] == STYLE_FULL_OLD && ReadDWord(hooker, hookSpace->check[1] + 1, &check[1]) && check[1] == STYLE_FULL_OLD)
+				const AddressSpace* defaultSpace = NULL;
+				const AddressSpace* equalSpace = NULL;
+
+				hookSpace = addressArray;
+				do
 				{
-					if (!hookSpace->equal.address)
+					DWORD space = CheckSpace(hooker, hookSpace);
+					if (space == SPACE_DEFAULT)
 						defaultSpace = hookSpace;
-					else if (ReadDWord(hooker, hookSpace->equal.address, &check[2]) && check[2] == hookSpace->equal.value)
+					else if (space == SPACE_EQUAL)
 					{
 						equalSpace = hookSpace;
 						break;
 					}
-				}
 
-				++hookSpace;
-			} while (--hookCount);
+					++hookSpace;
+				} while (--hookCount);
+
+				hookSpace = equalSpace ? equalSpace : defaultSpace;
+				if (hookSpace && isImage && !config.isDDraw)
+					Config::Set(CONFIG_IMAGES, imageKey, (INT)(hookSpace - addressArray) + 1);
+			}
 
-			hookSpace = equalSpace ? equalSpace : defaultSpace;
 			if (hookSpace)
 			{
-				Config::Load(GetHookerModule(hooker), hookSpace);
+				Config::Load(hModule, hookSpace);
+				idleGovernor = new IdleGovernor();
 
 				HOOKER user = CreateHooker(GetModuleHandle("USER32.dll"));
 				if (user)
@@ -767,5 +742,11 @@ namespace Hooks
 
 		return res;
 	}
+
+	VOID Release()
+	{
+		if (idleGovernor)
+			delete idleGovernor;
+	}
 #pragma optimize("", on)
 }
\ No newline at end of file
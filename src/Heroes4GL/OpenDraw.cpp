@@ -29,9 +29,17 @@
 #include "Main.h"
 #include "Config.h"
 #include "Window.h"
+#include "Hooks.h"
 #include "ShaderGroup.h"
 #include "PixelBuffer.h"
 #include "FpsCounter.h"
+#include "FramePacer.h"
+#include "Resampler.h"
+#include "ColorTable.h"
+#include "Snapshot.h"
+#include "Recorder.h"
+#include "Ini.h"
+#include "Convert.h"
 
 DWORD GetPow2(DWORD value)
 {
@@ -41,6 +49,14 @@ DWORD GetPow2(DWORD value)
 	return res;
 }
 
+VOID WaitResize(OpenDraw* ddraw)
+{
+	SetEvent(ddraw->hResizeEvent);
+	do
+		WaitForSingleObject(ddraw->hDrawEvent, INFINITE);
+	while (ddraw->isResized && !ddraw->isFinish);
+}
+
 DWORD __stdcall RenderThread(LPVOID lpParameter)
 {
 	OpenDraw* ddraw = (OpenDraw*)lpParameter;
@@ -114,12 +130,20 @@ DWORD __stdcall RenderThread(LPVOID lpParameter)
 							break;
 						}
 
-						if (config.gl.version.value >= GL_VER_3_0)
-							ddraw->RenderNew();
-						else if (config.gl.version.value >= GL_VER_2_0)
-							ddraw->RenderMid();
-						else
-							ddraw->RenderOld();
+						do
+						{
+							if (config.gl.version.value >= GL_VER_3_0)
+								ddraw->RenderNew();
+							else if (config.gl.version.value >= GL_VER_2_0)
+								ddraw->RenderMid();
+							else
+								ddraw->RenderOld();
+
+							if (ddraw->isFinish || !ddraw->isResized)
+								break;
+
+							WaitResize(ddraw);
+						} while (!ddraw->isFinish);
 
 						wglMakeCurrent(ddraw->hDc, NULL);
 					}
@@ -132,7 +156,10 @@ DWORD __stdcall RenderThread(LPVOID lpParameter)
 			break;
 		}
 
-		Sleep(0);
+		if (ddraw->isResized)
+			WaitResize(ddraw);
+		else
+			Sleep(0);
 	} while (!ddraw->isFinish);
 
 	return NULL;
@@ -222,6 +249,38 @@ VOID OpenDraw::RenderOld()
 		GLEnable(GL_TEXTURE_2D);
 		GLClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
+		// All tiles are drawn from one display list, textures are bound only for tiles with changed pixels
+		GLuint frameList = GLGenLists(1);
+		GLuint bound = frames[frameCount - 1].id;
+		GLNewList(frameList, GL_COMPILE);
+		{
+			DWORD count = frameCount;
+			frame = frames;
+			while (count--)
+			{
+				if (frameCount != 1)
+					GLBindTexture(GL_TEXTURE_2D, frame->id);
+
+				GLBegin(GL_TRIANGLE_FAN);
+				{
+					GLTexCoord2f(0.0f, 0.0f);
+					GLVertex2s(frame->rect.x, frame->rect.y);
+
+					GLTexCoord2f(frame->tSize.width, 0.0f);
+					GLVertex2s(frame->vSize.width, frame->rect.y);
+
+					GLTexCoord2f(frame->tSize.width, frame->tSize.height);
+					GLVertex2s(frame->vSize.width, frame->vSize.height);
+
+					GLTexCoord2f(0.0f, frame->tSize.height);
+					GLVertex2s(frame->rect.x, frame->vSize.height);
+				}
+				GLEnd();
+				++frame;
+			}
+		}
+		GLEndList();
+
 		BOOL isVSync = FALSE;
 		if (WGLSwapInterval)
 			WGLSwapInterval(0);
@@ -230,7 +289,10 @@ VOID OpenDraw::RenderOld()
 
 		BOOL isDirectUpdate = config.gl.version.value <= GL_VER_1_1;
 		FpsCounter* fpsCounter = new FpsCounter(isDirectUpdate ? FpsRgba : FpsRgb, this->textureWidth);
-		PixelBuffer* pixelBuffer = new PixelBuffer(this->textureWidth, this->mode->height, isDirectUpdate, isDirectUpdate ? GL_RGBA : GL_RGB, config.updateMode);
+		FramePacer* pacer = new FramePacer(config.frameLatency);
+		UpdateMode updateMode = PixelBuffer::Tune(this->textureWidth, this->mode->height, isDirectUpdate, isDirectUpdate ? GL_RGBA : GL_RGB);
+		PixelBuffer* pixelBuffer = new PixelBuffer(this->textureWidth, this->mode->height, isDirectUpdate, isDirectUpdate ? GL_RGBA : GL_RGB, updateMode);
+		ColorTable* colorTable = new ColorTable(this->pitch, this->mode->height, FpsRgb);
 		{
 			do
 			{
@@ -275,92 +337,111 @@ VOID OpenDraw::RenderOld()
 					clear = 0;
 				}
 
-				if (clear++ <= 1)
+				BOOL isRedraw = clear++ <= 1;
+				if (isRedraw)
 					GLClear(GL_COLOR_BUFFER_BIT);
 
+				VOID* frameData = this->frames->Acquire();
+				VOID* drawData = colorTable->Apply(frameData, this->frames->GetChanged());
 				if (isDirectUpdate)
 				{
-					BYTE* srcData = (BYTE*)surface->indexBuffer;
+					BYTE* srcData = (BYTE*)drawData;
 					DWORD* dstData = (DWORD*)pixelBuffer->GetBuffer();
 					DWORD copyHeight = this->mode->height;
 					do
 					{
-						WORD* src = (WORD*)srcData;
+						Rgb565ToRgba((const uint16_t*)srcData, (uint32_t*)dstData, this->mode->width);
 						srcData += this->pitch;
-
-						DWORD* dst = dstData;
 						dstData += textureWidth;
-
-						DWORD count = this->mode->width;
-						do
-						{
-							WORD px = *src++;
-							*dst++ = ((px & 0xF800) >> 8) | ((px & 0x07E0) << 5) | ((px & 0x001F) << 19);
-						} while (--count);
 					} while (--copyHeight);
 				}
 				else
-					pixelBuffer->Copy(surface->indexBuffer);
+					pixelBuffer->Copy(drawData);
 
+				fpsCounter->latency = pacer->latency;
+				if (Hooks::idleGovernor)
+				{
+					fpsCounter->idle = Hooks::idleGovernor->idle;
+					fpsCounter->idleLatency = Hooks::idleGovernor->latency;
+				}
 				fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
 
-				DWORD count = frameCount;
-				frame = frames;
-				while (count--)
+				BOOL isDamaged = FALSE;
+				if (frameCount == 1)
+				{
+					if (glFilter)
+					{
+						GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glFilter);
+						GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glFilter);
+						fpsCounter->changes += 2;
+					}
+
+					isDamaged = pixelBuffer->Update();
+				}
+				else
 				{
-					if (frameCount == 1)
+					DWORD count = frameCount;
+					frame = frames;
+					while (count--)
 					{
 						if (glFilter)
 						{
+							GLBindTexture(GL_TEXTURE_2D, frame->id);
 							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glFilter);
 							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glFilter);
+							fpsCounter->changes += 3;
+							bound = frame->id;
 						}
 
-						pixelBuffer->Update();
-					}
-					else
-					{
-						GLBindTexture(GL_TEXTURE_2D, frame->id);
-
-						if (glFilter)
+						// Clean tiles skip both the bind and the upload
+						if (pixelBuffer->Update(&frame->align, frame->id != bound ? frame->id : 0))
 						{
-							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glFilter);
-							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glFilter);
+							if (frame->id != bound)
+							{
+								bound = frame->id;
+								++fpsCounter->changes;
+							}
+
+							isDamaged = TRUE;
 						}
 
-						pixelBuffer->Update(&frame->align);
+						++frame;
 					}
+				}
 
-					GLBegin(GL_TRIANGLE_FAN);
-					{
-						GLTexCoord2f(0.0f, 0.0f);
-						GLVertex2s(frame->rect.x, frame->rect.y);
+				RECT damage = *pixelBuffer->GetDamage();
+				this->histogram->Update(frameData, this->mode->width, this->mode->height, this->pitch, FpsRgb, &damage);
+				pixelBuffer->SwapBuffers();
 
-						GLTexCoord2f(frame->tSize.width, 0.0f);
-						GLVertex2s(frame->vSize.width, frame->rect.y);
+				if (isRedraw || isDamaged || config.fps == FpsBenchmark)
+				{
+					GLCallList(frameList);
+					++fpsCounter->draws;
+					if (frameCount != 1)
+					{
+						fpsCounter->changes += frameCount;
+						bound = frames[frameCount - 1].id;
+					}
 
-						GLTexCoord2f(frame->tSize.width, frame->tSize.height);
-						GLVertex2s(frame->vSize.width, frame->vSize.height);
+					if (isSnapshot)
+						surface->TakeSnapshot();
 
-						GLTexCoord2f(0.0f, frame->tSize.height);
-						GLVertex2s(frame->rect.x, frame->vSize.height);
-					}
-					GLEnd();
-					++frame;
+					this->Present(isRedraw ? NULL : &damage);
+					pacer->Submit(this->frames->GetStamp());
 				}
+				else
+					++fpsCounter->elided;
 
-				if (isSnapshot)
-					surface->TakeSnapshot();
-
-				pixelBuffer->SwapBuffers();
-				SwapBuffers(this->hDc);
 				if (clear > 1 && config.fps != FpsBenchmark)
 					WaitForSingleObject(this->hDrawEvent, INFINITE);
-				GLFinish();
-			} while (!this->isFinish);
+			} while (!this->isFinish && !this->isResized);
 		}
 		delete pixelBuffer;
+		delete colorTable;
 		delete fpsCounter;
+		delete pacer;
+
+		GLDeleteLists(frameList, 1);
 
 		frame = frames;
 		DWORD count = frameCount;
@@ -465,7 +546,9 @@ VOID OpenDraw::RenderMid()
 					DWORD clear = 0;
 
 					FpsCounter* fpsCounter = new FpsCounter(FpsRgb, this->textureWidth);
-					PixelBuffer* pixelBuffer = new PixelBuffer(this->textureWidth, this->mode->height, FALSE, GL_RGB, config.updateMode);
+					FramePacer* pacer = new FramePacer(config.frameLatency);
+					UpdateMode updateMode = PixelBuffer::Tune(this->textureWidth, this->mode->height, FALSE, GL_RGB);
+					PixelBuffer* pixelBuffer = new PixelBuffer(this->textureWidth, this->mode->height, FALSE, GL_RGB, updateMode);
 					{
 						do
 						{
@@ -507,7 +590,8 @@ VOID OpenDraw::RenderMid()
 								clear = 0;
 							}
 
-							if (clear++ <= 1)
+							BOOL isRedraw = clear++ <= 1;
+							if (isRedraw)
 								GLClear(GL_COLOR_BUFFER_BIT);
 
 							if (state.flags)
@@ -537,26 +621,40 @@ VOID OpenDraw::RenderMid()
 							}
 
 							// NEXT UNCHANGED
+							VOID* frameData = this->frames->Acquire();
+							pixelBuffer->Copy(frameData);
+							fpsCounter->latency = pacer->latency;
+							if (Hooks::idleGovernor)
 							{
-								pixelBuffer->Copy(surface->indexBuffer);
-								fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
-								pixelBuffer->Update();
-								pixelBuffer->SwapBuffers();
+								fpsCounter->idle = Hooks::idleGovernor->idle;
+								fpsCounter->idleLatency = Hooks::idleGovernor->latency;
+							}
+							fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
+							BOOL isDamaged = pixelBuffer->Update();
+							RECT damage = *pixelBuffer->GetDamage();
+							this->histogram->Update(frameData, this->mode->width, this->mode->height, this->pitch, FpsRgb, &damage);
+							pixelBuffer->SwapBuffers();
 
+							if (isRedraw || isDamaged || config.fps == FpsBenchmark)
+							{
 								GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-							}
 
-							if (isSnapshot)
-								surface->TakeSnapshot();
+								if (isSnapshot)
+									surface->TakeSnapshot();
+
+								this->Present(isRedraw ? NULL : &damage);
+								pacer->Submit(this->frames->GetStamp());
+							}
+							else
+								++fpsCounter->elided;
 
-							SwapBuffers(this->hDc);
 							if (clear > 1 && config.fps != FpsBenchmark)
 								WaitForSingleObject(this->hDrawEvent, INFINITE);
-							GLFinish();
-						} while (!this->isFinish);
+						} while (!this->isFinish && !this->isResized);
 					}
 					delete pixelBuffer;
 					delete fpsCounter;
+					delete pacer;
 				}
 				GLDeleteTextures(1, &textureId);
 			}
@@ -588,11 +686,14 @@ VOID OpenDraw::RenderNew()
 		ShaderGroup* hermite;
 		ShaderGroup* cubic;
 		ShaderGroup* lanczos;
+		ShaderGroup* cubic_h;
+		ShaderGroup* lanczos_h;
 		ShaderGroup* xBRz_2x;
 		ShaderGroup* xBRz_3x;
 		ShaderGroup* xBRz_4x;
 		ShaderGroup* xBRz_5x;
 		ShaderGroup* xBRz_6x;
+		ShaderGroup* xBRz_edge;
 		ShaderGroup* scaleHQ_2x;
 		ShaderGroup* scaleHQ_4x;
 		ShaderGroup* xSal_2x;
@@ -602,13 +703,16 @@ VOID OpenDraw::RenderNew()
 	} shaders = {
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LINEAR_FRAGMENT, SHADER_LEVELS),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_HERMITE_FRAGMENT, SHADER_TEXSIZE | SHADER_LEVELS),
-		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_CUBIC_FRAGMENT, SHADER_TEXSIZE | SHADER_LEVELS),
-		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LANCZOS_FRAGMENT, SHADER_TEXSIZE | SHADER_LEVELS),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_CUBIC_FRAGMENT_VERTICAL, SHADER_TEXSIZE | SHADER_LEVELS),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LANCZOS_FRAGMENT_VERTICAL, SHADER_TEXSIZE | SHADER_LEVELS),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_CUBIC_FRAGMENT_HORIZONTAL, SHADER_TEXSIZE),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LANCZOS_FRAGMENT_HORIZONTAL, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_2X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_3X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_4X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_5X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_6X, SHADER_TEXSIZE),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_EDGE, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_SCALEHQ_FRAGMENT_2X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_SCALEHQ_FRAGMENT_4X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XSAL_FRAGMENT, SHADER_TEXSIZE),
@@ -619,6 +723,7 @@ VOID OpenDraw::RenderNew()
 
 	ShaderGroup* program = NULL;
 	ShaderGroup* upscaleProgram = NULL;
+	ShaderGroup* passProgram = NULL;
 	{
 		GLuint arrayName;
 		GLGenVertexArrays(1, &arrayName);
@@ -631,7 +736,7 @@ VOID OpenDraw::RenderNew()
 					GLBindBuffer(GL_ARRAY_BUFFER, bufferName);
 					{
 						{
-							FLOAT buffer[8][8] = {
+							FLOAT buffer[16][8] = {
 								{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
 								{ (FLOAT)this->mode->width, 0.0f, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
 								{ (FLOAT)this->mode->width, (FLOAT)this->mode->height, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
@@ -640,7 +745,17 @@ VOID OpenDraw::RenderNew()
 								{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f },
 								{ (FLOAT)this->mode->width, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
 								{ (FLOAT)this->mode->width, (FLOAT)this->mode->height, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f },
-								{ 0.0f, (FLOAT)this->mode->height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f }
+								{ 0.0f, (FLOAT)this->mode->height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+
+								{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, texHeight, 0.0f, 0.0f },
+								{ (FLOAT)this->mode->width, 0.0f, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
+								{ (FLOAT)this->mode->width, (FLOAT)this->mode->height, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
+								{ 0.0f, (FLOAT)this->mode->height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+
+								{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+								{ (FLOAT)this->mode->width, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+								{ (FLOAT)this->mode->width, (FLOAT)this->mode->height, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
+								{ 0.0f, (FLOAT)this->mode->height, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f }
 							};
 
 							{
@@ -651,7 +766,7 @@ VOID OpenDraw::RenderNew()
 									{ -1.0f, 1.0f, -1.0f, 1.0f }
 								};
 
-								for (DWORD i = 0; i < 8; ++i)
+								for (DWORD i = 0; i < 16; ++i)
 								{
 									FLOAT* vector = &buffer[i][0];
 									for (DWORD j = 0; j < 4; ++j)
@@ -680,6 +795,7 @@ VOID OpenDraw::RenderNew()
 							GLuint primary;
 							GLuint secondary;
 							GLuint buffer;
+							GLuint edge;
 						} texId;
 
 						GLGenTextures(1, &texId.primary);
@@ -703,9 +819,13 @@ VOID OpenDraw::RenderNew()
 							DWORD clear = 0;
 
 							FpsCounter* fpsCounter = new FpsCounter(FpsRgb, this->textureWidth);
-							PixelBuffer* firstBuffer = new PixelBuffer(this->textureWidth, this->mode->height, FALSE, GL_RGB, config.updateMode);
+							FramePacer* pacer = new FramePacer(config.frameLatency);
+							Resampler* resampler = NULL;
+							UpdateMode updateMode = PixelBuffer::Tune(this->textureWidth, this->mode->height, FALSE, GL_RGB);
+							PixelBuffer* firstBuffer = new PixelBuffer(this->textureWidth, this->mode->height, FALSE, GL_RGB, updateMode);
 							{
 								GLuint fboId = 0;
+								GLuint edgeId = 0;
 								DWORD viewSize;
 								BOOL activeIndex;
 								VOID* emptyBuffer;
@@ -745,7 +865,15 @@ VOID OpenDraw::RenderNew()
 									if (state.flags || isFps || isSnapshot)
 										clear = 0;
 
+									// Only the separable kernels render through the resampler, release its targets once another filter is chosen
+									if (state.flags && resampler && state.interpolation != InterpolateCubic && state.interpolation != InterpolateLanczos)
+									{
+										delete resampler;
+										resampler = NULL;
+									}
+
 									PixelBuffer* pixelBuffer;
+									BOOL isRedraw = TRUE;
 
 									if (state.upscaling)
 									{
@@ -815,7 +943,7 @@ VOID OpenDraw::RenderNew()
 												viewSize = MAKELONG(this->mode->width * state.value, this->mode->height * state.value);
 												activeIndex = TRUE;
 												firstBuffer->Reset();
-												secondBuffer = new PixelBuffer(this->textureWidth, this->mode->height, FALSE, GL_RGB, config.updateMode);
+												secondBuffer = new PixelBuffer(this->textureWidth, this->mode->height, FALSE, GL_RGB, updateMode);
 
 												DWORD size = this->pitch * this->mode->height;
 												emptyBuffer = AlignedAlloc(size);
@@ -878,6 +1006,42 @@ VOID OpenDraw::RenderNew()
 													GLTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, LOWORD(viewSize), HIWORD(viewSize), GL_NONE, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 												}
 											}
+
+											// Edge classification targets exist only while xBRZ reads them
+											if (state.upscaling == UpscaleXRBZ)
+											{
+												if (!edgeId)
+												{
+													GLGenTextures(1, &texId.edge);
+													GLBindTexture(GL_TEXTURE_2D, texId.edge);
+													{
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+														GLTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->mode->width, this->mode->height, GL_NONE, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+													}
+
+													// Edge classes stay bound on unit 2 for the xBRZ scaling pass
+													GLActiveTexture(GL_TEXTURE2);
+													GLBindTexture(GL_TEXTURE_2D, texId.edge);
+													GLActiveTexture(GL_TEXTURE0);
+
+													GLGenFramebuffers(1, &edgeId);
+													GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, edgeId);
+													GLFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texId.edge, 0);
+
+													GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
+												}
+											}
+											else if (edgeId)
+											{
+												GLDeleteTextures(1, &texId.edge);
+												GLDeleteFramebuffers(1, &edgeId);
+												edgeId = 0;
+											}
 										}
 										else
 											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
@@ -911,7 +1075,8 @@ VOID OpenDraw::RenderNew()
 											clear = 0;
 										}
 
-										if (clear++ <= 1)
+										isRedraw = clear++ <= 1;
+										if (isRedraw)
 											GLClear(GL_COLOR_BUFFER_BIT);
 
 										if (state.flags)
@@ -921,6 +1086,13 @@ VOID OpenDraw::RenderNew()
 												GLBindTexture(GL_TEXTURE_2D, texId.primary);
 												GLDeleteTextures(2, &texId.secondary);
 												GLDeleteFramebuffers(1, &fboId);
+												if (edgeId)
+												{
+													GLDeleteTextures(1, &texId.edge);
+													GLDeleteFramebuffers(1, &edgeId);
+													edgeId = 0;
+												}
+
 												AlignedFree(emptyBuffer);
 
 												firstBuffer->Reset();
@@ -933,15 +1105,19 @@ VOID OpenDraw::RenderNew()
 											{
 											case InterpolateHermite:
 												program = shaders.hermite;
+												passProgram = NULL;
 												break;
 											case InterpolateCubic:
 												program = shaders.cubic;
+												passProgram = shaders.cubic_h;
 												break;
 											case InterpolateLanczos:
 												program = shaders.lanczos;
+												passProgram = shaders.lanczos_h;
 												break;
 											default:
 												program = shaders.linear;
+												passProgram = NULL;
 												break;
 											}
 
@@ -956,108 +1132,155 @@ VOID OpenDraw::RenderNew()
 									}
 
 									// NEXT UNCHANGED
+									VOID* frameData = this->frames->Acquire();
+									pixelBuffer->Copy(frameData);
+									fpsCounter->latency = pacer->latency;
+									if (Hooks::idleGovernor)
 									{
-										pixelBuffer->Copy(surface->indexBuffer);
-										fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
-										pixelBuffer->Update();
-										pixelBuffer->SwapBuffers();
-
-										GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+										fpsCounter->idle = Hooks::idleGovernor->idle;
+										fpsCounter->idleLatency = Hooks::idleGovernor->latency;
 									}
+									fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
+									BOOL isDamaged = pixelBuffer->Update();
+									RECT damage = *pixelBuffer->GetDamage();
+									this->histogram->Update(frameData, this->mode->width, this->mode->height, this->pitch, FpsRgb, &damage);
+									pixelBuffer->SwapBuffers();
 
-									// Draw from FBO
-									if (state.upscaling)
+									if (isRedraw || isDamaged || config.fps == FpsBenchmark)
 									{
-										GLFinish();
-										GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, NULL);
-
-										GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
+										if (state.upscaling == UpscaleXRBZ)
+										{
+											// Classify edges once per source pixel, the scaling pass only blends
+											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, edgeId);
+											GLViewport(0, 0, this->mode->width, this->mode->height);
+											shaders.xBRz_edge->Use(texSize);
+											GLDrawArrays(GL_TRIANGLE_FAN, 8, 4);
 
-										if (clear++ <= 1)
-											GLClear(GL_COLOR_BUFFER_BIT);
+											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
+											GLViewport(0, 0, LOWORD(viewSize), HIWORD(viewSize));
+											upscaleProgram->Use(texSize);
+										}
 
-										switch (state.interpolation)
+										if (!state.upscaling && passProgram)
 										{
-										case InterpolateHermite:
-											program = shaders.hermite;
-											break;
-										case InterpolateCubic:
-											program = shaders.cubic;
-											break;
-										case InterpolateLanczos:
-											program = shaders.lanczos;
-											break;
-										default:
-											program = shaders.linear;
-											break;
+											// Separable kernel: source rows at output width, then columns
+											if (!resampler)
+												resampler = new Resampler();
+											resampler->Begin(state.interpolation, this->viewport.rectangle.width, this->mode->height);
+											passProgram->Use(texSize);
+											GLDrawArrays(GL_TRIANGLE_FAN, 8, 4);
+
+											DWORD passSize = resampler->End();
+											GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
+											program->Use(passSize);
+											GLDrawArrays(GL_TRIANGLE_FAN, 12, 4);
+
+											GLBindTexture(GL_TEXTURE_2D, texId.primary);
 										}
+										else
+											GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 
-										program->Use(viewSize);
+										// Draw from FBO
+										if (state.upscaling)
+										{
+											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, NULL);
 
-										GLBindTexture(GL_TEXTURE_2D, texId.buffer);
+											GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
 
-										DWORD filter = state.interpolation == InterpolateLinear || state.interpolation == InterpolateHermite ? GL_LINEAR : GL_NEAREST;
-										GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-										GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+											if (clear++ <= 1)
+												GLClear(GL_COLOR_BUFFER_BIT);
 
-										GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
+											switch (state.interpolation)
+											{
+											case InterpolateHermite:
+												program = shaders.hermite;
+												passProgram = NULL;
+												break;
+											case InterpolateCubic:
+												program = shaders.cubic;
+												passProgram = shaders.cubic_h;
+												break;
+											case InterpolateLanczos:
+												program = shaders.lanczos;
+												passProgram = shaders.lanczos_h;
+												break;
+											default:
+												program = shaders.linear;
+												passProgram = NULL;
+												break;
+											}
 
-										if (isSnapshot && OpenClipboard(NULL))
-										{
-											EmptyClipboard();
+											GLBindTexture(GL_TEXTURE_2D, texId.buffer);
 
-											DWORD size = LOWORD(viewSize) * HIWORD(viewSize) * 3;
-											DWORD slice = sizeof(BITMAPINFOHEADER);
-											HGLOBAL hMemory = GlobalAlloc(GMEM_MOVEABLE, slice + size);
-											if (hMemory)
+											DWORD filter = state.interpolation == InterpolateLinear || state.interpolation == InterpolateHermite ? GL_LINEAR : GL_NEAREST;
+											GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+											GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+
+											if (passProgram)
 											{
-												VOID* data = GlobalLock(hMemory);
-												if (data)
-												{
-													BITMAPINFOHEADER* bmi = (BITMAPINFOHEADER*)data;
-													bmi->biSize = sizeof(BITMAPINFOHEADER);
-													bmi->biWidth = LOWORD(viewSize);
-													bmi->biHeight = HIWORD(viewSize);
-													bmi->biPlanes = 1;
-													bmi->biBitCount = 24;
-													bmi->biCompression = BI_RGB;
-													bmi->biSizeImage = size;
-													bmi->biXPelsPerMeter = 1;
-													bmi->biYPelsPerMeter = 1;
-													bmi->biClrUsed = 0;
-													bmi->biClrImportant = 0;
-
-													GLGetTexImage(GL_TEXTURE_2D, 0, GL_BGR_EXT, GL_UNSIGNED_BYTE, (BYTE*)data + slice);
-
-													GlobalUnlock(hMemory);
-													SetClipboardData(CF_DIB, hMemory);
-												}
+												if (!resampler)
+													resampler = new Resampler();
+												resampler->Begin(state.interpolation, this->viewport.rectangle.width, HIWORD(viewSize));
+												passProgram->Use(viewSize);
+												GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
+
+												DWORD passSize = resampler->End();
+												GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
+												program->Use(passSize);
+												GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
 
-												GlobalFree(hMemory);
+												GLBindTexture(GL_TEXTURE_2D, texId.buffer);
+											}
+											else
+											{
+												program->Use(viewSize);
+												GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
 											}
 
-											CloseClipboard();
+											if (isSnapshot)
+											{
+												SnapshotFrame* frame = Snapshot::Acquire(LOWORD(viewSize), HIWORD(viewSize));
+												if (frame)
+												{
+													frame->isFlipped = TRUE;
+													GLGetTexImage(GL_TEXTURE_2D, 0, GL_BGRA_EXT, GL_UNSIGNED_BYTE, frame->data);
+													Snapshot::Commit(frame);
+												}
+											}
 										}
+										else if (isSnapshot)
+											surface->TakeSnapshot();
+
+										this->Present(isRedraw ? NULL : &damage);
+										pacer->Submit(this->frames->GetStamp());
 									}
-									else if (isSnapshot)
-										surface->TakeSnapshot();
+									else
+										++fpsCounter->elided;
 
-									SwapBuffers(this->hDc);
 									if (clear > 1 && config.fps != FpsBenchmark)
 										WaitForSingleObject(this->hDrawEvent, INFINITE);
-									GLFinish();
-								} while (!this->isFinish);
+								} while (!this->isFinish && !this->isResized);
 
 								if (fboId)
 								{
 									GLDeleteTextures(2, &texId.secondary);
 									GLDeleteFramebuffers(1, &fboId);
+									if (edgeId)
+									{
+										GLDeleteTextures(1, &texId.edge);
+										GLDeleteFramebuffers(1, &edgeId);
+										edgeId = 0;
+									}
+
 									AlignedFree(emptyBuffer);
 									delete secondBuffer;
 								}
 							}
 							delete firstBuffer;
 							delete fpsCounter;
+							delete pacer;
+							if (resampler)
+								delete resampler;
 						}
 						GLDeleteTextures(1, &texId.primary);
 					}
@@ -1126,6 +1349,8 @@ VOID OpenDraw::ResetDisplayMode(DWORD width, DWORD height)
 		{
 			if (mode->width == width && mode->height == height)
 			{
+				BOOL isResizing = this->BeginResize();
+
 				this->mode = mode;
 				this->pitch = this->mode->width * this->mode->bpp >> 3;
 				if (this->pitch & 15)
@@ -1136,6 +1361,9 @@ VOID OpenDraw::ResetDisplayMode(DWORD width, DWORD height)
 				if (surface)
 					surface->CreateBuffer(mode->width, mode->height);
 
+				if (isResizing)
+					this->EndResize();
+
 				return;
 			}
 
@@ -1201,6 +1429,13 @@ VOID OpenDraw::RenderStart()
 	this->viewport.height = rect.bottom;
 	this->viewport.refresh = TRUE;
 
+	this->ResetFrames();
+	if (!this->frames)
+	{
+		this->RenderStop();
+		return;
+	}
+
 	DWORD threadId;
 	SECURITY_ATTRIBUTES sAttribs = { sizeof(SECURITY_ATTRIBUTES), NULL, FALSE };
 	this->hDrawThread = CreateThread(&sAttribs, NULL, RenderThread, this, NORMAL_PRIORITY_CLASS, &threadId);
@@ -1213,9 +1448,16 @@ VOID OpenDraw::RenderStop()
 
 	this->isFinish = TRUE;
 	SetEvent(this->hDrawEvent);
-	WaitForSingleObject(this->hDrawThread, INFINITE);
-	CloseHandle(this->hDrawThread);
-	this->hDrawThread = NULL;
+	if (this->hDrawThread)
+	{
+		WaitForSingleObject(this->hDrawThread, INFINITE);
+		CloseHandle(this->hDrawThread);
+		this->hDrawThread = NULL;
+	}
+	this->isResized = FALSE;
+
+	delete this->frames;
+	this->frames = NULL;
 
 	if (this->hDraw != this->hWnd)
 	{
@@ -1231,6 +1473,92 @@ VOID OpenDraw::RenderStop()
 	Window::CheckMenu(this->hWnd);
 }
 
+BOOL OpenDraw::BeginResize()
+{
+	if (this->isFinish || this->isResized)
+		return FALSE;
+
+	this->isResized = TRUE;
+	SetEvent(this->hDrawEvent);
+	WaitForSingleObject(this->hResizeEvent, INFINITE);
+
+	return TRUE;
+}
+
+VOID OpenDraw::EndResize()
+{
+	OpenDrawSurface* surface = this->attachedSurface;
+	if (surface && surface->indexBuffer)
+	{
+		this->LoadFilterState();
+		this->viewport.refresh = TRUE;
+		this->ResetFrames();
+
+		if (this->frames)
+		{
+			this->isResized = FALSE;
+			SetEvent(this->hDrawEvent);
+			return;
+		}
+	}
+
+	this->RenderStop();
+}
+
+VOID OpenDraw::ResetFrames()
+{
+	delete this->frames;
+	this->frames = NULL;
+
+	if (this->mode)
+	{
+		this->frames = FrameQueue::Create(this->mode->width, this->mode->height, this->pitch, sizeof(WORD));
+
+		OpenDrawSurface* surface = this->attachedSurface;
+		if (this->frames && surface && surface->indexBuffer)
+		{
+			this->frames->Publish(surface->indexBuffer);
+			SetRectEmpty(&surface->damage);
+		}
+	}
+}
+
+BOOL OpenDraw::Publish(const VOID* buffer, const RECT* rect)
+{
+	if (!this->frames)
+		return FALSE;
+
+	this->frames->Publish(buffer, rect);
+	SetEvent(this->hDrawEvent);
+	return TRUE;
+}
+
+// Damage tracking skips unchanged frames, anything the window system painted over needs a full frame again
+VOID OpenDraw::Redraw()
+{
+	this->viewport.refresh = TRUE;
+	SetEvent(this->hDrawEvent);
+}
+
+VOID OpenDraw::Present(const RECT* damage)
+{
+	if (damage && GLAddSwapHintRect)
+	{
+		FLOAT fx = this->viewport.clipFactor.x;
+		FLOAT fy = this->viewport.clipFactor.y;
+		INT top = this->viewport.rectangle.y + this->viewport.rectangle.height;
+
+		INT left = this->viewport.rectangle.x + (INT)MathFloor((damage->left - PRESENT_BORDER) * fx);
+		INT right = this->viewport.rectangle.x + (INT)MathCeil((damage->right + PRESENT_BORDER) * fx);
+		INT bottom = top - (INT)MathCeil((damage->bottom + PRESENT_BORDER) * fy);
+		top -= (INT)MathFloor((damage->top - PRESENT_BORDER) * fy);
+
+		GLAddSwapHintRect(left, bottom, right - left, top - bottom);
+	}
+
+	SwapBuffers(this->hDc);
+}
+
 BOOL OpenDraw::CheckView()
 {
 	if (this->viewport.refresh)
@@ -1328,15 +1656,24 @@ OpenDraw::OpenDraw(IDraw7** last)
 
 	this->isTakeSnapshot = FALSE;
 	this->isFinish = TRUE;
+	this->isResized = FALSE;
 
 	this->temp = { NULL };
+	this->frames = NULL;
+	this->histogram = new Histogram();
 	this->hDrawEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	this->hResizeEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
 }
 
 OpenDraw::~OpenDraw()
 {
 	this->RenderStop();
+	delete this->histogram;
+	Snapshot::Stop();
+	Recorder::Release();
+	Ini::Stop();
 	CloseHandle(this->hDrawEvent);
+	CloseHandle(this->hResizeEvent);
 	ClipCursor(NULL);
 
 	if (this->temp.data)
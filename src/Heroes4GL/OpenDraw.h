@@ -26,6 +26,10 @@
 #include "IDraw7.h"
 #include "ExtraTypes.h"
 #include "OpenDrawSurface.h"
+#include "FrameQueue.h"
+#include "Histogram.h"
+
+#define PRESENT_BORDER 4
 
 class OpenDraw : public IDraw7
 {
@@ -43,9 +47,11 @@ public:
 	DWORD textureWidth;
 
 	BOOL isFinish;
+	BOOL isResized;
 
 	HANDLE hDrawThread;
 	HANDLE hDrawEvent;
+	HANDLE hResizeEvent;
 
 	Viewport viewport;
 	WindowState windowState;
@@ -55,6 +61,8 @@ public:
 	BOOL isFpsChanged;
 
 	RenderBuffer temp;
+	FrameQueue* frames;
+	Histogram* histogram;
 
 	OpenDraw(IDraw7**);
 	~OpenDraw();
@@ -64,6 +72,12 @@ public:
 
 	VOID RenderStart();
 	VOID RenderStop();
+	VOID Present(const RECT*);
+	VOID Redraw();
+	BOOL BeginResize();
+	VOID EndResize();
+	VOID ResetFrames();
+	BOOL Publish(const VOID*, const RECT* = NULL);
 
 	VOID RenderOld();
 	VOID RenderMid();
@@ -27,6 +27,9 @@
 #include "OpenDraw.h"
 #include "GLib.h"
 #include "Config.h"
+#include "Snapshot.h"
+#include "Convert.h"
+#include "Gdi.h"
 
 OpenDrawSurface::OpenDrawSurface(IDraw7* lpDD, DWORD index)
 {
@@ -39,6 +42,9 @@ OpenDrawSurface::OpenDrawSurface(IDraw7* lpDD, DWORD index)
 
 	this->index = index;
 	this->indexBuffer = NULL;
+	this->ownBuffer = NULL;
+	this->alias = NULL;
+	SetRectEmpty(&this->damage);
 
 	this->width = 0;
 	this->height = 0;
@@ -58,6 +64,9 @@ OpenDrawSurface::~OpenDrawSurface()
 
 VOID OpenDrawSurface::CreateBuffer(DWORD width, DWORD height)
 {
+	OpenDraw* ddraw = (OpenDraw*)this->ddraw;
+	BOOL isResizing = ddraw->attachedSurface == this && ddraw->BeginResize();
+
 	this->ReleaseBuffer();
 
 	if (width && height)
@@ -68,105 +77,69 @@ VOID OpenDrawSurface::CreateBuffer(DWORD width, DWORD height)
 		if (this->pitch & 15)
 			this->pitch = (this->pitch & 0xFFFFFFF0) + 16;
 
-		DWORD size = this->pitch * this->height;
-		this->indexBuffer = (WORD*)AlignedAlloc(size);
-
-		RenderBuffer* temp = &((OpenDraw*)this->ddraw)->temp;
+		RenderBuffer* temp = &ddraw->temp;
 		if (temp->data && temp->width == this->width && temp->height == this->height)
-			MemoryCopy(this->indexBuffer, temp->data, size);
+		{
+			this->indexBuffer = temp->data;
+			temp->data = NULL;
+		}
+		else
+			this->indexBuffer = (WORD*)AlignedAlloc(this->pitch * this->height);
 
-		if (((OpenDraw*)this->ddraw)->attachedSurface == this)
-			((OpenDraw*)this->ddraw)->RenderStart();
+		SetRectEmpty(&this->damage);
 	}
+
+	if (isResizing)
+		ddraw->EndResize();
+	else if (this->indexBuffer && ddraw->attachedSurface == this && !ddraw->isResized)
+		ddraw->RenderStart();
 }
 
 VOID OpenDrawSurface::ReleaseBuffer()
 {
 	if (this->indexBuffer)
 	{
-		if (((OpenDraw*)this->ddraw)->attachedSurface == this)
-			((OpenDraw*)this->ddraw)->RenderStop();
+		OpenDraw* ddraw = (OpenDraw*)this->ddraw;
+		if (ddraw->attachedSurface == this && !ddraw->isResized)
+			ddraw->RenderStop();
 
-		RenderBuffer* temp = &((OpenDraw*)this->ddraw)->temp;
-		if (temp->data && (temp->width != this->width || temp->height != this->height))
-		{
-			AlignedFree(temp->data);
-			temp->data = NULL;
-		}
+		Gdi::Detach(this);
 
-		DWORD size = this->pitch * this->height;
-		if (!((OpenDraw*)this->ddraw)->temp.data)
-		{
-			temp->width = this->width;
-			temp->height = this->height;
-			temp->data = (WORD*)AlignedAlloc(size);
-		}
+		RenderBuffer* temp = &ddraw->temp;
+		if (temp->data)
+			AlignedFree(temp->data);
 
-		MemoryCopy(temp->data, this->indexBuffer, size);
-		AlignedFree(this->indexBuffer);
+		temp->width = this->width;
+		temp->height = this->height;
+		temp->data = this->indexBuffer;
 
 		this->indexBuffer = NULL;
 	}
 }
 
-VOID OpenDrawSurface::TakeSnapshot()
+// Collects what changed since the surface was last handed to presentation, a change made while
+// the frame queue is rebuilt is carried to the next publish
+VOID OpenDrawSurface::Damage(const RECT* rect)
 {
-	if (OpenClipboard(NULL))
-	{
-		EmptyClipboard();
+	if (rect)
+		UnionRect(&this->damage, &this->damage, rect);
+	else
+		SetRect(&this->damage, 0, 0, this->width, this->height);
 
-		DWORD pitch = this->width * sizeof(WORD);
-		if (pitch & 3)
-			pitch = (pitch & 0xFFFFFFFC) + 4;
+	OpenDraw* ddraw = (OpenDraw*)this->ddraw;
+	if (ddraw->attachedSurface == this && ddraw->Publish(this->indexBuffer, &this->damage))
+		SetRectEmpty(&this->damage);
+}
 
-		DWORD size = pitch * this->height;
-		DWORD slice = sizeof(BITMAPINFOHEADER) + 12;
-		HGLOBAL hMemory = GlobalAlloc(GMEM_MOVEABLE, slice + size);
-		if (hMemory)
-		{
-			VOID* data = GlobalLock(hMemory);
-			if (data)
-			{
-				BITMAPV5HEADER* bmi = (BITMAPV5HEADER*)data;
-				bmi->bV5Size = sizeof(BITMAPINFOHEADER);
-				bmi->bV5Width = this->width;
-				bmi->bV5Height = this->height;
-				bmi->bV5Planes = 1;
-				bmi->bV5BitCount = 16;
-				bmi->bV5Compression = BI_BITFIELDS;
-				bmi->bV5SizeImage = size;
-				bmi->bV5XPelsPerMeter = 1;
-				bmi->bV5YPelsPerMeter = 1;
-				bmi->bV5ClrUsed = 0;
-				bmi->bV5ClrImportant = 0;
-				bmi->bV5RedMask = 0xF800;
-				bmi->bV5GreenMask = 0x07E0;
-				bmi->bV5BlueMask = 0x001F;
-
-				BYTE* dstData = (BYTE*)data + slice + size - pitch;
-
-				WORD* src = this->indexBuffer;
-				DWORD height = this->height;
-				do
-				{
-					WORD* dst = (WORD*)dstData;
-					DWORD width = this->width;
-					do
-						*dst++ = *src++;
-					while (--width);
-
-					dstData -= pitch;
-				} while (--height);
-
-				GlobalUnlock(hMemory);
-				SetClipboardData(CF_DIB, hMemory);
-			}
-
-			GlobalFree(hMemory);
-		}
+VOID OpenDrawSurface::TakeSnapshot()
+{
+	SnapshotFrame* frame = Snapshot::Acquire(this->width, this->height);
+	if (!frame)
+		return;
 
-		CloseClipboard();
-	}
+	Rgb565ToBgra((const uint16_t*)this->indexBuffer, (uint32_t*)frame->data, this->width * this->height);
+
+	Snapshot::Commit(frame);
 }
 
 ULONG __stdcall OpenDrawSurface::AddRef()
@@ -230,6 +203,8 @@ HRESULT __stdcall OpenDrawSurface::GetDC(HDC* dcMem)
 
 HRESULT __stdcall OpenDrawSurface::Lock(LPRECT lpDestRect, LPDDSURFACEDESC2 lpDDSurfaceDesc, DWORD dwFlags, HANDLE hEvent)
 {
+	Gdi::Detach(this);
+
 	lpDDSurfaceDesc->dwWidth = this->width;
 	lpDDSurfaceDesc->dwHeight = this->height;
 	lpDDSurfaceDesc->lPitch = this->pitch;
@@ -238,9 +213,16 @@ HRESULT __stdcall OpenDrawSurface::Lock(LPRECT lpDestRect, LPDDSURFACEDESC2 lpDD
 	return DD_OK;
 }
 
+HRESULT __stdcall OpenDrawSurface::Unlock(LPRECT lpRect)
+{
+	this->Damage(lpRect);
+	return DD_OK;
+}
+
 HRESULT __stdcall OpenDrawSurface::Blt(LPRECT lpDestRect, LPDIRECTDRAWSURFACE7 lpDDSrcSurface, LPRECT lpSrcRect, DWORD dwFlags, LPDDBLTFX lpDDBltFx)
 {
 	OpenDrawSurface* surface = (OpenDrawSurface*)lpDDSrcSurface;
+	Gdi::Detach(this);
 
 	DWORD sPitch = surface->pitch;
 	DWORD dPitch;
@@ -264,6 +246,8 @@ HRESULT __stdcall OpenDrawSurface::Blt(LPRECT lpDestRect, LPDIRECTDRAWSURFACE7 l
 	WORD* src = surface->indexBuffer + lpSrcRect->top * sPitch + lpSrcRect->left;
 	WORD* dst = this->indexBuffer + lpDestRect->top * dPitch + lpDestRect->left;
 
+	RECT rc = { lpDestRect->left, lpDestRect->top, lpDestRect->left + width, lpDestRect->top + height };
+
 	width *= sizeof(WORD);
 	do
 	{
@@ -272,11 +256,7 @@ HRESULT __stdcall OpenDrawSurface::Blt(LPRECT lpDestRect, LPDIRECTDRAWSURFACE7 l
 		dst += dPitch;
 	} while (--height);
 
-	if (((OpenDraw*)this->ddraw)->attachedSurface == this)
-	{
-		SetEvent(((OpenDraw*)this->ddraw)->hDrawEvent);
-		Sleep(0);
-	}
+	this->Damage(&rc);
 
 	return DD_OK;
 }
@@ -284,6 +264,7 @@ HRESULT __stdcall OpenDrawSurface::Blt(LPRECT lpDestRect, LPDIRECTDRAWSURFACE7 l
 HRESULT __stdcall OpenDrawSurface::BltFast(DWORD dwX, DWORD dwY, LPDIRECTDRAWSURFACE7 lpDDSrcSurface, LPRECT lpSrcRect, DWORD dwFlags)
 {
 	OpenDrawSurface* surface = (OpenDrawSurface*)lpDDSrcSurface;
+	Gdi::Detach(this);
 
 	INT width = lpSrcRect->right - lpSrcRect->left;
 	INT height = lpSrcRect->bottom - lpSrcRect->top;
@@ -293,6 +274,8 @@ HRESULT __stdcall OpenDrawSurface::BltFast(DWORD dwX, DWORD dwY, LPDIRECTDRAWSUR
 	WORD* source = surface->indexBuffer + lpSrcRect->top * sPitch + lpSrcRect->left;
 	WORD* destination = this->indexBuffer + dwY * dPitch + dwX;
 
+	RECT rc = { *(LONG*)&dwX, *(LONG*)&dwY, *(LONG*)&dwX + width, *(LONG*)&dwY + height };
+
 	width *= sizeof(WORD);
 	do
 	{
@@ -301,11 +284,7 @@ HRESULT __stdcall OpenDrawSurface::BltFast(DWORD dwX, DWORD dwY, LPDIRECTDRAWSUR
 		destination += dPitch;
 	} while (--height);
 
-	if (((OpenDraw*)this->ddraw)->attachedSurface == this)
-	{
-		SetEvent(((OpenDraw*)this->ddraw)->hDrawEvent);
-		Sleep(0);
-	}
+	this->Damage(&rc);
 
 	return DD_OK;
 }
\ No newline at end of file
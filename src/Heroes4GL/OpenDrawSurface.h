@@ -42,12 +42,16 @@ public:
 	OpenDrawClipper* attachedClipper;
 
 	WORD* indexBuffer;
+	WORD* ownBuffer;
+	RenderBuffer* alias;
+	RECT damage;
 
 	OpenDrawSurface(IDraw7*, DWORD);
 	~OpenDrawSurface();
 
 	VOID CreateBuffer(DWORD, DWORD);
 	VOID ReleaseBuffer();
+	VOID Damage(const RECT*);
 	VOID TakeSnapshot();
 
 	// Inherited via IDrawSurface7
@@ -59,5 +63,6 @@ public:
 	HRESULT __stdcall GetPixelFormat(LPDDPIXELFORMAT);
 	HRESULT __stdcall GetSurfaceDesc(LPDDSURFACEDESC2);
 	HRESULT __stdcall Lock(LPRECT, LPDDSURFACEDESC2, DWORD, HANDLE);
+	HRESULT __stdcall Unlock(LPRECT);
 	HRESULT __stdcall SetClipper(LPDIRECTDRAWCLIPPER);
 };
\ No newline at end of file
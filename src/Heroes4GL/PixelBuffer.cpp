@@ -24,660 +24,10 @@
 
 #include "stdafx.h"
 #include "PixelBuffer.h"
-#include "intrin.h"
+#include "Config.h"
+#include "Recorder.h"
 
-namespace ASM
-{
-	DWORD __declspec(naked) __fastcall ForwardCompare(DWORD count, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		__asm {
-			push ebp
-			mov ebp, esp
-			push esi
-			push edi
-
-			mov esi, ptr1
-			mov edi, ptr2
-
-			sal edx, 2
-			add esi, edx
-			add edi, edx
-
-			repe cmpsd
-			jz lbl_ret
-			inc ecx
-
-			lbl_ret:
-			mov eax, ecx
-
-			pop edi
-			pop esi
-			mov esp, ebp
-			pop ebp
-
-			retn 8
-		}
-	}
-
-	DWORD __declspec(naked) __fastcall BackwardCompare(DWORD count, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		__asm {
-			push ebp
-			mov ebp, esp
-			push esi
-			push edi
-
-			mov esi, ptr1
-			mov edi, ptr2
-
-			sal edx, 2
-			add esi, edx
-			add edi, edx
-
-			std
-			repe cmpsd
-			cld
-			jz lbl_ret
-			inc ecx
-
-			lbl_ret:
-			mov eax, ecx
-
-			pop edi
-			pop esi
-			mov esp, ebp
-			pop ebp
-
-			retn 8
-		}
-	}
-
-	BOOL __declspec(naked) __fastcall BlockForwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2, POINT* p)
-	{
-		__asm {
-			push ebp
-			mov ebp, esp
-			push ebx
-			push esi
-			push edi
-
-			mov eax, ecx
-			mov esp, edx
-
-			mov ebx, pitch
-			sub ebx, eax
-			sal ebx, 2
-
-			mov esi, ptr1
-			mov edi, ptr2
-
-			mov ecx, slice
-			sal ecx, 2
-
-			add esi, ecx
-			add edi, ecx
-
-			lbl_cycle:
-				mov ecx, eax
-				repe cmpsd
-				jne lbl_break
-
-				add esi, ebx
-				add edi, ebx
-			dec edx
-			jnz lbl_cycle
-
-			xor eax, eax
-			jmp lbl_ret
-
-			lbl_break:
-			mov ebx, p
-		
-			inc ecx
-			sub eax, ecx
-			mov [ebx], eax
-
-			sub esp, edx
-			mov [ebx+4], esp
-
-			xor eax, eax
-			inc eax
-
-			lbl_ret:
-			mov esp, ebp
-			sub esp, 12
-			pop edi
-			pop esi
-			pop ebx
-			pop ebp
-
-			retn 20
-		}
-	}
-
-	BOOL __declspec(naked) __fastcall BlockBackwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2, POINT* p)
-	{
-		__asm {
-			push ebp
-			mov ebp, esp
-			push ebx
-			push esi
-			push edi
-
-			mov eax, ecx
-
-			mov ebx, pitch
-			sub ebx, eax
-			sal ebx, 2
-
-			mov esi, ptr1
-			mov edi, ptr2
-
-			mov ecx, slice
-			sal ecx, 2
-
-			add esi, ecx
-			add edi, ecx
-
-			std
-
-			lbl_cycle:
-				mov ecx, eax
-				repe cmpsd
-				jnz lbl_break
-
-				sub esi, ebx
-				sub edi, ebx
-			dec edx
-			jnz lbl_cycle
-
-			xor eax, eax
-			jmp lbl_ret
-
-			lbl_break:
-			mov ebx, p
-		
-			mov [ebx], ecx
-
-			dec edx
-			mov [ebx+4], edx
-
-			xor eax, eax
-			inc eax
-
-			lbl_ret:
-			cld
-			pop edi
-			pop esi
-			pop ebx
-			mov esp, ebp
-			pop ebp
-
-			retn 20
-		}
-	}
-
-	DWORD __declspec(naked) __fastcall SideForwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		__asm {
-			push ebp
-			mov ebp, esp
-			push ebx
-			push esi
-			push edi
-
-			mov eax, ecx
-			mov esp, ecx
-
-			mov ebx, pitch
-			sub ebx, eax
-			sal ebx, 2
-
-			mov esi, ptr1
-			mov edi, ptr2
-
-			mov ecx, slice
-			sal ecx, 2
-
-			add esi, ecx
-			add edi, ecx
-
-			lbl_cycle:
-				mov ecx, eax
-				repe cmpsd
-				jz lbl_inc
-			
-				sub eax, ecx
-				dec eax
-				jz lbl_ret
-
-				sal ecx, 2
-				add ebx, ecx
-				add esi, ebx
-				add edi, ebx
-				add ebx, 4
-				jmp lbl_cont
-
-				lbl_inc:
-				add esi, ebx
-				add edi, ebx
-			
-				lbl_cont:
-			dec edx
-			jnz lbl_cycle
-
-			lbl_ret:
-			sub esp, eax
-			mov eax, esp
-
-			mov esp, ebp
-			sub esp, 12
-			pop edi
-			pop esi
-			pop ebx
-			pop ebp
-
-			retn 16
-		}
-	}
-
-	DWORD __declspec(naked) __fastcall SideBackwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		__asm {
-			push ebp
-			mov ebp, esp
-			push ebx
-			push esi
-			push edi
-
-			mov eax, ecx
-			mov esp, ecx
-
-			mov ebx, pitch
-			sub ebx, eax
-			sal ebx, 2
-
-			mov esi, ptr1
-			mov edi, ptr2
-
-			mov ecx, slice
-			sal ecx, 2
-
-			add esi, ecx
-			add edi, ecx
-
-			std
-
-			lbl_cycle:
-				mov ecx, eax
-				repe cmpsd
-				jz lbl_inc
-			
-				sub eax, ecx
-				dec eax
-				jz lbl_ret
-
-				sal ecx, 2
-				add ebx, ecx
-				sub esi, ebx
-				sub edi, ebx
-				add ebx, 4
-				jmp lbl_cont
-
-				lbl_inc:
-				sub esi, ebx
-				sub edi, ebx
-			
-				lbl_cont:
-			dec edx
-			jnz lbl_cycle
-
-			lbl_ret:
-			sub esp, eax
-			mov eax, esp
-
-			cld
-
-			mov esp, ebp
-			sub esp, 12
-			pop edi
-			pop esi
-			pop ebx
-			pop ebp
-
-			retn 16
-		}
-	}
-}
-
-namespace CPP
-{
-	DWORD __fastcall ForwardCompare(DWORD count, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		ptr1 += slice;
-		ptr2 += slice;
-
-		for (DWORD i = 0; i < count; ++i)
-			if (ptr1[i] != ptr2[i])
-				return count - i;
-
-		return 0;
-	}
-
-	DWORD __fastcall BackwardCompare(DWORD count, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		ptr1 += slice;
-		ptr2 += slice;
-
-		for (DWORD i = 0; i < count; ++i)
-			if (ptr1[-i] != ptr2[-i])
-				return count - i;
-
-		return 0;
-	}
-
-	BOOL __fastcall BlockForwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2, POINT* p)
-	{
-		ptr1 += slice;
-		ptr2 += slice;
-
-		for (LONG y = 0; y < height; ++y)
-		{
-			for (LONG x = 0; x < width; ++x)
-			{
-				if (ptr1[x] != ptr2[x])
-				{
-					p->x = x;
-					p->y = y;
-					return TRUE;
-				}
-			}
-
-			ptr1 += pitch;
-			ptr2 += pitch;
-		}
-
-		return FALSE;
-	}
-
-	BOOL __fastcall BlockBackwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2, POINT* p)
-	{
-		ptr1 += slice;
-		ptr2 += slice;
-
-		for (LONG y = 0; y < height; ++y)
-		{
-			for (LONG x = 0; x < width; ++x)
-			{
-				if (ptr1[-x] != ptr2[-x])
-				{
-					p->x = width - x - 1;
-					p->y = height - y - 1;
-					return TRUE;
-				}
-			}
-
-			ptr1 -= pitch;
-			ptr2 -= pitch;
-		}
-
-		return FALSE;
-	}
-
-	DWORD __fastcall SideForwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		DWORD count = width;
-		ptr1 += slice;
-		ptr2 += slice;
-		for (LONG x = 0; x < width; ++x, ++ptr1, ++ptr2)
-		{
-			DWORD* cmp1 = ptr1;
-			DWORD* cmp2 = ptr2;
-			for (LONG y = 0; y < height; ++y, cmp1 += pitch, cmp2 += pitch)
-				if (*cmp1 != *cmp2)
-					return count - x;
-		}
-
-		return 0;
-	}
-
-	DWORD __fastcall SideBackwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		DWORD count = width;
-		ptr1 += slice;
-		ptr2 += slice;
-		for (LONG x = 0; x < width; ++x, --ptr1, --ptr2)
-		{
-			DWORD* cmp1 = ptr1;
-			DWORD* cmp2 = ptr2;
-			for (LONG y = 0; y < height; ++y, cmp1 -= pitch, cmp2 -= pitch)
-				if (*cmp1 != *cmp2)
-					return count - x;
-		}
-
-		return 0;
-	}
-}
-
-namespace SSE
-{
-	DWORD __fastcall ForwardCompare(DWORD count, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		__m128i* a = (__m128i*)(ptr1 + slice);
-		__m128i* b = (__m128i*)(ptr2 + slice);
-		count >>= 2;
-		do
-		{
-			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(a), _mm_load_si128(b))) != 0xFFFF)
-				return count << 2;
-
-			++a;
-			++b;
-		} while (--count);
-
-		return 0;
-	}
-
-	DWORD __fastcall BackwardCompare(DWORD count, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		__m128i* a = (__m128i*)(ptr1 + slice - 3);
-		__m128i* b = (__m128i*)(ptr2 + slice - 3);
-		count >>= 2;
-
-		do
-		{
-			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(a), _mm_load_si128(b))) != 0xFFFF)
-				return count << 2;
-
-			--a;
-			--b;
-		} while (--count);
-
-		return 0;
-	}
-
-	BOOL __fastcall BlockForwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2, POINT* p)
-	{
-		pitch -= width;
-		pitch >>= 2;
-		width >>= 2;
-
-		__m128i* a = (__m128i*)(ptr1 + slice);
-		__m128i* b = (__m128i*)(ptr2 + slice);
-		for (LONG y = 0; y < height; ++y, a += pitch, b += pitch)
-		{
-			DWORD count = width;
-			do
-			{
-				INT mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(a), _mm_load_si128(b)));
-				if (mask != 0xFFFF)
-				{
-					LONG c = 3;
-					do
-					{
-						if (!(mask & 0x000F))
-							break;
-						mask >>= 4;
-					} while (--c);
-
-					p->x = ((width - count) << 2) + 3 - c;
-					p->y = y;
-					return TRUE;
-				}
-
-				++a;
-				++b;
-			} while (--count);
-		}
-
-		return FALSE;
-	}
-
-	BOOL __fastcall BlockBackwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2, POINT* p)
-	{
-		pitch -= width;
-		pitch >>= 2;
-		width >>= 2;
-
-		__m128i* a = (__m128i*)(ptr1 + slice - 3);
-		__m128i* b = (__m128i*)(ptr2 + slice - 3);
-		for (LONG y = 0; y < height; ++y, a -= pitch, b -= pitch)
-		{
-			DWORD count = width;
-			do
-			{
-				INT mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(a), _mm_load_si128(b)));
-				if (mask != 0xFFFF)
-				{
-					LONG c = 3;
-					do
-					{
-						if (!(mask & 0xF000))
-							break;
-						mask <<= 4;
-					} while (--c);
-
-					p->x = (count << 2) - (4 - c);
-					p->y = height - y - 1;
-					return TRUE;
-				}
-
-				--a;
-				--b;
-			} while (--count);
-		}
-
-		return FALSE;
-	}
-
-	DWORD __fastcall SideForwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		DWORD count = width;
-		LONG swd = width >> 2;
-		DWORD spt = pitch >> 2;
-
-		__m128i* a = (__m128i*)(ptr1 + slice);
-		__m128i* b = (__m128i*)(ptr2 + slice);
-
-		LONG i = 0, j;
-		for (i = 0; i < swd; ++i, ++a, ++b)
-		{
-			__m128i* cmp1 = a;
-			__m128i* cmp2 = b;
-			for (j = 0; j < height; ++j, cmp1 += spt, cmp2 += spt)
-			{
-				INT mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(cmp1), _mm_load_si128(cmp2)));
-				if (mask != 0xFFFF)
-				{
-					LONG c = 3;
-					do
-					{
-						if (!(mask & 0x000F))
-							break;
-						mask >>= 4;
-					} while (--c);
-
-					++j;
-					a = cmp1 + spt;
-					b = cmp2 + spt;
-					width = (i << 2) + 3 - c;
-					goto lbl_dword;
-				}
-			}
-		}
-
-		j = 0;
-
-	lbl_dword:;
-		ptr1 = (DWORD*)a;
-		ptr2 = (DWORD*)b;
-		for (LONG x = i << 2; x < width; ++x, ++ptr1, ++ptr2)
-		{
-			DWORD* cmp1 = ptr1;
-			DWORD* cmp2 = ptr2;
-			for (LONG y = j; y < height; ++y, cmp1 += pitch, cmp2 += pitch)
-				if (*cmp1 != *cmp2)
-					return count - x;
-		}
-
-		return count - width;
-	}
-
-	DWORD __fastcall SideBackwardCompare(LONG width, LONG height, DWORD pitch, DWORD slice, DWORD* ptr1, DWORD* ptr2)
-	{
-		DWORD count = width;
-		LONG swd = width >> 2;
-		DWORD spt = pitch >> 2;
-
-		__m128i* a = (__m128i*)(ptr1 + slice - 3);
-		__m128i* b = (__m128i*)(ptr2 + slice - 3);
-
-		LONG i = 0, j;
-		for (i = 0; i < swd; ++i, --a, --b)
-		{
-			__m128i* cmp1 = a;
-			__m128i* cmp2 = b;
-			for (j = 0; j < height; ++j, cmp1 -= spt, cmp2 -= spt)
-			{
-				INT mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(cmp1), _mm_load_si128(cmp2)));
-				if (mask != 0xFFFF)
-				{
-					LONG c = 3;
-					do
-					{
-						if (!(mask & 0xF000))
-							break;
-						mask <<= 4;
-					} while (--c);
-
-					++j;
-					a = cmp1 - spt;
-					b = cmp2 - spt;
-					width = (i << 2) + 3 - c;
-					goto lbl_dword;
-				}
-			}
-		}
-
-		j = 0;
-
-	lbl_dword:;
-		ptr1 = (DWORD*)a + 3;
-		ptr2 = (DWORD*)b + 3;
-		for (LONG x = i << 2; x < width; ++x, --ptr1, --ptr2)
-		{
-			DWORD* cmp1 = ptr1;
-			DWORD* cmp2 = ptr2;
-			for (LONG y = j; y < height; ++y, cmp1 -= pitch, cmp2 -= pitch)
-				if (*cmp1 != *cmp2)
-					return count - x;
-		}
-
-		return count - width;
-	}
-}
-
-PixelBuffer::PixelBuffer(DWORD width, DWORD height, BOOL isTrue, GLenum format, UpdateMode mode)
+PixelBuffer::PixelBuffer(DWORD width, DWORD height, BOOL isTrue, GLenum format, UpdateMode mode, BOOL isTracked)
 {
 	this->width = width;
 	this->height = height;
@@ -687,6 +37,7 @@ PixelBuffer::PixelBuffer(DWORD width, DWORD height, BOOL isTrue, GLenum format,
 	this->block.width = BLOCK_SIZE;
 	this->block.height = BLOCK_SIZE;
 	this->reset = TRUE;
+	SetRectEmpty(&this->damage);
 
 	if (!this->isTrue)
 	{
@@ -697,6 +48,9 @@ PixelBuffer::PixelBuffer(DWORD width, DWORD height, BOOL isTrue, GLenum format,
 	else
 		this->type = GL_UNSIGNED_BYTE;
 
+	this->track = isTracked ? Recorder::Open(this->width, this->height, this->isTrue, this->format, this->type) : 0;
+	this->texture = 0;
+
 	this->size = this->pitch * this->height * sizeof(DWORD);
 	this->primaryBuffer = (DWORD*)AlignedAlloc(this->size);
 	this->secondaryBuffer = (DWORD*)AlignedAlloc(this->size);
@@ -713,6 +67,9 @@ PixelBuffer::PixelBuffer(DWORD width, DWORD height, BOOL isTrue, GLenum format,
 		this->SideForwardCompare = SSE::SideForwardCompare;
 		this->SideBackwardCompare = SSE::SideBackwardCompare;
 		break;
+#ifndef _M_IX86
+	case UpdateASM:
+#endif
 	case UpdateCPP:
 		this->ForwardCompare = CPP::ForwardCompare;
 		this->BackwardCompare = CPP::BackwardCompare;
@@ -721,6 +78,7 @@ PixelBuffer::PixelBuffer(DWORD width, DWORD height, BOOL isTrue, GLenum format,
 		this->SideForwardCompare = CPP::SideForwardCompare;
 		this->SideBackwardCompare = CPP::SideBackwardCompare;
 		break;
+#ifdef _M_IX86
 	case UpdateASM:
 		this->ForwardCompare = ASM::ForwardCompare;
 		this->BackwardCompare = ASM::BackwardCompare;
@@ -729,6 +87,7 @@ PixelBuffer::PixelBuffer(DWORD width, DWORD height, BOOL isTrue, GLenum format,
 		this->SideForwardCompare = ASM::SideForwardCompare;
 		this->SideBackwardCompare = ASM::SideBackwardCompare;
 		break;
+#endif
 	default:
 		this->ForwardCompare = NULL;
 		this->BackwardCompare = NULL;
@@ -751,15 +110,54 @@ VOID PixelBuffer::Reset()
 	this->reset = TRUE;
 }
 
-VOID PixelBuffer::Update(Rect* rect)
+VOID PixelBuffer::Bind()
 {
+	if (this->texture)
+	{
+		GLBindTexture(GL_TEXTURE_2D, this->texture);
+		this->texture = 0;
+	}
+}
+
+BOOL PixelBuffer::Update(Rect* rect, GLuint texture)
+{
+	BOOL isUpdated = FALSE;
+
+	// The target texture is bound only once something in the rectangle actually changed
+	this->texture = texture;
+
 	GLPixelStorei(GL_UNPACK_ROW_LENGTH, this->width);
 	if (!this->ForwardCompare || this->reset)
 	{
+		isUpdated = TRUE;
+		this->Bind();
+
 		if (rect)
-			GLTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, rect->width, rect->height, this->format, this->type, this->primaryBuffer + rect->y * this->pitch + (this->isTrue ? rect->x : rect->x >> 1));
+		{
+			RECT rc = { rect->x, rect->y, rect->x + rect->width, rect->y + rect->height };
+			UnionRect(&this->damage, &this->damage, &rc);
+
+			DWORD* ptr = this->primaryBuffer + rect->y * this->pitch + (this->isTrue ? rect->x : rect->x >> 1);
+			GLTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, rect->width, rect->height, this->format, this->type, ptr);
+
+			if (this->track)
+			{
+				Rect rc = { this->isTrue ? rect->x : rect->x & ~1, rect->y, rect->width, rect->height };
+				Recorder::AddRect(this->track, &rc, ptr, this->pitch);
+			}
+		}
 		else
+		{
+			SetRect(&this->damage, 0, 0, this->width, this->height);
+
 			GLTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->width, this->height, this->format, this->type, this->primaryBuffer);
+
+			if (this->track)
+			{
+				Rect full = { 0, 0, *(INT*)&this->width, *(INT*)&this->height };
+				Recorder::AddRect(this->track, &full, this->primaryBuffer, this->pitch);
+			}
+		}
 	}
 	else if (rect)
 	{
@@ -787,7 +185,7 @@ VOID PixelBuffer::Update(Rect* rect)
 					rt = right;
 
 				RECT rc = { *(LONG*)&x, *(LONG*)&y, *(LONG*)&rt, *(LONG*)&bt };
-				this->UpdateBlock(&rc, (POINT*)rect);
+				isUpdated |= this->UpdateBlock(&rc, (POINT*)rect);
 			}
 		}
 	}
@@ -795,8 +193,8 @@ VOID PixelBuffer::Update(Rect* rect)
 	{
 		DWORD left, right;
 		DWORD length = this->pitch * this->height;
-		if ((left = this->ForwardCompare(length, 0, this->primaryBuffer, this->secondaryBuffer))
-			&& (right = this->BackwardCompare(length, length - 1, this->primaryBuffer, this->secondaryBuffer)))
+		if ((left = this->ForwardCompare(length, 0, (const uint32_t*)this->primaryBuffer, (const uint32_t*)this->secondaryBuffer))
+			&& (right = this->BackwardCompare(length, length - 1, (const uint32_t*)this->primaryBuffer, (const uint32_t*)this->secondaryBuffer)))
 		{
 			DWORD top = (length - left) / this->pitch;
 			DWORD bottom = (right - 1) / this->pitch + 1;
@@ -818,21 +216,23 @@ VOID PixelBuffer::Update(Rect* rect)
 						rt = right;
 
 					RECT rc = { *(LONG*)&x, *(LONG*)&y, *(LONG*)&rt, *(LONG*)&bt };
-					this->UpdateBlock(&rc, &offset);
+					isUpdated |= this->UpdateBlock(&rc, &offset);
 				}
 			}
 		}
 	}
 	GLPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+	return isUpdated;
 }
 
-VOID PixelBuffer::UpdateBlock(RECT* rect, const POINT* offset)
+BOOL PixelBuffer::UpdateBlock(RECT* rect, const POINT* offset)
 {
 	RECT rc;
 	LONG width = rect->right-- - rect->left;
 	LONG height = rect->bottom-- - rect->top;
-	if (this->BlockForwardCompare(width, height, this->pitch, rect->top * this->pitch + rect->left, this->primaryBuffer, this->secondaryBuffer, (POINT*)&rc.left)
-		&& this->BlockBackwardCompare(width, height, this->pitch, rect->bottom * this->pitch + rect->right, this->primaryBuffer, this->secondaryBuffer, (POINT*)&rc.right))
+	if (this->BlockForwardCompare(width, height, this->pitch, rect->top * this->pitch + rect->left, (const uint32_t*)this->primaryBuffer, (const uint32_t*)this->secondaryBuffer, (ComparePoint*)&rc.left)
+		&& this->BlockBackwardCompare(width, height, this->pitch, rect->bottom * this->pitch + rect->right, (const uint32_t*)this->primaryBuffer, (const uint32_t*)this->secondaryBuffer, (ComparePoint*)&rc.right))
 	{
 		if (rc.left > rc.right)
 		{
@@ -851,11 +251,11 @@ VOID PixelBuffer::UpdateBlock(RECT* rect, const POINT* offset)
 		{
 			width = rc.left - rect->left;
 			if (width)
-				rc.left -= this->SideForwardCompare(width, height, this->pitch, (rc.top + 1) * this->pitch + rect->left, this->primaryBuffer, this->secondaryBuffer);
+				rc.left -= this->SideForwardCompare(width, height, this->pitch, (rc.top + 1) * this->pitch + rect->left, (const uint32_t*)this->primaryBuffer, (const uint32_t*)this->secondaryBuffer);
 
 			width = rect->right - rc.right;
 			if (width)
-				rc.right += this->SideBackwardCompare(width, height, this->pitch, (rc.bottom - 1) * this->pitch + rect->right, this->primaryBuffer, this->secondaryBuffer);
+				rc.right += this->SideBackwardCompare(width, height, this->pitch, (rc.bottom - 1) * this->pitch + rect->right, (const uint32_t*)this->primaryBuffer, (const uint32_t*)this->secondaryBuffer);
 		}
 
 		Rect rect = { rc.left, rc.top, rc.right - rc.left + 1, height + 1 };
@@ -867,8 +267,19 @@ VOID PixelBuffer::UpdateBlock(RECT* rect, const POINT* offset)
 			rect.width <<= 1;
 		}
 
+		this->Bind();
 		GLTexSubImage2D(GL_TEXTURE_2D, 0, rect.x - offset->x, rect.y - offset->y, rect.width, rect.height, this->format, this->type, ptr);
+
+		if (this->track)
+			Recorder::AddRect(this->track, &rect, ptr, this->pitch);
+
+		RECT rc = { rect.x, rect.y, rect.x + rect.width, rect.y + rect.height };
+		UnionRect(&this->damage, &this->damage, &rc);
+
+		return TRUE;
 	}
+
+	return FALSE;
 }
 
 VOID PixelBuffer::Copy(VOID* buffer)
@@ -881,11 +292,167 @@ VOID* PixelBuffer::GetBuffer()
 	return this->primaryBuffer;
 }
 
+const RECT* PixelBuffer::GetDamage()
+{
+	return &this->damage;
+}
+
 VOID PixelBuffer::SwapBuffers()
 {
 	DWORD* buff = this->primaryBuffer;
 	this->primaryBuffer = this->secondaryBuffer;
 	this->secondaryBuffer = buff;
 
-	this->reset = FALSE;
+	SetRectEmpty(&this->damage);
+
+	this->reset = this->track && Recorder::Commit(this->track);
+}
+
+VOID TuneFrame(DWORD* frame, DWORD pitch, DWORD height, DWORD index, DWORD* seed)
+{
+	switch (index & 3)
+	{
+	case 0:
+	{
+		DWORD* ptr = frame;
+		DWORD count = pitch * height;
+		do
+			*ptr++ ^= index + 1;
+		while (--count);
+
+		break;
+	}
+
+	case 3:
+		break;
+
+	default:
+	{
+		DWORD w = min(pitch, TUNE_SPRITE);
+		DWORD h = min(height, TUNE_SPRITE);
+		DWORD x = index * 37 % (pitch - w + 1);
+		DWORD y = index * 23 % (height - h + 1);
+
+		DWORD* line = frame + y * pitch + x;
+		for (DWORD j = 0; j < h; ++j, line += pitch)
+			for (DWORD i = 0; i < w; ++i)
+				line[i] = *seed = *seed * 1103515245 + 12345;
+
+		break;
+	}
+	}
+}
+
+LONGLONG PixelBuffer::Measure(DWORD width, DWORD height, BOOL isTrue, GLenum format, UpdateMode mode)
+{
+	// Tiles never exceed the texture limit, so neither does the scratch frame
+	GLint maxSize = 0;
+	GLGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+	if (maxSize > 0)
+	{
+		width = min(width, (DWORD)maxSize);
+		height = min(height, (DWORD)maxSize);
+	}
+
+	DWORD texWidth = 1;
+	while (texWidth < width)
+		texWidth <<= 1;
+
+	DWORD texHeight = 1;
+	while (texHeight < height)
+		texHeight <<= 1;
+
+	GLint bound = 0;
+	GLGetIntegerv(GL_TEXTURE_BINDING_2D, &bound);
+
+	GLuint scratch = 0;
+	GLGenTextures(1, &scratch);
+	GLBindTexture(GL_TEXTURE_2D, scratch);
+	GLTexImage2D(GL_TEXTURE_2D, 0, isTrue ? GL_RGBA : GL_RGB, texWidth, texHeight, GL_NONE, format, isTrue ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT_5_6_5, NULL);
+
+	DWORD pitch = isTrue ? width : width >> 1;
+	DWORD size = pitch * height * sizeof(DWORD);
+	DWORD* frame = (DWORD*)AlignedAlloc(size);
+	MemoryZero(frame, size);
+
+	LONGLONG time = 0;
+	PixelBuffer* buffer = new PixelBuffer(width, height, isTrue, format, mode, FALSE);
+	{
+		// The first frames pay for the initial full upload and cold caches, keep them out of the result
+		DWORD seed = 0;
+		for (DWORD index = 0; index < TUNE_WARMUP + TUNE_FRAMES; ++index)
+		{
+			TuneFrame(frame, pitch, height, index, &seed);
+
+			GLFinish();
+			LARGE_INTEGER start;
+			QueryPerformanceCounter(&start);
+
+			buffer->Copy(frame);
+			buffer->Update(NULL, scratch);
+			buffer->SwapBuffers();
+			GLFinish();
+
+			LARGE_INTEGER end;
+			QueryPerformanceCounter(&end);
+			if (index >= TUNE_WARMUP)
+				time += end.QuadPart - start.QuadPart;
+		}
+	}
+	delete buffer;
+
+	AlignedFree(frame);
+
+	GLBindTexture(GL_TEXTURE_2D, bound);
+	GLDeleteTextures(1, &scratch);
+
+	return time;
+}
+
+UpdateMode PixelBuffer::Tune(DWORD width, DWORD height, BOOL isTrue, GLenum format)
+{
+	if (config.updateMode != UpdateAuto)
+		return config.updateMode;
+
+	CHAR key[32];
+	StrPrint(key, "UpdateMode%ux%ux%u", width, height, isTrue ? 32 : 16);
+
+	INT value = Config::Get(CONFIG_WRAPPER, key, UpdateAuto);
+	UpdateMode best = *(UpdateMode*)&value;
+	if (best >= UpdateNone && best < UpdateAuto && (best != UpdateSSE || config.isSSE2))
+		return best;
+
+	best = config.isSSE2 ? UpdateSSE : UpdateCPP;
+	LONGLONG bestTime = 0;
+	for (DWORD i = UpdateNone; i < UpdateAuto; ++i)
+	{
+		UpdateMode mode = (UpdateMode)i;
+		if (mode == UpdateSSE && !config.isSSE2)
+			continue;
+
+#ifndef _M_IX86
+		if (mode == UpdateASM)
+			continue;
+#endif
+
+		LONGLONG time = Measure(width, height, isTrue, format, mode);
+
+#ifdef _DEBUG
+		LARGE_INTEGER freq;
+		QueryPerformanceFrequency(&freq);
+
+		CHAR message[128];
+		StrPrint(message, "Tune: %s mode %u, %u us per frame\n", key, i, DWORD(time * 1000000 / freq.QuadPart / TUNE_FRAMES));
+		OutputDebugString(message);
+#endif
+
+		if (!bestTime || time < bestTime)
+		{
+			bestTime = time;
+			best = mode;
+		}
+	}
+
+	Config::Set(CONFIG_WRAPPER, key, *(INT*)&best);
+	return best;
 }
\ No newline at end of file
@@ -0,0 +1,331 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "Registry.h"
+#include "Config.h"
+#include "Ini.h"
+
+namespace Registry
+{
+	CRITICAL_SECTION section;
+	RegValue* buckets[REGISTRY_BUCKETS];
+
+	const CHAR hexDigits[] = "0123456789abcdef";
+
+	DWORD Hash(const CHAR* name)
+	{
+		DWORD hash = 2166136261;
+		while (*name)
+		{
+			CHAR ch = *name++;
+			if (ch >= 'A' && ch <= 'Z')
+				ch += 'a' - 'A';
+
+			hash = (hash ^ (BYTE)ch) * 16777619;
+		}
+
+		return hash;
+	}
+
+	BOOL IsNumber(const CHAR* str)
+	{
+		if (*str == '-')
+			++str;
+
+		if (!*str)
+			return FALSE;
+
+		do
+		{
+			if (*str < '0' || *str > '9')
+				return FALSE;
+		} while (*++str);
+
+		return TRUE;
+	}
+
+	INT ToNumber(const CHAR* str)
+	{
+		BOOL isNegative = *str == '-';
+		if (isNegative)
+			++str;
+
+		DWORD number = 0;
+		while (*str >= '0' && *str <= '9')
+			number = number * 10 + (*str++ - '0');
+
+		return isNegative ? -(INT)number : (INT)number;
+	}
+
+	BOOL HasPrefix(const CHAR* str, const CHAR* prefix)
+	{
+		while (*prefix)
+			if (*str++ != *prefix++)
+				return FALSE;
+
+		return TRUE;
+	}
+
+	BYTE FromHex(CHAR ch)
+	{
+		if (ch >= '0' && ch <= '9')
+			return ch - '0';
+		if (ch >= 'a' && ch <= 'f')
+			return ch - 'a' + 10;
+		if (ch >= 'A' && ch <= 'F')
+			return ch - 'A' + 10;
+		return 0;
+	}
+
+	VOID Assign(RegValue* value, DWORD type, const BYTE* data, DWORD size)
+	{
+		if (value->data)
+			MemoryFree(value->data);
+
+		value->isLegacy = FALSE;
+		value->type = type;
+		value->size = size;
+		value->data = (BYTE*)MemoryAlloc(size ? size : 1);
+		MemoryCopy(value->data, data, size);
+	}
+
+	RegValue* Find(const CHAR* name, DWORD hash)
+	{
+		RegValue* value = buckets[hash & (REGISTRY_BUCKETS - 1)];
+		while (value)
+		{
+			if (value->hash == hash && !StrCompareInsensitive(value->name, name))
+				return value;
+
+			value = value->chain;
+		}
+
+		return NULL;
+	}
+
+	RegValue* Add(const CHAR* name, DWORD hash)
+	{
+		RegValue* value = (RegValue*)MemoryAlloc(sizeof(RegValue));
+		MemoryZero(value, sizeof(RegValue));
+		value->hash = hash;
+		value->name = StrDuplicate(name);
+
+		RegValue** bucket = &buckets[hash & (REGISTRY_BUCKETS - 1)];
+		value->chain = *bucket;
+		*bucket = value;
+
+		return value;
+	}
+
+	CHAR* ReadText(const CHAR* name)
+	{
+		DWORD size = REGISTRY_BUFFER;
+		do
+		{
+			CHAR* text = (CHAR*)MemoryAlloc(size);
+			if (Ini::Get(CONFIG_APP, name, "", text, size) < size - 1)
+				return text;
+
+			MemoryFree(text);
+			size <<= 1;
+		} while (TRUE);
+	}
+
+	// [Application] text: "hex:" is REG_BINARY, "sz:" is REG_SZ, "dword:" is REG_DWORD from earlier builds.
+	// Untyped text is a plain REG_SZ or a REG_DWORD written as a bare integer, so older versions
+	// keep reading it with GetPrivateProfileInt (see Query)
+	RegValue* Read(const CHAR* name, DWORD hash)
+	{
+		if (!Ini::Check(CONFIG_APP, name))
+			return NULL;
+
+		CHAR* text = ReadText(name);
+
+		RegValue* value = Add(name, hash);
+		if (HasPrefix(text, "hex:"))
+		{
+			BYTE* data = (BYTE*)MemoryAlloc(StrLength(text) / 3 + 1);
+			DWORD size = 0;
+			for (const CHAR* ptr = text + 4; ptr[0] && ptr[1]; ptr += ptr[2] ? 3 : 2)
+				data[size++] = (FromHex(ptr[0]) << 4) | FromHex(ptr[1]);
+
+			Assign(value, REG_BINARY, data, size);
+			MemoryFree(data);
+		}
+		else if (HasPrefix(text, "dword:"))
+		{
+			INT number = ToNumber(text + 6);
+			Assign(value, REG_DWORD, (BYTE*)&number, sizeof(number));
+		}
+		else if (HasPrefix(text, "sz:"))
+			Assign(value, REG_SZ, (const BYTE*)(text + 3), StrLength(text + 3) + 1);
+		else
+		{
+			Assign(value, REG_SZ, (const BYTE*)text, StrLength(text) + 1);
+			value->isLegacy = TRUE;
+		}
+
+		MemoryFree(text);
+		return value;
+	}
+
+	VOID Write(RegValue* value)
+	{
+		CHAR* text;
+		switch (value->type)
+		{
+		case REG_DWORD:
+			text = (CHAR*)MemoryAlloc(32);
+			StrFromInt(*(INT*)value->data, text, 10);
+			break;
+
+		case REG_BINARY:
+		{
+			text = (CHAR*)MemoryAlloc(value->size * 3 + 5);
+			StrCopy(text, "hex:");
+			CHAR* ptr = text + 4;
+			for (DWORD i = 0; i < value->size; ++i)
+			{
+				if (i)
+					*ptr++ = ',';
+
+				*ptr++ = hexDigits[value->data[i] >> 4];
+				*ptr++ = hexDigits[value->data[i] & 0xF];
+			}
+
+			*ptr = NULL;
+			break;
+		}
+
+		default:
+		{
+			text = (CHAR*)MemoryAlloc(value->size + 4);
+			CHAR* str = text + 3;
+			MemoryCopy(str, value->data, value->size);
+			str[value->size] = NULL;
+
+			if (IsNumber(str) || HasPrefix(str, "hex:") || HasPrefix(str, "dword:") || HasPrefix(str, "sz:"))
+				MemoryCopy(text, "sz:", 3);
+			else
+			{
+				CHAR* dst = text;
+				while (*dst++ = *str++);
+			}
+
+			break;
+		}
+		}
+
+		Ini::Set(CONFIG_APP, value->name, text);
+		MemoryFree(text);
+	}
+
+	VOID Create()
+	{
+		InitializeCriticalSection(&section);
+	}
+
+	LSTATUS Query(const CHAR* name, LPDWORD lpType, LPBYTE lpData, LPDWORD lpcbData)
+	{
+		LSTATUS res;
+		EnterCriticalSection(&section);
+		{
+			DWORD hash = Hash(name);
+			RegValue* value = Find(name, hash);
+			if (!value)
+				value = Read(name, hash);
+
+			if (!value)
+				res = ERROR_FILE_NOT_FOUND;
+			else
+			{
+				DWORD type = value->type;
+				const BYTE* data = value->data;
+				DWORD size = value->size;
+
+				// DWORDs are stored untyped, like the previous hook it tells them apart by the buffer size
+				INT number;
+				if (value->isLegacy && lpcbData && *lpcbData == sizeof(DWORD) && IsNumber((CHAR*)value->data))
+				{
+					number = ToNumber((CHAR*)value->data);
+					type = REG_DWORD;
+					data = (const BYTE*)&number;
+					size = sizeof(number);
+				}
+
+				if (lpType)
+					*lpType = type;
+
+				res = ERROR_SUCCESS;
+				if (lpcbData)
+				{
+					if (lpData)
+					{
+						if (*lpcbData >= size)
+							MemoryCopy(lpData, data, size);
+						else
+							res = ERROR_MORE_DATA;
+					}
+
+					*lpcbData = size;
+				}
+			}
+		}
+		LeaveCriticalSection(&section);
+
+		return res;
+	}
+
+	VOID Set(const CHAR* name, DWORD type, const BYTE* data, DWORD size)
+	{
+		if (type == REG_DWORD && size < sizeof(DWORD))
+			return;
+
+		if (type != REG_DWORD && type != REG_BINARY)
+		{
+			type = REG_SZ;
+			if (!size)
+			{
+				data = (const BYTE*)"";
+				size = 1;
+			}
+		}
+
+		EnterCriticalSection(&section);
+		{
+			DWORD hash = Hash(name);
+			RegValue* value = Find(name, hash);
+			if (!value)
+				value = Add(name, hash);
+
+			if (value->type != type || value->size != size || MemoryCompare(value->data, data, size))
+			{
+				Assign(value, type, data, type == REG_DWORD ? sizeof(DWORD) : size);
+				Write(value);
+			}
+		}
+		LeaveCriticalSection(&section);
+	}
+}
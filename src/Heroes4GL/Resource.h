@@ -52,6 +52,10 @@
 #define IDR_HERMITE_FRAGMENT 13
 #define IDR_CUBIC_FRAGMENT 14
 #define IDR_LANCZOS_FRAGMENT 15
+#define IDR_CUBIC_FRAGMENT_HORIZONTAL 28
+#define IDR_CUBIC_FRAGMENT_VERTICAL 29
+#define IDR_LANCZOS_FRAGMENT_HORIZONTAL 30
+#define IDR_LANCZOS_FRAGMENT_VERTICAL 31
 
 #define IDR_SCALENX_FRAGMENT_2X 16
 #define IDR_SCALENX_FRAGMENT_3X 17
@@ -68,6 +72,7 @@
 #define IDR_XBRZ_FRAGMENT_4X 24
 #define IDR_XBRZ_FRAGMENT_5X 25
 #define IDR_XBRZ_FRAGMENT_6X 26
+#define IDR_XBRZ_FRAGMENT_EDGE 27
 #pragma endregion
 
 #pragma region Dialogs
@@ -108,6 +113,8 @@
 #define IDM_FPS_OFF 10
 #define IDM_FPS_NORMAL 11
 #define IDM_FPS_BENCHMARK 12
+#define IDM_FPS_LATENCY 13
+#define IDM_FPS_IDLE 14
 
 #define IDM_FILT_OFF 20
 #define IDM_FILT_LINEAR 21
@@ -88,6 +88,14 @@ ShaderProgram::ShaderProgram(const CHAR* version, DWORD vertexName, DWORD fragme
 	if (loc >= 0)
 		GLUniform1i(loc, 1);
 
+	loc = GLGetUniformLocation(this->id, "tex03");
+	if (loc >= 0)
+		GLUniform1i(loc, 2);
+
+	loc = GLGetUniformLocation(this->id, "tex04");
+	if (loc >= 0)
+		GLUniform1i(loc, 3);
+
 	if (this->flags & SHADER_TEXSIZE)
 		this->loc.texSize = GLGetUniformLocation(this->id, "texSize");
 
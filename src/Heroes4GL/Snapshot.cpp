@@ -0,0 +1,537 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "intrin.h"
+#include "Snapshot.h"
+#include "Deflate.h"
+#include "Config.h"
+
+namespace Snapshot
+{
+	CRITICAL_SECTION section;
+	HANDLE hEvent;
+	HANDLE hThread;
+	BOOL isFinish;
+
+	SnapshotFrame* freeList;
+	DWORD freeCount;
+
+	struct {
+		SnapshotFrame* first;
+		SnapshotFrame* last;
+	} queue;
+
+#pragma region Encoders
+	BYTE* PutLong(BYTE* dst, DWORD value)
+	{
+		*(DWORD*)dst = _byteswap_ulong(value);
+		return dst + sizeof(DWORD);
+	}
+
+	const DWORD* GetRow(SnapshotFrame* frame, DWORD y)
+	{
+		return frame->data + (frame->isFlipped ? frame->height - 1 - y : y) * frame->width;
+	}
+
+	BYTE* EncodePng(SnapshotFrame* frame, DWORD* size)
+	{
+		DWORD stride = frame->width * 3 + 1;
+		DWORD rawSize = stride * frame->height;
+
+		DWORD maxSize = 8 + 25 + 12 + Deflate::Bound(rawSize) + 12;
+		BYTE* buffer = (BYTE*)MemoryAlloc(maxSize + rawSize + stride * 4 + DEFLATE_WINDOW * sizeof(DWORD));
+		if (!buffer)
+			return NULL;
+
+		BYTE* raw = buffer + maxSize;
+		BYTE* lines = raw + rawSize;
+		DWORD* head = (DWORD*)(lines + stride * 4);
+
+		{
+			BYTE* prev = lines;
+			BYTE* curr = lines + stride;
+			BYTE* sub = curr + stride;
+			BYTE* up = sub + stride;
+			MemoryZero(prev, stride);
+
+			BYTE* dst = raw;
+			for (DWORD y = 0; y < frame->height; ++y)
+			{
+				const DWORD* src = GetRow(frame, y);
+				BYTE* line = curr + 1;
+				DWORD count = frame->width;
+				do
+				{
+					DWORD px = *src++;
+					*line++ = LOBYTE(px >> 16);
+					*line++ = LOBYTE(px >> 8);
+					*line++ = LOBYTE(px);
+				} while (--count);
+
+				DWORD sumNone = 0, sumSub = 0, sumUp = 0;
+				for (DWORD i = 1; i < stride; ++i)
+				{
+					BYTE n = curr[i];
+					BYTE s = BYTE(n - (i > 3 ? curr[i - 3] : 0));
+					BYTE u = BYTE(n - prev[i]);
+
+					sub[i] = s;
+					up[i] = u;
+
+					sumNone += n < 128 ? n : 256 - n;
+					sumSub += s < 128 ? s : 256 - s;
+					sumUp += u < 128 ? u : 256 - u;
+				}
+
+				if (sumSub < sumNone && sumSub <= sumUp)
+				{
+					sub[0] = 1;
+					MemoryCopy(dst, sub, stride);
+				}
+				else if (sumUp < sumNone)
+				{
+					up[0] = 2;
+					MemoryCopy(dst, up, stride);
+				}
+				else
+				{
+					curr[0] = 0;
+					MemoryCopy(dst, curr, stride);
+				}
+
+				dst += stride;
+
+				BYTE* swap = prev;
+				prev = curr;
+				curr = swap;
+			}
+		}
+
+		static const BYTE signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		BYTE* ptr = buffer;
+		MemoryCopy(ptr, signature, sizeof(signature));
+		ptr += sizeof(signature);
+
+		{
+			BYTE* chunk = ptr;
+			ptr = PutLong(ptr, 13);
+			*(DWORD*)ptr = 'RDHI';
+			ptr += 4;
+			ptr = PutLong(ptr, frame->width);
+			ptr = PutLong(ptr, frame->height);
+			*ptr++ = 8;
+			*ptr++ = 2;
+			*ptr++ = 0;
+			*ptr++ = 0;
+			*ptr++ = 0;
+			ptr = PutLong(ptr, ~Deflate::Crc32(chunk + 4, 17));
+		}
+
+		{
+			BYTE* chunk = ptr;
+			ptr += 4;
+			*(DWORD*)ptr = 'TADI';
+			ptr += 4;
+
+			BYTE* data = ptr;
+			ptr = Deflate::Compress(ptr, raw, rawSize, head);
+
+			DWORD length = ptr - data;
+			PutLong(chunk, length);
+			ptr = PutLong(ptr, ~Deflate::Crc32(chunk + 4, length + 4));
+		}
+
+		{
+			ptr = PutLong(ptr, 0);
+			BYTE* chunk = ptr;
+			*(DWORD*)ptr = 'DNEI';
+			ptr += 4;
+			ptr = PutLong(ptr, ~Deflate::Crc32(chunk, 4));
+		}
+
+		*size = ptr - buffer;
+		return buffer;
+	}
+
+	BYTE* EncodeQoi(SnapshotFrame* frame, DWORD* size)
+	{
+		BYTE* buffer = (BYTE*)MemoryAlloc(14 + frame->width * frame->height * 4 + 8);
+		if (!buffer)
+			return NULL;
+
+		BYTE* ptr = buffer;
+		*(DWORD*)ptr = 'fioq';
+		ptr += 4;
+		ptr = PutLong(ptr, frame->width);
+		ptr = PutLong(ptr, frame->height);
+		*ptr++ = 3;
+		*ptr++ = 0;
+
+		DWORD index[64];
+		MemoryZero(index, sizeof(index));
+
+		DWORD prev = 0xFF000000;
+		DWORD run = 0;
+		for (DWORD y = 0; y < frame->height; ++y)
+		{
+			const DWORD* src = GetRow(frame, y);
+			DWORD count = frame->width;
+			do
+			{
+				DWORD px = *src++ | 0xFF000000;
+				if (px == prev)
+				{
+					if (++run == 62)
+					{
+						*ptr++ = 0xC0 | (run - 1);
+						run = 0;
+					}
+
+					continue;
+				}
+
+				if (run)
+				{
+					*ptr++ = 0xC0 | (run - 1);
+					run = 0;
+				}
+
+				INT r = LOBYTE(px >> 16);
+				INT g = LOBYTE(px >> 8);
+				INT b = LOBYTE(px);
+
+				DWORD hash = (r * 3 + g * 5 + b * 7 + 255 * 11) & 63;
+				if (index[hash] == px)
+					*ptr++ = (BYTE)hash;
+				else
+				{
+					index[hash] = px;
+
+					CHAR vr = CHAR(r - LOBYTE(prev >> 16));
+					CHAR vg = CHAR(g - LOBYTE(prev >> 8));
+					CHAR vb = CHAR(b - LOBYTE(prev));
+					CHAR vgr = vr - vg;
+					CHAR vgb = vb - vg;
+
+					if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2)
+						*ptr++ = 0x40 | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2);
+					else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8)
+					{
+						*ptr++ = 0x80 | (vg + 32);
+						*ptr++ = ((vgr + 8) << 4) | (vgb + 8);
+					}
+					else
+					{
+						*ptr++ = 0xFE;
+						*ptr++ = (BYTE)r;
+						*ptr++ = (BYTE)g;
+						*ptr++ = (BYTE)b;
+					}
+				}
+
+				prev = px;
+			} while (--count);
+		}
+
+		if (run)
+			*ptr++ = 0xC0 | (run - 1);
+
+		static const BYTE padding[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+		MemoryCopy(ptr, padding, sizeof(padding));
+		ptr += sizeof(padding);
+
+		*size = ptr - buffer;
+		return buffer;
+	}
+#pragma endregion
+
+	VOID WriteToFile(SnapshotFrame* frame)
+	{
+		DWORD size;
+		BYTE* data = config.snapshot == SnapshotQoi ? EncodeQoi(frame, &size) : EncodePng(frame, &size);
+		if (data)
+		{
+			CHAR path[MAX_PATH];
+			StrCopy(path, config.file);
+			CHAR* p = StrLastChar(path, '\\') + 1;
+			StrCopy(p, SNAPSHOT_DIR);
+			CreateDirectory(path, NULL);
+
+			SYSTEMTIME time;
+			GetLocalTime(&time);
+			StrPrint(p + sizeof(SNAPSHOT_DIR) - 1, "\\%04d%02d%02d_%02d%02d%02d_%03d%s",
+				time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond, time.wMilliseconds,
+				config.snapshot == SnapshotQoi ? ".qoi" : ".png");
+
+			HANDLE hFile = CreateFile(path, GENERIC_WRITE, NULL, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+			if (hFile != INVALID_HANDLE_VALUE)
+			{
+				DWORD written;
+				WriteFile(hFile, data, size, &written, NULL);
+				CloseHandle(hFile);
+			}
+
+			MemoryFree(data);
+		}
+	}
+
+	VOID WriteToClipboard(SnapshotFrame* frame)
+	{
+		if (OpenClipboard(NULL))
+		{
+			EmptyClipboard();
+
+			DWORD pitch = frame->width * 3;
+			if (pitch & 3)
+				pitch = (pitch & 0xFFFFFFFC) + 4;
+
+			DWORD size = pitch * frame->height;
+			DWORD slice = sizeof(BITMAPINFOHEADER);
+			HGLOBAL hMemory = GlobalAlloc(GMEM_MOVEABLE, slice + size);
+			if (hMemory)
+			{
+				VOID* data = GlobalLock(hMemory);
+				if (data)
+				{
+					BITMAPINFOHEADER* bmi = (BITMAPINFOHEADER*)data;
+					bmi->biSize = sizeof(BITMAPINFOHEADER);
+					bmi->biWidth = frame->width;
+					bmi->biHeight = frame->height;
+					bmi->biPlanes = 1;
+					bmi->biBitCount = 24;
+					bmi->biCompression = BI_RGB;
+					bmi->biSizeImage = size;
+					bmi->biXPelsPerMeter = 1;
+					bmi->biYPelsPerMeter = 1;
+					bmi->biClrUsed = 0;
+					bmi->biClrImportant = 0;
+
+					BYTE* dstData = (BYTE*)data + slice + size - pitch;
+					for (DWORD y = 0; y < frame->height; ++y, dstData -= pitch)
+					{
+						const BYTE* src = (const BYTE*)GetRow(frame, y);
+						BYTE* dst = dstData;
+						DWORD count = frame->width;
+						do
+						{
+							*dst++ = *src++;
+							*dst++ = *src++;
+							*dst++ = *src++;
+							++src;
+						} while (--count);
+					}
+
+					GlobalUnlock(hMemory);
+					SetClipboardData(CF_DIB, hMemory);
+				}
+				else
+					GlobalFree(hMemory);
+			}
+
+			CloseClipboard();
+		}
+	}
+
+	VOID Recycle(SnapshotFrame* frame)
+	{
+		EnterCriticalSection(&section);
+		{
+			if (freeCount < SNAPSHOT_POOL)
+			{
+				frame->next = freeList;
+				freeList = frame;
+				++freeCount;
+				frame = NULL;
+			}
+		}
+		LeaveCriticalSection(&section);
+
+		if (frame)
+		{
+			AlignedFree(frame->data);
+			MemoryFree(frame);
+		}
+	}
+
+	DWORD __stdcall SnapshotThread(LPVOID lpParameter)
+	{
+		do
+		{
+			WaitForSingleObject(hEvent, INFINITE);
+
+			do
+			{
+				SnapshotFrame* frame;
+				EnterCriticalSection(&section);
+				{
+					frame = queue.first;
+					if (frame)
+					{
+						queue.first = frame->next;
+						if (!queue.first)
+							queue.last = NULL;
+					}
+				}
+				LeaveCriticalSection(&section);
+
+				if (!frame)
+					break;
+
+				if (config.snapshot == SnapshotClipboard)
+					WriteToClipboard(frame);
+				else
+					WriteToFile(frame);
+
+				Recycle(frame);
+			} while (TRUE);
+		} while (!isFinish);
+
+		return NULL;
+	}
+
+	VOID Create()
+	{
+		Deflate::Create();
+
+		InitializeCriticalSection(&section);
+		hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	}
+
+	VOID Stop()
+	{
+		if (hThread)
+		{
+			isFinish = TRUE;
+			SetEvent(hEvent);
+			WaitForSingleObject(hThread, INFINITE);
+			CloseHandle(hThread);
+			hThread = NULL;
+		}
+	}
+
+	VOID Release()
+	{
+		// Called under the loader lock, so it never waits on the worker; ~OpenDraw joins it through Stop
+		SnapshotFrame* frame = freeList;
+		freeList = NULL;
+		freeCount = 0;
+
+		while (frame)
+		{
+			SnapshotFrame* next = frame->next;
+
+			AlignedFree(frame->data);
+			MemoryFree(frame);
+
+			frame = next;
+		}
+
+		if (!hThread)
+		{
+			CloseHandle(hEvent);
+			hEvent = NULL;
+
+			DeleteCriticalSection(&section);
+		}
+	}
+
+	SnapshotFrame* Acquire(DWORD width, DWORD height)
+	{
+		if (!width || !height)
+			return NULL;
+
+		DWORD size = width * height * sizeof(DWORD);
+
+		SnapshotFrame* frame;
+		EnterCriticalSection(&section);
+		{
+			frame = freeList;
+			if (frame)
+			{
+				freeList = frame->next;
+				--freeCount;
+			}
+		}
+		LeaveCriticalSection(&section);
+
+		if (frame && frame->capacity < size)
+		{
+			AlignedFree(frame->data);
+			frame->data = NULL;
+		}
+		else if (!frame)
+		{
+			frame = (SnapshotFrame*)MemoryAlloc(sizeof(SnapshotFrame));
+			if (!frame)
+				return NULL;
+
+			frame->data = NULL;
+		}
+
+		if (!frame->data)
+		{
+			frame->capacity = size;
+			frame->data = (DWORD*)AlignedAlloc(size);
+			if (!frame->data)
+			{
+				MemoryFree(frame);
+				return NULL;
+			}
+		}
+
+		frame->next = NULL;
+		frame->width = width;
+		frame->height = height;
+		frame->isFlipped = FALSE;
+
+		return frame;
+	}
+
+	VOID Commit(SnapshotFrame* frame)
+	{
+		EnterCriticalSection(&section);
+		{
+			if (queue.last)
+				queue.last->next = frame;
+			else
+				queue.first = frame;
+			queue.last = frame;
+
+			if (!hThread)
+			{
+				isFinish = FALSE;
+
+				DWORD threadId;
+				SECURITY_ATTRIBUTES sAttribs = { sizeof(SECURITY_ATTRIBUTES), NULL, FALSE };
+				hThread = CreateThread(&sAttribs, NULL, SnapshotThread, NULL, NORMAL_PRIORITY_CLASS, &threadId);
+				if (hThread)
+					SetThreadPriority(hThread, THREAD_PRIORITY_BELOW_NORMAL);
+			}
+		}
+		LeaveCriticalSection(&section);
+
+		SetEvent(hEvent);
+	}
+}
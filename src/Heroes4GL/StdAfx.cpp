@@ -36,6 +36,9 @@ DEACTIVATEACTCTX DeactivateActCtxC;
 
 SETTHREADLANGUAGE SetThreadLanguage;
 
+ADDVECTOREDEXCEPTIONHANDLER AddVectoredExceptionHandlerC;
+REMOVEVECTOREDEXCEPTIONHANDLER RemoveVectoredExceptionHandlerC;
+
 SETPROCESSDPIAWARENESS SetProcessDpiAwarenessC;
 
 #define LIBEXP(a) DWORD p##a; VOID __declspec(naked,nothrow) __stdcall ex##a() { LoadDDraw(); _asm { jmp p##a } }
@@ -70,40 +73,6 @@ DOUBLE MathRound(DOUBLE number)
 	return floorVal + 0.5f > number ? floorVal : MathCeil(number);
 }
 
-struct Aligned {
-	Aligned* last;
-	VOID* block;
-	DWORD data[1];
-} * alignedList;
-
-VOID* AlignedAlloc(size_t size)
-{
-	Aligned* entry = (Aligned*)MemoryAlloc(sizeof(Aligned) + size + 12);
-	entry->last = alignedList;
-	entry->block = (VOID*)(DWORD(entry->data + 4) & 0xFFFFFFF0);
-	alignedList = entry;
-
-	return entry->block;
-}
-
-VOID AlignedFree(VOID* block)
-{
-	Aligned** list = &alignedList;
-	Aligned* entry = alignedList;
-	while (entry)
-	{
-		if (entry->block == block)
-		{
-			*list = entry->last;
-			MemoryFree(entry);
-			break;
-		}
-
-		list = &entry->last;
-		entry = entry->last;
-	}
-}
-
 VOID LoadKernel32()
 {
 	HMODULE hLib = GetModuleHandle("KERNEL32.dll");
@@ -114,6 +83,8 @@ VOID LoadKernel32()
 		ActivateActCtxC = (ACTIVATEACTCTX)GetProcAddress(hLib, "ActivateActCtx");
 		DeactivateActCtxC = (DEACTIVATEACTCTX)GetProcAddress(hLib, "DeactivateActCtx");
 		SetThreadLanguage = (SETTHREADLANGUAGE)GetProcAddress(hLib, "SetThreadUILanguage");
+		AddVectoredExceptionHandlerC = (ADDVECTOREDEXCEPTIONHANDLER)GetProcAddress(hLib, "AddVectoredExceptionHandler");
+		RemoveVectoredExceptionHandlerC = (REMOVEVECTOREDEXCEPTIONHANDLER)GetProcAddress(hLib, "RemoveVectoredExceptionHandler");
 	}
 }
 
@@ -52,6 +52,12 @@ typedef DWORD(__stdcall* SETTHREADLANGUAGE)(DWORD lang);
 
 extern SETTHREADLANGUAGE SetThreadLanguage;
 
+typedef PVOID(__stdcall* ADDVECTOREDEXCEPTIONHANDLER)(ULONG first, PVECTORED_EXCEPTION_HANDLER handler);
+typedef ULONG(__stdcall* REMOVEVECTOREDEXCEPTIONHANDLER)(PVOID handle);
+
+extern ADDVECTOREDEXCEPTIONHANDLER AddVectoredExceptionHandlerC;
+extern REMOVEVECTOREDEXCEPTIONHANDLER RemoveVectoredExceptionHandlerC;
+
 typedef HRESULT(__stdcall* SETPROCESSDPIAWARENESS)(PROCESS_DPI_AWARENESS);
 
 extern SETPROCESSDPIAWARENESS SetProcessDpiAwarenessC;
@@ -100,9 +106,15 @@ extern "C"
 #define FileClose(stream) fclose(stream)
 #define Exit(code) exit(code)
 
+#define ALIGNED_BOUNDARY 64
+#define ALIGNED_CLASS 0x10000
+#define ALIGNED_SLOTS 8
+#define ALIGNED_LIMIT (64 << 20)
+
 DOUBLE MathRound(DOUBLE);
 VOID* AlignedAlloc(size_t);
 VOID AlignedFree(VOID*);
+VOID AlignedRelease();
 
 extern HMODULE hDllModule;
 extern HANDLE hActCtx;
@@ -33,8 +33,11 @@
 #include "Config.h"
 #include "Hooks.h"
 #include "OpenDraw.h"
+#include "intrin.h"
 
 #define WM_REDRAW_CANVAS 0x8001
+#define IDT_HISTOGRAM 1
+#define IDT_CANVAS 2
 
 namespace Window
 {
@@ -157,6 +160,12 @@ namespace Window
 			case FpsBenchmark:
 				menuId = IDM_FPS_BENCHMARK;
 				break;
+			case FpsLatency:
+				menuId = IDM_FPS_LATENCY;
+				break;
+			case FpsIdle:
+				menuId = IDM_FPS_IDLE;
+				break;
 			default:
 				menuId = IDM_FPS_OFF;
 				break;
@@ -165,6 +174,8 @@ namespace Window
 			CheckMenuItem(hMenu, IDM_FPS_OFF, MF_BYCOMMAND | (menuId == IDM_FPS_OFF ? MF_CHECKED : MF_UNCHECKED));
 			CheckMenuItem(hMenu, IDM_FPS_NORMAL, MF_BYCOMMAND | (menuId == IDM_FPS_NORMAL ? MF_CHECKED : MF_UNCHECKED));
 			CheckMenuItem(hMenu, IDM_FPS_BENCHMARK, MF_BYCOMMAND | (menuId == IDM_FPS_BENCHMARK ? MF_CHECKED : MF_UNCHECKED));
+			CheckMenuItem(hMenu, IDM_FPS_LATENCY, MF_BYCOMMAND | (menuId == IDM_FPS_LATENCY ? MF_CHECKED : MF_UNCHECKED));
+			CheckMenuItem(hMenu, IDM_FPS_IDLE, MF_BYCOMMAND | (menuId == IDM_FPS_IDLE ? MF_CHECKED : MF_UNCHECKED));
 
 			MenuItemData mData;
 			mData.childId = IDM_FPS_OFF;
@@ -318,7 +329,7 @@ namespace Window
 		break;
 
 		case MenuColors: {
-			EnableMenuItem(hMenu, IDM_COLOR_ADJUST, MF_BYCOMMAND | (config.gl.version.value >= GL_VER_2_0 ? MF_ENABLED : (MF_DISABLED | MF_GRAYED)));
+			EnableMenuItem(hMenu, IDM_COLOR_ADJUST, MF_BYCOMMAND | (config.gl.version.value ? MF_ENABLED : (MF_DISABLED | MF_GRAYED)));
 		}
 		break;
 
@@ -673,6 +684,138 @@ namespace Window
 		return DefWindowProc(hDlg, uMsg, wParam, lParam);
 	}
 
+	BOOL IsToneChanged(const Adjustment* a, const Adjustment* b, DWORD idx)
+	{
+		return a->input.left.chanel[idx] != b->input.left.chanel[idx]
+			|| a->input.right.chanel[idx] != b->input.right.chanel[idx]
+			|| a->gamma.chanel[idx] != b->gamma.chanel[idx]
+			|| a->output.left.chanel[idx] != b->output.left.chanel[idx]
+			|| a->output.right.chanel[idx] != b->output.right.chanel[idx];
+	}
+
+	VOID UpdateTone(LevelsData* levelsData)
+	{
+		const Adjustment* active = &config.colors.active;
+		BOOL isRgb = !levelsData->isTone || IsToneChanged(&levelsData->toneValues, active, 0);
+
+		struct {
+			Levels input;
+			Levels gamma;
+			Levels output;
+		} levels;
+
+		for (DWORD i = 0; i < 4; ++i)
+		{
+			levels.input.chanel[i] = active->input.right.chanel[i] - active->input.left.chanel[i];
+			levels.gamma.chanel[i] = 1.0f / (FLOAT)MathPower(2.0f * active->gamma.chanel[i], 3.32f);
+			levels.output.chanel[i] = active->output.right.chanel[i] - active->output.left.chanel[i];
+		}
+
+		for (DWORD j = 0; j < 3; ++j)
+		{
+			if (isRgb || IsToneChanged(&levelsData->toneValues, active, j + 1))
+			{
+				BYTE* tone = levelsData->tone[j];
+				for (DWORD i = 0; i < 256; ++i)
+				{
+					FLOAT k = (FLOAT)i / 255.0f;
+					for (DWORD s = 2, idx = j + 1; s; --s, idx = 0)
+					{
+						k = (k - active->input.left.chanel[idx]) / levels.input.chanel[idx];
+						k = min(1.0f, max(0.0f, k));
+						k = (FLOAT)MathPower(k, levels.gamma.chanel[idx]);
+						k = k * levels.output.chanel[idx] + active->output.left.chanel[idx];
+					}
+
+					tone[i] = (BYTE)(k * 255.0f);
+				}
+			}
+		}
+
+		levelsData->toneValues = *active;
+		levelsData->isTone = TRUE;
+	}
+
+	VOID SmoothLevels(const FLOAT* src, FLOAT* dst, DWORD count, BOOL isClamp)
+	{
+		const FLOAT outer = FLOAT(0.125 / 6.0);
+		const FLOAT inner = FLOAT(2.875 / 6.0);
+
+		if (config.isSSE2)
+		{
+			__m128 vOuter = _mm_set1_ps(outer);
+			__m128 vInner = _mm_set1_ps(inner);
+			__m128 vMin = _mm_setzero_ps();
+			__m128 vMax = _mm_set1_ps(1.0f);
+
+			for (; count >= 4; count -= 4, src += 4, dst += 4)
+			{
+				__m128 v = _mm_add_ps(
+					_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(src), _mm_loadu_ps(src + 9)), vOuter),
+					_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(src + 3), _mm_loadu_ps(src + 6)), vInner));
+
+				if (isClamp)
+					v = _mm_min_ps(_mm_max_ps(v, vMin), vMax);
+
+				_mm_storeu_ps(dst, v);
+			}
+		}
+
+		for (; count; --count, ++src, ++dst)
+		{
+			FLOAT v = (src[0] + src[9]) * outer + (src[3] + src[6]) * inner;
+			*dst = isClamp ? min(1.0f, max(0.0f, v)) : v;
+		}
+	}
+
+	VOID ResampleCanvas(LevelsData* levelsData, LONG width)
+	{
+		const CanvasTap* tap = levelsData->taps;
+		for (LONG i = 0; i < width; ++i, ++tap)
+		{
+			const DWORD* src = levelsData->bmpData + tap->index;
+			DWORD* dst = levelsData->data + i;
+
+			if (config.isSSE2)
+			{
+				__m128 w0 = _mm_set1_ps(tap->weight[0]);
+				__m128 w1 = _mm_set1_ps(tap->weight[1]);
+				__m128 w2 = _mm_set1_ps(tap->weight[2]);
+				__m128 w3 = _mm_set1_ps(tap->weight[3]);
+				__m128i zero = _mm_setzero_si128();
+
+				for (DWORD j = 0; j < 100; ++j, src += 516, dst += width)
+				{
+					__m128i px = _mm_loadu_si128((const __m128i*)src);
+					__m128i lo = _mm_unpacklo_epi8(px, zero);
+					__m128i hi = _mm_unpackhi_epi8(px, zero);
+
+					__m128 sum = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), w0);
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), w1));
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), w2));
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), w3));
+
+					__m128i res = _mm_cvttps_epi32(sum);
+					res = _mm_packs_epi32(res, res);
+					*dst = _mm_cvtsi128_si32(_mm_packus_epi16(res, res));
+				}
+			}
+			else
+			{
+				for (DWORD j = 0; j < 100; ++j, src += 516, dst += width)
+				{
+					const BYTE* s = (const BYTE*)src;
+					BYTE* d = (BYTE*)dst;
+					for (DWORD c = 0; c < 3; ++c, ++s)
+					{
+						INT v = INT(tap->weight[0] * s[0] + tap->weight[1] * s[4] + tap->weight[2] * s[8] + tap->weight[3] * s[12]);
+						d[c] = LOBYTE(min(255, max(0, v)));
+					}
+				}
+			}
+		}
+	}
+
 	LRESULT __stdcall ColorAdjustmentProc(HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lParam)
 	{
 		switch (uMsg)
@@ -727,34 +870,14 @@ namespace Window
 				levelsData->delta = 0.7f;
 				levelsData->values = config.colors.active;
 
+				HDC hDc = GetDC(hDlg);
+				DWORD rate = GetDeviceCaps(hDc, VREFRESH);
+				ReleaseDC(hDlg, hDc);
+				levelsData->interval = rate > 1 ? 1000 / rate : 16;
+
 				OpenDraw* ddraw = Main::FindOpenDrawByWindow(GetParent(hDlg));
-				if (ddraw && ddraw->attachedSurface && ddraw->attachedSurface->indexBuffer)
+				if (ddraw)
 				{
-					OpenDrawSurface* surface = ddraw->attachedSurface;
-
-					struct {
-						DWORD width;
-						DWORD height;
-					} size = {
-						surface->width,
-						surface->height
-					};
-
-					LevelColors levels[256] = {};
-
-					WORD* data = (WORD*)surface->indexBuffer;
-					DWORD count = size.width * size.height;
-					do
-					{
-						WORD p = *data++;
-						DWORD px = ((p & 0xF800) >> 8) | ((p & 0x07E0) << 5) | ((p & 0x001F) << 19);
-
-						BYTE* b = (BYTE*)&px;
-						++levels[*b++].red;
-						++levels[*b++].green;
-						++levels[*b].blue;
-					} while (--count);
-
 					levelsData->hDc = CreateCompatibleDC(NULL);
 					if (levelsData->hDc)
 					{
@@ -776,22 +899,30 @@ namespace Window
 						{
 							SelectObject(levelsData->hDc, levelsData->hBmp);
 
-							DWORD total = size.width * size.height;
-
-							LevelColors* src = levels;
-							LevelColorsFloat* dst = levelsData->colors;
-							DWORD count = 256;
-							do
+							levelsData->taps = (CanvasTap*)MemoryAlloc(rc.right * sizeof(CanvasTap));
+							if (levelsData->taps)
 							{
-								dst->red = (FLOAT)src->red / total;
-								dst->green = (FLOAT)src->green / total;
-								dst->blue = (FLOAT)src->blue / total;
-
-								++src;
-								++dst;
-							} while (--count);
+								CanvasTap* tap = levelsData->taps;
+								for (LONG i = 0; i < rc.right; ++i, ++tap)
+								{
+									FLOAT pos = (FLOAT)i / rc.right * 514.0f;
+									tap->index = DWORD(pos);
+									pos -= (FLOAT)tap->index;
+
+									FLOAT pos2 = pos * pos;
+									FLOAT pos3 = pos2 * pos;
+									tap->weight[0] = 0.5f * (2.0f * pos2 - pos - pos3);
+									tap->weight[1] = 1.0f + 0.5f * (3.0f * pos3 - 5.0f * pos2);
+									tap->weight[2] = 0.5f * (pos + 4.0f * pos2 - 3.0f * pos3);
+									tap->weight[3] = 0.5f * (pos3 - pos2);
+								}
+							}
 						}
 					}
+
+					ddraw->histogram->Enable(TRUE);
+					SetEvent(ddraw->hDrawEvent);
+					SetTimer(hDlg, IDT_HISTOGRAM, HISTOGRAM_INTERVAL, NULL);
 				}
 			}
 
@@ -856,6 +987,24 @@ namespace Window
 		}
 
 		case WM_REDRAW_CANVAS: {
+			LevelsData* levelsData = (LevelsData*)GetWindowLong(hDlg, GWLP_USERDATA);
+			if (levelsData)
+			{
+				DWORD elapsed = GetTickCount() - levelsData->drawTick;
+				if (elapsed < levelsData->interval)
+				{
+					if (!levelsData->isPending)
+					{
+						levelsData->isPending = TRUE;
+						SetTimer(hDlg, IDT_CANVAS, levelsData->interval - elapsed, NULL);
+					}
+
+					return NULL;
+				}
+
+				levelsData->drawTick += elapsed;
+			}
+
 			HWND hImg = GetDlgItem(hDlg, IDC_CANVAS);
 
 			RECT rc;
@@ -869,6 +1018,34 @@ namespace Window
 			return NULL;
 		}
 
+		case WM_TIMER: {
+			if (wParam == IDT_HISTOGRAM)
+			{
+				OpenDraw* ddraw = Main::FindOpenDrawByWindow(GetParent(hDlg));
+				LevelsData* levelsData = (LevelsData*)GetWindowLong(hDlg, GWLP_USERDATA);
+				if (ddraw && levelsData)
+				{
+					if (ddraw->histogram->Get(levelsData->colors, &levelsData->version))
+						SendMessage(hDlg, WM_REDRAW_CANVAS, NULL, NULL);
+
+					SetEvent(ddraw->hDrawEvent);
+				}
+			}
+			else if (wParam == IDT_CANVAS)
+			{
+				KillTimer(hDlg, IDT_CANVAS);
+
+				LevelsData* levelsData = (LevelsData*)GetWindowLong(hDlg, GWLP_USERDATA);
+				if (levelsData)
+				{
+					levelsData->isPending = FALSE;
+					SendMessage(hDlg, WM_REDRAW_CANVAS, NULL, NULL);
+				}
+			}
+
+			break;
+		}
+
 		case WM_DRAWITEM: {
 			if (wParam == IDC_CANVAS)
 			{
@@ -882,18 +1059,7 @@ namespace Window
 						FLOAT h = 2.0f * config.colors.active.satHue.hueShift - 1.0f;
 						FLOAT s = 4.0f * config.colors.active.satHue.saturation * config.colors.active.satHue.saturation;
 
-						struct {
-							Levels input;
-							Levels gamma;
-							Levels output;
-						} levels;
-
-						for (DWORD i = 0; i < 4; ++i)
-						{
-							levels.input.chanel[i] = config.colors.active.input.right.chanel[i] - config.colors.active.input.left.chanel[i];
-							levels.gamma.chanel[i] = 1.0f / (FLOAT)MathPower(2.0f * config.colors.active.gamma.chanel[i], 3.32f);
-							levels.output.chanel[i] = config.colors.active.output.right.chanel[i] - config.colors.active.output.left.chanel[i];
-						}
+						UpdateTone(levelsData);
 
 						INT sh = 0;
 						if (h < 0.0f)
@@ -905,8 +1071,6 @@ namespace Window
 						LevelColorsFloat* src = levelsData->colors;
 						for (DWORD i = 0; i < 256; ++i, ++src)
 						{
-							FLOAT dx = (FLOAT)i / 255.0f;
-
 							LevelColorsFloat ex;
 							FLOAT sss = 0;
 							for (DWORD j = 0; j < 3; ++j)
@@ -921,18 +1085,7 @@ namespace Window
 							sss /= 3;
 
 							for (DWORD j = 0; j < 3; ++j)
-							{
-								FLOAT k = dx;
-								for (DWORD s = 2, idx = j + 1; s; --s, idx = 0)
-								{
-									k = (k - config.colors.active.input.left.chanel[idx]) / levels.input.chanel[idx];
-									k = min(1.0f, max(0.0f, k));
-									k = (FLOAT)MathPower(k, levels.gamma.chanel[idx]);
-									k = k * levels.output.chanel[idx] + config.colors.active.output.left.chanel[idx];
-								}
-
-								prep[(DWORD)(k * 255.0f) + 2].chanel[j] += sss - (sss - ex.chanel[j]) * s;
-							}
+								prep[levelsData->tone[j][i] + 2].chanel[j] += sss - (sss - ex.chanel[j]) * s;
 						}
 					}
 
@@ -942,52 +1095,16 @@ namespace Window
 					LevelColorsFloat floats[259];
 					for (DWORD y = 4; y; --y)
 					{
-						{
-							LevelColorsFloat* src = prep;
-							LevelColorsFloat* dst = floats + 1;
-							DWORD count = 257;
-							do
-							{
-								for (DWORD i = 0; i < 3; ++i)
-									dst->chanel[i] = FLOAT((src[0].chanel[i] + src[3].chanel[i]) * (0.125 / 6.0) + (src[1].chanel[i] + src[2].chanel[i]) * (2.875 / 6.0));
-
-								++src;
-								++dst;
-							} while (--count);
-						}
+						SmoothLevels((FLOAT*)prep, (FLOAT*)(floats + 1), 257 * 3, FALSE);
 						floats[0] = floats[1];
 						floats[258] = floats[257];
 
-						{
-							LevelColorsFloat* src = floats;
-							LevelColorsFloat* dst = prep + 2;
-							DWORD count = 256;
-							do
-							{
-								for (DWORD i = 0; i < 3; ++i)
-									dst->chanel[i] = FLOAT((src[0].chanel[i] + src[3].chanel[i]) * (0.125 / 6.0) + (src[1].chanel[i] + src[2].chanel[i]) * (2.875 / 6.0));
-
-								++src;
-								++dst;
-							} while (--count);
-						}
+						SmoothLevels((FLOAT*)floats, (FLOAT*)(prep + 2), 256 * 3, FALSE);
 						prep[1] = prep[2];
 						prep[258] = prep[257];
 					}
 
-					{
-						LevelColorsFloat* src = prep;
-						LevelColorsFloat* dst = floats + 1;
-						DWORD count = 257;
-						do
-						{
-							for (DWORD i = 0; i < 3; ++i)
-								dst->chanel[i] = min(1.0f, max(0.0f, FLOAT((src[0].chanel[i] + src[3].chanel[i]) * (0.125 / 6.0) + (src[1].chanel[i] + src[2].chanel[i]) * (2.875 / 6.0))));
-
-							++src;
-							++dst;
-						} while (--count);
-					}
+					SmoothLevels((FLOAT*)prep, (FLOAT*)(floats + 1), 257 * 3, TRUE);
 
 					FLOAT max = 0.0;
 					{
@@ -1113,27 +1230,8 @@ namespace Window
 							RECT rc;
 							GetClientRect(hImg, &rc);
 
-							for (LONG i = 0; i < rc.right; ++i)
-							{
-								FLOAT pos = (FLOAT)i / rc.right * 514.0f;
-								DWORD index = DWORD(pos);
-								pos -= (FLOAT)index;
-
-								DWORD* dest = levelsData->data + i;
-								for (DWORD j = 0; j < 100; ++j)
-								{
-									BYTE* src = (BYTE*)&levelsData->bmpData[j * 516 + index];
-									BYTE* dst = (BYTE*)dest;
-
-									for (DWORD j = 0; j < 3; ++j, ++src)
-									{
-										INT d = INT(src[4] + 0.5 * pos * (src[8] - src[0] + pos * (2 * src[0] - 5 * src[4] + 4 * src[8] - src[12] + pos * (3 * (src[4] - src[8]) + src[12] - src[0]))));
-										dst[j] = LOBYTE(min(255, max(0, d)));
-									}
-
-									dest += rc.right;
-								}
-							}
+							if (levelsData->taps)
+								ResampleCanvas(levelsData, rc.right);
 
 							if (levelsData->hBmp)
 								BitBlt(paint->hDC, 0, 0, rc.right, 100, levelsData->hDc, 0, 0, SRCCOPY);
@@ -1532,6 +1630,12 @@ namespace Window
 		}
 
 		case WM_DESTROY: {
+			KillTimer(hDlg, IDT_HISTOGRAM);
+			KillTimer(hDlg, IDT_CANVAS);
+			OpenDraw* ddraw = Main::FindOpenDrawByWindow(GetParent(hDlg));
+			if (ddraw)
+				ddraw->histogram->Enable(FALSE);
+
 			LevelsData* levelsData = (LevelsData*)GetWindowLong(hDlg, GWLP_USERDATA);
 			if (levelsData)
 			{
@@ -1543,6 +1647,9 @@ namespace Window
 						DeleteObject(levelsData->hBmp);
 				}
 
+				if (levelsData->taps)
+					MemoryFree(levelsData->taps);
+
 				config.colors.active = levelsData->values;
 				MemoryFree(levelsData);
 			}
@@ -1562,16 +1669,29 @@ namespace Window
 		{
 		case WM_ERASEBKGND: {
 			OpenDraw* ddraw = Main::FindOpenDrawByWindow(hWnd);
-			if (ddraw && ddraw->windowState != WinStateWindowed)
+			if (ddraw)
 			{
-				RECT rc;
-				GetClientRect(hWnd, &rc);
-				FillRect((HDC)wParam, &rc, (HBRUSH)GetStockObject(BLACK_BRUSH));
-				return TRUE;
+				ddraw->Redraw();
+
+				if (ddraw->windowState != WinStateWindowed)
+				{
+					RECT rc;
+					GetClientRect(hWnd, &rc);
+					FillRect((HDC)wParam, &rc, (HBRUSH)GetStockObject(BLACK_BRUSH));
+					return TRUE;
+				}
 			}
 			return NULL;
 		}
 
+		case WM_PAINT: {
+			OpenDraw* ddraw = Main::FindOpenDrawByWindow(hWnd);
+			if (ddraw)
+				ddraw->Redraw();
+
+			return CallWindowProc(OldWindowProc, hWnd, uMsg, wParam, lParam);
+		}
+
 		case WM_MOVE: {
 			OpenDraw* ddraw = Main::FindOpenDrawByWindow(hWnd);
 			if (ddraw)
@@ -1613,7 +1733,7 @@ namespace Window
 				else
 				{
 					config.colors.current = (BOOL)wParam ? &config.colors.active : &inactiveColors;
-					SetEvent(ddraw->hDrawEvent);
+					ddraw->Redraw();
 				}
 			}
 
@@ -1621,8 +1741,13 @@ namespace Window
 			return CallWindowProc(OldWindowProc, hWnd, uMsg, wParam, lParam);
 		}
 
-		case WM_ACTIVATE:
+		case WM_ACTIVATE: {
+			OpenDraw* ddraw = Main::FindOpenDrawByWindow(hWnd);
+			if (ddraw && LOWORD(wParam) != WA_INACTIVE)
+				ddraw->Redraw();
+
 			return DefWindowProc(hWnd, uMsg, wParam, lParam);
+		}
 
 		case WM_SYSKEYDOWN:
 		case WM_KEYDOWN: {
@@ -1634,6 +1759,12 @@ namespace Window
 					FpsChanged(hWnd, FpsBenchmark);
 					break;
 				case FpsBenchmark:
+					FpsChanged(hWnd, FpsLatency);
+					break;
+				case FpsLatency:
+					FpsChanged(hWnd, FpsIdle);
+					break;
+				case FpsIdle:
 					FpsChanged(hWnd, FpsDisabled);
 					break;
 				default:
@@ -1831,6 +1962,16 @@ namespace Window
 				return NULL;
 			}
 
+			case IDM_FPS_LATENCY: {
+				FpsChanged(hWnd, FpsLatency);
+				return NULL;
+			}
+
+			case IDM_FPS_IDLE: {
+				FpsChanged(hWnd, FpsIdle);
+				return NULL;
+			}
+
 			case IDM_FILT_OFF: {
 				InterpolationChanged(hWnd, InterpolateNearest);
 				return NULL;
@@ -2064,6 +2205,14 @@ namespace Window
 			return CallWindowProc(proc, hParent, uMsg, wParam, lParam);
 		}
 
+		case WM_PAINT: {
+			OpenDraw* ddraw = Main::FindOpenDrawByWindow(GetParent(hWnd));
+			if (ddraw)
+				ddraw->Redraw();
+
+			return DefWindowProc(hWnd, uMsg, wParam, lParam);
+		}
+
 		default:
 			return DefWindowProc(hWnd, uMsg, wParam, lParam);
 		}
@@ -0,0 +1,344 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "ColorTable.h"
+#include "ShaderProgram.h"
+#include "Config.h"
+
+DWORD __forceinline ToLevel(FLOAT value, DWORD max)
+{
+	if (!(value > 0.0f))
+		return 0;
+
+	if (value >= 1.0f)
+		return max;
+
+	return DWORD(value * max + 0.5f);
+}
+
+ColorTable::ColorTable(DWORD pitch, DWORD height, FpsMode format)
+{
+	this->pitch = pitch;
+	this->height = height;
+	this->format = format;
+	this->depth = format == FpsRgb ? sizeof(WORD) : sizeof(DWORD);
+
+	if (format == FpsBgra)
+	{
+		this->red = 2;
+		this->blue = 0;
+	}
+	else
+	{
+		this->red = 0;
+		this->blue = 2;
+	}
+
+	this->colors = defaultColors;
+	this->flags = 0;
+	this->isFull = TRUE;
+
+	this->table = NULL;
+	this->ramp = NULL;
+	this->rampSize = 0;
+	this->low = 0;
+	this->buffer = NULL;
+}
+
+ColorTable::~ColorTable()
+{
+	if (this->table)
+		MemoryFree(this->table);
+
+	if (this->ramp)
+		MemoryFree(this->ramp);
+
+	if (this->buffer)
+		MemoryFree(this->buffer);
+}
+
+VOID ColorTable::Mix(FLOAT* color)
+{
+	DWORD flags = this->flags;
+	Adjustment* colors = &this->colors;
+
+	if (flags & CMP_HUE)
+	{
+		FLOAT r = color[0];
+		FLOAT g = color[1];
+		FLOAT b = color[2];
+
+		FLOAT y = 2.0f * colors->satHue.hueShift;
+		if (y < 1.0f)
+		{
+			color[0] = b + 0.5f * y * (r - g + y * (g - 5.0f * b + 4.0f * r + 3.0f * y * (b - r)));
+			color[1] = r + 0.5f * y * (g - b + y * (b - 5.0f * r + 4.0f * g + 3.0f * y * (r - g)));
+			color[2] = g + 0.5f * y * (b - r + y * (r - 5.0f * g + 4.0f * b + 3.0f * y * (g - b)));
+		}
+		else
+		{
+			y -= 1.0f;
+			color[0] = r + 0.5f * y * (g - b + y * (b - 5.0f * r + 4.0f * g + 3.0f * y * (r - g)));
+			color[1] = g + 0.5f * y * (b - r + y * (r - 5.0f * g + 4.0f * b + 3.0f * y * (g - b)));
+			color[2] = b + 0.5f * y * (r - g + y * (g - 5.0f * b + 4.0f * r + 3.0f * y * (b - r)));
+		}
+	}
+
+	if (flags & CMP_SAT)
+	{
+		FLOAT sat = 4.0f * colors->satHue.saturation * colors->satHue.saturation;
+		FLOAT s = (color[0] + color[1] + color[2]) / 3.0f;
+		for (DWORD i = 0; i < 3; ++i)
+			color[i] = (color[i] - s) * sat + s;
+	}
+}
+
+VOID ColorTable::Grade(FLOAT* color)
+{
+	DWORD flags = this->flags;
+	for (DWORD i = 0; i < 3; ++i)
+	{
+		FLOAT c = this->Level(color[i], i + 1, flags & CMP_LEVELS_IN_RGB, flags & CMP_LEVELS_GAMMA_RGB, flags & CMP_LEVELS_OUT_RGB);
+		color[i] = this->Level(c, 0, flags & CMP_LEVELS_IN_A, flags & CMP_LEVELS_GAMMA_A, flags & CMP_LEVELS_OUT_A);
+	}
+}
+
+FLOAT ColorTable::Level(FLOAT value, DWORD index, DWORD isIn, DWORD isGamma, DWORD isOut)
+{
+	Adjustment* colors = &this->colors;
+
+	if (isIn)
+	{
+		value = (value - colors->input.left.chanel[index]) / (colors->input.right.chanel[index] - colors->input.left.chanel[index]);
+		value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+	}
+
+	if (isGamma)
+		value = value > 0.0f ? (FLOAT)MathPower(value, this->exponent[index]) : 0.0f;
+
+	if (isOut)
+	{
+		value = value * (colors->output.right.chanel[index] - colors->output.left.chanel[index]) + colors->output.left.chanel[index];
+		value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+	}
+
+	return value;
+}
+
+VOID ColorTable::Adjust(FLOAT* color)
+{
+	this->Mix(color);
+	this->Grade(color);
+}
+
+VOID ColorTable::Build()
+{
+	this->flags = ShaderProgram::CompareAdjustments(&this->colors, &defaultColors);
+	if (!this->flags)
+		return;
+
+	for (DWORD i = 0; i < 4; ++i)
+		this->exponent[i] = 1.0f / (FLOAT)MathPower(2.0f * this->colors.gamma.chanel[i], 3.32f);
+
+	if (!this->buffer)
+		this->buffer = (BYTE*)MemoryAlloc(this->pitch * this->height);
+
+	FLOAT color[3];
+	if (this->format == FpsRgb)
+	{
+		if (!this->table)
+			this->table = (WORD*)MemoryAlloc(65536 * sizeof(WORD));
+
+		WORD* dst = this->table;
+		if (this->flags & CMP_SATHUE)
+		{
+			for (DWORD i = 0; i < 65536; ++i)
+			{
+				color[0] = FLOAT((i >> 11) & 0x1F) / 31.0f;
+				color[1] = FLOAT((i >> 5) & 0x3F) / 63.0f;
+				color[2] = FLOAT(i & 0x1F) / 31.0f;
+				this->Adjust(color);
+
+				*dst++ = WORD((ToLevel(color[0], 0x1F) << 11) | (ToLevel(color[1], 0x3F) << 5) | ToLevel(color[2], 0x1F));
+			}
+		}
+		else
+		{
+			WORD curves[3][64];
+			for (DWORD i = 0; i < 64; ++i)
+			{
+				color[0] = FLOAT(i & 0x1F) / 31.0f;
+				color[1] = FLOAT(i) / 63.0f;
+				color[2] = color[0];
+				this->Adjust(color);
+
+				curves[0][i] = WORD(ToLevel(color[0], 0x1F) << 11);
+				curves[1][i] = WORD(ToLevel(color[1], 0x3F) << 5);
+				curves[2][i] = WORD(ToLevel(color[2], 0x1F));
+			}
+
+			for (DWORD i = 0; i < 65536; ++i)
+				*dst++ = curves[0][(i >> 11) & 0x1F] | curves[1][(i >> 5) & 0x3F] | curves[2][i & 0x1F];
+		}
+	}
+	else if (this->flags & CMP_SATHUE)
+	{
+		DWORD green = 1;
+		DWORD pos[3] = { this->red, green, this->blue };
+
+		INT low = 0;
+		INT high = 0;
+		for (DWORD i = 0; i < 3; ++i)
+		{
+			color[0] = color[1] = color[2] = 0.0f;
+			color[i] = 1.0f;
+			this->Mix(color);
+
+			for (DWORD j = 0; j < 3; ++j)
+				this->mix[pos[j]][pos[i]] = (INT)floor(color[j] * MIX_SCALE * 256.0f + 0.5f);
+		}
+
+		for (DWORD i = 0; i < 3; ++i)
+		{
+			INT bottom = 0;
+			INT top = 0;
+			for (DWORD j = 0; j < 3; ++j)
+			{
+				INT value = this->mix[i][j] * 255;
+				if (value < 0)
+					bottom += value;
+				else
+					top += value;
+			}
+
+			bottom = (bottom >> 8) - 1;
+			top = (top >> 8) + 1;
+			if (low > bottom)
+				low = bottom;
+			if (high < top)
+				high = top;
+		}
+
+		DWORD span = DWORD(high - low + 1);
+		if (this->rampSize < span)
+		{
+			if (this->ramp)
+				MemoryFree(this->ramp);
+
+			this->rampSize = span;
+			this->ramp = (BYTE*)MemoryAlloc(3 * span);
+		}
+
+		this->low = low;
+		BYTE* dst = this->ramp;
+		for (INT v = low; v <= high; ++v, dst += 3)
+		{
+			color[0] = color[1] = color[2] = FLOAT(v) / (255.0f * MIX_SCALE);
+			this->Grade(color);
+
+			dst[this->red] = BYTE(ToLevel(color[0], 0xFF));
+			dst[green] = BYTE(ToLevel(color[1], 0xFF));
+			dst[this->blue] = BYTE(ToLevel(color[2], 0xFF));
+		}
+	}
+	else
+	{
+		for (DWORD i = 0; i < 256; ++i)
+		{
+			color[0] = color[1] = color[2] = FLOAT(i) / 255.0f;
+			this->Adjust(color);
+
+			this->curve[this->red][i] = BYTE(ToLevel(color[0], 0xFF));
+			this->curve[1][i] = BYTE(ToLevel(color[1], 0xFF));
+			this->curve[this->blue][i] = BYTE(ToLevel(color[2], 0xFF));
+		}
+	}
+}
+
+VOID ColorTable::Convert(const BYTE* src, BYTE* dst)
+{
+	if (this->format == FpsRgb)
+		*(WORD*)dst = this->table[*(const WORD*)src];
+	else if (this->flags & CMP_SATHUE)
+	{
+		for (DWORD i = 0; i < 3; ++i)
+		{
+			INT* mix = this->mix[i];
+			INT value = (mix[0] * src[0] + mix[1] * src[1] + mix[2] * src[2] + 0x80) >> 8;
+			dst[i] = this->ramp[(value - this->low) * 3 + i];
+		}
+
+		dst[3] = src[3];
+	}
+	else
+	{
+		dst[0] = this->curve[0][src[0]];
+		dst[1] = this->curve[1][src[1]];
+		dst[2] = this->curve[2][src[2]];
+		dst[3] = src[3];
+	}
+}
+
+// Only the rectangle the frame queue reports as changed since the previous frame is converted again
+VOID* ColorTable::Apply(VOID* frame, const RECT* rect)
+{
+	if (MemoryCompare(&this->colors, config.colors.current, sizeof(Adjustment)))
+	{
+		this->colors = *config.colors.current;
+		this->Build();
+		this->isFull = TRUE;
+	}
+
+	if (!this->flags)
+		return frame;
+
+	DWORD depth = this->depth;
+	const BYTE* src = (const BYTE*)frame;
+	BYTE* dst = this->buffer;
+
+	if (this->isFull)
+	{
+		this->isFull = FALSE;
+		for (DWORD count = this->pitch * this->height / depth; count; --count, src += depth, dst += depth)
+			this->Convert(src, dst);
+	}
+	else if (rect && !IsRectEmpty(rect))
+	{
+		DWORD offset = rect->top * this->pitch + rect->left * depth;
+		src += offset;
+		dst += offset;
+
+		DWORD width = rect->right - rect->left;
+		for (LONG height = rect->bottom - rect->top; height; --height, src += this->pitch, dst += this->pitch)
+		{
+			const BYTE* s = src;
+			BYTE* d = dst;
+			for (DWORD count = width; count; --count, s += depth, d += depth)
+				this->Convert(s, d);
+		}
+	}
+
+	return this->buffer;
+}
\ No newline at end of file
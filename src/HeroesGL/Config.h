@@ -30,6 +30,7 @@
 #define CONFIG_WRAPPER "Wrapper"
 #define CONFIG_COLORS "Colors"
 #define CONFIG_KEYS "FunktionKeys"
+#define CONFIG_IMAGES "Images"
 
 extern ConfigItems config;
 
@@ -39,9 +40,10 @@ extern const Adjustment defaultColors;
 
 namespace Config
 {
+	VOID Open(HMODULE hModule);
 	VOID Load(HMODULE hModule, const AddressSpace* hookSpace);
-	INT Get(const CHAR* app, const CHAR* key, INT default);
-	DWORD Get(const CHAR* app, const CHAR* key, const CHAR* default, CHAR* returnString, DWORD nSize);
+	INT Get(const CHAR* app, const CHAR* key, INT defValue);
+	DWORD Get(const CHAR* app, const CHAR* key, const CHAR* defValue, CHAR* returnString, DWORD nSize);
 	BOOL Set(const CHAR* app, const CHAR* key, INT value);
 	BOOL Set(const CHAR* app, const CHAR* key, CHAR* value);
 }
\ No newline at end of file
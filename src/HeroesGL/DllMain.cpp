@@ -31,6 +31,10 @@
 #include "Window.h"
 #include "Resource.h"
 #include "Mods.h"
+#include "Snapshot.h"
+#include "Recorder.h"
+#include "Ini.h"
+#include "Registry.h"
 
 BOOL __stdcall DllMain(HMODULE hModule, DWORD fdwReason, LPVOID lpReserved)
 {
@@ -56,9 +60,13 @@ BOOL __stdcall DllMain(HMODULE hModule, DWORD fdwReason, LPVOID lpReserved)
 		hDllModule = hModule;
 		if (Hooks::Load())
 		{
+			Registry::Create();
+
 			if (!config.isDDraw)
 			{
 				Mods::Load();
+				Snapshot::Create();
+				Recorder::Create();
 
 				{
 					WNDCLASS wc = {
@@ -106,6 +114,14 @@ BOOL __stdcall DllMain(HMODULE hModule, DWORD fdwReason, LPVOID lpReserved)
 	case DLL_PROCESS_DETACH:
 		if (hDllModule)
 		{
+			Hooks::Release();
+
+			if (!config.isDDraw)
+				Snapshot::Release();
+
+			Ini::Release();
+			AlignedRelease();
+
 			timeEndPeriod(1);
 
 			if (hActCtx && hActCtx != INVALID_HANDLE_VALUE)
@@ -153,14 +153,27 @@ union LevelColorsFloat
 	FLOAT chanel[3];
 };
 
+struct CanvasTap {
+	DWORD index;
+	FLOAT weight[4];
+};
+
 struct LevelsData {
 	HDC hDc;
 	HBITMAP hBmp;
 	DWORD* data;
 	DWORD bmpData[100 * 516];
 	LevelColorsFloat colors[256];
+	LONG version;
 	FLOAT delta;
 	Adjustment values;
+	Adjustment toneValues;
+	BYTE tone[3][256];
+	BOOL isTone;
+	CanvasTap* taps;
+	DWORD interval;
+	DWORD drawTick;
+	BOOL isPending;
 };
 
 struct AppSettings
@@ -230,7 +243,9 @@ enum FpsState
 {
 	FpsDisabled = 0,
 	FpsNormal,
-	FpsBenchmark
+	FpsBenchmark,
+	FpsLatency,
+	FpsIdle
 };
 
 struct FpsItem {
@@ -250,7 +265,62 @@ enum UpdateMode
 	UpdateNone = 0,
 	UpdateSSE = 1,
 	UpdateCPP = 2,
-	UpdateASM = 3
+	UpdateASM = 3,
+	UpdateAuto = 4
+};
+
+enum SnapshotType
+{
+	SnapshotClipboard = 0,
+	SnapshotPng = 1,
+	SnapshotQoi = 2
+};
+
+struct SnapshotFrame
+{
+	SnapshotFrame* next;
+	DWORD width;
+	DWORD height;
+	DWORD capacity;
+	BOOL isFlipped;
+	DWORD* data;
+};
+
+enum RecordType : BYTE
+{
+	RecordTrack = 1,
+	RecordFrame = 2
+};
+
+struct IniLine
+{
+	IniLine* next;
+	IniLine* chain;
+	IniLine* section;
+	IniLine* tail;
+	DWORD hash;
+	CHAR* key;
+	CHAR* value;
+	CHAR* text;
+};
+
+struct RegValue
+{
+	RegValue* chain;
+	DWORD hash;
+	CHAR* name;
+	DWORD type;
+	DWORD size;
+	BYTE* data;
+	BOOL isLegacy;
+};
+
+struct RecordChunk
+{
+	RecordChunk* next;
+	DWORD capacity;
+	DWORD size;
+	BYTE* data;
 };
 
 struct ConfigItems
@@ -266,6 +336,9 @@ struct ConfigItems
 	BOOL isSSE2;
 	RendererType renderer;
 	UpdateMode updateMode;
+	DWORD frameLatency;
+	SnapshotType snapshot;
+	BOOL record;
 
 	struct {
 		LCID current;
@@ -273,7 +346,7 @@ struct ConfigItems
 	} language;
 
 	struct {
-		HCURSOR default;
+		HCURSOR arrow;
 		HCURSOR game;
 		BOOL fix;
 		BOOL hidden;
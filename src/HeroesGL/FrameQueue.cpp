@@ -0,0 +1,201 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "FrameQueue.h"
+
+FrameQueue::FrameQueue(DWORD width, DWORD height, DWORD pitch, DWORD depth)
+{
+	SetRect(&this->bounds, 0, 0, width, height);
+	this->pitch = pitch;
+	this->depth = depth;
+
+	DWORD size = this->pitch * height;
+	for (DWORD i = 0; i < FRAME_SLOTS; ++i)
+	{
+		this->slots[i] = AlignedAlloc(size);
+		if (this->slots[i])
+			MemoryZero(this->slots[i], size);
+		SetRectEmpty(&this->dirty[i]);
+		SetRectEmpty(&this->changes[i]);
+	}
+
+	SetRectEmpty(&this->hidden);
+	SetRectEmpty(&this->changed);
+
+	this->write = 0;
+	this->ready = 1;
+	this->read = 2;
+
+	MemoryZero(this->stamps, sizeof(this->stamps));
+	this->stamp = 0;
+
+#ifdef _DEBUG
+	this->latency = 0;
+	this->published = 0;
+	this->acquired = 0;
+	this->dropped = 0;
+#endif
+}
+
+// Returns NULL when a slot cannot be allocated, the caller has nothing to publish into then
+FrameQueue* FrameQueue::Create(DWORD width, DWORD height, DWORD pitch, DWORD depth)
+{
+	FrameQueue* queue = new FrameQueue(width, height, pitch, depth);
+	if (queue)
+	{
+		for (DWORD i = 0; i < FRAME_SLOTS; ++i)
+		{
+			if (!queue->slots[i])
+			{
+				delete queue;
+				return NULL;
+			}
+		}
+	}
+
+	return queue;
+}
+
+FrameQueue::~FrameQueue()
+{
+	for (DWORD i = 0; i < FRAME_SLOTS; ++i)
+		AlignedFree(this->slots[i]);
+
+#ifdef _DEBUG
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+
+	DWORD average = this->acquired ? DWORD(this->latency * 1000000 / freq.QuadPart / this->acquired) : 0;
+
+	CHAR message[128];
+	StrPrint(message, "Frames: %u published, %u acquired, %u dropped, %u us average latency\n", this->published, this->acquired, this->dropped, average);
+	OutputDebugString(message);
+#endif
+}
+
+VOID FrameQueue::Publish(const VOID* buffer, const RECT* rect)
+{
+	RECT rc;
+	if (!rect)
+		rc = this->bounds;
+	else if (!IntersectRect(&rc, rect, &this->bounds))
+		return;
+
+	// every slot but the one we fill now has missed this change
+	for (DWORD i = 0; i < FRAME_SLOTS; ++i)
+		UnionRect(&this->dirty[i], &this->dirty[i], &rc);
+
+	RECT* dirty = &this->dirty[this->write];
+	DWORD offset = dirty->top * this->pitch + dirty->left * this->depth;
+	BYTE* src = (BYTE*)buffer + offset;
+	BYTE* dst = (BYTE*)this->slots[this->write] + offset;
+
+	DWORD width = (dirty->right - dirty->left) * this->depth;
+	LONG height = dirty->bottom - dirty->top;
+	if (width == this->pitch)
+		MemoryCopy(dst, src, width * height);
+	else
+		do
+		{
+			MemoryCopy(dst, src, width);
+			src += this->pitch;
+			dst += this->pitch;
+		} while (--height);
+
+	SetRectEmpty(dirty);
+
+	// What the reader has not seen yet: this change, the hidden ones it carries,
+	// and the frame it replaces when that one was never acquired
+	RECT* changes = &this->changes[this->write];
+	UnionRect(changes, &rc, &this->hidden);
+	SetRectEmpty(&this->hidden);
+
+	LONG ready = this->ready;
+	if (ready & FRAME_FRESH)
+		UnionRect(changes, changes, &this->changes[ready & FRAME_INDEX]);
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	this->stamps[this->write] = now.QuadPart;
+
+#ifdef _DEBUG
+	++this->published;
+#endif
+
+	LONG last = InterlockedExchange(&this->ready, this->write | FRAME_FRESH);
+	this->write = last & FRAME_INDEX;
+
+#ifdef _DEBUG
+	if (last & FRAME_FRESH)
+		++this->dropped;
+#endif
+}
+
+// Marks a change that is left for a later Publish to carry, every slot picks it up with its next fill
+VOID FrameQueue::Invalidate(const RECT* rect)
+{
+	RECT rc;
+	if (!rect)
+		rc = this->bounds;
+	else if (!IntersectRect(&rc, rect, &this->bounds))
+		return;
+
+	for (DWORD i = 0; i < FRAME_SLOTS; ++i)
+		UnionRect(&this->dirty[i], &this->dirty[i], &rc);
+
+	UnionRect(&this->hidden, &this->hidden, &rc);
+}
+
+VOID* FrameQueue::Acquire()
+{
+	this->stamp = 0;
+	SetRectEmpty(&this->changed);
+	if (this->ready & FRAME_FRESH)
+	{
+		this->read = InterlockedExchange(&this->ready, this->read) & FRAME_INDEX;
+		this->stamp = this->stamps[this->read];
+		this->changed = this->changes[this->read];
+
+#ifdef _DEBUG
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		this->latency += now.QuadPart - this->stamp;
+		++this->acquired;
+#endif
+	}
+
+	return this->slots[this->read];
+}
+
+LONGLONG FrameQueue::GetStamp()
+{
+	return this->stamp;
+}
+
+// The part of the acquired frame that differs from the one acquired before it
+const RECT* FrameQueue::GetChanged()
+{
+	return &this->changed;
+}
@@ -46,12 +46,17 @@ GLMATRIXMODE GLMatrixMode;
 GLLOADIDENTITY GLLoadIdentity;
 GLORTHO GLOrtho;
 GLFINISH GLFinish;
+GLFENCESYNC GLFenceSync;
+GLCLIENTWAITSYNC GLClientWaitSync;
+GLDELETESYNC GLDeleteSync;
+GLADDSWAPHINTRECT GLAddSwapHintRect;
 GLENABLE GLEnable;
 GLBINDTEXTURE GLBindTexture;
 GLDELETETEXTURES GLDeleteTextures;
 GLTEXPARAMETERI GLTexParameteri;
 GLTEXENVI GLTexEnvi;
 GLGETTEXIMAGE GLGetTexImage;
+GLTEXIMAGE1D GLTexImage1D;
 GLTEXIMAGE2D GLTexImage2D;
 GLTEXSUBIMAGE2D GLTexSubImage2D;
 GLGENTEXTURES GLGenTextures;
@@ -59,6 +64,11 @@ GLGETINTEGERV GLGetIntegerv;
 GLCLEAR GLClear;
 GLCLEARCOLOR GLClearColor;
 GLPIXELSTOREI GLPixelStorei;
+GLGENLISTS GLGenLists;
+GLDELETELISTS GLDeleteLists;
+GLNEWLIST GLNewList;
+GLENDLIST GLEndList;
+GLCALLLIST GLCallList;
 
 #ifdef _DEBUG
 GLGETERROR GLGetError;
@@ -191,12 +201,14 @@ namespace GL
 		LoadFunction(buffer, PREFIX_GL, "LoadIdentity", &GLLoadIdentity);
 		LoadFunction(buffer, PREFIX_GL, "Ortho", &GLOrtho);
 		LoadFunction(buffer, PREFIX_GL, "Finish", &GLFinish);
+		LoadFunction(buffer, PREFIX_GL, "AddSwapHintRect", &GLAddSwapHintRect, "WIN");
 		LoadFunction(buffer, PREFIX_GL, "Enable", &GLEnable);
 		LoadFunction(buffer, PREFIX_GL, "BindTexture", &GLBindTexture);
 		LoadFunction(buffer, PREFIX_GL, "DeleteTextures", &GLDeleteTextures);
 		LoadFunction(buffer, PREFIX_GL, "TexParameteri", &GLTexParameteri);
 		LoadFunction(buffer, PREFIX_GL, "TexEnvi", &GLTexEnvi);
 		LoadFunction(buffer, PREFIX_GL, "GetTexImage", &GLGetTexImage);
+		LoadFunction(buffer, PREFIX_GL, "TexImage1D", &GLTexImage1D);
 		LoadFunction(buffer, PREFIX_GL, "TexImage2D", &GLTexImage2D);
 		LoadFunction(buffer, PREFIX_GL, "TexSubImage2D", &GLTexSubImage2D);
 		LoadFunction(buffer, PREFIX_GL, "GenTextures", &GLGenTextures);
@@ -204,6 +216,11 @@ namespace GL
 		LoadFunction(buffer, PREFIX_GL, "Clear", &GLClear);
 		LoadFunction(buffer, PREFIX_GL, "ClearColor", &GLClearColor);
 		LoadFunction(buffer, PREFIX_GL, "PixelStorei", &GLPixelStorei);
+		LoadFunction(buffer, PREFIX_GL, "GenLists", &GLGenLists);
+		LoadFunction(buffer, PREFIX_GL, "DeleteLists", &GLDeleteLists);
+		LoadFunction(buffer, PREFIX_GL, "NewList", &GLNewList);
+		LoadFunction(buffer, PREFIX_GL, "EndList", &GLEndList);
+		LoadFunction(buffer, PREFIX_GL, "CallList", &GLCallList);
 
 #ifdef _DEBUG
 		LoadFunction(buffer, PREFIX_GL, "GetError", &GLGetError);
@@ -249,6 +266,10 @@ namespace GL
 		LoadFunction(buffer, PREFIX_GL, "BindFramebuffer", &GLBindFramebuffer);
 		LoadFunction(buffer, PREFIX_GL, "FramebufferTexture2D", &GLFramebufferTexture2D);
 
+		LoadFunction(buffer, PREFIX_GL, "FenceSync", &GLFenceSync);
+		LoadFunction(buffer, PREFIX_GL, "ClientWaitSync", &GLClientWaitSync);
+		LoadFunction(buffer, PREFIX_GL, "DeleteSync", &GLDeleteSync);
+
 		if (GLGetString)
 		{
 			config.gl.version.value = 0;
@@ -33,6 +33,7 @@
 #include "Window.h"
 #include "Hooker.h"
 #include "Mods.h"
+#include "Registry.h"
 #include "mss.h"
 
 #define STYLE_FULL_OLD (WS_VISIBLE | WS_CLIPSIBLINGS)
@@ -1190,12 +1191,16 @@ namespace Hooks
 #pragma endregion
 
 #pragma region CPU patch
+	IdleGovernor* idleGovernor;
 	BOOL __stdcall PeekMessageHook(LPMSG lpMsg, HWND hWnd, UINT wMsgFilterMin, UINT wMsgFilterMax, UINT wRemoveMsg)
 	{
 		if (PeekMessage(lpMsg, hWnd, wMsgFilterMin, wMsgFilterMax, wRemoveMsg))
 			return TRUE;
 
-		Sleep(config.coldCPU);
+		if (config.coldCPU)
+			idleGovernor->Wait();
+		else
+			Sleep(0);
 
 		return FALSE;
 	}
@@ -1233,45 +1238,47 @@ namespace Hooks
 
 	LSTATUS __stdcall RegQueryValueExHook(HKEY hKey, LPCSTR lpValueName, LPDWORD lpReserved, LPDWORD lpType, LPBYTE lpData, LPDWORD lpcbData)
 	{
-		DWORD size = *lpcbData;
-
 		if (!config.isExist)
 		{
-			LSTATUS res = RegQueryValueEx(hKey, lpValueName, lpReserved, lpType, lpData, lpcbData);
+			DWORD type;
+			LSTATUS res = RegQueryValueEx(hKey, lpValueName, lpReserved, &type, lpData, lpcbData);
+			if (lpType)
+				*lpType = type;
 
-			if (size == sizeof(DWORD))
-				Config::Set(CONFIG_APP, lpValueName, *(INT*)lpData);
-			else
-				Config::Set(CONFIG_APP, lpValueName, (CHAR*)lpData);
+			if (!res && lpData && lpcbData)
+				Registry::Set(lpValueName, type, lpData, *lpcbData);
 
 			return res;
 		}
 		else
 		{
-			if (size == sizeof(DWORD))
+			LSTATUS res = Registry::Query(lpValueName, lpType, lpData, lpcbData);
+			if (res == ERROR_FILE_NOT_FOUND)
 			{
-				*(INT*)lpData = Config::Get(CONFIG_APP, lpValueName, *(INT*)lpData);
-				if (lpType)
-					*lpType = REG_DWORD;
-			}
-			else
-			{
-				Config::Get(CONFIG_APP, lpValueName, "", (CHAR*)lpData, *lpcbData);
-				if (lpType)
-					*lpType = *lpcbData ? REG_BINARY : REG_SZ;
+				if (lpcbData && *lpcbData == sizeof(DWORD))
+				{
+					if (lpType)
+						*lpType = REG_DWORD;
+				}
+				else
+				{
+					if (lpData && lpcbData && *lpcbData)
+						*lpData = NULL;
+
+					if (lpType)
+						*lpType = REG_SZ;
+				}
+
+				res = ERROR_SUCCESS;
 			}
 
-			return ERROR_SUCCESS;
+			return res;
 		}
 	}
 
 	LSTATUS __stdcall RegSetValueExHook(HKEY hKey, LPCSTR lpValueName, DWORD Reserved, DWORD dwType, const BYTE* lpData, DWORD cbData)
 	{
-		if (dwType == REG_DWORD)
-			Config::Set(CONFIG_APP, lpValueName, *(INT*)lpData);
-		else
-			Config::Set(CONFIG_APP, lpValueName, (CHAR*)lpData);
-
+		Registry::Set(lpValueName, dwType, lpData, cbData);
 		return ERROR_SUCCESS;
 	}
 #pragma endregion
@@ -1378,6 +1385,28 @@ namespace Hooks
 	}
 #pragma endregion
 
+#pragma region Image index
+	BOOL GetImageKey(HMODULE hModule, CHAR* key)
+	{
+		PIMAGE_DOS_HEADER headDos = (PIMAGE_DOS_HEADER)hModule;
+		if (headDos->e_magic != IMAGE_DOS_SIGNATURE)
+			return FALSE;
+
+		PIMAGE_NT_HEADERS headNT = (PIMAGE_NT_HEADERS)((BYTE*)hModule + headDos->e_lfanew);
+		if (headNT->Signature != IMAGE_NT_SIGNATURE)
+			return FALSE;
+
+		StrPrint(key, "%08X%08X%08X", headNT->FileHeader.TimeDateStamp, headNT->OptionalHeader.SizeOfImage, headNT->OptionalHeader.AddressOfEntryPoint);
+		return TRUE;
+	}
+
+	BOOL CheckSpace(HOOKER hooker, const AddressSpace* space)
+	{
+		DWORD check;
+		return ReadDWord(hooker, space->check + 6, &check) && check == STYLE_FULL_OLD;
+	}
+#pragma endregion
+
 #pragma optimize("s", on)
 #define f(a) (a + baseOffset)
 
@@ -1395,14 +1424,31 @@ namespace Hooks
 		HOOKER hooker = CreateHooker(GetModuleHandle(NULL));
 		if (hooker)
 		{
+			HMODULE hModule = GetHookerModule(hooker);
+			Config::Open(hModule);
+
 			hookSpace = addressArray;
 			DWORD hookCount = sizeof(addressArray) / sizeof(AddressSpace);
+
+			// Known executables are matched by their PE header, the scan starts at the remembered entry
+			CHAR imageKey[32];
+			BOOL isImage = GetImageKey(hModule, imageKey);
+			DWORD index = isImage ? Config::Get(CONFIG_IMAGES, imageKey, 0) : 0;
+			if (index && index <= hookCount && CheckSpace(hooker, addressArray + index - 1))
+			{
+				hookSpace += index - 1;
+				hookCount -= index - 1;
+			}
+
 			do
 			{
-				DWORD check;
-				if (ReadDWord(hooker, hookSpace->check + 6, &check) && check == STYLE_FULL_OLD)
+				if (CheckSpace(hooker, hookSpace))
 				{
-					Config::Load(GetHookerModule(hooker), hookSpace);
+					if (isImage && !config.isDDraw && index != (DWORD)(hookSpace - addressArray) + 1)
+						Config::Set(CONFIG_IMAGES, imageKey, (INT)(hookSpace - addressArray) + 1);
+
+					Config::Load(hModule, hookSpace);
+					idleGovernor = new IdleGovernor();
 
 					HOOKER user = CreateHooker(GetModuleHandle("USER32.dll"));
 					if (user)
@@ -1586,5 +1632,11 @@ namespace Hooks
 
 		return res;
 	}
+
+	VOID Release()
+	{
+		if (idleGovernor)
+			delete idleGovernor;
+	}
 #pragma optimize("", on)
 }
\ No newline at end of file
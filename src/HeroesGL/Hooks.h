@@ -25,11 +25,13 @@
 #pragma once
 
 #include "ExtraTypes.h"
+#include "IdleGovernor.h"
 
 namespace Hooks
 {
 	extern const AddressSpace* hookSpace;
 	extern const DWORD palEntries[256];
+	extern IdleGovernor* idleGovernor;
 
 	INT_PTR __stdcall DialogBoxParamHook(HINSTANCE, LPCSTR, HWND, DLGPROC, LPARAM);
 	INT __stdcall MessageBoxHook(HWND, LPCSTR, LPCSTR, UINT);
@@ -37,4 +39,5 @@ namespace Hooks
 	VOID ScalePointer(FLOAT, FLOAT);
 	BOOL __stdcall EnumChildProc(HWND, LPARAM);
 	BOOL Load();
+	VOID Release();
 }
\ No newline at end of file
@@ -0,0 +1,249 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "IdleGovernor.h"
+#include "timeapi.h"
+
+IdleSource::IdleSource()
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	this->frequency = freq.QuadPart;
+}
+
+IdleSource::~IdleSource()
+{
+}
+
+LONGLONG IdleSource::Now()
+{
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+
+	return counter.QuadPart / this->frequency * 1000000 + counter.QuadPart % this->frequency * 1000000 / this->frequency;
+}
+
+DWORD IdleSource::Time()
+{
+	return timeGetTime();
+}
+
+BOOL IdleSource::Wait(DWORD timeout)
+{
+	// Without MWMO_INPUTAVAILABLE input that is already queued, but outside of the game's filter, would not wake the wait
+	return MsgWaitForMultipleObjectsEx(0, NULL, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE) == WAIT_OBJECT_0;
+}
+
+IdleGovernor::IdleGovernor(IdleSource* source)
+{
+	this->source = source ? source : new IdleSource();
+
+	this->released = this->source->Now();
+	this->work = 0;
+	this->cadence = 0;
+	this->next = 0;
+	this->deadline = 0;
+	this->target = 0;
+	this->average = 0;
+	this->overshoot = GOVERNOR_MARGIN;
+	this->windowStart = this->released;
+	this->windowIdle = 0;
+	this->woken = FALSE;
+	this->missing = FALSE;
+	this->late = 0;
+	this->misses = 0;
+	this->waits = 0;
+	this->signaled = 0;
+	this->missed = 0;
+
+	this->idle = 0;
+	this->latency = 0;
+	this->period = 0;
+}
+
+IdleGovernor::~IdleGovernor()
+{
+#ifdef _DEBUG
+	CHAR message[160];
+	StrPrint(message, "Idle: %u waits, %u woken by input, %u missed ticks, %u us cadence, %u%% idle, %u us added latency\n", this->waits, this->signaled, this->missed, this->period, this->idle, this->latency);
+	OutputDebugString(message);
+#endif
+
+	delete this->source;
+}
+
+VOID IdleGovernor::Relearn()
+{
+	this->work = 0;
+	this->cadence = 0;
+	this->missing = FALSE;
+	this->late = 0;
+	this->misses = 0;
+	this->period = 0;
+}
+
+VOID IdleGovernor::Learn(LONGLONG now)
+{
+	// Quick successive polls mean the game is still waiting on its own timer
+	if (now - this->released < GOVERNOR_WORK)
+	{
+		if (this->woken)
+			this->late = 0;
+
+		this->woken = FALSE;
+		return;
+	}
+
+	// Work straight after an early planned wake means the tick was due before the prediction
+	BOOL woken = this->woken;
+	this->woken = FALSE;
+	if (woken && ++this->late >= GOVERNOR_RELEARN)
+		this->Relearn();
+
+	LONGLONG stamp = this->released;
+	LONGLONG interval = stamp - this->work;
+	if (this->cadence)
+	{
+		// Work well ahead of the expected tick is driven by messages, not by the game timer
+		if (interval < (this->cadence >> 1))
+			return;
+
+		if (interval < GOVERNOR_LIMIT)
+		{
+			interval /= (interval + (this->cadence >> 1)) / this->cadence;
+			this->cadence = (this->cadence * 7 + interval) >> 3;
+		}
+
+		if (this->missing)
+			this->missing = FALSE;
+		else
+			this->misses = 0;
+	}
+	else if (this->work && interval < GOVERNOR_LIMIT)
+		this->cadence = interval;
+
+	this->work = stamp;
+	this->next = stamp + this->cadence;
+	this->period = DWORD(this->cadence);
+}
+
+DWORD IdleGovernor::Plan(LONGLONG now)
+{
+	this->target = 0;
+
+	LONGLONG deadline = this->deadline;
+	if (this->cadence)
+	{
+		// The expected tick passed without work, poll with short sleeps until the game catches up
+		if (!this->missing && now > this->next + GOVERNOR_MARGIN)
+		{
+			this->missing = TRUE;
+			++this->missed;
+
+			if (++this->misses >= GOVERNOR_RELEARN)
+				this->Relearn();
+		}
+
+		if (this->cadence && !this->missing && (!deadline || this->next < deadline))
+			deadline = this->next;
+	}
+
+	if (!deadline)
+		return GOVERNOR_FALLBACK;
+
+	// Close to the deadline the game spins on its own, the timer could not wake it in time
+	LONGLONG remaining = deadline - now - this->overshoot;
+	if (remaining < 1000)
+		return 0;
+
+	this->target = deadline;
+	return DWORD((remaining < GOVERNOR_LIMIT ? remaining : GOVERNOR_LIMIT) / 1000);
+}
+
+VOID IdleGovernor::Account(LONGLONG start, LONGLONG end, DWORD timeout, BOOL input)
+{
+	LONGLONG span = end - start;
+	this->windowIdle += span;
+
+	++this->waits;
+	if (input)
+		++this->signaled;
+
+	if (!input)
+	{
+		// Learn how late the system timer fires so waits end right before the deadline
+		LONGLONG overshoot = span - timeout * 1000;
+		if (overshoot > 0 && overshoot < GOVERNOR_LIMIT)
+			this->overshoot = (this->overshoot * 7 + overshoot) >> 3;
+
+		if (this->target)
+		{
+			LONGLONG delay = end > this->target ? end - this->target : 0;
+			this->average = (this->average * 7 + delay) >> 3;
+			this->latency = DWORD(this->average);
+
+			this->woken = this->target == this->next && end < this->target;
+		}
+	}
+
+	LONGLONG elapsed = end - this->windowStart;
+	if (elapsed >= GOVERNOR_WINDOW)
+	{
+		this->idle = DWORD(this->windowIdle * 100 / elapsed);
+		this->windowStart = end;
+		this->windowIdle = 0;
+	}
+}
+
+VOID IdleGovernor::SetDeadline(DWORD time)
+{
+	// Game deadlines are on the multimedia clock, move them onto the counter timeline
+	LONG remaining = LONG(time - this->source->Time());
+	this->deadline = this->source->Now() + (remaining > 0 ? remaining * 1000 : 0);
+}
+
+VOID IdleGovernor::ResetDeadline()
+{
+	this->deadline = 0;
+}
+
+VOID IdleGovernor::Wait()
+{
+	LONGLONG start = this->source->Now();
+	this->Learn(start);
+
+	LONGLONG end = start;
+	BOOL input = FALSE;
+
+	DWORD timeout = this->Plan(start);
+	if (timeout)
+	{
+		input = this->source->Wait(timeout);
+		end = this->source->Now();
+		this->Account(start, end, timeout, input);
+	}
+
+	this->released = end;
+}
@@ -0,0 +1,565 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "Ini.h"
+
+namespace Ini
+{
+	CRITICAL_SECTION section;
+	HANDLE hEvent;
+	HANDLE hThread;
+	CHAR filePath[MAX_PATH];
+	BOOL isDirty;
+	BOOL isFinish;
+
+	IniLine* first;
+	IniLine* last;
+	IniLine* buckets[INI_BUCKETS];
+
+	CHAR Lower(CHAR ch)
+	{
+		return ch >= 'A' && ch <= 'Z' ? ch + ('a' - 'A') : ch;
+	}
+
+	BOOL IsSpace(CHAR ch)
+	{
+		return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n';
+	}
+
+	DWORD Hash(const CHAR* app, const CHAR* key)
+	{
+		DWORD hash = 2166136261;
+		while (*app)
+			hash = (hash ^ (BYTE)Lower(*app++)) * 16777619;
+
+		hash *= 16777619;
+		if (key)
+			while (*key)
+				hash = (hash ^ (BYTE)Lower(*key++)) * 16777619;
+
+		return hash;
+	}
+
+	CHAR* Duplicate(const CHAR* start, const CHAR* end)
+	{
+		DWORD length = end - start;
+		CHAR* str = (CHAR*)MemoryAlloc(length + 1);
+		MemoryCopy(str, start, length);
+		str[length] = NULL;
+		return str;
+	}
+
+	BOOL IsQuote(const CHAR* start, const CHAR* end)
+	{
+		return end - start >= 2 && (*start == '"' || *start == '\'') && end[-1] == *start;
+	}
+
+	CHAR* Compose(const CHAR* text, const CHAR* key, const CHAR* value)
+	{
+		// Rewrites only the value part of the line, so spacing and quotes written by hand survive
+		const CHAR* start = text ? StrChar(text, '=') : NULL;
+		const CHAR* end = NULL;
+		CHAR quote = NULL;
+		if (start)
+		{
+			++start;
+			while (*start && IsSpace(*start))
+				++start;
+
+			end = text + StrLength(text);
+			while (end > start && IsSpace(end[-1]))
+				--end;
+
+			if (IsQuote(start, end))
+			{
+				quote = *start;
+				++start;
+				--end;
+			}
+		}
+
+		DWORD length = StrLength(value);
+		CHAR wrap = !quote && length && (IsSpace(*value) || IsSpace(value[length - 1]) || IsQuote(value, value + length)) ? '"' : NULL;
+
+		DWORD prefix = start ? start - text : StrLength(key) + 1;
+		DWORD suffix = start ? StrLength(end) : 0;
+
+		CHAR* str = (CHAR*)MemoryAlloc(prefix + length + suffix + 3);
+		CHAR* ptr = str;
+		if (start)
+		{
+			MemoryCopy(ptr, text, prefix);
+			ptr += prefix;
+		}
+		else
+		{
+			MemoryCopy(ptr, key, prefix - 1);
+			ptr += prefix - 1;
+			*ptr++ = '=';
+		}
+
+		if (wrap)
+			*ptr++ = wrap;
+
+		MemoryCopy(ptr, value, length);
+		ptr += length;
+
+		if (wrap)
+			*ptr++ = wrap;
+
+		MemoryCopy(ptr, end ? end : "", suffix);
+		ptr[suffix] = NULL;
+
+		return str;
+	}
+
+	IniLine* Find(const CHAR* app, const CHAR* key)
+	{
+		DWORD hash = Hash(app, key);
+		IniLine* line = buckets[hash & (INI_BUCKETS - 1)];
+		while (line)
+		{
+			if (line->hash == hash)
+			{
+				if (!key)
+				{
+					if (line->section == line && !StrCompareInsensitive(line->key, app))
+						return line;
+				}
+				else if (line->section != line && !StrCompareInsensitive(line->key, key) && !StrCompareInsensitive(line->section->key, app))
+					return line;
+			}
+
+			line = line->chain;
+		}
+
+		return NULL;
+	}
+
+	VOID Index(IniLine* line)
+	{
+		const CHAR* app = line->section->key;
+		const CHAR* key = line->section == line ? NULL : line->key;
+		if (Find(app, key))
+			return;
+
+		line->hash = Hash(app, key);
+		IniLine** bucket = &buckets[line->hash & (INI_BUCKETS - 1)];
+		line->chain = *bucket;
+		*bucket = line;
+	}
+
+	IniLine* Append(IniLine* after, CHAR* text)
+	{
+		IniLine* line = (IniLine*)MemoryAlloc(sizeof(IniLine));
+		MemoryZero(line, sizeof(IniLine));
+		line->text = text;
+
+		if (after)
+		{
+			line->next = after->next;
+			after->next = line;
+		}
+		else if (last)
+			last->next = line;
+		else
+			first = line;
+
+		if (!line->next)
+			last = line;
+
+		return line;
+	}
+
+	VOID Parse(CHAR* data)
+	{
+		IniLine* current = NULL;
+		while (*data)
+		{
+			CHAR* end = data;
+			while (*end && *end != '\n')
+				++end;
+
+			CHAR* next = *end ? end + 1 : end;
+			if (end > data && end[-1] == '\r')
+				--end;
+
+			IniLine* line = Append(NULL, Duplicate(data, end));
+
+			while (data < end && IsSpace(*data))
+				++data;
+
+			while (end > data && IsSpace(end[-1]))
+				--end;
+
+			if (*data == '[')
+			{
+				CHAR* close = data + 1;
+				while (close < end && *close != ']')
+					++close;
+
+				CHAR* start = data + 1;
+				while (start < close && IsSpace(*start))
+					++start;
+
+				CHAR* stop = close;
+				while (stop > start && IsSpace(stop[-1]))
+					--stop;
+
+				line->key = Duplicate(start, stop);
+				line->section = line;
+				line->tail = line;
+				current = line;
+
+				Index(line);
+			}
+			else if (current && data < end && *data != ';')
+			{
+				CHAR* equal = data;
+				while (equal < end && *equal != '=')
+					++equal;
+
+				if (equal < end)
+				{
+					CHAR* stop = equal;
+					while (stop > data && IsSpace(stop[-1]))
+						--stop;
+
+					CHAR* start = equal + 1;
+					while (start < end && IsSpace(*start))
+						++start;
+
+					if (IsQuote(start, end))
+					{
+						++start;
+						--end;
+					}
+
+					line->key = Duplicate(data, stop);
+					line->value = Duplicate(start, end);
+					line->section = current;
+					current->tail = line;
+
+					Index(line);
+				}
+			}
+
+			data = next;
+		}
+	}
+
+	CHAR* Serialize(DWORD* size)
+	{
+		DWORD length = 0;
+		for (IniLine* line = first; line; line = line->next)
+			length += StrLength(line->text) + 2;
+
+		CHAR* data = (CHAR*)MemoryAlloc(length + 1);
+		CHAR* ptr = data;
+		for (IniLine* line = first; line; line = line->next)
+		{
+			StrCopy(ptr, line->text);
+			ptr += StrLength(ptr);
+
+			*ptr++ = '\r';
+			*ptr++ = '\n';
+		}
+
+		*size = ptr - data;
+		return data;
+	}
+
+	VOID Save()
+	{
+		DWORD size;
+		CHAR* data;
+		EnterCriticalSection(&section);
+		{
+			data = isDirty ? Serialize(&size) : NULL;
+			isDirty = FALSE;
+		}
+		LeaveCriticalSection(&section);
+
+		if (!data)
+			return;
+
+		CHAR tempPath[MAX_PATH];
+		StrCopy(tempPath, filePath);
+		StrCat(tempPath, ".tmp");
+
+		HANDLE hFile = CreateFile(tempPath, GENERIC_WRITE, NULL, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (hFile != INVALID_HANDLE_VALUE)
+		{
+			DWORD written;
+			BOOL isWritten = WriteFile(hFile, data, size, &written, NULL) && written == size;
+			CloseHandle(hFile);
+
+			if (!isWritten || !MoveFileEx(tempPath, filePath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+				DeleteFile(tempPath);
+		}
+
+		MemoryFree(data);
+	}
+
+	DWORD __stdcall WriterThread(LPVOID lpParameter)
+	{
+		do
+		{
+			WaitForSingleObject(hEvent, INFINITE);
+			while (!isFinish && WaitForSingleObject(hEvent, INI_DELAY) == WAIT_OBJECT_0);
+
+			Save();
+		} while (!isFinish);
+
+		return NULL;
+	}
+
+	BOOL Load(const CHAR* path)
+	{
+		InitializeCriticalSection(&section);
+		hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+		StrCopy(filePath, path);
+
+		HANDLE hFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (hFile == INVALID_HANDLE_VALUE)
+			return FALSE;
+
+		DWORD size = GetFileSize(hFile, NULL);
+		CHAR* data = (CHAR*)MemoryAlloc(size + 1);
+		if (data)
+		{
+			DWORD read;
+			if (!ReadFile(hFile, data, size, &read, NULL))
+				read = 0;
+
+			data[read] = NULL;
+			Parse(data);
+			MemoryFree(data);
+		}
+
+		CloseHandle(hFile);
+		return TRUE;
+	}
+
+	VOID Flush()
+	{
+		if (isDirty)
+			Save();
+	}
+
+	VOID Stop()
+	{
+		Flush();
+
+		if (hThread)
+		{
+			isFinish = TRUE;
+			SetEvent(hEvent);
+			WaitForSingleObject(hThread, INFINITE);
+			CloseHandle(hThread);
+			hThread = NULL;
+			isFinish = FALSE;
+		}
+	}
+
+	VOID Release()
+	{
+		Flush();
+
+		// Called under the loader lock, so a writer not yet joined by Stop is only told to finish and keeps its lines
+		if (hThread)
+		{
+			isFinish = TRUE;
+			SetEvent(hEvent);
+			return;
+		}
+
+		while (first)
+		{
+			IniLine* line = first;
+			first = line->next;
+
+			if (line->key)
+				MemoryFree(line->key);
+
+			if (line->value)
+				MemoryFree(line->value);
+
+			MemoryFree(line->text);
+			MemoryFree(line);
+		}
+
+		last = NULL;
+		MemoryZero(buckets, sizeof(buckets));
+
+		CloseHandle(hEvent);
+		hEvent = NULL;
+
+		DeleteCriticalSection(&section);
+	}
+
+	BOOL Check(const CHAR* app, const CHAR* key)
+	{
+		BOOL res;
+		EnterCriticalSection(&section);
+		{
+			res = Find(app, key) != NULL;
+		}
+		LeaveCriticalSection(&section);
+
+		return res;
+	}
+
+	DWORD Copy(CHAR* returnString, const CHAR* value, DWORD nSize)
+	{
+		DWORD length = StrLength(value);
+		if (length >= nSize)
+			length = nSize - 1;
+
+		MemoryCopy(returnString, value, length);
+		returnString[length] = NULL;
+
+		return length;
+	}
+
+	INT Get(const CHAR* app, const CHAR* key, INT defValue)
+	{
+		// Like GetPrivateProfileInt, only a missing key yields the default, an empty value reads as 0
+		CHAR buffer[32];
+		BOOL isFound;
+		EnterCriticalSection(&section);
+		{
+			IniLine* line = Find(app, key);
+			isFound = line != NULL;
+			if (isFound)
+				Copy(buffer, line->value, sizeof(buffer));
+		}
+		LeaveCriticalSection(&section);
+
+		if (!isFound)
+			return defValue;
+
+		const CHAR* ptr = buffer;
+		BOOL isNegative = *ptr == '-';
+		if (isNegative || *ptr == '+')
+			++ptr;
+
+		DWORD radix = 10;
+		if (ptr[0] == '0' && Lower(ptr[1]) == 'x')
+		{
+			radix = 16;
+			ptr += 2;
+		}
+
+		DWORD value = 0;
+		do
+		{
+			CHAR ch = Lower(*ptr++);
+			DWORD digit;
+			if (ch >= '0' && ch <= '9')
+				digit = ch - '0';
+			else if (radix == 16 && ch >= 'a' && ch <= 'f')
+				digit = ch - 'a' + 10;
+			else
+				break;
+
+			value = value * radix + digit;
+		} while (TRUE);
+
+		return isNegative ? -(INT)value : (INT)value;
+	}
+
+	DWORD Get(const CHAR* app, const CHAR* key, const CHAR* defValue, CHAR* returnString, DWORD nSize)
+	{
+		if (!nSize)
+			return 0;
+
+		DWORD length;
+		EnterCriticalSection(&section);
+		{
+			IniLine* line = Find(app, key);
+			length = Copy(returnString, line ? line->value : defValue, nSize);
+		}
+		LeaveCriticalSection(&section);
+
+		return length;
+	}
+
+	VOID Set(const CHAR* app, const CHAR* key, const CHAR* value)
+	{
+		EnterCriticalSection(&section);
+		{
+			IniLine* line = Find(app, key);
+			if (line)
+			{
+				if (StrCompare(line->value, value))
+				{
+					MemoryFree(line->value);
+					line->value = StrDuplicate(value);
+
+					CHAR* text = Compose(line->text, key, value);
+					MemoryFree(line->text);
+					line->text = text;
+
+					isDirty = TRUE;
+				}
+			}
+			else
+			{
+				IniLine* header = Find(app, NULL);
+				if (!header)
+				{
+					CHAR* text = (CHAR*)MemoryAlloc(StrLength(app) + 3);
+					StrPrint(text, "[%s]", app);
+
+					header = Append(NULL, text);
+					header->key = StrDuplicate(app);
+					header->section = header;
+					header->tail = header;
+					Index(header);
+				}
+
+				line = Append(header->tail, Compose(NULL, key, value));
+				line->key = StrDuplicate(key);
+				line->value = StrDuplicate(value);
+				line->section = header;
+				header->tail = line;
+				Index(line);
+
+				isDirty = TRUE;
+			}
+
+			if (isDirty && !hThread)
+			{
+				DWORD threadId;
+				SECURITY_ATTRIBUTES sAttribs = { sizeof(SECURITY_ATTRIBUTES), NULL, FALSE };
+				hThread = CreateThread(&sAttribs, NULL, WriterThread, NULL, NORMAL_PRIORITY_CLASS, &threadId);
+			}
+		}
+		LeaveCriticalSection(&section);
+
+		SetEvent(hEvent);
+	}
+}
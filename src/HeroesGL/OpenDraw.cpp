@@ -33,6 +33,14 @@
 #include "ShaderGroup.h"
 #include "PixelBuffer.h"
 #include "FpsCounter.h"
+#include "FramePacer.h"
+#include "Resampler.h"
+#include "ColorTable.h"
+#include "Snapshot.h"
+#include "Recorder.h"
+#include "Ini.h"
+#include "Convert.h"
+#include "Cursor.h"
 
 DWORD GetPow2(DWORD value)
 {
@@ -91,148 +99,30 @@ VOID OpenDraw::CopyPointer(VOID* frameBuffer)
 
 			if (size.cx > 0 && size.cy > 0)
 			{
-				DWORD* source = (DWORD*)frameBuffer + pos.y * this->width + pos.x;
+				uint32_t palette[256];
 
-				DWORD initMask = 8 - (offset.x % 8);
-				DWORD initOffset = offset.x & (8 - 1);
-
-				INT shadowIdx = offset.y - SHADOW_OFFSET;
-				LONG copyHeight = size.cy;
+				CursorImage image;
+				image.mask = (const uint8_t*)maskInfo->bmBits;
+				image.maskPitch = maskInfo->bmWidthBytes;
+				image.shadow = SHADOW_OFFSET;
+				image.palette = palette;
 
 				if (colorInfo)
 				{
-					BYTE* sourceColor = (BYTE*)colorInfo->bmBits + offset.y * colorInfo->bmWidthBytes + offset.x;
-					BYTE* sourceMask = (BYTE*)maskInfo->bmBits + offset.y * maskInfo->bmWidthBytes + (offset.x / 8);
-					BYTE* shadowMask = (BYTE*)sourceMask - SHADOW_OFFSET * maskInfo->bmWidthBytes;
-
-					do
-					{
-						DWORD* src = source;
-						BYTE* srcColor = sourceColor;
-						BYTE* srcMask = sourceMask;
-						BYTE* shadMask = shadowMask;
-
-						BYTE xorMask = *srcMask++;
-						BYTE shdMask = shadowIdx > 0 ? *shadMask++ : 0xFF;
-
-						xorMask <<= initOffset;
-						shdMask <<= initOffset;
-
-						DWORD countMask = initMask;
-						LONG copyWidth = size.cx;
-						do
-						{
-							if (xorMask & 0x80)
-							{
-								DWORD color = *src;
-
-								if (!(shdMask & 0x80))
-								{
-									BYTE* cp = (BYTE*)&color;
-									DWORD cc = 3;
-									do
-										*cp++ >>= 1;
-									while (--cc);
-								}
+					SwapRedBlue((const uint32_t*)Hooks::palEntries, palette, 256);
 
-								*src = color;
-							}
-							else
-								*src = _byteswap_ulong(_rotl(Hooks::palEntries[*srcColor], 8));
-
-							if (--countMask)
-							{
-								xorMask <<= 1;
-								shdMask <<= 1;
-							}
-							else
-							{
-								countMask = 8;
-								xorMask = *srcMask++;
-								shdMask = shadowIdx > 0 ? *shadMask++ : 0xFF;
-							}
-
-							++src;
-							++srcColor;
-						} while (--copyWidth);
-
-						source += this->width;
-						sourceColor += colorInfo->bmWidthBytes;
-						sourceMask += maskInfo->bmWidthBytes;
-						shadowMask += maskInfo->bmWidthBytes;
-
-						++shadowIdx;
-					} while (--copyHeight);
+					image.color = (const uint8_t*)colorInfo->bmBits;
+					image.colorPitch = colorInfo->bmWidthBytes;
+					image.bright = NULL;
 				}
 				else
 				{
-					BYTE* sourceMask = (BYTE*)maskInfo->bmBits + offset.y * maskInfo->bmWidthBytes + (offset.x / 8);
-					BYTE* shadowMask = (BYTE*)sourceMask - SHADOW_OFFSET * maskInfo->bmWidthBytes;
-					BYTE* colorMask = (BYTE*)sourceMask + 32 * maskInfo->bmWidthBytes;
-
-					do
-					{
-						DWORD* src = source;
-						BYTE* clrMask = colorMask;
-						BYTE* srcMask = sourceMask;
-						BYTE* shadMask = shadowMask;
-
-						BYTE andMask = *clrMask++;
-						BYTE xorMask = *srcMask++;
-						BYTE shdMask = shadowIdx > 0 ? *shadMask++ : 0xFF;
-
-						andMask <<= initOffset;
-						xorMask <<= initOffset;
-						shdMask <<= initOffset;
-
-						DWORD countMask = initMask;
-						LONG copyWidth = size.cx;
-						do
-						{
-							if (xorMask & 0x80)
-							{
-								DWORD color = *src;
-
-								if (!(shdMask & 0x80))
-								{
-									BYTE* cp = (BYTE*)&color;
-									DWORD cc = 3;
-									do
-										*cp++ >>= 1;
-									while (--cc);
-								}
-
-								*src = color;
-							}
-							else
-								*src = (andMask & 0x80) ? 0xFFFFFFFF : 0xFF000000;
-
-							if (--countMask)
-							{
-								andMask <<= 1;
-								xorMask <<= 1;
-								shdMask <<= 1;
-							}
-							else
-							{
-								countMask = 8;
-								andMask = *clrMask++;
-								xorMask = *srcMask++;
-								shdMask = shadowIdx > 0 ? *shadMask++ : 0xFF;
-							}
-
-							++src;
-						} while (--copyWidth);
-
-						source += this->width;
-
-						colorMask += maskInfo->bmWidthBytes;
-						sourceMask += maskInfo->bmWidthBytes;
-						shadowMask += maskInfo->bmWidthBytes;
-
-						++shadowIdx;
-					} while (--copyHeight);
+					image.color = NULL;
+					image.colorPitch = 0;
+					image.bright = image.mask + 32 * image.maskPitch;
 				}
+
+				DrawCursor((uint32_t*)frameBuffer + pos.y * this->width + pos.x, this->width, offset.x, offset.y, size.cx, size.cy, &image);
 			}
 		}
 	}
@@ -408,6 +298,38 @@ VOID OpenDraw::RenderOld()
 		GLEnable(GL_TEXTURE_2D);
 		GLClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
+		// All tiles are drawn from one display list, textures are bound only for tiles with changed pixels
+		GLuint frameList = GLGenLists(1);
+		GLuint bound = frames[frameCount - 1].id;
+		GLNewList(frameList, GL_COMPILE);
+		{
+			DWORD count = frameCount;
+			frame = frames;
+			while (count--)
+			{
+				if (frameCount != 1)
+					GLBindTexture(GL_TEXTURE_2D, frame->id);
+
+				GLBegin(GL_TRIANGLE_FAN);
+				{
+					GLTexCoord2f(0.0f, 0.0f);
+					GLVertex2s(frame->rect.x, frame->rect.y);
+
+					GLTexCoord2f(frame->tSize.width, 0.0f);
+					GLVertex2s(frame->vSize.width, frame->rect.y);
+
+					GLTexCoord2f(frame->tSize.width, frame->tSize.height);
+					GLVertex2s(frame->vSize.width, frame->vSize.height);
+
+					GLTexCoord2f(0.0f, frame->tSize.height);
+					GLVertex2s(frame->rect.x, frame->vSize.height);
+				}
+				GLEnd();
+				++frame;
+			}
+		}
+		GLEndList();
+
 		BOOL isVSync = FALSE;
 		if (WGLSwapInterval)
 			WGLSwapInterval(0);
@@ -415,7 +337,10 @@ VOID OpenDraw::RenderOld()
 		DWORD clear = 0;
 
 		FpsCounter* fpsCounter = new FpsCounter(FpsRgba, this->width);
-		PixelBuffer* pixelBuffer = new PixelBuffer(this->width, this->height, TRUE, GL_RGBA, config.updateMode);
+		FramePacer* pacer = new FramePacer(config.frameLatency);
+		UpdateMode updateMode = PixelBuffer::Tune(this->width, this->height, TRUE, GL_RGBA);
+		PixelBuffer* pixelBuffer = new PixelBuffer(this->width, this->height, TRUE, GL_RGBA, updateMode);
+		ColorTable* colorTable = new ColorTable(RES_WIDTH * sizeof(DWORD), RES_HEIGHT, FpsRgba);
 		{
 			do
 			{
@@ -460,70 +385,98 @@ VOID OpenDraw::RenderOld()
 					clear = 0;
 				}
 
-				if (clear++ <= 1)
+				BOOL isRedraw = clear++ <= 1;
+				if (isRedraw)
 					GLClear(GL_COLOR_BUFFER_BIT);
 
-				pixelBuffer->Copy(surface->pixelBuffer);
+				VOID* frameData = this->frames->Acquire();
+				VOID* drawData = colorTable->Apply(frameData, this->frames->GetChanged());
+				pixelBuffer->Copy(drawData);
 				this->CopyPointer(pixelBuffer->GetBuffer());
+				fpsCounter->latency = pacer->latency;
+				if (Hooks::idleGovernor)
+				{
+					fpsCounter->idle = Hooks::idleGovernor->idle;
+					fpsCounter->idleLatency = Hooks::idleGovernor->latency;
+				}
 				fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
 
-				DWORD count = frameCount;
-				frame = frames;
-				while (count--)
+				BOOL isDamaged = FALSE;
+				if (frameCount == 1)
+				{
+					if (glFilter)
+					{
+						GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glFilter);
+						GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glFilter);
+						fpsCounter->changes += 2;
+					}
+
+					isDamaged = pixelBuffer->Update();
+				}
+				else
 				{
-					if (frameCount == 1)
+					DWORD count = frameCount;
+					frame = frames;
+					while (count--)
 					{
 						if (glFilter)
 						{
+							GLBindTexture(GL_TEXTURE_2D, frame->id);
 							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glFilter);
 							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glFilter);
+							fpsCounter->changes += 3;
+							bound = frame->id;
 						}
 
-						pixelBuffer->Update();
-					}
-					else
-					{
-						GLBindTexture(GL_TEXTURE_2D, frame->id);
-
-						if (glFilter)
+						// Clean tiles skip both the bind and the upload
+						if (pixelBuffer->Update(&frame->rect, frame->id != bound ? frame->id : 0))
 						{
-							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glFilter);
-							GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glFilter);
+							if (frame->id != bound)
+							{
+								bound = frame->id;
+								++fpsCounter->changes;
+							}
+
+							isDamaged = TRUE;
 						}
 
-						pixelBuffer->Update(&frame->rect);
+						++frame;
 					}
+				}
 
-					GLBegin(GL_TRIANGLE_FAN);
-					{
-						GLTexCoord2f(0.0f, 0.0f);
-						GLVertex2s(frame->rect.x, frame->rect.y);
+				RECT damage = *pixelBuffer->GetDamage();
+				this->histogram->Update(frameData, RES_WIDTH, RES_HEIGHT, RES_WIDTH * sizeof(DWORD), FpsRgba, &damage);
+				pixelBuffer->SwapBuffers();
 
-						GLTexCoord2f(frame->tSize.width, 0.0f);
-						GLVertex2s(frame->vSize.width, frame->rect.y);
+				if (isRedraw || isDamaged || config.fps == FpsBenchmark)
+				{
+					GLCallList(frameList);
+					++fpsCounter->draws;
+					if (frameCount != 1)
+					{
+						fpsCounter->changes += frameCount;
+						bound = frames[frameCount - 1].id;
+					}
 
-						GLTexCoord2f(frame->tSize.width, frame->tSize.height);
-						GLVertex2s(frame->vSize.width, frame->vSize.height);
+					if (isSnapshot)
+						surface->TakeSnapshot(this->width, this->height);
 
-						GLTexCoord2f(0.0f, frame->tSize.height);
-						GLVertex2s(frame->rect.x, frame->vSize.height);
-					}
-					GLEnd();
-					++frame;
+					this->Present(isRedraw ? NULL : &damage);
+					pacer->Submit(this->frames->GetStamp());
 				}
+				else
+					++fpsCounter->elided;
 
-				if (isSnapshot)
-					surface->TakeSnapshot(this->width, this->height);
-
-				pixelBuffer->SwapBuffers();
-				SwapBuffers(this->hDc);
 				if (clear > 1 && config.fps != FpsBenchmark)
 					WaitForSingleObject(this->hDrawEvent, INFINITE);
-				GLFinish();
 			} while (!this->isFinish);
 		}
 		delete pixelBuffer;
+		delete colorTable;
 		delete fpsCounter;
+		delete pacer;
+
+		GLDeleteLists(frameList, 1);
 
 		frame = frames;
 		DWORD count = frameCount;
@@ -628,7 +581,9 @@ VOID OpenDraw::RenderMid()
 					DWORD clear = 0;
 
 					FpsCounter* fpsCounter = new FpsCounter(FpsRgba, this->width);
-					PixelBuffer* pixelBuffer = new PixelBuffer(this->width, this->height, TRUE, GL_RGBA, config.updateMode);
+					FramePacer* pacer = new FramePacer(config.frameLatency);
+					UpdateMode updateMode = PixelBuffer::Tune(this->width, this->height, TRUE, GL_RGBA);
+					PixelBuffer* pixelBuffer = new PixelBuffer(this->width, this->height, TRUE, GL_RGBA, updateMode);
 					{
 						do
 						{
@@ -670,7 +625,8 @@ VOID OpenDraw::RenderMid()
 								clear = 0;
 							}
 
-							if (clear++ <= 1)
+							BOOL isRedraw = clear++ <= 1;
+							if (isRedraw)
 								GLClear(GL_COLOR_BUFFER_BIT);
 
 							if (state.flags)
@@ -700,28 +656,41 @@ VOID OpenDraw::RenderMid()
 							}
 
 							// NEXT UNCHANGED
+							VOID* frameData = this->frames->Acquire();
+							pixelBuffer->Copy(frameData);
+							this->CopyPointer(pixelBuffer->GetBuffer());
+							fpsCounter->latency = pacer->latency;
+							if (Hooks::idleGovernor)
 							{
-								pixelBuffer->Copy(surface->pixelBuffer);
-								this->CopyPointer(pixelBuffer->GetBuffer());
-								fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
-								pixelBuffer->Update();
-								pixelBuffer->SwapBuffers();
+								fpsCounter->idle = Hooks::idleGovernor->idle;
+								fpsCounter->idleLatency = Hooks::idleGovernor->latency;
+							}
+							fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
+							BOOL isDamaged = pixelBuffer->Update();
+							RECT damage = *pixelBuffer->GetDamage();
+							this->histogram->Update(frameData, RES_WIDTH, RES_HEIGHT, RES_WIDTH * sizeof(DWORD), FpsRgba, &damage);
+							pixelBuffer->SwapBuffers();
 
+							if (isRedraw || isDamaged || config.fps == FpsBenchmark)
+							{
 								GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-							}
 
-							if (isSnapshot)
-								surface->TakeSnapshot(this->width, this->height);
+								if (isSnapshot)
+									surface->TakeSnapshot(this->width, this->height);
+
+								this->Present(isRedraw ? NULL : &damage);
+								pacer->Submit(this->frames->GetStamp());
+							}
+							else
+								++fpsCounter->elided;
 
-							// Swap
-							SwapBuffers(this->hDc);
 							if (clear > 1 && config.fps != FpsBenchmark)
 								WaitForSingleObject(this->hDrawEvent, INFINITE);
-							GLFinish();
 						} while (!this->isFinish);
 					}
 					delete pixelBuffer;
 					delete fpsCounter;
+					delete pacer;
 				}
 				GLDeleteTextures(1, &textureId);
 			}
@@ -753,11 +722,14 @@ VOID OpenDraw::RenderNew()
 		ShaderGroup* hermite;
 		ShaderGroup* cubic;
 		ShaderGroup* lanczos;
+		ShaderGroup* cubic_h;
+		ShaderGroup* lanczos_h;
 		ShaderGroup* xBRz_2x;
 		ShaderGroup* xBRz_3x;
 		ShaderGroup* xBRz_4x;
 		ShaderGroup* xBRz_5x;
 		ShaderGroup* xBRz_6x;
+		ShaderGroup* xBRz_edge;
 		ShaderGroup* scaleHQ_2x;
 		ShaderGroup* scaleHQ_4x;
 		ShaderGroup* xSal_2x;
@@ -767,13 +739,16 @@ VOID OpenDraw::RenderNew()
 	} shaders = {
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LINEAR_FRAGMENT, SHADER_LEVELS),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_HERMITE_FRAGMENT, SHADER_TEXSIZE | SHADER_LEVELS),
-		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_CUBIC_FRAGMENT, SHADER_TEXSIZE | SHADER_LEVELS),
-		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LANCZOS_FRAGMENT, SHADER_TEXSIZE | SHADER_LEVELS),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_CUBIC_FRAGMENT_VERTICAL, SHADER_TEXSIZE | SHADER_LEVELS),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LANCZOS_FRAGMENT_VERTICAL, SHADER_TEXSIZE | SHADER_LEVELS),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_CUBIC_FRAGMENT_HORIZONTAL, SHADER_TEXSIZE),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_LANCZOS_FRAGMENT_HORIZONTAL, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_2X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_3X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_4X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_5X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_6X, SHADER_TEXSIZE),
+		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_EDGE, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_SCALEHQ_FRAGMENT_2X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_SCALEHQ_FRAGMENT_4X, SHADER_TEXSIZE),
 		new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XSAL_FRAGMENT, SHADER_TEXSIZE),
@@ -784,6 +759,7 @@ VOID OpenDraw::RenderNew()
 
 	ShaderGroup* program = NULL;
 	ShaderGroup* upscaleProgram = NULL;
+	ShaderGroup* passProgram = NULL;
 	{
 		GLuint arrayName;
 		GLGenVertexArrays(1, &arrayName);
@@ -796,7 +772,7 @@ VOID OpenDraw::RenderNew()
 					GLBindBuffer(GL_ARRAY_BUFFER, bufferName);
 					{
 						{
-							FLOAT buffer[8][8] = {
+							FLOAT buffer[16][8] = {
 								{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
 								{ (FLOAT)this->width, 0.0f, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
 								{ (FLOAT)this->width, (FLOAT)this->height, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
@@ -805,7 +781,17 @@ VOID OpenDraw::RenderNew()
 								{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f },
 								{ (FLOAT)this->width, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
 								{ (FLOAT)this->width, (FLOAT)this->height, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f },
-								{ 0.0f, (FLOAT)this->height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f }
+								{ 0.0f, (FLOAT)this->height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+
+								{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, texHeight, 0.0f, 0.0f },
+								{ (FLOAT)this->width, 0.0f, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
+								{ (FLOAT)this->width, (FLOAT)this->height, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
+								{ 0.0f, (FLOAT)this->height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+
+								{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+								{ (FLOAT)this->width, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+								{ (FLOAT)this->width, (FLOAT)this->height, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
+								{ 0.0f, (FLOAT)this->height, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f }
 							};
 
 							{
@@ -816,7 +802,7 @@ VOID OpenDraw::RenderNew()
 									{ -1.0f, 1.0f, -1.0f, 1.0f }
 								};
 
-								for (DWORD i = 0; i < 8; ++i)
+								for (DWORD i = 0; i < 16; ++i)
 								{
 									FLOAT* vector = &buffer[i][0];
 									for (DWORD j = 0; j < 4; ++j)
@@ -845,6 +831,7 @@ VOID OpenDraw::RenderNew()
 							GLuint primary;
 							GLuint secondary;
 							GLuint buffer;
+							GLuint edge;
 						} texId;
 
 						GLGenTextures(1, &texId.primary);
@@ -868,9 +855,13 @@ VOID OpenDraw::RenderNew()
 							DWORD clear = 0;
 
 							FpsCounter* fpsCounter = new FpsCounter(FpsRgba, this->width);
-							PixelBuffer* firstBuffer = new PixelBuffer(this->width, this->height, TRUE, GL_RGBA, config.updateMode);
+							FramePacer* pacer = new FramePacer(config.frameLatency);
+							Resampler* resampler = NULL;
+							UpdateMode updateMode = PixelBuffer::Tune(this->width, this->height, TRUE, GL_RGBA);
+							PixelBuffer* firstBuffer = new PixelBuffer(this->width, this->height, TRUE, GL_RGBA, updateMode);
 							{
 								GLuint fboId = 0;
+								GLuint edgeId = 0;
 								DWORD viewSize;
 								BOOL activeIndex;
 								VOID* emptyBuffer;
@@ -910,7 +901,15 @@ VOID OpenDraw::RenderNew()
 									if (state.flags || isFps || isSnapshot)
 										clear = 0;
 
+									// Only the separable kernels render through the resampler, release its targets once another filter is chosen
+									if (state.flags && resampler && state.interpolation != InterpolateCubic && state.interpolation != InterpolateLanczos)
+									{
+										delete resampler;
+										resampler = NULL;
+									}
+
 									PixelBuffer* pixelBuffer;
+									BOOL isRedraw = TRUE;
 
 									if (state.upscaling)
 									{
@@ -980,7 +979,7 @@ VOID OpenDraw::RenderNew()
 												viewSize = MAKELONG(this->width * state.value, this->height * state.value);
 												activeIndex = TRUE;
 												firstBuffer->Reset();
-												secondBuffer = new PixelBuffer(this->width, this->height, TRUE, GL_RGBA, config.updateMode);
+												secondBuffer = new PixelBuffer(this->width, this->height, TRUE, GL_RGBA, updateMode);
 
 												DWORD size = this->width * this->height * sizeof(DWORD);
 												emptyBuffer = AlignedAlloc(size);
@@ -1043,6 +1042,42 @@ VOID OpenDraw::RenderNew()
 													GLTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, LOWORD(viewSize), HIWORD(viewSize), GL_NONE, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 												}
 											}
+
+											// Edge classification targets exist only while xBRZ reads them
+											if (state.upscaling == UpscaleXRBZ)
+											{
+												if (!edgeId)
+												{
+													GLGenTextures(1, &texId.edge);
+													GLBindTexture(GL_TEXTURE_2D, texId.edge);
+													{
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+														GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+														GLTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->width, this->height, GL_NONE, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+													}
+
+													// Edge classes stay bound on unit 2 for the xBRZ scaling pass
+													GLActiveTexture(GL_TEXTURE2);
+													GLBindTexture(GL_TEXTURE_2D, texId.edge);
+													GLActiveTexture(GL_TEXTURE0);
+
+													GLGenFramebuffers(1, &edgeId);
+													GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, edgeId);
+													GLFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texId.edge, 0);
+
+													GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
+												}
+											}
+											else if (edgeId)
+											{
+												GLDeleteTextures(1, &texId.edge);
+												GLDeleteFramebuffers(1, &edgeId);
+												edgeId = 0;
+											}
 										}
 										else
 											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
@@ -1076,7 +1111,8 @@ VOID OpenDraw::RenderNew()
 											clear = 0;
 										}
 
-										if (clear++ <= 1)
+										isRedraw = clear++ <= 1;
+										if (isRedraw)
 											GLClear(GL_COLOR_BUFFER_BIT);
 
 										if (state.flags)
@@ -1086,6 +1122,13 @@ VOID OpenDraw::RenderNew()
 												GLBindTexture(GL_TEXTURE_2D, texId.primary);
 												GLDeleteTextures(2, &texId.secondary);
 												GLDeleteFramebuffers(1, &fboId);
+												if (edgeId)
+												{
+													GLDeleteTextures(1, &texId.edge);
+													GLDeleteFramebuffers(1, &edgeId);
+													edgeId = 0;
+												}
+
 												AlignedFree(emptyBuffer);
 
 												firstBuffer->Reset();
@@ -1098,15 +1141,19 @@ VOID OpenDraw::RenderNew()
 											{
 											case InterpolateHermite:
 												program = shaders.hermite;
+												passProgram = NULL;
 												break;
 											case InterpolateCubic:
 												program = shaders.cubic;
+												passProgram = shaders.cubic_h;
 												break;
 											case InterpolateLanczos:
 												program = shaders.lanczos;
+												passProgram = shaders.lanczos_h;
 												break;
 											default:
 												program = shaders.linear;
+												passProgram = NULL;
 												break;
 											}
 
@@ -1121,109 +1168,156 @@ VOID OpenDraw::RenderNew()
 									}
 
 									// NEXT UNCHANGED
+									VOID* frameData = this->frames->Acquire();
+									pixelBuffer->Copy(frameData);
+									this->CopyPointer(pixelBuffer->GetBuffer());
+									fpsCounter->latency = pacer->latency;
+									if (Hooks::idleGovernor)
 									{
-										pixelBuffer->Copy(surface->pixelBuffer);
-										this->CopyPointer(pixelBuffer->GetBuffer());
-										fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
-										pixelBuffer->Update();
-										pixelBuffer->SwapBuffers();
-
-										GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+										fpsCounter->idle = Hooks::idleGovernor->idle;
+										fpsCounter->idleLatency = Hooks::idleGovernor->latency;
 									}
+									fpsCounter->Draw(config.fps, pixelBuffer->GetBuffer());
+									BOOL isDamaged = pixelBuffer->Update();
+									RECT damage = *pixelBuffer->GetDamage();
+									this->histogram->Update(frameData, RES_WIDTH, RES_HEIGHT, RES_WIDTH * sizeof(DWORD), FpsRgba, &damage);
+									pixelBuffer->SwapBuffers();
 
-									// Draw from FBO
-									if (state.upscaling)
+									if (isRedraw || isDamaged || config.fps == FpsBenchmark)
 									{
-										GLFinish();
-										GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, NULL);
-
-										GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
+										if (state.upscaling == UpscaleXRBZ)
+										{
+											// Classify edges once per source pixel, the scaling pass only blends
+											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, edgeId);
+											GLViewport(0, 0, this->width, this->height);
+											shaders.xBRz_edge->Use(texSize);
+											GLDrawArrays(GL_TRIANGLE_FAN, 8, 4);
 
-										if (clear++ <= 1)
-											GLClear(GL_COLOR_BUFFER_BIT);
+											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, fboId);
+											GLViewport(0, 0, LOWORD(viewSize), HIWORD(viewSize));
+											upscaleProgram->Use(texSize);
+										}
 
-										switch (state.interpolation)
+										if (!state.upscaling && passProgram)
 										{
-										case InterpolateHermite:
-											program = shaders.hermite;
-											break;
-										case InterpolateCubic:
-											program = shaders.cubic;
-											break;
-										case InterpolateLanczos:
-											program = shaders.lanczos;
-											break;
-										default:
-											program = shaders.linear;
-											break;
+											// Separable kernel: source rows at output width, then columns
+											if (!resampler)
+												resampler = new Resampler();
+											resampler->Begin(state.interpolation, this->viewport.rectangle.width, this->height);
+											passProgram->Use(texSize);
+											GLDrawArrays(GL_TRIANGLE_FAN, 8, 4);
+
+											DWORD passSize = resampler->End();
+											GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
+											program->Use(passSize);
+											GLDrawArrays(GL_TRIANGLE_FAN, 12, 4);
+
+											GLBindTexture(GL_TEXTURE_2D, texId.primary);
 										}
+										else
+											GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 
-										program->Use(viewSize);
+										// Draw from FBO
+										if (state.upscaling)
+										{
+											GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, NULL);
 
-										GLBindTexture(GL_TEXTURE_2D, texId.buffer);
+											GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
 
-										DWORD filter = state.interpolation == InterpolateLinear || state.interpolation == InterpolateHermite ? GL_LINEAR : GL_NEAREST;
-										GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-										GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+											if (clear++ <= 1)
+												GLClear(GL_COLOR_BUFFER_BIT);
 
-										GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
+											switch (state.interpolation)
+											{
+											case InterpolateHermite:
+												program = shaders.hermite;
+												passProgram = NULL;
+												break;
+											case InterpolateCubic:
+												program = shaders.cubic;
+												passProgram = shaders.cubic_h;
+												break;
+											case InterpolateLanczos:
+												program = shaders.lanczos;
+												passProgram = shaders.lanczos_h;
+												break;
+											default:
+												program = shaders.linear;
+												passProgram = NULL;
+												break;
+											}
 
-										if (isSnapshot && OpenClipboard(NULL))
-										{
-											EmptyClipboard();
+											GLBindTexture(GL_TEXTURE_2D, texId.buffer);
 
-											DWORD size = LOWORD(viewSize) * HIWORD(viewSize) * 3;
-											DWORD slice = sizeof(BITMAPINFOHEADER);
-											HGLOBAL hMemory = GlobalAlloc(GMEM_MOVEABLE, slice + size);
-											if (hMemory)
+											DWORD filter = state.interpolation == InterpolateLinear || state.interpolation == InterpolateHermite ? GL_LINEAR : GL_NEAREST;
+											GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+											GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+
+											if (passProgram)
 											{
-												VOID* data = GlobalLock(hMemory);
-												if (data)
-												{
-													BITMAPINFOHEADER* bmi = (BITMAPINFOHEADER*)data;
-													bmi->biSize = sizeof(BITMAPINFOHEADER);
-													bmi->biWidth = LOWORD(viewSize);
-													bmi->biHeight = HIWORD(viewSize);
-													bmi->biPlanes = 1;
-													bmi->biBitCount = 24;
-													bmi->biCompression = BI_RGB;
-													bmi->biSizeImage = size;
-													bmi->biXPelsPerMeter = 1;
-													bmi->biYPelsPerMeter = 1;
-													bmi->biClrUsed = 0;
-													bmi->biClrImportant = 0;
-
-													GLGetTexImage(GL_TEXTURE_2D, 0, GL_BGR_EXT, GL_UNSIGNED_BYTE, (BYTE*)data + slice);
-
-													GlobalUnlock(hMemory);
-													SetClipboardData(CF_DIB, hMemory);
-												}
+												if (!resampler)
+													resampler = new Resampler();
+												resampler->Begin(state.interpolation, this->viewport.rectangle.width, HIWORD(viewSize));
+												passProgram->Use(viewSize);
+												GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
+
+												DWORD passSize = resampler->End();
+												GLViewport(this->viewport.rectangle.x, this->viewport.rectangle.y, this->viewport.rectangle.width, this->viewport.rectangle.height);
+												program->Use(passSize);
+												GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
 
-												GlobalFree(hMemory);
+												GLBindTexture(GL_TEXTURE_2D, texId.buffer);
+											}
+											else
+											{
+												program->Use(viewSize);
+												GLDrawArrays(GL_TRIANGLE_FAN, 4, 4);
 											}
 
-											CloseClipboard();
+											if (isSnapshot)
+											{
+												SnapshotFrame* frame = Snapshot::Acquire(LOWORD(viewSize), HIWORD(viewSize));
+												if (frame)
+												{
+													frame->isFlipped = TRUE;
+													GLGetTexImage(GL_TEXTURE_2D, 0, GL_BGRA_EXT, GL_UNSIGNED_BYTE, frame->data);
+													Snapshot::Commit(frame);
+												}
+											}
 										}
+										else if (isSnapshot)
+											surface->TakeSnapshot(this->width, this->height);
+
+										this->Present(isRedraw ? NULL : &damage);
+										pacer->Submit(this->frames->GetStamp());
 									}
-									else if (isSnapshot)
-										surface->TakeSnapshot(this->width, this->height);
+									else
+										++fpsCounter->elided;
 
-									SwapBuffers(this->hDc);
 									if (clear > 1 && config.fps != FpsBenchmark)
 										WaitForSingleObject(this->hDrawEvent, INFINITE);
-									GLFinish();
 								} while (!this->isFinish);
 
 								if (fboId)
 								{
 									GLDeleteTextures(2, &texId.secondary);
 									GLDeleteFramebuffers(1, &fboId);
+									if (edgeId)
+									{
+										GLDeleteTextures(1, &texId.edge);
+										GLDeleteFramebuffers(1, &edgeId);
+										edgeId = 0;
+									}
+
 									AlignedFree(emptyBuffer);
 									delete secondBuffer;
 								}
 							}
 							delete firstBuffer;
 							delete fpsCounter;
+							delete pacer;
+							if (resampler)
+								delete resampler;
 						}
 						GLDeleteTextures(1, &texId.primary);
 					}
@@ -1335,6 +1429,13 @@ VOID OpenDraw::RenderStart()
 	this->viewport.height = rect.bottom;
 	this->viewport.refresh = TRUE;
 
+	this->ResetFrames();
+	if (!this->frames)
+	{
+		this->RenderStop();
+		return;
+	}
+
 	DWORD threadId;
 	SECURITY_ATTRIBUTES sAttribs = { sizeof(SECURITY_ATTRIBUTES), NULL, FALSE };
 	this->hDrawThread = CreateThread(&sAttribs, STACK_SIZE, RenderThread, this, NORMAL_PRIORITY_CLASS, &threadId);
@@ -1347,9 +1448,15 @@ VOID OpenDraw::RenderStop()
 
 	this->isFinish = TRUE;
 	SetEvent(this->hDrawEvent);
-	WaitForSingleObject(this->hDrawThread, INFINITE);
-	CloseHandle(this->hDrawThread);
-	this->hDrawThread = NULL;
+	if (this->hDrawThread)
+	{
+		WaitForSingleObject(this->hDrawThread, INFINITE);
+		CloseHandle(this->hDrawThread);
+		this->hDrawThread = NULL;
+	}
+
+	delete this->frames;
+	this->frames = NULL;
 
 	if (this->hDraw != this->hWnd)
 	{
@@ -1365,6 +1472,51 @@ VOID OpenDraw::RenderStop()
 	Window::CheckMenu(this->hWnd);
 }
 
+VOID OpenDraw::ResetFrames()
+{
+	delete this->frames;
+	this->frames = FrameQueue::Create(RES_WIDTH, RES_HEIGHT, RES_WIDTH * sizeof(DWORD), sizeof(DWORD));
+
+	OpenDrawSurface* surface = this->attachedSurface;
+	if (this->frames && surface && surface->pixelBuffer)
+		this->frames->Publish(surface->pixelBuffer);
+}
+
+VOID OpenDraw::Publish(const VOID* buffer, const RECT* rect)
+{
+	if (this->frames)
+	{
+		this->frames->Publish(buffer, rect);
+		SetEvent(this->hDrawEvent);
+	}
+}
+
+// Damage tracking skips unchanged frames, anything the window system painted over needs a full frame again
+VOID OpenDraw::Redraw()
+{
+	this->viewport.refresh = TRUE;
+	SetEvent(this->hDrawEvent);
+}
+
+VOID OpenDraw::Present(const RECT* damage)
+{
+	if (damage && GLAddSwapHintRect)
+	{
+		FLOAT fx = this->viewport.clipFactor.x;
+		FLOAT fy = this->viewport.clipFactor.y;
+		INT top = this->viewport.rectangle.y + this->viewport.rectangle.height;
+
+		INT left = this->viewport.rectangle.x + (INT)MathFloor((damage->left - PRESENT_BORDER) * fx);
+		INT right = this->viewport.rectangle.x + (INT)MathCeil((damage->right + PRESENT_BORDER) * fx);
+		INT bottom = top - (INT)MathCeil((damage->bottom + PRESENT_BORDER) * fy);
+		top -= (INT)MathFloor((damage->top - PRESENT_BORDER) * fy);
+
+		GLAddSwapHintRect(left, bottom, right - left, top - bottom);
+	}
+
+	SwapBuffers(this->hDc);
+}
+
 BOOL OpenDraw::CheckView()
 {
 	if (this->viewport.refresh)
@@ -1463,6 +1615,8 @@ OpenDraw::OpenDraw(IDraw** last)
 	this->height = 0;
 	this->isTakeSnapshot = FALSE;
 	this->isFinish = TRUE;
+	this->frames = NULL;
+	this->histogram = new Histogram();
 
 	this->hDrawEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
 }
@@ -1470,6 +1624,10 @@ OpenDraw::OpenDraw(IDraw** last)
 OpenDraw::~OpenDraw()
 {
 	this->RenderStop();
+	delete this->histogram;
+	Snapshot::Stop();
+	Recorder::Release();
+	Ini::Stop();
 	CloseHandle(this->hDrawEvent);
 	ClipCursor(NULL);
 }
@@ -26,6 +26,10 @@
 #include "IDraw.h"
 #include "ExtraTypes.h"
 #include "OpenDrawSurface.h"
+#include "FrameQueue.h"
+#include "Histogram.h"
+
+#define PRESENT_BORDER 4
 
 class OpenDraw : public IDraw
 {
@@ -53,6 +57,9 @@ public:
 	BOOL isTakeSnapshot;
 	BOOL isFpsChanged;
 
+	FrameQueue* frames;
+	Histogram* histogram;
+
 	OpenDraw(IDraw**);
 	~OpenDraw();
 
@@ -62,6 +69,10 @@ public:
 
 	VOID RenderStart();
 	VOID RenderStop();
+	VOID Present(const RECT*);
+	VOID Redraw();
+	VOID ResetFrames();
+	VOID Publish(const VOID*, const RECT* = NULL);
 
 	VOID RenderOld();
 	VOID RenderMid();
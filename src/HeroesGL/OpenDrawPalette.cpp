@@ -27,6 +27,7 @@
 #include "OpenDrawSurface.h"
 #include "OpenDraw.h"
 #include "Glib.h"
+#include "Convert.h"
 
 OpenDrawPalette::OpenDrawPalette(IDraw* lpDD)
 {
@@ -64,12 +65,7 @@ HRESULT __stdcall OpenDrawPalette::SetEntries(DWORD dwFlags, DWORD dwStartingEnt
 		{
 			if (surfaceEntry->attachedPalette == this)
 			{
-				BYTE* idx = surfaceEntry->indexBuffer;
-				DWORD* pix = surfaceEntry->pixelBuffer;
-				DWORD count = RES_WIDTH * RES_HEIGHT;
-				do
-					*pix++ = this->entries[*idx++];
-				while (--count);
+				ExpandPalette(surfaceEntry->indexBuffer, (uint32_t*)surfaceEntry->pixelBuffer, RES_WIDTH * RES_HEIGHT, (const uint32_t*)this->entries);
 
 				update = TRUE;
 			}
@@ -77,11 +73,9 @@ HRESULT __stdcall OpenDrawPalette::SetEntries(DWORD dwFlags, DWORD dwStartingEnt
 			surfaceEntry = (OpenDrawSurface*)surfaceEntry->last;
 		}
 
-		if (update)
-		{
-			SetEvent(((OpenDraw*)this->ddraw)->hDrawEvent);
-			Sleep(0);
-		}
+		OpenDrawSurface* surface = ((OpenDraw*)this->ddraw)->attachedSurface;
+		if (update && surface && surface->pixelBuffer)
+			((OpenDraw*)this->ddraw)->Publish(surface->pixelBuffer);
 	}
 
 	return DD_OK;
@@ -27,6 +27,8 @@
 #include "OpenDraw.h"
 #include "GLib.h"
 #include "Config.h"
+#include "Snapshot.h"
+#include "Convert.h"
 
 OpenDrawSurface::OpenDrawSurface(IDraw* lpDD, DWORD index)
 {
@@ -71,64 +73,15 @@ OpenDrawSurface::~OpenDrawSurface()
 
 VOID OpenDrawSurface::TakeSnapshot(DWORD width, DWORD height)
 {
-	if (OpenClipboard(NULL))
-	{
-		EmptyClipboard();
+	SnapshotFrame* frame = Snapshot::Acquire(width, height);
+	if (!frame)
+		return;
 
-		DWORD size = width * height;
-		DWORD slice = sizeof(BITMAPINFOHEADER) + 1024;
-		HGLOBAL hMemory = GlobalAlloc(GMEM_MOVEABLE, slice + size);
-		if (hMemory)
-		{
-			VOID* data = GlobalLock(hMemory);
-			if (data)
-			{
-				BITMAPINFOHEADER* bmi = (BITMAPINFOHEADER*)data;
-				bmi->biSize = sizeof(BITMAPINFOHEADER);
-				bmi->biWidth = width;
-				bmi->biHeight = height;
-				bmi->biPlanes = 1;
-				bmi->biBitCount = 8;
-				bmi->biCompression = BI_RGB;
-				bmi->biSizeImage = 0;
-				bmi->biXPelsPerMeter = 1;
-				bmi->biYPelsPerMeter = 1;
-				bmi->biClrUsed = 0;
-				bmi->biClrImportant = 0;
-
-				{
-					DWORD* src = this->attachedPalette->entries;
-					DWORD* dst = (DWORD*)((BYTE*)data + sizeof(BITMAPINFOHEADER));
-					DWORD count = 256;
-					do
-						*dst++ = _byteswap_ulong(_rotl(*src++, 8));
-					while (--count);
-				}
-
-				{
-					BYTE* dstData = (BYTE*)data + slice + size - width;
-					BYTE* src = this->indexBuffer;
-					do
-					{
-						BYTE* dst = dstData;
-						DWORD count = width;
-						do
-							*dst++ = *src++;
-						while (--count);
-
-						dstData -= width;
-					} while (--height);
-				}
-
-				GlobalUnlock(hMemory);
-				SetClipboardData(CF_DIB, hMemory);
-			}
-
-			GlobalFree(hMemory);
-		}
-		
-		CloseClipboard();
-	}
+	uint32_t palette[256];
+	SwapRedBlue((const uint32_t*)this->attachedPalette->entries, palette, 256);
+	ExpandPalette(this->indexBuffer, (uint32_t*)frame->data, width * height, palette);
+
+	Snapshot::Commit(frame);
 }
 
 ULONG __stdcall OpenDrawSurface::AddRef()
@@ -174,26 +127,20 @@ HRESULT __stdcall OpenDrawSurface::Blt(LPRECT, LPDIRECTDRAWSURFACE lpDDSrcSurfac
 
 	LONG width = rcSrc.right - rcSrc.left;
 	LONG height = rcSrc.bottom - rcSrc.top;
-	DWORD pitch = RES_WIDTH - width;
 
 	LONG ch = height;
 	do
 	{
-		LONG cw = width;
-		do
-		{
-			BYTE index = *src++;
-			*pix++ = this->attachedPalette->entries[index];
-			*dst++ = index;
-		} while (--cw);
-
-		src += pitch;
-		pix += pitch;
-		dst += pitch;
+		MemoryCopy(dst, src, width);
+		ExpandPalette(src, (uint32_t*)pix, width, (const uint32_t*)this->attachedPalette->entries);
+
+		src += RES_WIDTH;
+		pix += RES_WIDTH;
+		dst += RES_WIDTH;
 	} while (--ch);
 
-	SetEvent(((OpenDraw*)this->ddraw)->hDrawEvent);
-	Sleep(0);
+	if (((OpenDraw*)this->ddraw)->attachedSurface == this)
+		((OpenDraw*)this->ddraw)->Publish(this->pixelBuffer, &config.update.rect);
 
 	return DD_OK;
 }
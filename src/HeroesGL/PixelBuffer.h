@@ -26,12 +26,12 @@
 
 #include "Allocation.h"
 #include "ExtraTypes.h"
+#include "Compare.h"
 
 #define BLOCK_SIZE 256
-
-typedef DWORD(__fastcall* COMPARE)(DWORD, DWORD, DWORD*, DWORD*);
-typedef BOOL(__fastcall* BLOCKCOMPARE)(LONG, LONG, DWORD, DWORD, DWORD*, DWORD*, POINT*);
-typedef DWORD(__fastcall* SIDECOMPARE)(LONG, LONG, DWORD, DWORD, DWORD*, DWORD*);
+#define TUNE_WARMUP 2
+#define TUNE_FRAMES 16
+#define TUNE_SPRITE 64
 
 class PixelBuffer : public Allocation {
 private:
@@ -50,6 +50,9 @@ private:
 	DWORD* primaryBuffer;
 	DWORD* secondaryBuffer;
 	DWORD* white;
+	DWORD track;
+	GLuint texture;
+	RECT damage;
 
 	COMPARE ForwardCompare;
 	COMPARE BackwardCompare;
@@ -58,15 +61,20 @@ private:
 	SIDECOMPARE SideForwardCompare;
 	SIDECOMPARE SideBackwardCompare;
 
-	VOID UpdateBlock(RECT*, const POINT*);
+	VOID Bind();
+	BOOL UpdateBlock(RECT*, const POINT*);
 
 public:
-	PixelBuffer(DWORD, DWORD, BOOL, GLenum, UpdateMode);
+	PixelBuffer(DWORD, DWORD, BOOL, GLenum, UpdateMode, BOOL = TRUE);
 	~PixelBuffer();
 
 	VOID Reset();
 	VOID Copy(VOID*);
-	VOID Update(Rect* = NULL);
+	BOOL Update(Rect* = NULL, GLuint = 0);
 	VOID* GetBuffer();
+	const RECT* GetDamage();
 	VOID SwapBuffers();
+
+	static LONGLONG Measure(DWORD, DWORD, BOOL, GLenum, UpdateMode);
+	static UpdateMode Tune(DWORD, DWORD, BOOL, GLenum);
 };
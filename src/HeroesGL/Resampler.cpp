@@ -0,0 +1,147 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "Resampler.h"
+
+Resampler::Resampler()
+{
+	this->size = 0;
+	this->kernel = InterpolateNearest;
+
+	GLGenTextures(2, &this->texId);
+
+	// Kernel weights live on unit 3 for the lifetime of the renderer
+	GLActiveTexture(GL_TEXTURE3);
+	{
+		GLBindTexture(GL_TEXTURE_1D, this->weightsId);
+		GLTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		GLTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_BASE_LEVEL, 0);
+		GLTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAX_LEVEL, 0);
+		GLTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		GLTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+		GLBindTexture(GL_TEXTURE_2D, this->texId);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		GLBindTexture(GL_TEXTURE_2D, NULL);
+	}
+	GLActiveTexture(GL_TEXTURE0);
+
+	GLGenFramebuffers(1, &this->fboId);
+}
+
+Resampler::~Resampler()
+{
+	GLDeleteFramebuffers(1, &this->fboId);
+	GLDeleteTextures(2, &this->texId);
+}
+
+VOID Resampler::Weights(InterpolationFilter kernel)
+{
+	FLOAT weights[RESAMPLE_PHASES][4];
+	for (DWORD i = 0; i < RESAMPLE_PHASES; ++i)
+	{
+		FLOAT* weight = weights[i];
+		FLOAT phase = (FLOAT)i / (RESAMPLE_PHASES - 1);
+
+		if (kernel == InterpolateLanczos)
+		{
+			// Taps -2..3 around the sample, only the left half is stored
+			FLOAT taps[6];
+			FLOAT sum = 0.0f;
+			for (INT j = 0; j < 6; ++j)
+			{
+				FLOAT s = FLOAT(M_PI) * (FLOAT(j - 2) - phase);
+				if (s < 0.0f)
+					s = -s;
+				if (s < 1e-5f)
+					s = 1e-5f;
+
+				taps[j] = (FLOAT)(MathSinus(s) * MathSinus(s / 3.0f)) / (s * s);
+				sum += taps[j];
+			}
+
+			weight[0] = taps[0] / sum;
+			weight[1] = taps[1] / sum;
+			weight[2] = taps[2] / sum;
+		}
+		else
+		{
+			// Catmull-Rom taps -1 and 0
+			FLOAT t2 = phase * phase;
+			FLOAT t3 = t2 * phase;
+			weight[0] = -0.5f * phase + t2 - 0.5f * t3;
+			weight[1] = 1.0f - 2.5f * t2 + 1.5f * t3;
+			weight[2] = 0.0f;
+		}
+
+		weight[3] = 0.0f;
+	}
+
+	GLActiveTexture(GL_TEXTURE3);
+	GLTexImage1D(GL_TEXTURE_1D, 0, GL_RGBA32F, RESAMPLE_PHASES, GL_NONE, GL_RGBA, GL_FLOAT, weights);
+	GLActiveTexture(GL_TEXTURE0);
+}
+
+VOID Resampler::Begin(InterpolationFilter kernel, DWORD width, DWORD height)
+{
+	if (this->kernel != kernel)
+	{
+		this->kernel = kernel;
+		this->Weights(kernel);
+	}
+
+	DWORD size = MAKELONG(width, height);
+	if (this->size != size)
+	{
+		this->size = size;
+
+		// Signed float keeps the overshoot of the first pass for the second one
+		GLActiveTexture(GL_TEXTURE3);
+		GLBindTexture(GL_TEXTURE_2D, this->texId);
+		GLTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, GL_NONE, GL_RGBA, GL_HALF_FLOAT, NULL);
+		GLBindTexture(GL_TEXTURE_2D, NULL);
+		GLActiveTexture(GL_TEXTURE0);
+
+		GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->fboId);
+		GLFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->texId, 0);
+	}
+	else
+		GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, this->fboId);
+
+	GLViewport(0, 0, width, height);
+}
+
+DWORD Resampler::End()
+{
+	GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, NULL);
+	GLBindTexture(GL_TEXTURE_2D, this->texId);
+
+	return this->size;
+}
@@ -58,40 +58,6 @@ DOUBLE MathRound(DOUBLE number)
 	return floorVal + 0.5f > number ? floorVal : MathCeil(number);
 }
 
-struct Aligned {
-	Aligned* last;
-	VOID* block;
-	DWORD data[1];
-} * alignedList;
-
-VOID* AlignedAlloc(size_t size)
-{
-	Aligned* entry = (Aligned*)MemoryAlloc(sizeof(Aligned) + size + 12);
-	entry->last = alignedList;
-	entry->block = (VOID*)(DWORD(entry->data + 4) & 0xFFFFFFF0);
-	alignedList = entry;
-
-	return entry->block;
-}
-
-VOID AlignedFree(VOID* block)
-{
-	Aligned** list = &alignedList;
-	Aligned* entry = alignedList;
-	while (entry)
-	{
-		if (entry->block == block)
-		{
-			*list = entry->last;
-			MemoryFree(entry);
-			break;
-		}
-
-		list = &entry->last;
-		entry = entry->last;
-	}
-}
-
 VOID LoadKernel32()
 {
 	HMODULE hLib = GetModuleHandle("KERNEL32.dll");
@@ -107,9 +107,15 @@ extern "C"
 #define SeedRandom(seed) srand(seed)
 #define Exit(code) exit(code)
 
+#define ALIGNED_BOUNDARY 64
+#define ALIGNED_CLASS 0x10000
+#define ALIGNED_SLOTS 8
+#define ALIGNED_LIMIT (64 << 20)
+
 DOUBLE MathRound(DOUBLE);
 VOID* AlignedAlloc(size_t);
 VOID AlignedFree(VOID*);
+VOID AlignedRelease();
 
 extern HMODULE hDllModule;
 extern HANDLE hActCtx;
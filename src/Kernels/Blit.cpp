@@ -0,0 +1,142 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Blit.h"
+#include <emmintrin.h>
+
+namespace CPP
+{
+	void KeyBlit(const uint16_t* src, uint32_t sPitch, uint16_t* dst, uint32_t dPitch, uint32_t width, uint32_t height, uint16_t key)
+	{
+		if (!width)
+			return;
+
+		sPitch -= width;
+		dPitch -= width;
+
+		while (height--)
+		{
+			uint32_t count = width;
+			do
+			{
+				if (*src != key)
+					*dst = *src;
+
+				++src;
+				++dst;
+			} while (--count);
+
+			src += sPitch;
+			dst += dPitch;
+		}
+	}
+
+	void KeyBlit(const uint32_t* src, uint32_t sPitch, uint32_t* dst, uint32_t dPitch, uint32_t width, uint32_t height, uint32_t key)
+	{
+		if (!width)
+			return;
+
+		sPitch -= width;
+		dPitch -= width;
+
+		while (height--)
+		{
+			uint32_t count = width;
+			do
+			{
+				if (*src != key)
+					*dst = *src;
+
+				++src;
+				++dst;
+			} while (--count);
+
+			src += sPitch;
+			dst += dPitch;
+		}
+	}
+}
+
+namespace SSE
+{
+	void KeyBlit(const uint16_t* src, uint32_t sPitch, uint16_t* dst, uint32_t dPitch, uint32_t width, uint32_t height, uint16_t key)
+	{
+		uint32_t count = width >> 3;
+		if (count)
+		{
+			__m128i k = _mm_set1_epi16(key);
+			const uint16_t* srcRow = src;
+			uint16_t* dstRow = dst;
+			for (uint32_t y = height; y; --y, srcRow += sPitch, dstRow += dPitch)
+			{
+				const __m128i* s = (const __m128i*)srcRow;
+				__m128i* d = (__m128i*)dstRow;
+				for (uint32_t x = count; x; --x, ++s, ++d)
+				{
+					__m128i a = _mm_loadu_si128(s);
+					__m128i mask = _mm_cmpeq_epi16(a, k);
+					if (_mm_movemask_epi8(mask) != 0xFFFF)
+						_mm_storeu_si128(d, _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, _mm_loadu_si128(d))));
+				}
+			}
+
+			count <<= 3;
+			src += count;
+			dst += count;
+			width -= count;
+		}
+
+		CPP::KeyBlit(src, sPitch, dst, dPitch, width, height, key);
+	}
+
+	void KeyBlit(const uint32_t* src, uint32_t sPitch, uint32_t* dst, uint32_t dPitch, uint32_t width, uint32_t height, uint32_t key)
+	{
+		uint32_t count = width >> 2;
+		if (count)
+		{
+			__m128i k = _mm_set1_epi32(key);
+			const uint32_t* srcRow = src;
+			uint32_t* dstRow = dst;
+			for (uint32_t y = height; y; --y, srcRow += sPitch, dstRow += dPitch)
+			{
+				const __m128i* s = (const __m128i*)srcRow;
+				__m128i* d = (__m128i*)dstRow;
+				for (uint32_t x = count; x; --x, ++s, ++d)
+				{
+					__m128i a = _mm_loadu_si128(s);
+					__m128i mask = _mm_cmpeq_epi32(a, k);
+					if (_mm_movemask_epi8(mask) != 0xFFFF)
+						_mm_storeu_si128(d, _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, _mm_loadu_si128(d))));
+				}
+			}
+
+			count <<= 2;
+			src += count;
+			dst += count;
+			width -= count;
+		}
+
+		CPP::KeyBlit(src, sPitch, dst, dPitch, width, height, key);
+	}
+}
\ No newline at end of file
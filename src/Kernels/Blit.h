@@ -0,0 +1,48 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include <stdint.h>
+
+/*
+	Color key blits of DirectDraw surfaces. A width x height block is copied
+	from `src` to `dst`, pixels equal to `key` are skipped and leave the
+	destination as it was. Pitches are counted in pixels.
+
+	The SSE variants take 16 bytes at a time with unaligned loads, a block that
+	is all key is not written back. The columns left over go through the plain
+	loop.
+*/
+
+namespace CPP
+{
+	void KeyBlit(const uint16_t* src, uint32_t sPitch, uint16_t* dst, uint32_t dPitch, uint32_t width, uint32_t height, uint16_t key);
+	void KeyBlit(const uint32_t* src, uint32_t sPitch, uint32_t* dst, uint32_t dPitch, uint32_t width, uint32_t height, uint32_t key);
+}
+
+namespace SSE
+{
+	void KeyBlit(const uint16_t* src, uint32_t sPitch, uint16_t* dst, uint32_t dPitch, uint32_t width, uint32_t height, uint16_t key);
+	void KeyBlit(const uint32_t* src, uint32_t sPitch, uint32_t* dst, uint32_t dPitch, uint32_t width, uint32_t height, uint32_t key);
+}
\ No newline at end of file
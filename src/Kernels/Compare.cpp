@@ -0,0 +1,679 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Compare.h"
+#include <emmintrin.h>
+
+#ifdef COMPARE_ASM
+namespace ASM
+{
+	uint32_t __declspec(naked) COMPARECALL ForwardCompare(uint32_t count, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		__asm {
+			push ebp
+			mov ebp, esp
+			push esi
+			push edi
+
+			mov esi, ptr1
+			mov edi, ptr2
+
+			sal edx, 2
+			add esi, edx
+			add edi, edx
+
+			repe cmpsd
+			jz lbl_ret
+			inc ecx
+
+			lbl_ret:
+			mov eax, ecx
+
+			pop edi
+			pop esi
+			mov esp, ebp
+			pop ebp
+
+			retn 8
+		}
+	}
+
+	uint32_t __declspec(naked) COMPARECALL BackwardCompare(uint32_t count, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		__asm {
+			push ebp
+			mov ebp, esp
+			push esi
+			push edi
+
+			mov esi, ptr1
+			mov edi, ptr2
+
+			sal edx, 2
+			add esi, edx
+			add edi, edx
+
+			std
+			repe cmpsd
+			cld
+			jz lbl_ret
+			inc ecx
+
+			lbl_ret:
+			mov eax, ecx
+
+			pop edi
+			pop esi
+			mov esp, ebp
+			pop ebp
+
+			retn 8
+		}
+	}
+
+	bool __declspec(naked) COMPARECALL BlockForwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2, ComparePoint* p)
+	{
+		__asm {
+			push ebp
+			mov ebp, esp
+			push ebx
+			push esi
+			push edi
+
+			mov eax, ecx
+			mov esp, edx
+
+			mov ebx, pitch
+			sub ebx, eax
+			sal ebx, 2
+
+			mov esi, ptr1
+			mov edi, ptr2
+
+			mov ecx, slice
+			sal ecx, 2
+
+			add esi, ecx
+			add edi, ecx
+
+			lbl_cycle:
+				mov ecx, eax
+				repe cmpsd
+				jne lbl_break
+
+				add esi, ebx
+				add edi, ebx
+			dec edx
+			jnz lbl_cycle
+
+			xor eax, eax
+			jmp lbl_ret
+
+			lbl_break:
+			mov ebx, p
+		
+			inc ecx
+			sub eax, ecx
+			mov [ebx], eax
+
+			sub esp, edx
+			mov [ebx+4], esp
+
+			xor eax, eax
+			inc eax
+
+			lbl_ret:
+			mov esp, ebp
+			sub esp, 12
+			pop edi
+			pop esi
+			pop ebx
+			pop ebp
+
+			retn 20
+		}
+	}
+
+	bool __declspec(naked) COMPARECALL BlockBackwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2, ComparePoint* p)
+	{
+		__asm {
+			push ebp
+			mov ebp, esp
+			push ebx
+			push esi
+			push edi
+
+			mov eax, ecx
+
+			mov ebx, pitch
+			sub ebx, eax
+			sal ebx, 2
+
+			mov esi, ptr1
+			mov edi, ptr2
+
+			mov ecx, slice
+			sal ecx, 2
+
+			add esi, ecx
+			add edi, ecx
+
+			std
+
+			lbl_cycle:
+				mov ecx, eax
+				repe cmpsd
+				jnz lbl_break
+
+				sub esi, ebx
+				sub edi, ebx
+			dec edx
+			jnz lbl_cycle
+
+			xor eax, eax
+			jmp lbl_ret
+
+			lbl_break:
+			mov ebx, p
+		
+			mov [ebx], ecx
+
+			dec edx
+			mov [ebx+4], edx
+
+			xor eax, eax
+			inc eax
+
+			lbl_ret:
+			cld
+			pop edi
+			pop esi
+			pop ebx
+			mov esp, ebp
+			pop ebp
+
+			retn 20
+		}
+	}
+
+	uint32_t __declspec(naked) COMPARECALL SideForwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		__asm {
+			push ebp
+			mov ebp, esp
+			push ebx
+			push esi
+			push edi
+
+			mov eax, ecx
+			mov esp, ecx
+
+			mov ebx, pitch
+			sub ebx, eax
+			sal ebx, 2
+
+			mov esi, ptr1
+			mov edi, ptr2
+
+			mov ecx, slice
+			sal ecx, 2
+
+			add esi, ecx
+			add edi, ecx
+
+			lbl_cycle:
+				mov ecx, eax
+				repe cmpsd
+				jz lbl_inc
+			
+				sub eax, ecx
+				dec eax
+				jz lbl_ret
+
+				sal ecx, 2
+				add ebx, ecx
+				add esi, ebx
+				add edi, ebx
+				add ebx, 4
+				jmp lbl_cont
+
+				lbl_inc:
+				add esi, ebx
+				add edi, ebx
+			
+				lbl_cont:
+			dec edx
+			jnz lbl_cycle
+
+			lbl_ret:
+			sub esp, eax
+			mov eax, esp
+
+			mov esp, ebp
+			sub esp, 12
+			pop edi
+			pop esi
+			pop ebx
+			pop ebp
+
+			retn 16
+		}
+	}
+
+	uint32_t __declspec(naked) COMPARECALL SideBackwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		__asm {
+			push ebp
+			mov ebp, esp
+			push ebx
+			push esi
+			push edi
+
+			mov eax, ecx
+			mov esp, ecx
+
+			mov ebx, pitch
+			sub ebx, eax
+			sal ebx, 2
+
+			mov esi, ptr1
+			mov edi, ptr2
+
+			mov ecx, slice
+			sal ecx, 2
+
+			add esi, ecx
+			add edi, ecx
+
+			std
+
+			lbl_cycle:
+				mov ecx, eax
+				repe cmpsd
+				jz lbl_inc
+			
+				sub eax, ecx
+				dec eax
+				jz lbl_ret
+
+				sal ecx, 2
+				add ebx, ecx
+				sub esi, ebx
+				sub edi, ebx
+				add ebx, 4
+				jmp lbl_cont
+
+				lbl_inc:
+				sub esi, ebx
+				sub edi, ebx
+			
+				lbl_cont:
+			dec edx
+			jnz lbl_cycle
+
+			lbl_ret:
+			sub esp, eax
+			mov eax, esp
+
+			cld
+
+			mov esp, ebp
+			sub esp, 12
+			pop edi
+			pop esi
+			pop ebx
+			pop ebp
+
+			retn 16
+		}
+	}
+}
+#endif
+
+namespace CPP
+{
+	uint32_t COMPARECALL ForwardCompare(uint32_t count, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		ptr1 += slice;
+		ptr2 += slice;
+
+		for (uint32_t i = 0; i < count; ++i)
+			if (ptr1[i] != ptr2[i])
+				return count - i;
+
+		return 0;
+	}
+
+	uint32_t COMPARECALL BackwardCompare(uint32_t count, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		ptr1 += slice;
+		ptr2 += slice;
+
+		for (uint32_t i = 0; i < count; ++i, --ptr1, --ptr2)
+			if (*ptr1 != *ptr2)
+				return count - i;
+
+		return 0;
+	}
+
+	bool COMPARECALL BlockForwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2, ComparePoint* p)
+	{
+		ptr1 += slice;
+		ptr2 += slice;
+
+		for (int32_t y = 0; y < height; ++y)
+		{
+			for (int32_t x = 0; x < width; ++x)
+			{
+				if (ptr1[x] != ptr2[x])
+				{
+					p->x = x;
+					p->y = y;
+					return true;
+				}
+			}
+
+			ptr1 += pitch;
+			ptr2 += pitch;
+		}
+
+		return false;
+	}
+
+	bool COMPARECALL BlockBackwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2, ComparePoint* p)
+	{
+		ptr1 += slice;
+		ptr2 += slice;
+
+		for (int32_t y = 0; y < height; ++y)
+		{
+			for (int32_t x = 0; x < width; ++x)
+			{
+				if (ptr1[-x] != ptr2[-x])
+				{
+					p->x = width - x - 1;
+					p->y = height - y - 1;
+					return true;
+				}
+			}
+
+			ptr1 -= pitch;
+			ptr2 -= pitch;
+		}
+
+		return false;
+	}
+
+	uint32_t COMPARECALL SideForwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		uint32_t count = width;
+		ptr1 += slice;
+		ptr2 += slice;
+		for (int32_t x = 0; x < width; ++x, ++ptr1, ++ptr2)
+		{
+			const uint32_t* cmp1 = ptr1;
+			const uint32_t* cmp2 = ptr2;
+			for (int32_t y = 0; y < height; ++y, cmp1 += pitch, cmp2 += pitch)
+				if (*cmp1 != *cmp2)
+					return count - x;
+		}
+
+		return 0;
+	}
+
+	uint32_t COMPARECALL SideBackwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		uint32_t count = width;
+		ptr1 += slice;
+		ptr2 += slice;
+		for (int32_t x = 0; x < width; ++x, --ptr1, --ptr2)
+		{
+			const uint32_t* cmp1 = ptr1;
+			const uint32_t* cmp2 = ptr2;
+			for (int32_t y = 0; y < height; ++y, cmp1 -= pitch, cmp2 -= pitch)
+				if (*cmp1 != *cmp2)
+					return count - x;
+		}
+
+		return 0;
+	}
+}
+
+namespace SSE
+{
+	uint32_t COMPARECALL ForwardCompare(uint32_t count, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		const __m128i* a = (const __m128i*)(ptr1 + slice);
+		const __m128i* b = (const __m128i*)(ptr2 + slice);
+		count >>= 2;
+		do
+		{
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(a), _mm_load_si128(b))) != 0xFFFF)
+				return count << 2;
+
+			++a;
+			++b;
+		} while (--count);
+
+		return 0;
+	}
+
+	uint32_t COMPARECALL BackwardCompare(uint32_t count, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		const __m128i* a = (const __m128i*)(ptr1 + slice - 3);
+		const __m128i* b = (const __m128i*)(ptr2 + slice - 3);
+		count >>= 2;
+
+		do
+		{
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(a), _mm_load_si128(b))) != 0xFFFF)
+				return count << 2;
+
+			--a;
+			--b;
+		} while (--count);
+
+		return 0;
+	}
+
+	bool COMPARECALL BlockForwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2, ComparePoint* p)
+	{
+		pitch -= width;
+		pitch >>= 2;
+		width >>= 2;
+
+		const __m128i* a = (const __m128i*)(ptr1 + slice);
+		const __m128i* b = (const __m128i*)(ptr2 + slice);
+		for (int32_t y = 0; y < height; ++y, a += pitch, b += pitch)
+		{
+			uint32_t count = width;
+			do
+			{
+				int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(a), _mm_load_si128(b)));
+				if (mask != 0xFFFF)
+				{
+					int32_t c = 3;
+					do
+					{
+						if (!(mask & 0x000F))
+							break;
+						mask >>= 4;
+					} while (--c);
+
+					p->x = ((width - count) << 2) + 3 - c;
+					p->y = y;
+					return true;
+				}
+
+				++a;
+				++b;
+			} while (--count);
+		}
+
+		return false;
+	}
+
+	bool COMPARECALL BlockBackwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2, ComparePoint* p)
+	{
+		pitch -= width;
+		pitch >>= 2;
+		width >>= 2;
+
+		const __m128i* a = (const __m128i*)(ptr1 + slice - 3);
+		const __m128i* b = (const __m128i*)(ptr2 + slice - 3);
+		for (int32_t y = 0; y < height; ++y, a -= pitch, b -= pitch)
+		{
+			uint32_t count = width;
+			do
+			{
+				int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(a), _mm_load_si128(b)));
+				if (mask != 0xFFFF)
+				{
+					int32_t c = 3;
+					do
+					{
+						if (!(mask & 0xF000))
+							break;
+						mask <<= 4;
+					} while (--c);
+
+					p->x = (count << 2) - (4 - c);
+					p->y = height - y - 1;
+					return true;
+				}
+
+				--a;
+				--b;
+			} while (--count);
+		}
+
+		return false;
+	}
+
+	uint32_t COMPARECALL SideForwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		uint32_t count = width;
+		int32_t swd = width >> 2;
+		uint32_t spt = pitch >> 2;
+
+		const __m128i* a = (const __m128i*)(ptr1 + slice);
+		const __m128i* b = (const __m128i*)(ptr2 + slice);
+
+		int32_t i = 0, j;
+		for (i = 0; i < swd; ++i, ++a, ++b)
+		{
+			const __m128i* cmp1 = a;
+			const __m128i* cmp2 = b;
+			for (j = 0; j < height; ++j, cmp1 += spt, cmp2 += spt)
+			{
+				int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(cmp1), _mm_load_si128(cmp2)));
+				if (mask != 0xFFFF)
+				{
+					int32_t c = 3;
+					do
+					{
+						if (!(mask & 0x000F))
+							break;
+						mask >>= 4;
+					} while (--c);
+
+					++j;
+					a = cmp1 + spt;
+					b = cmp2 + spt;
+					width = (i << 2) + 3 - c;
+					goto lbl_dword;
+				}
+			}
+		}
+
+		j = 0;
+
+	lbl_dword:;
+		ptr1 = (const uint32_t*)a;
+		ptr2 = (const uint32_t*)b;
+		for (int32_t x = i << 2; x < width; ++x, ++ptr1, ++ptr2)
+		{
+			const uint32_t* cmp1 = ptr1;
+			const uint32_t* cmp2 = ptr2;
+			for (int32_t y = j; y < height; ++y, cmp1 += pitch, cmp2 += pitch)
+				if (*cmp1 != *cmp2)
+					return count - x;
+		}
+
+		return count - width;
+	}
+
+	uint32_t COMPARECALL SideBackwardCompare(int32_t width, int32_t height, uint32_t pitch, uint32_t slice, const uint32_t* ptr1, const uint32_t* ptr2)
+	{
+		uint32_t count = width;
+		int32_t swd = width >> 2;
+		uint32_t spt = pitch >> 2;
+
+		const __m128i* a = (const __m128i*)(ptr1 + slice - 3);
+		const __m128i* b = (const __m128i*)(ptr2 + slice - 3);
+
+		int32_t i = 0, j;
+		for (i = 0; i < swd; ++i, --a, --b)
+		{
+			const __m128i* cmp1 = a;
+			const __m128i* cmp2 = b;
+			for (j = 0; j < height; ++j, cmp1 -= spt, cmp2 -= spt)
+			{
+				int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_load_si128(cmp1), _mm_load_si128(cmp2)));
+				if (mask != 0xFFFF)
+				{
+					int32_t c = 3;
+					do
+					{
+						if (!(mask & 0xF000))
+							break;
+						mask <<= 4;
+					} while (--c);
+
+					++j;
+					a = cmp1 - spt;
+					b = cmp2 - spt;
+					width = (i << 2) + 3 - c;
+					goto lbl_dword;
+				}
+			}
+		}
+
+		j = 0;
+
+	lbl_dword:;
+		ptr1 = (const uint32_t*)a + 3;
+		ptr2 = (const uint32_t*)b + 3;
+		for (int32_t x = i << 2; x < width; ++x, --ptr1, --ptr2)
+		{
+			const uint32_t* cmp1 = ptr1;
+			const uint32_t* cmp2 = ptr2;
+			for (int32_t y = j; y < height; ++y, cmp1 -= pitch, cmp2 -= pitch)
+				if (*cmp1 != *cmp2)
+					return count - x;
+		}
+
+		return count - width;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include <stdint.h>
+
+/*
+	Compare kernels of PixelBuffer. Two frames with the same pitch are scanned
+	for the first differing pixel, counting in 32-bit words from word `slice`.
+
+	ForwardCompare and BackwardCompare return how many of the `count` words
+	are left from the first mismatch on, 0 when all are equal. The block
+	variants store the first mismatch of a width x height block in `p`, the
+	side variants return the remaining columns.
+
+	The SSE variants need 16-byte aligned rows and widths in multiples of 4
+	and report the linear compares at 4-word granularity. The ASM variants
+	are MSVC x86 inline assembly and rely on its register calling convention,
+	which is why every variant is declared with COMPARECALL.
+*/
+
+#if defined(_MSC_VER) && defined(_M_IX86)
+#define COMPARE_ASM
+#define COMPARECALL __fastcall
+#else
+#define COMPARECALL
+#endif
+
+struct ComparePoint
+{
+	int32_t x;
+	int32_t y;
+};
+
+typedef uint32_t(COMPARECALL* COMPARE)(uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+typedef bool(COMPARECALL* BLOCKCOMPARE)(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*, ComparePoint*);
+typedef uint32_t(COMPARECALL* SIDECOMPARE)(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+
+#ifdef COMPARE_ASM
+namespace ASM
+{
+	uint32_t COMPARECALL ForwardCompare(uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+	uint32_t COMPARECALL BackwardCompare(uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+	bool COMPARECALL BlockForwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*, ComparePoint*);
+	bool COMPARECALL BlockBackwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*, ComparePoint*);
+	uint32_t COMPARECALL SideForwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+	uint32_t COMPARECALL SideBackwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+}
+#endif
+
+namespace CPP
+{
+	uint32_t COMPARECALL ForwardCompare(uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+	uint32_t COMPARECALL BackwardCompare(uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+	bool COMPARECALL BlockForwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*, ComparePoint*);
+	bool COMPARECALL BlockBackwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*, ComparePoint*);
+	uint32_t COMPARECALL SideForwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+	uint32_t COMPARECALL SideBackwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+}
+
+namespace SSE
+{
+	uint32_t COMPARECALL ForwardCompare(uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+	uint32_t COMPARECALL BackwardCompare(uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+	bool COMPARECALL BlockForwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*, ComparePoint*);
+	bool COMPARECALL BlockBackwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*, ComparePoint*);
+	uint32_t COMPARECALL SideForwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+	uint32_t COMPARECALL SideBackwardCompare(int32_t, int32_t, uint32_t, uint32_t, const uint32_t*, const uint32_t*);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Convert.h"
+
+void SwapRedBlue(const uint32_t* src, uint32_t* dst, uint32_t count)
+{
+	while (count--)
+	{
+		uint32_t px = *src++;
+		*dst++ = (px & 0xFF00FF00) | ((px >> 16) & 0xFF) | ((px & 0xFF) << 16);
+	}
+}
+
+void Rgb565ToRgba(const uint16_t* src, uint32_t* dst, uint32_t count)
+{
+	while (count--)
+	{
+		uint32_t px = *src++;
+		*dst++ = ((px & 0xF800) >> 8) | ((px & 0x07E0) << 5) | ((px & 0x001F) << 19);
+	}
+}
+
+void Rgb565ToBgra(const uint16_t* src, uint32_t* dst, uint32_t count)
+{
+	while (count--)
+	{
+		uint32_t px = *src++;
+		uint32_t r = (px >> 11) & 0x1F;
+		uint32_t g = (px >> 5) & 0x3F;
+		uint32_t b = px & 0x1F;
+
+		*dst++ = ((r << 3) | (r >> 2)) << 16 | ((g << 2) | (g >> 4)) << 8 | ((b << 3) | (b >> 2));
+	}
+}
+
+void ExpandPalette(const uint8_t* src, uint32_t* dst, uint32_t count, const uint32_t* palette)
+{
+	while (count--)
+		*dst++ = palette[*src++];
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include <stdint.h>
+
+/*
+	Pixel format conversions between the game surfaces and the frames handed
+	to OpenGL or written to snapshots. Every kernel converts `count` pixels
+	from `src` into `dst`, the buffers must not overlap.
+
+	SwapRedBlue turns BGRA into RGBA and back, alpha and green stay.
+	Rgb565ToRgba widens RGB565 by shifting, the low bits of each channel stay
+	zero, the way the texture upload always did. Rgb565ToBgra replicates the
+	high bits into the low ones, so white stays white in snapshots.
+	ExpandPalette looks every 8-bit index up in a 256-entry palette.
+*/
+
+void SwapRedBlue(const uint32_t* src, uint32_t* dst, uint32_t count);
+void Rgb565ToRgba(const uint16_t* src, uint32_t* dst, uint32_t count);
+void Rgb565ToBgra(const uint16_t* src, uint32_t* dst, uint32_t count);
+void ExpandPalette(const uint8_t* src, uint32_t* dst, uint32_t count, const uint32_t* palette);
\ No newline at end of file
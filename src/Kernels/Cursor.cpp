@@ -0,0 +1,56 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Cursor.h"
+#include <stddef.h>
+
+static bool IsSet(const uint8_t* row, int32_t x)
+{
+	return (row[x >> 3] & (0x80 >> (x & 7))) != 0;
+}
+
+void DrawCursor(uint32_t* frame, uint32_t pitch, int32_t x, int32_t y, int32_t width, int32_t height, const CursorImage* image)
+{
+	for (int32_t row = y; row < y + height; ++row, frame += pitch)
+	{
+		const uint8_t* mask = image->mask + row * image->maskPitch;
+
+		int32_t shadowRow = row - (int32_t)image->shadow;
+		const uint8_t* shadow = shadowRow > 0 ? image->mask + shadowRow * image->maskPitch : NULL;
+
+		uint32_t* pix = frame;
+		for (int32_t col = x; col < x + width; ++col, ++pix)
+		{
+			if (IsSet(mask, col))
+			{
+				if (shadow && !IsSet(shadow, col))
+					*pix = (*pix & 0xFF000000) | ((*pix >> 1) & 0x007F7F7F);
+			}
+			else if (image->color)
+				*pix = image->palette[image->color[row * image->colorPitch + col]];
+			else
+				*pix = IsSet(image->bright + row * image->maskPitch, col) ? 0xFFFFFFFF : 0xFF000000;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include <stdint.h>
+
+/*
+	Software cursor of Heroes II. The cursor bitmap comes with a 1 bpp mask,
+	set where the frame shows through, and either 8-bit palette indices or,
+	for a monochrome cursor, a second 1 bpp mask set for white and clear for
+	black. Mask rows start at the most significant bit.
+
+	DrawCursor draws the width x height part of the bitmap that starts at
+	column `x` and row `y` to `frame`, `pitch` is counted in pixels. Where the
+	frame shows through it is darkened to half when the opaque part of the
+	cursor lies `shadow` rows above, bitmap row 0 never casts a shadow.
+*/
+
+struct CursorImage
+{
+	const uint8_t* mask;
+	const uint8_t* color;
+	const uint8_t* bright;
+	const uint32_t* palette;
+	uint32_t maskPitch;
+	uint32_t colorPitch;
+	uint32_t shadow;
+};
+
+void DrawCursor(uint32_t* frame, uint32_t pitch, int32_t x, int32_t y, int32_t width, int32_t height, const CursorImage* image);
\ No newline at end of file
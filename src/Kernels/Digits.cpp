@@ -0,0 +1,343 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Digits.h"
+
+const uint16_t digitGlyphs[10][DIGIT_HEIGHT] = {
+	{ // 0
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC
+	}, { // 1
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000
+	}, { // 2
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0x003C,
+		0x003C,
+		0x003C,
+		0x003C,
+		0x003C,
+		0x003C,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC
+	}, { // 3
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC
+	}, { // 4
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000
+	}, { // 5
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0x003C,
+		0x003C,
+		0x003C,
+		0x003C,
+		0x003C,
+		0x003C,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC
+	}, { // 6
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0x003C,
+		0x003C,
+		0x003C,
+		0x003C,
+		0x003C,
+		0x003C,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC
+	}, { // 7
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000
+	}, { // 8
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC
+	}, { // 9
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xF03C,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xF000,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC,
+		0xFFFC
+	}
+};
+
+static uint32_t CountDigits(uint32_t value)
+{
+	uint32_t count = 0;
+	do
+	{
+		++count;
+		value /= 10;
+	} while (value);
+
+	return count;
+}
+
+void DrawDigits(uint16_t* frame, uint32_t pitch, uint32_t value, uint16_t color)
+{
+	pitch -= DIGIT_WIDTH;
+	uint32_t count = CountDigits(value);
+	do
+	{
+		uint16_t* pix = frame + DIGIT_WIDTH * (count - 1);
+		const uint16_t* glyph = digitGlyphs[value % 10];
+		for (uint32_t y = 0; y < DIGIT_HEIGHT; ++y, pix += pitch)
+		{
+			uint16_t check = *glyph++;
+			uint32_t width = DIGIT_WIDTH;
+			do
+			{
+				if (check & 1)
+					*pix = color;
+
+				++pix;
+				check >>= 1;
+			} while (--width);
+		}
+
+		value /= 10;
+	} while (--count);
+}
+
+void DrawDigits(uint32_t* frame, uint32_t pitch, uint32_t value, uint32_t color)
+{
+	pitch -= DIGIT_WIDTH;
+	uint32_t count = CountDigits(value);
+	do
+	{
+		uint32_t* pix = frame + DIGIT_WIDTH * (count - 1);
+		const uint16_t* glyph = digitGlyphs[value % 10];
+		for (uint32_t y = 0; y < DIGIT_HEIGHT; ++y, pix += pitch)
+		{
+			uint16_t check = *glyph++;
+			uint32_t width = DIGIT_WIDTH;
+			do
+			{
+				if (check & 1)
+					*pix = color;
+
+				++pix;
+				check >>= 1;
+			} while (--width);
+		}
+
+		value /= 10;
+	} while (--count);
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include <stdint.h>
+
+/*
+	Digits of the FPS counter. Each glyph is DIGIT_HEIGHT rows of a 16-bit
+	mask, bit 0 is the leftmost column.
+
+	DrawDigits writes `value` in decimal from `frame` on, the first digit at
+	the top left, `pitch` is counted in pixels. Only the set glyph bits are
+	written, the frame shows through everywhere else.
+*/
+
+#define DIGIT_WIDTH 16
+#define DIGIT_HEIGHT 24
+
+extern const uint16_t digitGlyphs[10][DIGIT_HEIGHT];
+
+void DrawDigits(uint16_t* frame, uint32_t pitch, uint32_t value, uint16_t color);
+void DrawDigits(uint32_t* frame, uint32_t pitch, uint32_t value, uint32_t color);
\ No newline at end of file
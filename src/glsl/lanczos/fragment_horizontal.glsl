@@ -0,0 +1,61 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+uniform sampler2D tex01;
+uniform sampler1D tex04;
+uniform vec2 texSize;
+
+in vec2 fTex;
+out vec4 fragColor;
+
+// Normalized weights of taps -2, -1 and 0 by phase, taps 1, 2 and 3 mirror them
+vec3 weight(float phase) {
+	float size = float(textureSize(tex04, 0));
+	return texture(tex04, (phase * (size - 1.0) + 0.5) / size).rgb;
+}
+
+vec3 lanczos(sampler2D tex, vec2 coord) {
+	float stp = 1.0 / texSize.x;
+	float uv = coord.x + stp * 0.5;
+	float f = fract(uv / stp);
+
+	vec3 w1 = weight(f);
+	vec3 w2 = weight(1.0 - f);
+
+	float pos = (-0.5 - f) * stp + uv;
+
+	#define TEX(a) texture(tex, vec2(pos + stp * a, coord.y)).rgb
+
+	return
+		TEX(-2.0) * w1.r +
+		TEX(-1.0) * w1.g +
+		TEX(0.0) * w1.b +
+		TEX(1.0) * w2.b +
+		TEX(2.0) * w2.g +
+		TEX(3.0) * w2.r;
+}
+
+void main() {
+	fragColor = vec4(lanczos(tex01, fTex), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+uniform sampler2D tex01;
+uniform sampler1D tex04;
+uniform vec2 texSize;
+#if defined(LEV_IN_RGB) || defined(LEV_IN_A)
+#define LEV_IN
+#endif
+#if defined(LEV_GAMMA_RGB) || defined(LEV_GAMMA_A)
+#define LEV_GAMMA
+#endif
+#if defined(LEV_OUT_RGB) || defined(LEV_OUT_A)
+#define LEV_OUT
+#endif
+#if defined(LEV_IN) || defined(LEV_GAMMA) || defined(LEV_OUT)
+#define LEVELS
+#endif
+#if defined(LEV_HUE_L) || defined(LEV_HUE_R)
+#define LEV_HUE
+#endif
+#if defined(LEV_HUE) || defined(LEV_SAT)
+#define SATHUE
+uniform vec2 satHue;
+#endif
+#ifdef LEV_IN
+uniform vec4 in_left;
+uniform vec4 in_right;
+#endif
+#ifdef LEV_GAMMA
+uniform vec4 gamma;
+#endif
+#ifdef LEV_OUT
+uniform vec4 out_left;
+uniform vec4 out_right;
+#endif
+
+in vec2 fTex;
+out vec4 fragColor;
+
+// Normalized weights of taps -2, -1 and 0 by phase, taps 1, 2 and 3 mirror them
+vec3 weight(float phase) {
+	float size = float(textureSize(tex04, 0));
+	return texture(tex04, (phase * (size - 1.0) + 0.5) / size).rgb;
+}
+
+vec3 lanczos(sampler2D tex, vec2 coord) {
+	float stp = 1.0 / texSize.y;
+	float uv = coord.y + stp * 0.5;
+	float f = fract(uv / stp);
+
+	vec3 w1 = weight(f);
+	vec3 w2 = weight(1.0 - f);
+
+	float pos = (-0.5 - f) * stp + uv;
+
+	#define TEX(a) texture(tex, vec2(coord.x, pos + stp * a)).rgb
+
+	return
+		TEX(-2.0) * w1.r +
+		TEX(-1.0) * w1.g +
+		TEX(0.0) * w1.b +
+		TEX(1.0) * w2.b +
+		TEX(2.0) * w2.g +
+		TEX(3.0) * w2.r;
+}
+
+#ifdef SATHUE
+vec3 saturate(vec3 color) {
+#ifdef LEV_HUE
+#ifdef LEV_HUE_L
+	color = color.brg + 0.5 * satHue.y * (color - color.gbr + satHue.y * (color.gbr - 5.0 * color.brg + 4.0 * color + 3.0 * satHue.y * (color.brg - color)));
+#else
+	color = color + 0.5 * satHue.y * (color.gbr - color.brg + satHue.y * (color.brg - 5.0 * color + 4.0 * color.gbr + 3.0 * satHue.y * (color - color.gbr)));
+#endif
+#endif
+#ifdef LEV_SAT
+	float s = dot(color, vec3(1.0)) / 3.0;
+	color = (color - s) * satHue.x + s;
+#endif
+	return color;
+}
+#endif
+
+#ifdef LEVELS
+vec3 levels(vec3 color) {
+#ifdef LEV_IN_RGB
+	color = clamp((color - in_left.rgb) / (in_right.rgb - in_left.rgb), 0.0, 1.0);
+#endif
+#ifdef LEV_GAMMA_RGB
+	color = pow(color, gamma.rgb);
+#endif
+#ifdef LEV_OUT_RGB
+	color = clamp(color * (out_right.rgb - out_left.rgb) + out_left.rgb, 0.0, 1.0);
+#endif
+#ifdef LEV_IN_A
+	color = clamp((color - in_left.a) / (in_right.a - in_left.a), 0.0, 1.0);
+#endif
+#ifdef LEV_GAMMA_A
+	color = pow(color, gamma.aaa);
+#endif
+#ifdef LEV_OUT_A
+	color = clamp(color * (out_right.a - out_left.a) + out_left.a, 0.0, 1.0);
+#endif
+	return color;
+}
+#endif
+
+void main() {
+	vec3 color = lanczos(tex01, fTex);
+
+#ifdef SATHUE
+	color = saturate(color);
+#endif
+#ifdef LEVELS
+	color = levels(color);
+#endif
+
+	fragColor = vec4(color, 1.0);
+}
\ No newline at end of file
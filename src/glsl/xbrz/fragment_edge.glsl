@@ -0,0 +1,200 @@
+/*
+	xBRZ fragment shader
+	based on libretro xBRZ shader
+	https://github.com/libretro/glsl-shaders/tree/master/xbrz/shaders
+
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+uniform sampler2D tex01;
+uniform sampler2D tex02;
+uniform vec2 texSize;
+
+in vec2 fTex;
+out vec4 fragColor;
+
+#define BLEND_NONE 0
+#define BLEND_NORMAL 1
+#define BLEND_DOMINANT 2
+#define LUMINANCE_WEIGHT 1.0
+#define EQUAL_COLOR_TOLERANCE 30.0/255.0
+#define STEEP_DIRECTION_THRESHOLD 2.2
+#define DOMINANT_DIRECTION_THRESHOLD 3.6
+#define INFO_BLEND 1
+#define INFO_LINE 2
+#define INFO_SHALLOW 4
+#define INFO_STEEP 8
+#define INFO_FIRST 16
+
+float reduce(const vec3 color) {
+	const vec3 w = vec3(65536.0, 256.0, 1.0);
+	return dot(color, w);
+}
+
+float DistYCbCr(const vec3 pixA, const vec3 pixB) {
+	const vec3 w = vec3(0.2627, 0.6780, 0.0593);
+	const float scaleB = 0.5 / (1.0 - w.b);
+	const float scaleR = 0.5 / (1.0 - w.r);
+	vec3 diff = pixA - pixB;
+	float Y = dot(diff, w);
+	float Cb = scaleB * (diff.b - Y);
+	float Cr = scaleR * (diff.r - Y);
+	
+	return sqrt( ((LUMINANCE_WEIGHT * Y) * (LUMINANCE_WEIGHT * Y)) + (Cb * Cb) + (Cr * Cr) );
+}
+
+bool IsPixEqual(const vec3 pixA, const vec3 pixB) {
+	return (DistYCbCr(pixA, pixB) < EQUAL_COLOR_TOLERANCE);
+}
+
+bool IsBlendingNeeded(const ivec4 blend) {
+	return any(notEqual(blend, ivec4(BLEND_NONE)));
+}
+
+void main() {
+	vec2 texel = floor(fTex * texSize) + 0.5;
+
+	#define TEX(tex, x, y) texture(tex, (texel + vec2(x, y)) / texSize)
+	#define TAP(i, x, y) color = TEX(tex01, x, y); src[i] = color.rgb; isDirty = isDirty || color != TEX(tex02, x, y)
+
+	vec4 color;
+	bool isDirty = false;
+	vec3 src[25];
+	TAP(21, -1.0, -2.0);
+	TAP(22,  0.0, -2.0);
+	TAP(23,  1.0, -2.0);
+	TAP( 6, -1.0, -1.0);
+	TAP( 7,  0.0, -1.0);
+	TAP( 8,  1.0, -1.0);
+	TAP( 5, -1.0,  0.0);
+	TAP( 0,  0.0,  0.0);
+	TAP( 1,  1.0,  0.0);
+	TAP( 4, -1.0,  1.0);
+	TAP( 3,  0.0,  1.0);
+	TAP( 2,  1.0,  1.0);
+	TAP(15, -1.0,  2.0);
+	TAP(14,  0.0,  2.0);
+	TAP(13,  1.0,  2.0);
+	TAP(19, -2.0, -1.0);
+	TAP(18, -2.0,  0.0);
+	TAP(17, -2.0,  1.0);
+	TAP( 9,  2.0, -1.0);
+	TAP(10,  2.0,  0.0);
+	TAP(11,  2.0,  1.0);
+
+	if (!isDirty)
+		discard;
+
+	float v[9];
+	v[0] = reduce(src[0]);
+	v[1] = reduce(src[1]);
+	v[2] = reduce(src[2]);
+	v[3] = reduce(src[3]);
+	v[4] = reduce(src[4]);
+	v[5] = reduce(src[5]);
+	v[6] = reduce(src[6]);
+	v[7] = reduce(src[7]);
+	v[8] = reduce(src[8]);
+
+	ivec4 blendResult = ivec4(BLEND_NONE);
+	if (!((v[0] == v[1] && v[3] == v[2]) || (v[0] == v[3] && v[1] == v[2]))) {
+		float dist_03_01 = DistYCbCr(src[ 4], src[ 0]) + DistYCbCr(src[ 0], src[ 8]) + DistYCbCr(src[14], src[ 2]) + DistYCbCr(src[ 2], src[10]) + (4.0 * DistYCbCr(src[ 3], src[ 1]));
+		float dist_00_02 = DistYCbCr(src[ 5], src[ 3]) + DistYCbCr(src[ 3], src[13]) + DistYCbCr(src[ 7], src[ 1]) + DistYCbCr(src[ 1], src[11]) + (4.0 * DistYCbCr(src[ 0], src[ 2]));
+		bool dominantGradient = (DOMINANT_DIRECTION_THRESHOLD * dist_03_01) < dist_00_02;
+		blendResult.z = ((dist_03_01 < dist_00_02) && (v[0] != v[1]) && (v[0] != v[3])) ? ((dominantGradient) ? BLEND_DOMINANT : BLEND_NORMAL) : BLEND_NONE;
+	}
+
+	if (!((v[5] == v[0] && v[4] == v[3]) || (v[5] == v[4] && v[0] == v[3]))) {
+		float dist_04_00 = DistYCbCr(src[17], src[ 5]) + DistYCbCr(src[ 5], src[ 7]) + DistYCbCr(src[15], src[ 3]) + DistYCbCr(src[ 3], src[ 1]) + (4.0 * DistYCbCr(src[ 4], src[ 0]));
+		float dist_05_03 = DistYCbCr(src[18], src[ 4]) + DistYCbCr(src[ 4], src[14]) + DistYCbCr(src[ 6], src[ 0]) + DistYCbCr(src[ 0], src[ 2]) + (4.0 * DistYCbCr(src[ 5], src[ 3]));
+		bool dominantGradient = (DOMINANT_DIRECTION_THRESHOLD * dist_05_03) < dist_04_00;
+		blendResult.w = ((dist_04_00 > dist_05_03) && (v[0] != v[5]) && (v[0] != v[3])) ? ((dominantGradient) ? BLEND_DOMINANT : BLEND_NORMAL) : BLEND_NONE;
+	}
+
+	if (!((v[7] == v[8] && v[0] == v[1]) || (v[7] == v[0] && v[8] == v[1]))) {
+		float dist_00_08 = DistYCbCr(src[ 5], src[ 7]) + DistYCbCr(src[ 7], src[23]) + DistYCbCr(src[ 3], src[ 1]) + DistYCbCr(src[ 1], src[ 9]) + (4.0 * DistYCbCr(src[ 0], src[ 8]));
+		float dist_07_01 = DistYCbCr(src[ 6], src[ 0]) + DistYCbCr(src[ 0], src[ 2]) + DistYCbCr(src[22], src[ 8]) + DistYCbCr(src[ 8], src[10]) + (4.0 * DistYCbCr(src[ 7], src[ 1]));
+		bool dominantGradient = (DOMINANT_DIRECTION_THRESHOLD * dist_07_01) < dist_00_08;
+		blendResult.y = ((dist_00_08 > dist_07_01) && (v[0] != v[7]) && (v[0] != v[1])) ? ((dominantGradient) ? BLEND_DOMINANT : BLEND_NORMAL) : BLEND_NONE;
+	}
+
+	if (!((v[6] == v[7] && v[5] == v[0]) || (v[6] == v[5] && v[7] == v[0]))) {
+		float dist_05_07 = DistYCbCr(src[18], src[ 6]) + DistYCbCr(src[ 6], src[22]) + DistYCbCr(src[ 4], src[ 0]) + DistYCbCr(src[ 0], src[ 8]) + (4.0 * DistYCbCr(src[ 5], src[ 7]));
+		float dist_06_00 = DistYCbCr(src[19], src[ 5]) + DistYCbCr(src[ 5], src[ 3]) + DistYCbCr(src[21], src[ 7]) + DistYCbCr(src[ 7], src[ 1]) + (4.0 * DistYCbCr(src[ 6], src[ 0]));
+		bool dominantGradient = (DOMINANT_DIRECTION_THRESHOLD * dist_05_07) < dist_06_00;
+		blendResult.x = ((dist_05_07 < dist_06_00) && (v[0] != v[5]) && (v[0] != v[7])) ? ((dominantGradient) ? BLEND_DOMINANT : BLEND_NORMAL) : BLEND_NONE;
+	}
+
+	ivec4 info = ivec4(0);
+	if (IsBlendingNeeded(blendResult)) {
+		float dist_01_04 = DistYCbCr(src[1], src[4]);
+		float dist_03_08 = DistYCbCr(src[3], src[8]);
+		bool haveShallowLine = (STEEP_DIRECTION_THRESHOLD * dist_01_04 <= dist_03_08) && (v[0] != v[4]) && (v[5] != v[4]);
+		bool haveSteepLine   = (STEEP_DIRECTION_THRESHOLD * dist_03_08 <= dist_01_04) && (v[0] != v[8]) && (v[7] != v[8]);
+		bool needBlend = (blendResult.z != BLEND_NONE);
+		bool doLineBlend = (  blendResult.z >= BLEND_DOMINANT ||
+						   ((blendResult.y != BLEND_NONE && !IsPixEqual(src[0], src[4])) ||
+							 (blendResult.w != BLEND_NONE && !IsPixEqual(src[0], src[8])) ||
+							 (IsPixEqual(src[4], src[3]) && IsPixEqual(src[3], src[2]) && IsPixEqual(src[2], src[1]) && IsPixEqual(src[1], src[8]) && IsPixEqual(src[0], src[2]) == false) ) == false );
+		info.z = (needBlend ? INFO_BLEND : 0) | (doLineBlend ? INFO_LINE : 0) | (haveShallowLine ? INFO_SHALLOW : 0) | (haveSteepLine ? INFO_STEEP : 0) |
+			((DistYCbCr(src[0], src[1]) <= DistYCbCr(src[0], src[3])) ? INFO_FIRST : 0);
+	
+		dist_01_04 = DistYCbCr(src[7], src[2]);
+		dist_03_08 = DistYCbCr(src[1], src[6]);
+		haveShallowLine = (STEEP_DIRECTION_THRESHOLD * dist_01_04 <= dist_03_08) && (v[0] != v[2]) && (v[3] != v[2]);
+		haveSteepLine   = (STEEP_DIRECTION_THRESHOLD * dist_03_08 <= dist_01_04) && (v[0] != v[6]) && (v[5] != v[6]);
+		needBlend = (blendResult.y != BLEND_NONE);
+		doLineBlend = (  blendResult.y >= BLEND_DOMINANT ||
+					  !((blendResult.x != BLEND_NONE && !IsPixEqual(src[0], src[2])) ||
+						(blendResult.z != BLEND_NONE && !IsPixEqual(src[0], src[6])) ||
+						(IsPixEqual(src[2], src[1]) && IsPixEqual(src[1], src[8]) && IsPixEqual(src[8], src[7]) && IsPixEqual(src[7], src[6]) && !IsPixEqual(src[0], src[8])) ) );
+		info.y = (needBlend ? INFO_BLEND : 0) | (doLineBlend ? INFO_LINE : 0) | (haveShallowLine ? INFO_SHALLOW : 0) | (haveSteepLine ? INFO_STEEP : 0) |
+			((DistYCbCr(src[0], src[7]) <= DistYCbCr(src[0], src[1])) ? INFO_FIRST : 0);
+	
+		dist_01_04 = DistYCbCr(src[5], src[8]);
+		dist_03_08 = DistYCbCr(src[7], src[4]);
+		haveShallowLine = (STEEP_DIRECTION_THRESHOLD * dist_01_04 <= dist_03_08) && (v[0] != v[8]) && (v[1] != v[8]);
+		haveSteepLine   = (STEEP_DIRECTION_THRESHOLD * dist_03_08 <= dist_01_04) && (v[0] != v[4]) && (v[3] != v[4]);
+		needBlend = (blendResult.x != BLEND_NONE);
+		doLineBlend = (  blendResult.x >= BLEND_DOMINANT ||
+					  !((blendResult.w != BLEND_NONE && !IsPixEqual(src[0], src[8])) ||
+						(blendResult.y != BLEND_NONE && !IsPixEqual(src[0], src[4])) ||
+						(IsPixEqual(src[8], src[7]) && IsPixEqual(src[7], src[6]) && IsPixEqual(src[6], src[5]) && IsPixEqual(src[5], src[4]) && !IsPixEqual(src[0], src[6])) ) );
+		info.x = (needBlend ? INFO_BLEND : 0) | (doLineBlend ? INFO_LINE : 0) | (haveShallowLine ? INFO_SHALLOW : 0) | (haveSteepLine ? INFO_STEEP : 0) |
+			((DistYCbCr(src[0], src[5]) <= DistYCbCr(src[0], src[7])) ? INFO_FIRST : 0);
+	
+		dist_01_04 = DistYCbCr(src[3], src[6]);
+		dist_03_08 = DistYCbCr(src[5], src[2]);
+		haveShallowLine = (STEEP_DIRECTION_THRESHOLD * dist_01_04 <= dist_03_08) && (v[0] != v[6]) && (v[7] != v[6]);
+		haveSteepLine   = (STEEP_DIRECTION_THRESHOLD * dist_03_08 <= dist_01_04) && (v[0] != v[2]) && (v[1] != v[2]);
+		needBlend = (blendResult.w != BLEND_NONE);
+		doLineBlend = (  blendResult.w >= BLEND_DOMINANT ||
+					  !((blendResult.z != BLEND_NONE && !IsPixEqual(src[0], src[6])) ||
+						(blendResult.x != BLEND_NONE && !IsPixEqual(src[0], src[2])) ||
+						(IsPixEqual(src[6], src[5]) && IsPixEqual(src[5], src[4]) && IsPixEqual(src[4], src[3]) && IsPixEqual(src[3], src[2]) && !IsPixEqual(src[0], src[4])) ) );
+		info.w = (needBlend ? INFO_BLEND : 0) | (doLineBlend ? INFO_LINE : 0) | (haveShallowLine ? INFO_SHALLOW : 0) | (haveSteepLine ? INFO_STEEP : 0) |
+			((DistYCbCr(src[0], src[3]) <= DistYCbCr(src[0], src[5])) ? INFO_FIRST : 0);
+	}
+
+	fragColor = vec4(info) / 255.0;
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+
+namespace AlignedTest
+{
+	const DWORD threads = 8;
+	const DWORD rounds = 4000;
+	const DWORD held = 16;
+
+	volatile LONG errors;
+
+	DWORD Next(DWORD* seed)
+	{
+		*seed = *seed * 1103515245 + 12345;
+		return *seed >> 8;
+	}
+
+	size_t Size(DWORD* seed)
+	{
+		switch (Next(seed) % 4)
+		{
+		case 0:
+			return Next(seed) % 256;
+		case 1:
+			return Next(seed) % ALIGNED_CLASS;
+		case 2:
+			return ALIGNED_CLASS * (1 + Next(seed) % 4);
+		default:
+			return ALIGNED_CLASS + Next(seed) % (ALIGNED_CLASS * 8);
+		}
+	}
+
+	DWORD __stdcall Worker(LPVOID lpParameter)
+	{
+		DWORD seed = (DWORD)(size_t)lpParameter;
+
+		BYTE* blocks[held] = {};
+		size_t sizes[held] = {};
+		BYTE tags[held] = {};
+
+		for (DWORD i = 0; i < rounds; ++i)
+		{
+			DWORD slot = Next(&seed) % held;
+			if (blocks[slot])
+			{
+				BYTE* block = blocks[slot];
+				for (size_t j = 0; j < sizes[slot]; j += 97)
+					if (block[j] != tags[slot])
+					{
+						InterlockedIncrement(&errors);
+						break;
+					}
+
+				if (sizes[slot] && block[sizes[slot] - 1] != tags[slot])
+					InterlockedIncrement(&errors);
+
+				AlignedFree(block);
+				blocks[slot] = NULL;
+			}
+			else
+			{
+				size_t size = Size(&seed);
+				BYTE* block = (BYTE*)AlignedAlloc(size);
+				if (!block || (size_t)block & (ALIGNED_BOUNDARY - 1))
+				{
+					InterlockedIncrement(&errors);
+					continue;
+				}
+
+				tags[slot] = BYTE(Next(&seed));
+				MemorySet(block, tags[slot], size);
+
+				blocks[slot] = block;
+				sizes[slot] = size;
+			}
+		}
+
+		for (DWORD i = 0; i < held; ++i)
+			AlignedFree(blocks[i]);
+
+		return 0;
+	}
+
+	VOID TestStress()
+	{
+		errors = 0;
+
+		HANDLE handles[threads];
+		for (DWORD i = 0; i < threads; ++i)
+			handles[i] = CreateThread(NULL, 0, Worker, (LPVOID)(size_t)(i * 7919 + 1), 0, NULL);
+
+		for (DWORD i = 0; i < threads; ++i)
+		{
+			CHECK(handles[i] != NULL);
+			if (handles[i])
+			{
+				WaitForSingleObject(handles[i], INFINITE);
+				CloseHandle(handles[i]);
+			}
+		}
+
+		CHECK(errors == 0);
+		AlignedRelease();
+	}
+
+	VOID TestReuse()
+	{
+		VOID* first = AlignedAlloc(ALIGNED_CLASS * 2);
+		CHECK(first != NULL);
+		AlignedFree(first);
+
+		VOID* second = AlignedAlloc(ALIGNED_CLASS * 2 - 100);
+		CHECK(second == first);
+		AlignedFree(second);
+
+		VOID* small = AlignedAlloc(100);
+		CHECK(small != NULL && !((size_t)small & (ALIGNED_BOUNDARY - 1)));
+		AlignedFree(small);
+
+		AlignedFree(NULL);
+		AlignedRelease();
+	}
+
+	VOID TestLimit()
+	{
+		VOID* blocks[ALIGNED_SLOTS + 2];
+		for (DWORD i = 0; i < ALIGNED_SLOTS + 2; ++i)
+			blocks[i] = AlignedAlloc(ALIGNED_CLASS);
+
+		for (DWORD i = 0; i < ALIGNED_SLOTS + 2; ++i)
+			AlignedFree(blocks[i]);
+
+		VOID* big = AlignedAlloc(ALIGNED_LIMIT + ALIGNED_CLASS);
+		CHECK(big != NULL);
+		AlignedFree(big);
+
+		AlignedRelease();
+	}
+
+	VOID TestOutOfMemory()
+	{
+		Win32::allocBudget = 0;
+		CHECK(AlignedAlloc(100) == NULL);
+		CHECK(AlignedAlloc(ALIGNED_CLASS * 3) == NULL);
+		Win32::allocBudget = -1;
+
+		VOID* block = AlignedAlloc(ALIGNED_CLASS * 3);
+		CHECK(block != NULL);
+		AlignedFree(block);
+
+		Win32::allocBudget = 0;
+		CHECK(AlignedAlloc(ALIGNED_CLASS * 3) == block);
+		Win32::allocBudget = -1;
+
+		AlignedFree(block);
+		AlignedRelease();
+	}
+}
+
+INT main()
+{
+	VOID(*tests[])() = {
+		AlignedTest::TestReuse,
+		AlignedTest::TestLimit,
+		AlignedTest::TestOutOfMemory,
+		AlignedTest::TestStress
+	};
+
+	return Test::Run("AlignedTest", tests, sizeof(tests) / sizeof(*tests));
+}
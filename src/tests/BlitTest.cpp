@@ -0,0 +1,131 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Blit.h"
+
+namespace BlitTest
+{
+	uint32_t seed = 1;
+
+	uint32_t Next()
+	{
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	const uint32_t pitch = 83;
+	const uint32_t height = 29;
+
+	// Random blocks at odd offsets and widths, with runs of key so whole SSE blocks get skipped too
+	VOID TestKeyBlit16()
+	{
+		uint16_t src[pitch * height], dst[pitch * height], expected[pitch * height], result[pitch * height];
+
+		for (DWORD round = 0; round < 500; ++round)
+		{
+			uint16_t key = (uint16_t)Next();
+			for (uint32_t i = 0; i < pitch * height; ++i)
+			{
+				src[i] = Next() % 3 ? (uint16_t)Next() : key;
+				dst[i] = (uint16_t)Next();
+			}
+
+			uint32_t run = Next() % (pitch * height - 32);
+			for (uint32_t i = 0; i < 32; ++i)
+				src[run + i] = key;
+
+			uint32_t x = Next() % pitch, y = Next() % height;
+			uint32_t width = Next() % (pitch - x + 1);
+			uint32_t rows = Next() % (height - y + 1);
+
+			MemoryCopy(expected, dst, sizeof(dst));
+			for (uint32_t j = 0; j < rows; ++j)
+				for (uint32_t i = 0; i < width; ++i)
+				{
+					uint16_t px = src[(y + j) * pitch + x + i];
+					if (px != key)
+						expected[j * pitch + i] = px;
+				}
+
+			MemoryCopy(result, dst, sizeof(dst));
+			CPP::KeyBlit(src + y * pitch + x, pitch, result, pitch, width, rows, key);
+			CHECK(!MemoryCompare(result, expected, sizeof(result)));
+
+			MemoryCopy(result, dst, sizeof(dst));
+			SSE::KeyBlit(src + y * pitch + x, pitch, result, pitch, width, rows, key);
+			CHECK(!MemoryCompare(result, expected, sizeof(result)));
+		}
+	}
+
+	VOID TestKeyBlit32()
+	{
+		uint32_t src[pitch * height], dst[pitch * height], expected[pitch * height], result[pitch * height];
+
+		for (DWORD round = 0; round < 500; ++round)
+		{
+			uint32_t key = Next();
+			for (uint32_t i = 0; i < pitch * height; ++i)
+			{
+				src[i] = Next() % 3 ? Next() : key;
+				dst[i] = Next();
+			}
+
+			uint32_t run = Next() % (pitch * height - 16);
+			for (uint32_t i = 0; i < 16; ++i)
+				src[run + i] = key;
+
+			uint32_t x = Next() % pitch, y = Next() % height;
+			uint32_t width = Next() % (pitch - x + 1);
+			uint32_t rows = Next() % (height - y + 1);
+
+			MemoryCopy(expected, dst, sizeof(dst));
+			for (uint32_t j = 0; j < rows; ++j)
+				for (uint32_t i = 0; i < width; ++i)
+				{
+					uint32_t px = src[(y + j) * pitch + x + i];
+					if (px != key)
+						expected[j * pitch + i] = px;
+				}
+
+			MemoryCopy(result, dst, sizeof(dst));
+			CPP::KeyBlit(src + y * pitch + x, pitch, result, pitch, width, rows, key);
+			CHECK(!MemoryCompare(result, expected, sizeof(result)));
+
+			MemoryCopy(result, dst, sizeof(dst));
+			SSE::KeyBlit(src + y * pitch + x, pitch, result, pitch, width, rows, key);
+			CHECK(!MemoryCompare(result, expected, sizeof(result)));
+		}
+	}
+}
+
+INT main()
+{
+	VOID(*tests[])() = {
+		BlitTest::TestKeyBlit16,
+		BlitTest::TestKeyBlit32
+	};
+
+	return Test::Run("BlitTest", tests, sizeof(tests) / sizeof(*tests));
+}
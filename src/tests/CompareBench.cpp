@@ -0,0 +1,142 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Compare.h"
+
+/*
+	Throughput of every compare kernel over two equal 32-bit frames, the worst
+	case where nothing changed and each kernel has to read both frames fully.
+
+	CompareBench            640x480, 800x600, 1920x1080 and 3840x2160
+	CompareBench <w> <h>    one resolution
+*/
+
+namespace CompareBench
+{
+	struct Variant
+	{
+		const CHAR* name;
+		COMPARE forward;
+		COMPARE backward;
+		BLOCKCOMPARE blockForward;
+		BLOCKCOMPARE blockBackward;
+		SIDECOMPARE sideForward;
+		SIDECOMPARE sideBackward;
+	};
+
+	const Variant variants[] = {
+		{ "cpp", CPP::ForwardCompare, CPP::BackwardCompare, CPP::BlockForwardCompare, CPP::BlockBackwardCompare, CPP::SideForwardCompare, CPP::SideBackwardCompare },
+		{ "sse", SSE::ForwardCompare, SSE::BackwardCompare, SSE::BlockForwardCompare, SSE::BlockBackwardCompare, SSE::SideForwardCompare, SSE::SideBackwardCompare }
+	};
+
+	const CHAR* kernels[] = { "forward", "backward", "block>", "block<", "side>", "side<" };
+
+	const DOUBLE duration = 0.2;
+
+	uint32_t check;
+
+	VOID Call(const Variant* variant, DWORD kernel, uint32_t pitch, uint32_t height, const uint32_t* a, const uint32_t* b)
+	{
+		uint32_t length = pitch * height;
+		ComparePoint p;
+		switch (kernel)
+		{
+		case 0:
+			check += variant->forward(length, 0, a, b);
+			break;
+
+		case 1:
+			check += variant->backward(length, length - 1, a, b);
+			break;
+
+		case 2:
+			check += variant->blockForward(pitch, height, pitch, 0, a, b, &p);
+			break;
+
+		case 3:
+			check += variant->blockBackward(pitch, height, pitch, length - 1, a, b, &p);
+			break;
+
+		case 4:
+			check += variant->sideForward(pitch, height, pitch, 0, a, b);
+			break;
+
+		default:
+			check += variant->sideBackward(pitch, height, pitch, length - 1, a, b);
+			break;
+		}
+	}
+
+	VOID Run(uint32_t width, uint32_t height)
+	{
+		uint32_t pitch = (width + 3) & ~3;
+		uint32_t size = pitch * height * sizeof(uint32_t);
+		uint32_t* a = (uint32_t*)AlignedAlloc(size);
+		uint32_t* b = (uint32_t*)AlignedAlloc(size);
+		for (uint32_t i = 0; i < pitch * height; ++i)
+			a[i] = b[i] = i * 2654435761u;
+
+		for (DWORD v = 0; v < sizeof(variants) / sizeof(*variants); ++v)
+		{
+			printf("%4ux%-4u %s", width, height, variants[v].name);
+			for (DWORD k = 0; k < sizeof(kernels) / sizeof(*kernels); ++k)
+			{
+				DWORD frames = 0;
+				DOUBLE start = Test::Seconds(), elapsed;
+				do
+				{
+					Call(&variants[v], k, pitch, height, a, b);
+					++frames;
+				} while ((elapsed = Test::Seconds() - start) < duration);
+
+				printf("  %s %6.2f GB/s", kernels[k], 2.0 * size * frames / elapsed / 1e9);
+			}
+
+			printf("\n");
+		}
+
+		AlignedFree(a);
+		AlignedFree(b);
+	}
+}
+
+INT main(INT argc, CHAR** argv)
+{
+	if (argc == 3)
+		CompareBench::Run(atoi(argv[1]), atoi(argv[2]));
+	else if (argc == 1)
+	{
+		const uint32_t sizes[][2] = { { 640, 480 }, { 800, 600 }, { 1920, 1080 }, { 3840, 2160 } };
+		for (DWORD i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i)
+			CompareBench::Run(sizes[i][0], sizes[i][1]);
+	}
+	else
+	{
+		fprintf(stderr, "Usage: %s [<width> <height>]\n", argv[0]);
+		return 2;
+	}
+
+	return CompareBench::check ? 1 : 0;
+}
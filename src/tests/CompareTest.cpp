@@ -0,0 +1,248 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Compare.h"
+
+namespace CompareTest
+{
+	struct Frame
+	{
+		uint32_t* a;
+		uint32_t* b;
+		uint32_t pitch;
+		uint32_t height;
+	};
+
+	struct Variant
+	{
+		const CHAR* name;
+		COMPARE forward;
+		COMPARE backward;
+		BLOCKCOMPARE blockForward;
+		BLOCKCOMPARE blockBackward;
+		SIDECOMPARE sideForward;
+		SIDECOMPARE sideBackward;
+		uint32_t granularity;
+	};
+
+	const Variant variants[] = {
+		{ "cpp", CPP::ForwardCompare, CPP::BackwardCompare, CPP::BlockForwardCompare, CPP::BlockBackwardCompare, CPP::SideForwardCompare, CPP::SideBackwardCompare, 1 },
+		{ "sse", SSE::ForwardCompare, SSE::BackwardCompare, SSE::BlockForwardCompare, SSE::BlockBackwardCompare, SSE::SideForwardCompare, SSE::SideBackwardCompare, 4 }
+	};
+
+	uint32_t seed = 1;
+
+	uint32_t Next()
+	{
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	VOID Open(Frame* frame, uint32_t pitch, uint32_t height)
+	{
+		frame->pitch = pitch;
+		frame->height = height;
+		frame->a = (uint32_t*)AlignedAlloc(pitch * height * sizeof(uint32_t));
+		frame->b = (uint32_t*)AlignedAlloc(pitch * height * sizeof(uint32_t));
+
+		for (uint32_t i = 0; i < pitch * height; ++i)
+			frame->a[i] = frame->b[i] = Next();
+	}
+
+	VOID Close(Frame* frame)
+	{
+		AlignedFree(frame->a);
+		AlignedFree(frame->b);
+	}
+
+	VOID Touch(Frame* frame, uint32_t x, uint32_t y)
+	{
+		frame->b[y * frame->pitch + x] ^= 1 << (Next() & 31);
+	}
+
+	VOID Restore(Frame* frame)
+	{
+		MemoryCopy(frame->b, frame->a, frame->pitch * frame->height * sizeof(uint32_t));
+	}
+
+	BOOL IsChanged(Frame* frame, uint32_t x, uint32_t y)
+	{
+		uint32_t index = y * frame->pitch + x;
+		return frame->a[index] != frame->b[index];
+	}
+
+	VOID TestLinear()
+	{
+		Frame frame;
+		Open(&frame, 64, 32);
+		uint32_t length = frame.pitch * frame.height;
+
+		for (uint32_t v = 0; v < sizeof(variants) / sizeof(*variants); ++v)
+		{
+			const Variant* variant = &variants[v];
+			CHECK(!variant->forward(length, 0, frame.a, frame.b));
+			CHECK(!variant->backward(length, length - 1, frame.a, frame.b));
+		}
+
+		for (DWORD round = 0; round < 2000; ++round)
+		{
+			uint32_t first = length, last = 0;
+			for (DWORD count = 1 + Next() % 3; count; --count)
+			{
+				uint32_t index = Next() % length;
+				Touch(&frame, index % frame.pitch, index / frame.pitch);
+				first = min(first, index);
+				last = max(last, index);
+			}
+
+			for (uint32_t v = 0; v < sizeof(variants) / sizeof(*variants); ++v)
+			{
+				const Variant* variant = &variants[v];
+				uint32_t mask = variant->granularity - 1;
+				CHECK(variant->forward(length, 0, frame.a, frame.b) == length - (first & ~mask));
+				CHECK(variant->backward(length, length - 1, frame.a, frame.b) == (last | mask) + 1);
+			}
+
+			Restore(&frame);
+		}
+
+		Close(&frame);
+	}
+
+	VOID TestBlock()
+	{
+		Frame frame;
+		Open(&frame, 96, 40);
+
+		for (DWORD round = 0; round < 2000; ++round)
+		{
+			int32_t left = (Next() % (frame.pitch / 4)) * 4;
+			int32_t width = 4 * (1 + Next() % ((frame.pitch - left) / 4));
+			int32_t top = Next() % frame.height;
+			int32_t height = 1 + Next() % (frame.height - top);
+
+			for (DWORD count = Next() % 8; count; --count)
+				Touch(&frame, Next() % frame.pitch, Next() % frame.height);
+
+			BOOL isChanged = FALSE;
+			ComparePoint first = { 0, 0 }, last = { 0, 0 };
+			for (int32_t y = 0; y < height; ++y)
+				for (int32_t x = 0; x < width; ++x)
+					if (IsChanged(&frame, left + x, top + y))
+					{
+						if (!isChanged)
+						{
+							first.x = x;
+							first.y = y;
+						}
+
+						last.x = x;
+						last.y = y;
+						isChanged = TRUE;
+					}
+
+			uint32_t forward = top * frame.pitch + left;
+			uint32_t backward = (top + height - 1) * frame.pitch + left + width - 1;
+			for (uint32_t v = 0; v < sizeof(variants) / sizeof(*variants); ++v)
+			{
+				const Variant* variant = &variants[v];
+
+				ComparePoint p = { -1, -1 };
+				CHECK(variant->blockForward(width, height, frame.pitch, forward, frame.a, frame.b, &p) == !!isChanged);
+				CHECK(!isChanged || (p.x == first.x && p.y == first.y));
+
+				p.x = p.y = -1;
+				CHECK(variant->blockBackward(width, height, frame.pitch, backward, frame.a, frame.b, &p) == !!isChanged);
+				CHECK(!isChanged || (p.x == last.x && p.y == last.y));
+			}
+
+			Restore(&frame);
+		}
+
+		Close(&frame);
+	}
+
+	VOID TestSide()
+	{
+		Frame frame;
+		Open(&frame, 96, 40);
+
+		for (DWORD round = 0; round < 2000; ++round)
+		{
+			// The side kernels scan what is left of a block next to its changed span,
+			// so the near edge is aligned while the width is arbitrary
+			int32_t width = 1 + Next() % 40;
+			int32_t height = 1 + Next() % frame.height;
+			int32_t left = (Next() % ((frame.pitch - width) / 4 + 1)) * 4;
+			int32_t right = ((Next() % (frame.pitch / 4)) * 4 + 3);
+			if (right - width + 1 < 0)
+				right += (width + 3) & ~3;
+			int32_t top = Next() % (frame.height - height + 1);
+
+			for (DWORD count = Next() % 8; count; --count)
+				Touch(&frame, Next() % frame.pitch, Next() % frame.height);
+
+			uint32_t forward = 0;
+			for (int32_t x = 0; x < width && !forward; ++x)
+				for (int32_t y = 0; y < height; ++y)
+					if (IsChanged(&frame, left + x, top + y))
+					{
+						forward = width - x;
+						break;
+					}
+
+			uint32_t backward = 0;
+			for (int32_t x = 0; x < width && !backward; ++x)
+				for (int32_t y = 0; y < height; ++y)
+					if (IsChanged(&frame, right - x, top + height - 1 - y))
+					{
+						backward = width - x;
+						break;
+					}
+
+			for (uint32_t v = 0; v < sizeof(variants) / sizeof(*variants); ++v)
+			{
+				const Variant* variant = &variants[v];
+				CHECK(variant->sideForward(width, height, frame.pitch, top * frame.pitch + left, frame.a, frame.b) == forward);
+				CHECK(variant->sideBackward(width, height, frame.pitch, (top + height - 1) * frame.pitch + right, frame.a, frame.b) == backward);
+			}
+
+			Restore(&frame);
+		}
+
+		Close(&frame);
+	}
+}
+
+INT main()
+{
+	VOID(*tests[])() = {
+		CompareTest::TestLinear,
+		CompareTest::TestBlock,
+		CompareTest::TestSide
+	};
+
+	return Test::Run("CompareTest", tests, sizeof(tests) / sizeof(*tests));
+}
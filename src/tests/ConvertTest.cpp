@@ -0,0 +1,130 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Convert.h"
+
+namespace ConvertTest
+{
+	uint32_t seed = 1;
+
+	uint32_t Next()
+	{
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	// Byte order in memory, the way OpenGL and the snapshot writer read it
+	BOOL IsBytes(uint32_t px, BYTE b0, BYTE b1, BYTE b2, BYTE b3)
+	{
+		BYTE* bytes = (BYTE*)&px;
+		return bytes[0] == b0 && bytes[1] == b1 && bytes[2] == b2 && bytes[3] == b3;
+	}
+
+	VOID TestSwapRedBlue()
+	{
+		uint32_t src[37], dst[37];
+		for (DWORD i = 0; i < 37; ++i)
+			src[i] = Next() ^ (Next() << 16);
+
+		SwapRedBlue(src, dst, 37);
+
+		DWORD failed = 0;
+		for (DWORD i = 0; i < 37; ++i)
+		{
+			BYTE* s = (BYTE*)&src[i];
+			failed += !IsBytes(dst[i], s[2], s[1], s[0], s[3]);
+		}
+		CHECK(!failed);
+
+		// In place and back again
+		SwapRedBlue(dst, dst, 37);
+		CHECK(!MemoryCompare(src, dst, sizeof(src)));
+	}
+
+	VOID TestRgb565()
+	{
+		uint16_t* src = (uint16_t*)malloc(0x10000 * sizeof(uint16_t));
+		uint32_t* rgba = (uint32_t*)malloc(0x10000 * sizeof(uint32_t));
+		uint32_t* bgra = (uint32_t*)malloc(0x10000 * sizeof(uint32_t));
+		for (DWORD i = 0; i < 0x10000; ++i)
+			src[i] = (uint16_t)i;
+
+		Rgb565ToRgba(src, rgba, 0x10000);
+		Rgb565ToBgra(src, bgra, 0x10000);
+
+		DWORD failed = 0;
+		for (DWORD i = 0; i < 0x10000; ++i)
+		{
+			BYTE r = BYTE((i >> 11) << 3);
+			BYTE g = BYTE(((i >> 5) & 0x3F) << 2);
+			BYTE b = BYTE((i & 0x1F) << 3);
+			failed += !IsBytes(rgba[i], r, g, b, 0);
+			failed += !IsBytes(bgra[i], b | (b >> 5), g | (g >> 6), r | (r >> 5), 0);
+		}
+		CHECK(!failed);
+
+		CHECK(IsBytes(bgra[0xFFFF], 0xFF, 0xFF, 0xFF, 0));
+		CHECK(bgra[0] == 0);
+
+		free(src);
+		free(rgba);
+		free(bgra);
+	}
+
+	VOID TestExpandPalette()
+	{
+		uint32_t palette[256];
+		for (DWORD i = 0; i < 256; ++i)
+			palette[i] = Next();
+
+		uint8_t src[1000];
+		for (DWORD i = 0; i < sizeof(src); ++i)
+			src[i] = (uint8_t)Next();
+
+		uint32_t dst[sizeof(src) + 1];
+		dst[sizeof(src)] = 0xDEADBEEF;
+		ExpandPalette(src, dst, sizeof(src), palette);
+
+		DWORD failed = 0;
+		for (DWORD i = 0; i < sizeof(src); ++i)
+			failed += dst[i] != palette[src[i]];
+		CHECK(!failed);
+		CHECK(dst[sizeof(src)] == 0xDEADBEEF);
+
+		ExpandPalette(src, dst, 0, palette);
+		CHECK(dst[0] == palette[src[0]]);
+	}
+}
+
+INT main()
+{
+	VOID(*tests[])() = {
+		ConvertTest::TestSwapRedBlue,
+		ConvertTest::TestRgb565,
+		ConvertTest::TestExpandPalette
+	};
+
+	return Test::Run("ConvertTest", tests, sizeof(tests) / sizeof(*tests));
+}
@@ -0,0 +1,193 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Cursor.h"
+
+namespace CursorTest
+{
+	const uint32_t size = 32;
+	const uint32_t maskPitch = size / 8;
+	const uint32_t shadow = 6;
+	const uint32_t pitch = 50;
+
+	uint32_t seed = 1;
+
+	uint32_t Next()
+	{
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	struct Cursor
+	{
+		BYTE mask[2 * size * maskPitch];
+		BYTE color[size * size];
+		uint32_t palette[256];
+	};
+
+	VOID Make(Cursor* cursor)
+	{
+		for (DWORD i = 0; i < sizeof(cursor->mask); ++i)
+			cursor->mask[i] = (BYTE)Next();
+
+		for (DWORD i = 0; i < sizeof(cursor->color); ++i)
+			cursor->color[i] = (BYTE)Next();
+
+		for (DWORD i = 0; i < 256; ++i)
+			cursor->palette[i] = Next() | 0xFF000000;
+	}
+
+	// The byte walking loop the cursor was drawn with before it moved to the kernels
+	VOID Reference(uint32_t* source, const Cursor* cursor, BOOL isColor, POINT offset, SIZE clip)
+	{
+		DWORD initMask = 8 - (offset.x % 8);
+		DWORD initOffset = offset.x & (8 - 1);
+
+		INT shadowIdx = offset.y - shadow;
+		const BYTE* sourceColor = cursor->color + offset.y * size + offset.x;
+		const BYTE* sourceMask = cursor->mask + offset.y * maskPitch + (offset.x / 8);
+		const BYTE* colorMask = sourceMask + size * maskPitch;
+
+		LONG copyHeight = clip.cy;
+		do
+		{
+			uint32_t* src = source;
+			const BYTE* srcColor = sourceColor;
+			const BYTE* srcMask = sourceMask;
+			const BYTE* clrMask = colorMask;
+			const BYTE* shadMask = shadowIdx > 0 ? sourceMask - shadow * maskPitch : NULL;
+
+			BYTE andMask = *clrMask++;
+			BYTE xorMask = *srcMask++;
+			BYTE shdMask = shadMask ? *shadMask++ : 0xFF;
+
+			andMask <<= initOffset;
+			xorMask <<= initOffset;
+			shdMask <<= initOffset;
+
+			DWORD countMask = initMask;
+			LONG copyWidth = clip.cx;
+			do
+			{
+				if (xorMask & 0x80)
+				{
+					uint32_t color = *src;
+
+					if (!(shdMask & 0x80))
+					{
+						BYTE* cp = (BYTE*)&color;
+						DWORD cc = 3;
+						do
+							*cp++ >>= 1;
+						while (--cc);
+					}
+
+					*src = color;
+				}
+				else if (isColor)
+					*src = cursor->palette[*srcColor];
+				else
+					*src = (andMask & 0x80) ? 0xFFFFFFFF : 0xFF000000;
+
+				if (--countMask)
+				{
+					andMask <<= 1;
+					xorMask <<= 1;
+					shdMask <<= 1;
+				}
+				else
+				{
+					countMask = 8;
+					andMask = *clrMask++;
+					xorMask = *srcMask++;
+					shdMask = shadMask ? *shadMask++ : 0xFF;
+				}
+
+				++src;
+				++srcColor;
+			} while (--copyWidth);
+
+			source += pitch;
+			sourceColor += size;
+			sourceMask += maskPitch;
+			colorMask += maskPitch;
+
+			++shadowIdx;
+		} while (--copyHeight);
+	}
+
+	VOID Run(BOOL isColor)
+	{
+		Cursor cursor;
+		uint32_t frame[pitch * pitch], expected[pitch * pitch];
+
+		for (DWORD round = 0; round < 500; ++round)
+		{
+			Make(&cursor);
+			for (DWORD i = 0; i < pitch * pitch; ++i)
+				frame[i] = Next();
+
+			// Clipped at the top left by the offset, at the bottom right by the size
+			POINT offset = { LONG(Next() % size), LONG(Next() % size) };
+			SIZE clip = { LONG(1 + Next() % (size - offset.x)), LONG(1 + Next() % (size - offset.y)) };
+			POINT pos = { LONG(Next() % (pitch - clip.cx)), LONG(Next() % (pitch - clip.cy)) };
+
+			MemoryCopy(expected, frame, sizeof(frame));
+			Reference(expected + pos.y * pitch + pos.x, &cursor, isColor, offset, clip);
+
+			CursorImage image;
+			image.mask = cursor.mask;
+			image.maskPitch = maskPitch;
+			image.shadow = shadow;
+			image.palette = cursor.palette;
+			image.color = isColor ? cursor.color : NULL;
+			image.colorPitch = size;
+			image.bright = cursor.mask + size * maskPitch;
+
+			DrawCursor(frame + pos.y * pitch + pos.x, pitch, offset.x, offset.y, clip.cx, clip.cy, &image);
+			CHECK(!MemoryCompare(frame, expected, sizeof(frame)));
+		}
+	}
+
+	VOID TestColor()
+	{
+		Run(TRUE);
+	}
+
+	VOID TestMonochrome()
+	{
+		Run(FALSE);
+	}
+}
+
+INT main()
+{
+	VOID(*tests[])() = {
+		CursorTest::TestColor,
+		CursorTest::TestMonochrome
+	};
+
+	return Test::Run("CursorTest", tests, sizeof(tests) / sizeof(*tests));
+}
@@ -0,0 +1,298 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "GLMock.h"
+#include "PixelBuffer.h"
+#include "Ini.h"
+#include "Config.h"
+
+ConfigItems config;
+
+namespace DamageTest
+{
+	struct Loop
+	{
+		PixelBuffer* buffer;
+		DWORD* frame;
+		DWORD width;
+		DWORD height;
+		DWORD pitch;
+		BOOL isTrue;
+		RECT damage;
+		DWORD presents;
+		DWORD elided;
+	};
+
+	DWORD seed = 1;
+
+	DWORD Next()
+	{
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	VOID Open(Loop* loop, DWORD width, DWORD height, BOOL isTrue, UpdateMode mode)
+	{
+		MemoryZero(loop, sizeof(Loop));
+		loop->width = width;
+		loop->height = height;
+		loop->isTrue = isTrue;
+		loop->pitch = isTrue ? width : width >> 1;
+		loop->frame = (DWORD*)calloc(loop->pitch * height, sizeof(DWORD));
+		loop->buffer = new PixelBuffer(width, height, isTrue, isTrue ? GL_BGRA_EXT : GL_RGB, mode, FALSE);
+
+		GLMock::Create(width, height, isTrue ? sizeof(DWORD) : sizeof(WORD));
+		GLMock::origin.x = 0;
+		GLMock::origin.y = 0;
+	}
+
+	VOID Close(Loop* loop)
+	{
+		delete loop->buffer;
+		free(loop->frame);
+		GLMock::Release();
+	}
+
+	VOID Paint(Loop* loop, INT x, INT y, INT width, INT height)
+	{
+		for (INT j = y; j < y + height; ++j)
+			for (INT i = x; i < x + width; ++i)
+			{
+				if (loop->isTrue)
+					loop->frame[j * loop->pitch + i] = Next();
+				else
+					((WORD*)loop->frame)[j * loop->width + i] = WORD(Next());
+			}
+	}
+
+	BOOL IsShown(Loop* loop)
+	{
+		return !MemoryCompare(GLMock::GetTexture(), loop->frame, loop->pitch * loop->height * sizeof(DWORD));
+	}
+
+	// Mirrors the render loops: upload the frame, present only when it carries damage, then swap
+	BOOL Step(Loop* loop, Rect* rect = NULL)
+	{
+		GLMock::Reset();
+
+		loop->buffer->Copy(loop->frame);
+		BOOL isDamaged = loop->buffer->Update(rect, 1);
+		loop->damage = *loop->buffer->GetDamage();
+
+		if (isDamaged)
+			++loop->presents;
+		else
+			++loop->elided;
+
+		CHECK(GLMock::errors == 0);
+		loop->buffer->SwapBuffers();
+
+		return isDamaged;
+	}
+
+	BOOL Covers(const RECT* damage, INT x, INT y, INT width, INT height)
+	{
+		return damage->left <= x && damage->top <= y && damage->right >= x + width && damage->bottom >= y + height;
+	}
+
+	VOID TestElision(UpdateMode mode, BOOL isTrue)
+	{
+		Loop loop;
+		Open(&loop, 600, 340, isTrue, mode);
+
+		CHECK(Step(&loop));
+		CHECK(loop.damage.left == 0 && loop.damage.top == 0 && loop.damage.right == 600 && loop.damage.bottom == 340);
+		CHECK(IsShown(&loop));
+
+		BOOL isQuiet = TRUE;
+		for (DWORD i = 0; i < 5; ++i)
+			isQuiet &= !Step(&loop) && !GLMock::uploads && !GLMock::binds && IsRectEmpty(&loop.damage);
+		CHECK(isQuiet);
+		CHECK(loop.elided == 5);
+
+		Paint(&loop, 301, 257, 9, 7);
+		CHECK(Step(&loop));
+		CHECK(GLMock::binds == 1);
+		CHECK(GLMock::uploads >= 1);
+		CHECK(EqualRect(&GLMock::uploaded, &loop.damage));
+		CHECK(Covers(&loop.damage, 301, 257, 9, 7) && !Covers(&loop.damage, 299, 257, 11, 7) && !Covers(&loop.damage, 301, 256, 9, 8));
+		CHECK(IsShown(&loop));
+
+		CHECK(!Step(&loop));
+		CHECK(IsRectEmpty(&loop.damage));
+
+		loop.buffer->Reset();
+		CHECK(Step(&loop));
+		CHECK(loop.damage.right == 600 && loop.damage.bottom == 340);
+
+		Close(&loop);
+	}
+
+	VOID TestElisionCpp()
+	{
+		TestElision(UpdateCPP, TRUE);
+		TestElision(UpdateCPP, FALSE);
+	}
+
+	VOID TestElisionSse()
+	{
+		TestElision(UpdateSSE, TRUE);
+		TestElision(UpdateSSE, FALSE);
+	}
+
+	VOID TestNoCompare()
+	{
+		Loop loop;
+		Open(&loop, 64, 48, TRUE, UpdateNone);
+
+		BOOL isFull = TRUE;
+		for (DWORD i = 0; i < 4; ++i)
+			isFull &= Step(&loop) && loop.damage.right == 64 && loop.damage.bottom == 48;
+
+		CHECK(isFull);
+		CHECK(loop.elided == 0);
+
+		Close(&loop);
+	}
+
+	VOID TestRandom()
+	{
+		for (DWORD t = 0; t < 2; ++t)
+		{
+			Loop loop;
+			Open(&loop, 520, 300, !t, UpdateSSE);
+			Step(&loop);
+
+			DWORD quiet = 0, missed = 0, hidden = 0, loose = 0;
+			for (DWORD i = 0; i < 200; ++i)
+			{
+				DWORD count = Next() % 4;
+				if (!count)
+					++quiet;
+
+				RECT painted;
+				SetRectEmpty(&painted);
+				while (count--)
+				{
+					INT x = Next() % loop.width;
+					INT y = Next() % loop.height;
+					INT width = 1 + Next() % (loop.width - x);
+					INT height = 1 + Next() % (loop.height - y);
+					Paint(&loop, x, y, width, height);
+
+					RECT rc = { x, y, x + width, y + height };
+					UnionRect(&painted, &painted, &rc);
+				}
+
+				BOOL isDamaged = Step(&loop);
+				missed += isDamaged == IsRectEmpty(&painted);
+				hidden += !IsShown(&loop);
+				loose += isDamaged && !Covers(&painted, loop.damage.left + (t ? 1 : 0), loop.damage.top, loop.damage.right - loop.damage.left - (t ? 2 : 0), loop.damage.bottom - loop.damage.top);
+			}
+
+			CHECK(missed == 0);
+			CHECK(hidden == 0);
+			CHECK(loose == 0);
+			CHECK(loop.elided == quiet);
+
+			Close(&loop);
+		}
+	}
+
+	VOID TestTile()
+	{
+		Loop loop;
+		Open(&loop, 400, 300, TRUE, UpdateCPP);
+		Step(&loop);
+
+		Rect tile = { 128, 64, 200, 150 };
+		GLMock::origin.x = tile.x;
+		GLMock::origin.y = tile.y;
+
+		CHECK(!Step(&loop, &tile));
+
+		Paint(&loop, 150, 100, 20, 10);
+		CHECK(Step(&loop, &tile));
+		CHECK(Covers(&loop.damage, 150, 100, 20, 10));
+		CHECK(EqualRect(&GLMock::uploaded, &loop.damage));
+		CHECK(IsShown(&loop));
+
+		Paint(&loop, 10, 10, 5, 5);
+		CHECK(!Step(&loop, &tile));
+
+		Close(&loop);
+	}
+
+	VOID TestTune()
+	{
+		CHAR dir[MAX_PATH], path[MAX_PATH];
+		Test::TempDir(dir, "tune");
+		StrPrint(path, "%s/config.ini", dir);
+		Ini::Load(path);
+
+		UpdateMode saved = config.updateMode;
+		config.updateMode = UpdateAuto;
+		GLMock::Reset();
+		GLMock::origin.x = 0;
+		GLMock::origin.y = 0;
+		GLMock::bound = 7;
+		GLMock::maxSize = 512;
+
+		// Every mode uploads into its own scratch texture, clamped to the texture limit
+		UpdateMode mode = PixelBuffer::Tune(800, 600, FALSE, GL_RGB);
+		CHECK(mode >= UpdateNone && mode < UpdateAuto);
+		CHECK(GLMock::uploads && !GLMock::errors);
+		CHECK(GLMock::bound == 7 && !GLMock::textures);
+		CHECK(Ini::Get(CONFIG_WRAPPER, "UpdateMode800x600x16", -1) == mode);
+
+		GLMock::Reset();
+		CHECK(PixelBuffer::Tune(800, 600, FALSE, GL_RGB) == mode);
+		CHECK(!GLMock::uploads && !GLMock::binds);
+
+		GLMock::maxSize = 4096;
+		GLMock::bound = 0;
+		GLMock::Release();
+		config.updateMode = saved;
+
+		Ini::Release();
+		Test::RemoveDir(dir);
+	}
+}
+
+INT main()
+{
+	config.isSSE2 = TRUE;
+
+	VOID(*tests[])() = {
+		DamageTest::TestElisionCpp,
+		DamageTest::TestElisionSse,
+		DamageTest::TestNoCompare,
+		DamageTest::TestRandom,
+		DamageTest::TestTile,
+		DamageTest::TestTune
+	};
+
+	return Test::Run("DamageTest", tests, sizeof(tests) / sizeof(*tests));
+}
@@ -0,0 +1,97 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Digits.h"
+
+namespace DigitsTest
+{
+	const uint32_t pitch = 200;
+	const uint32_t height = DIGIT_HEIGHT + 4;
+	const uint32_t left = 3;
+	const uint32_t top = 2;
+
+	// Whether the pixel at x, y of the frame belongs to a set glyph bit of value
+	BOOL IsGlyph(uint32_t x, uint32_t y, uint32_t value)
+	{
+		CHAR text[16];
+		StrPrint(text, "%u", value);
+
+		uint32_t column = x - left;
+		uint32_t row = y - top;
+		if (x < left || y < top || row >= DIGIT_HEIGHT || column >= StrLength(text) * DIGIT_WIDTH)
+			return FALSE;
+
+		uint16_t glyph = digitGlyphs[text[column / DIGIT_WIDTH] - '0'][row];
+		return (glyph & (1 << (column % DIGIT_WIDTH))) != 0;
+	}
+
+	const uint32_t values[] = { 0, 7, 10, 60, 144, 1000, 98765, 4294967295u };
+
+	VOID TestDigits16()
+	{
+		uint16_t frame[pitch * height];
+		for (DWORD i = 0; i < sizeof(values) / sizeof(*values); ++i)
+		{
+			for (uint32_t j = 0; j < pitch * height; ++j)
+				frame[j] = 0x1234;
+
+			DrawDigits(frame + top * pitch + left, pitch, values[i], 0xFFE0);
+
+			DWORD failed = 0;
+			for (uint32_t y = 0; y < height; ++y)
+				for (uint32_t x = 0; x < pitch; ++x)
+					failed += frame[y * pitch + x] != (IsGlyph(x, y, values[i]) ? 0xFFE0 : 0x1234);
+			CHECK(!failed);
+		}
+	}
+
+	VOID TestDigits32()
+	{
+		uint32_t frame[pitch * height];
+		for (DWORD i = 0; i < sizeof(values) / sizeof(*values); ++i)
+		{
+			for (uint32_t j = 0; j < pitch * height; ++j)
+				frame[j] = 0x12345678;
+
+			DrawDigits(frame + top * pitch + left, pitch, values[i], 0xFF00FFFF);
+
+			DWORD failed = 0;
+			for (uint32_t y = 0; y < height; ++y)
+				for (uint32_t x = 0; x < pitch; ++x)
+					failed += frame[y * pitch + x] != (IsGlyph(x, y, values[i]) ? 0xFF00FFFF : 0x12345678);
+			CHECK(!failed);
+		}
+	}
+}
+
+INT main()
+{
+	VOID(*tests[])() = {
+		DigitsTest::TestDigits16,
+		DigitsTest::TestDigits32
+	};
+
+	return Test::Run("DigitsTest", tests, sizeof(tests) / sizeof(*tests));
+}
@@ -0,0 +1,320 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "FrameQueue.h"
+
+namespace FrameQueueTest
+{
+	const DWORD width = 160;
+	const DWORD height = 120;
+	const DWORD writes = 20000;
+
+	struct Change
+	{
+		RECT rect;
+		BOOL isPublished;
+	};
+
+	struct Session
+	{
+		FrameQueue* queue;
+		HANDLE hEvent;
+		DWORD* canvas;
+		DWORD* previous;
+		Change* log;
+		volatile LONG isFinish;
+		DWORD seed;
+
+		DWORD frames;
+		DWORD torn;
+		DWORD stale;
+		DWORD unreported;
+		LONGLONG latency;
+		LONGLONG worst;
+	};
+
+	DWORD Next(DWORD* seed)
+	{
+		*seed = *seed * 1103515245 + 12345;
+		return *seed >> 8;
+	}
+
+	VOID Fill(DWORD* buffer, const RECT* rect, DWORD value)
+	{
+		for (LONG y = rect->top; y < rect->bottom; ++y)
+			for (LONG x = rect->left; x < rect->right; ++x)
+				buffer[y * width + x] = value;
+	}
+
+	DWORD __stdcall Writer(LPVOID lpParameter)
+	{
+		Session* session = (Session*)lpParameter;
+		DWORD* seed = &session->seed;
+
+		for (DWORD i = 1; i < writes; ++i)
+		{
+			Change* change = &session->log[i];
+			change->isPublished = Next(seed) % 4 != 0 || i == writes - 1;
+
+			// published changes start at the origin so the first pixel always carries the newest change index
+			RECT* rc = &change->rect;
+			if (change->isPublished)
+			{
+				rc->left = 0;
+				rc->top = 0;
+			}
+			else
+			{
+				rc->left = Next(seed) % width;
+				rc->top = Next(seed) % height;
+			}
+
+			rc->right = rc->left + 1 + Next(seed) % (width - rc->left);
+			rc->bottom = rc->top + 1 + Next(seed) % (height - rc->top);
+
+			Fill(session->canvas, rc, i);
+
+			if (change->isPublished)
+			{
+				session->queue->Publish(session->canvas, rc);
+				SetEvent(session->hEvent);
+			}
+			else
+				session->queue->Invalidate(rc);
+
+			if (!(i & 0xFF))
+				Sleep(0);
+		}
+
+		InterlockedExchange(&session->isFinish, TRUE);
+		SetEvent(session->hEvent);
+
+		return 0;
+	}
+
+	VOID Check(Session* session, DWORD* expected, DWORD* applied)
+	{
+		DWORD* frame = (DWORD*)session->queue->Acquire();
+		const RECT* changed = session->queue->GetChanged();
+		if (!session->queue->GetStamp())
+		{
+			session->unreported += !IsRectEmpty(changed);
+			return;
+		}
+
+		// Outside the reported rectangle the frame has to match the one acquired before it
+		for (LONG y = 0; y < (LONG)height; ++y)
+			for (LONG x = 0; x < (LONG)width; ++x)
+			{
+				BOOL isInside = x >= changed->left && x < changed->right && y >= changed->top && y < changed->bottom;
+				if (!isInside && frame[y * width + x] != session->previous[y * width + x])
+				{
+					++session->unreported;
+					y = height;
+					break;
+				}
+			}
+
+		MemoryCopy(session->previous, frame, width * height * sizeof(DWORD));
+
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		LONGLONG latency = now.QuadPart - session->queue->GetStamp();
+		session->latency += latency;
+		if (session->worst < latency)
+			session->worst = latency;
+
+		++session->frames;
+
+		DWORD index = frame[0];
+		if (index < *applied || index >= writes || !session->log[index].isPublished)
+		{
+			++session->stale;
+			return;
+		}
+
+		while (*applied < index)
+		{
+			++*applied;
+			Fill(expected, &session->log[*applied].rect, *applied);
+		}
+
+		if (MemoryCompare(frame, expected, width * height * sizeof(DWORD)))
+			++session->torn;
+	}
+
+	VOID TestSequential()
+	{
+		FrameQueue* queue = FrameQueue::Create(width, height, width * sizeof(DWORD), sizeof(DWORD));
+		DWORD* canvas = (DWORD*)calloc(width * height, sizeof(DWORD));
+
+		CHECK(queue->Acquire() != NULL);
+		CHECK(queue->GetStamp() == 0);
+
+		RECT full = { 0, 0, width, height };
+		Fill(canvas, &full, 1);
+		queue->Publish(canvas);
+
+		DWORD* frame = (DWORD*)queue->Acquire();
+		CHECK(queue->GetStamp() != 0);
+		CHECK(frame[0] == 1 && frame[width * height - 1] == 1);
+		CHECK(EqualRect(queue->GetChanged(), &full));
+
+		queue->Acquire();
+		CHECK(queue->GetStamp() == 0);
+		CHECK(IsRectEmpty(queue->GetChanged()));
+
+		// frames the reader never took hand their changes on to the one that replaces them
+		RECT first = { 10, 10, 20, 20 };
+		RECT second = { 30, 40, 50, 60 };
+		queue->Publish(canvas, &first);
+		queue->Publish(canvas, &second);
+		queue->Acquire();
+
+		RECT both;
+		UnionRect(&both, &first, &second);
+		CHECK(EqualRect(queue->GetChanged(), &both));
+
+		// a hidden change rides along with the next published rectangle, in every slot
+		RECT hidden = { 100, 80, 120, 100 };
+		Fill(canvas, &hidden, 2);
+		queue->Invalidate(&hidden);
+
+		queue->Acquire();
+		CHECK(queue->GetStamp() == 0);
+
+		RECT corner = { 0, 0, 4, 4 };
+		queue->Publish(canvas, &corner);
+		queue->Acquire();
+
+		RECT carried;
+		UnionRect(&carried, &hidden, &corner);
+		CHECK(EqualRect(queue->GetChanged(), &carried));
+
+		for (DWORD i = 3; i < 3 + FRAME_SLOTS; ++i)
+		{
+			RECT small = { 0, 0, 4, 4 };
+			Fill(canvas, &small, i);
+			queue->Publish(canvas, &small);
+
+			frame = (DWORD*)queue->Acquire();
+			CHECK(!MemoryCompare(frame, canvas, width * height * sizeof(DWORD)));
+		}
+
+		RECT outside = { width, height, width + 10, height + 10 };
+		queue->Invalidate(&outside);
+		queue->Publish(canvas, &outside);
+		queue->Acquire();
+		CHECK(queue->GetStamp() == 0);
+
+		free(canvas);
+		delete queue;
+	}
+
+	// Every slot allocation that fails takes the whole queue down, nothing is left behind half built
+	VOID TestCreate()
+	{
+		// Sizes nobody else allocates, so every slot comes from the heap and not from the aligned pool
+		const DWORD odd = 333;
+		for (LONG budget = 1; budget <= FRAME_SLOTS; ++budget)
+		{
+			Win32::allocBudget = budget;
+			CHECK(FrameQueue::Create(odd, odd + budget * 64, odd * sizeof(DWORD), sizeof(DWORD)) == NULL);
+			Win32::allocBudget = -1;
+		}
+
+		Win32::allocBudget = FRAME_SLOTS + 1;
+		FrameQueue* queue = FrameQueue::Create(odd, odd, odd * sizeof(DWORD), sizeof(DWORD));
+		Win32::allocBudget = -1;
+
+		CHECK(queue != NULL);
+		if (queue)
+		{
+			CHECK(queue->Acquire() != NULL);
+			delete queue;
+		}
+	}
+
+	VOID TestStress()
+	{
+		Session session;
+		MemoryZero(&session, sizeof(Session));
+		session.seed = 7;
+		session.queue = FrameQueue::Create(width, height, width * sizeof(DWORD), sizeof(DWORD));
+		session.hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+		session.canvas = (DWORD*)calloc(width * height, sizeof(DWORD));
+		session.previous = (DWORD*)calloc(width * height, sizeof(DWORD));
+		session.log = (Change*)calloc(writes, sizeof(Change));
+
+		DWORD* expected = (DWORD*)calloc(width * height, sizeof(DWORD));
+		DWORD applied = 0;
+
+		DOUBLE start = Test::Seconds();
+		HANDLE hThread = CreateThread(NULL, 0, Writer, &session, 0, NULL);
+		CHECK(hThread != NULL);
+
+		while (!session.isFinish)
+		{
+			WaitForSingleObject(session.hEvent, 1);
+			Check(&session, expected, &applied);
+		}
+
+		WaitForSingleObject(hThread, INFINITE);
+		CloseHandle(hThread);
+		Check(&session, expected, &applied);
+		DOUBLE time = Test::Seconds() - start;
+
+		CHECK(session.frames > 0);
+		CHECK(session.torn == 0);
+		CHECK(session.stale == 0);
+		CHECK(session.unreported == 0);
+		CHECK(applied == writes - 1);
+
+		LARGE_INTEGER freq;
+		QueryPerformanceFrequency(&freq);
+		printf("FrameQueue: %u writes, %u frames in %.2f s, latency %.1f us average, %.1f us worst\n",
+			writes - 1, session.frames, time,
+			session.frames ? session.latency * 1000000.0 / freq.QuadPart / session.frames : 0.0,
+			session.worst * 1000000.0 / freq.QuadPart);
+
+		free(expected);
+		free(session.log);
+		free(session.canvas);
+		free(session.previous);
+		CloseHandle(session.hEvent);
+		delete session.queue;
+	}
+}
+
+INT main()
+{
+	VOID(*tests[])() = {
+		FrameQueueTest::TestSequential,
+		FrameQueueTest::TestCreate,
+		FrameQueueTest::TestStress
+	};
+
+	return Test::Run("FrameQueueTest", tests, sizeof(tests) / sizeof(*tests));
+}
@@ -0,0 +1,276 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "IdleGovernor.h"
+
+/*
+	Drives IdleGovernor with a simulated clock and message queue. The game
+	polls PeekMessage in a loop, runs a tick whenever its timer is due and
+	handles messages as they arrive. Waits advance the simulated clock up to
+	the timeout plus some timer lateness, or until the next message.
+*/
+
+namespace IdleGovernorTest
+{
+	DWORD seed = 1;
+
+	DWORD Next()
+	{
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	class SimSource : public IdleSource
+	{
+	public:
+		LONGLONG now;
+		LONGLONG input;
+
+		SimSource()
+		{
+			this->now = 1000000;
+			this->input = 0;
+		}
+
+		LONGLONG Now()
+		{
+			return this->now;
+		}
+
+		DWORD Time()
+		{
+			return DWORD(this->now / 1000);
+		}
+
+		BOOL Wait(DWORD timeout)
+		{
+			// The system timer fires up to a millisecond late
+			LONGLONG end = this->now + timeout * 1000 + 200 + Next() % 700;
+			if (this->input && this->input <= end)
+			{
+				if (this->input > this->now)
+					this->now = this->input;
+
+				return TRUE;
+			}
+
+			this->now = end;
+			return FALSE;
+		}
+	};
+
+	struct Game
+	{
+		SimSource* source;
+		IdleGovernor* governor;
+		LONGLONG period;
+		LONGLONG work;
+		LONGLONG next;
+		LONGLONG delay;
+		DWORD ticks;
+		LONGLONG gap;
+		LONGLONG messageDelay;
+		DWORD messages;
+	};
+
+	VOID Open(Game* game, LONGLONG period, LONGLONG work)
+	{
+		MemoryZero(game, sizeof(Game));
+		game->source = new SimSource();
+		game->governor = new IdleGovernor(game->source);
+		game->period = period;
+		game->work = work;
+		game->next = game->source->now + period;
+	}
+
+	VOID Close(Game* game)
+	{
+		delete game->governor;
+	}
+
+	VOID Reset(Game* game)
+	{
+		game->delay = 0;
+		game->ticks = 0;
+		game->messageDelay = 0;
+		game->messages = 0;
+	}
+
+	VOID Run(Game* game, LONGLONG duration)
+	{
+		SimSource* source = game->source;
+		LONGLONG end = source->now + duration;
+		while (source->now < end)
+		{
+			source->now += 3;
+
+			if (source->input && source->input <= source->now)
+			{
+				LONGLONG delay = source->now - source->input;
+				if (game->messageDelay < delay)
+					game->messageDelay = delay;
+				++game->messages;
+
+				source->now += 100;
+				source->input = game->gap ? source->now + game->gap / 4 + Next() % game->gap : 0;
+				continue;
+			}
+
+			game->governor->Wait();
+
+			if (source->now >= game->next)
+			{
+				game->delay += source->now - game->next;
+				++game->ticks;
+
+				source->now += game->work;
+				do
+					game->next += game->period;
+				while (game->next <= source->now);
+			}
+		}
+	}
+
+	VOID TestCadence()
+	{
+		Game game;
+		Open(&game, 16000, 3000);
+		Run(&game, 3000000);
+
+		Reset(&game);
+		Run(&game, 3000000);
+
+		CHECK(game.governor->period > 15500 && game.governor->period < 16500);
+		CHECK(game.ticks > 180);
+		CHECK(game.delay / game.ticks < 300);
+		CHECK(game.governor->idle >= 60);
+		CHECK(game.governor->latency < 300);
+
+		Close(&game);
+	}
+
+	VOID TestInput()
+	{
+		Game game;
+		Open(&game, 16000, 3000);
+		game.gap = 20000;
+		game.source->input = game.source->now + 5000;
+		Run(&game, 3000000);
+
+		Reset(&game);
+		Run(&game, 3000000);
+
+		// Messages end the wait as soon as they arrive and do not disturb the learned cadence
+		CHECK(game.messages > 100);
+		CHECK(game.messageDelay <= game.work + 200);
+		CHECK(game.governor->period > 15000 && game.governor->period < 17000);
+		CHECK(game.delay / game.ticks < 300);
+		CHECK(game.governor->idle >= 50);
+
+		Close(&game);
+	}
+
+	VOID TestRelearn()
+	{
+		Game game;
+		Open(&game, 16000, 3000);
+		Run(&game, 3000000);
+		CHECK(game.governor->period > 15500 && game.governor->period < 16500);
+
+		// The game switches to a slower timer, the governor has to follow
+		game.period = 33000;
+		Run(&game, 3000000);
+
+		Reset(&game);
+		Run(&game, 3000000);
+
+		CHECK(game.governor->period > 32000 && game.governor->period < 34000);
+		CHECK(game.delay / game.ticks < 300);
+		CHECK(game.governor->idle >= 70);
+
+		Close(&game);
+	}
+
+	VOID TestDeadline()
+	{
+		SimSource* source = new SimSource();
+		IdleGovernor* governor = new IdleGovernor(source);
+
+		// An irregular loop that announces each deadline on the multimedia clock
+		LONGLONG delay = 0, worst = 0;
+		DWORD ticks = 0;
+		LONGLONG end = source->now + 3000000;
+		while (source->now < end)
+		{
+			DWORD time = source->Time() + 5 + Next() % 20;
+			governor->SetDeadline(time);
+			do
+			{
+				source->now += 3;
+				governor->Wait();
+			} while (source->Time() < time);
+			governor->ResetDeadline();
+
+			LONGLONG late = source->now - LONGLONG(time) * 1000;
+			delay += late;
+			if (worst < late)
+				worst = late;
+			++ticks;
+
+			source->now += 1000;
+		}
+
+		CHECK(ticks > 150);
+		CHECK(delay / ticks < 300);
+		CHECK(worst < 1000);
+		CHECK(governor->idle >= 60);
+
+		delete governor;
+	}
+
+	VOID TestSystemWait()
+	{
+		// Input that is already queued has to end the wait too, not only input that arrives later
+		IdleSource source;
+		Win32::waitMask = 0;
+		Win32::waitFlags = 0;
+		CHECK(!source.Wait(1));
+		CHECK(Win32::waitMask == QS_ALLINPUT);
+		CHECK(Win32::waitFlags & MWMO_INPUTAVAILABLE);
+	}
+}
+
+INT main()
+{
+	VOID(*tests[])() = {
+		IdleGovernorTest::TestCadence,
+		IdleGovernorTest::TestInput,
+		IdleGovernorTest::TestRelearn,
+		IdleGovernorTest::TestDeadline,
+		IdleGovernorTest::TestSystemWait
+	};
+
+	return Test::Run("IdleGovernorTest", tests, sizeof(tests) / sizeof(*tests));
+}
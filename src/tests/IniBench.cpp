@@ -0,0 +1,152 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Ini.h"
+
+namespace IniBench
+{
+	CHAR path[MAX_PATH];
+
+	const DWORD sections = 12;
+	const DWORD keys = 24;
+
+	VOID Generate()
+	{
+		FILE* file = fopen(path, "wb");
+		for (DWORD s = 0; s < sections; ++s)
+		{
+			fprintf(file, "; Section %u\r\n[Section%u]\r\n", s, s);
+			for (DWORD k = 0; k < keys; ++k)
+				fprintf(file, "Key%u = %u\r\n", k, s * keys + k);
+
+			fprintf(file, "\r\n");
+		}
+
+		fclose(file);
+	}
+
+	// What every GetPrivateProfileInt call costs: open the file, scan to the section, scan to the key
+	INT Scan(const CHAR* app, const CHAR* key, INT defValue)
+	{
+		DWORD size;
+		CHAR* data = (CHAR*)Test::ReadAll(path, &size);
+		if (!data)
+			return defValue;
+
+		INT value = defValue;
+		BOOL isSection = FALSE;
+		DWORD appLength = StrLength(app);
+		DWORD keyLength = StrLength(key);
+
+		CHAR* line = data;
+		CHAR* end = data + size;
+		while (line < end)
+		{
+			CHAR* next = line;
+			while (next < end && *next != '\n')
+				++next;
+
+			if (*line == '[')
+				isSection = !strncasecmp(line + 1, app, appLength) && line[appLength + 1] == ']';
+			else if (isSection && !strncasecmp(line, key, keyLength) && (line[keyLength] == ' ' || line[keyLength] == '='))
+			{
+				CHAR* equal = StrChar(line, '=');
+				value = atoi(equal + 1);
+				break;
+			}
+
+			line = next + 1;
+		}
+
+		free(data);
+		return value;
+	}
+
+	VOID Run(DWORD iterations)
+	{
+		CHAR app[32], key[32];
+		DWORD lookups = sections * keys;
+
+		INT check = 0;
+		DOUBLE start = Test::Seconds();
+		for (DWORD i = 0; i < iterations; ++i)
+		{
+			Ini::Load(path);
+			for (DWORD s = 0; s < sections; ++s)
+				for (DWORD k = 0; k < keys; ++k)
+				{
+					StrPrint(app, "Section%u", s);
+					StrPrint(key, "Key%u", k);
+					check += Ini::Get(app, key, 0);
+				}
+
+			Ini::Stop();
+			Ini::Release();
+		}
+		DOUBLE cached = (Test::Seconds() - start) / iterations;
+
+		start = Test::Seconds();
+		for (DWORD i = 0; i < iterations; ++i)
+			for (DWORD s = 0; s < sections; ++s)
+				for (DWORD k = 0; k < keys; ++k)
+				{
+					StrPrint(app, "Section%u", s);
+					StrPrint(key, "Key%u", k);
+					check -= Scan(app, key, 0);
+				}
+		DOUBLE scanned = (Test::Seconds() - start) / iterations;
+
+		Ini::Load(path);
+		start = Test::Seconds();
+		for (DWORD i = 0; i < iterations; ++i)
+		{
+			StrPrint(key, "%u", i);
+			Ini::Set("Section0", "Key0", key);
+			Ini::Flush();
+		}
+		DOUBLE saved = (Test::Seconds() - start) / iterations;
+		Ini::Stop();
+		Ini::Release();
+
+		printf("%u lookups  cached %8.1f us  per-call scan %8.1f us  x%.1f  save %6.1f us%s\n",
+			lookups, cached * 1e6, scanned * 1e6, cached > 0.0 ? scanned / cached : 0.0, saved * 1e6,
+			check ? "  MISMATCH" : "");
+	}
+}
+
+INT main(INT argc, CHAR** argv)
+{
+	DWORD iterations = argc > 1 ? atoi(argv[1]) : 200;
+
+	CHAR dir[MAX_PATH];
+	Test::TempDir(dir, "ini");
+	StrPrint(IniBench::path, "%s/config.ini", dir);
+
+	IniBench::Generate();
+	IniBench::Run(iterations);
+
+	Test::RemoveDir(dir);
+	return 0;
+}
@@ -0,0 +1,244 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Ini.h"
+
+namespace Ini
+{
+	extern HANDLE hThread;
+	extern BOOL isFinish;
+}
+
+namespace IniTest
+{
+	CHAR dir[MAX_PATH];
+	CHAR path[MAX_PATH];
+
+	const CHAR* source =
+		"; Wrapper settings\r\n"
+		"[Wrapper]\r\n"
+		"UseOpenGL=1\r\n"
+		"  Title =  \"  Heroes  \"  \r\n"
+		"Quoted = 'single'\r\n"
+		"Empty=\r\n"
+		"Hex=0x1F\r\n"
+		"Negative=-7\r\n"
+		"Text=abc\r\n"
+		"\r\n"
+		"[Colors]\r\n"
+		"Gamma = \"50\"\r\n";
+
+	VOID Write(const CHAR* text)
+	{
+		FILE* file = fopen(path, "wb");
+		fwrite(text, 1, StrLength(text), file);
+		fclose(file);
+	}
+
+	BOOL Equals(const CHAR* text)
+	{
+		DWORD size;
+		BYTE* data = Test::ReadAll(path, &size);
+		if (!data)
+			return FALSE;
+
+		BOOL isEqual = size == StrLength(text) && !MemoryCompare(data, text, size);
+		free(data);
+		return isEqual;
+	}
+
+	VOID TestParse()
+	{
+		Write(source);
+		CHECK(Ini::Load(path));
+
+		CHAR buffer[64];
+		CHECK(Ini::Get("Wrapper", "Title", "", buffer, sizeof(buffer)) == 10 && !StrCompare(buffer, "  Heroes  "));
+		CHECK(Ini::Get("WRAPPER", "quoted", "", buffer, sizeof(buffer)) == 6 && !StrCompare(buffer, "single"));
+		CHECK(Ini::Get("Colors", "Gamma", "", buffer, sizeof(buffer)) == 2 && !StrCompare(buffer, "50"));
+		CHECK(Ini::Get("Wrapper", "Empty", "none", buffer, sizeof(buffer)) == 0 && !*buffer);
+		CHECK(Ini::Get("Wrapper", "Missing", "none", buffer, sizeof(buffer)) == 4 && !StrCompare(buffer, "none"));
+		CHECK(Ini::Get("Wrapper", "Title", "", buffer, 5) == 4 && !StrCompare(buffer, "  He"));
+
+		CHECK(Ini::Check("Wrapper", "Empty"));
+		CHECK(!Ini::Check("Wrapper", "Gamma"));
+		CHECK(!Ini::Check("Missing", "Title"));
+
+		Ini::Stop();
+		Ini::Release();
+		CHECK(Equals(source));
+	}
+
+	VOID TestInt()
+	{
+		Write(source);
+		Ini::Load(path);
+
+		CHECK(Ini::Get("Wrapper", "UseOpenGL", 5) == 1);
+		CHECK(Ini::Get("Wrapper", "Hex", 5) == 31);
+		CHECK(Ini::Get("Wrapper", "Negative", 5) == -7);
+		CHECK(Ini::Get("Colors", "Gamma", 5) == 50);
+		CHECK(Ini::Get("Wrapper", "Empty", 5) == 0);
+		CHECK(Ini::Get("Wrapper", "Text", 5) == 0);
+		CHECK(Ini::Get("Wrapper", "Missing", 5) == 5);
+		CHECK(Ini::Get("Missing", "Empty", 5) == 5);
+
+		Ini::Stop();
+		Ini::Release();
+	}
+
+	VOID TestRewrite()
+	{
+		Write(source);
+		Ini::Load(path);
+
+		Ini::Set("Wrapper", "Title", "Might");
+		Ini::Set("Wrapper", "Quoted", "");
+		Ini::Set("Wrapper", "Text", " padded ");
+		Ini::Set("Wrapper", "UseOpenGL", "1");
+		Ini::Set("Colors", "Gamma", "75");
+		Ini::Set("Colors", "Hue", "\"x\"");
+		Ini::Set("Fps", "Limit", "60");
+		Ini::Stop();
+		Ini::Release();
+
+		CHECK(Equals(
+			"; Wrapper settings\r\n"
+			"[Wrapper]\r\n"
+			"UseOpenGL=1\r\n"
+			"  Title =  \"Might\"  \r\n"
+			"Quoted = ''\r\n"
+			"Empty=\r\n"
+			"Hex=0x1F\r\n"
+			"Negative=-7\r\n"
+			"Text=\" padded \"\r\n"
+			"\r\n"
+			"[Colors]\r\n"
+			"Gamma = \"75\"\r\n"
+			"Hue=\"\"x\"\"\r\n"
+			"[Fps]\r\n"
+			"Limit=60\r\n"));
+
+		Ini::Load(path);
+
+		CHAR buffer[64];
+		Ini::Get("Wrapper", "Text", "", buffer, sizeof(buffer));
+		CHECK(!StrCompare(buffer, " padded "));
+		Ini::Get("Colors", "Hue", "", buffer, sizeof(buffer));
+		CHECK(!StrCompare(buffer, "\"x\""));
+		Ini::Get("Wrapper", "Quoted", "none", buffer, sizeof(buffer));
+		CHECK(!*buffer);
+		CHECK(Ini::Get("Colors", "Gamma", 0) == 75);
+		CHECK(Ini::Get("Fps", "Limit", 0) == 60);
+
+		Ini::Stop();
+		Ini::Release();
+	}
+
+	VOID TestDebounce()
+	{
+		Write(source);
+		Ini::Load(path);
+
+		CHAR value[16];
+		for (DWORD i = 0; i <= 20; ++i)
+		{
+			StrPrint(value, "%u", i);
+			Ini::Set("Colors", "Gamma", value);
+			Sleep(10);
+		}
+
+		CHECK(Equals(source));
+
+		DOUBLE start = Test::Seconds();
+		while (Equals(source) && Test::Seconds() - start < 5.0)
+			Sleep(10);
+
+		CHECK(Test::Seconds() - start >= (INI_DELAY - 100) / 1000.0);
+
+		Ini::Stop();
+		Ini::Release();
+		Ini::Load(path);
+		CHECK(Ini::Get("Colors", "Gamma", 0) == 20);
+		Ini::Stop();
+		Ini::Release();
+	}
+
+	VOID TestRelease()
+	{
+		Write(source);
+		Ini::Load(path);
+
+		Ini::Set("Colors", "Gamma", "99");
+		CHECK(Ini::hThread != NULL);
+
+		DOUBLE start = Test::Seconds();
+		Ini::Stop();
+
+		CHECK(Test::Seconds() - start < INI_DELAY / 1000.0);
+		CHECK(Ini::hThread == NULL);
+		Ini::Release();
+
+		Ini::Load(path);
+		CHECK(Ini::Get("Colors", "Gamma", 0) == 99);
+
+		// Release runs under the loader lock: it saves and signals the writer, but never joins it
+		Ini::Set("Colors", "Gamma", "98");
+		Ini::Release();
+		CHECK(Ini::hThread != NULL && Ini::isFinish);
+
+		Ini::Stop();
+		Ini::Release();
+
+		Ini::Load(path);
+		CHECK(Ini::Get("Colors", "Gamma", 0) == 98);
+		Ini::Release();
+
+		DeleteFile(path);
+		CHECK(!Ini::Load(path));
+		Ini::Set("Wrapper", "UseOpenGL", "0");
+		Ini::Stop();
+		Ini::Release();
+		CHECK(Equals("[Wrapper]\r\nUseOpenGL=0\r\n"));
+	}
+}
+
+INT main()
+{
+	Test::TempDir(IniTest::dir, "ini");
+	StrPrint(IniTest::path, "%s/config.ini", IniTest::dir);
+
+	VOID(*tests[])() = {
+		IniTest::TestParse,
+		IniTest::TestInt,
+		IniTest::TestRewrite,
+		IniTest::TestDebounce,
+		IniTest::TestRelease
+	};
+
+	INT result = Test::Run("IniTest", tests, sizeof(tests) / sizeof(*tests));
+	Test::RemoveDir(IniTest::dir);
+	return result;
+}
@@ -0,0 +1,172 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Pacing.h"
+
+namespace PacingTest
+{
+	struct Rate
+	{
+		UINT numerator;
+		UINT denominator;
+	};
+
+	const Rate rates[] = {
+		{ 60000, 1001 }, { 60, 1 }, { 75, 1 }, { 120, 1 }, { 143856, 1000 },
+		{ 144, 1 }, { 165, 1 }, { 240, 1 }, { 30000, 1001 }, { 50, 1 }
+	};
+
+	const DWORD rateCount = sizeof(rates) / sizeof(*rates);
+	const DWORD frames = 200000;
+
+	VOID Load(const Rate* rate)
+	{
+		Win32::dwmNumerator = rate->numerator;
+		Win32::dwmDenominator = rate->denominator;
+		Pacing::Load();
+	}
+
+	VOID TestLoad()
+	{
+		Win32::dwmNumerator = 60000;
+		Win32::dwmDenominator = 1001;
+		Win32::displayFrequency = 59;
+		Pacing::Load();
+		CHECK(fabs(Pacing::period - 1001.0 / 60.0) < 1e-9);
+
+		// Without DWM only the truncated display frequency is known
+		Win32::dwmNumerator = 0;
+		Win32::dwmDenominator = 0;
+		Pacing::Load();
+		CHECK(fabs(Pacing::period - 1000.0 / 59.0) < 1e-9);
+
+		Win32::displayFrequency = 1;
+		Pacing::Load();
+		CHECK(fabs(Pacing::period - 1000.0 / PACING_DEFAULT) < 1e-9);
+
+		Win32::displayFrequency = 0;
+		Pacing::Load();
+		CHECK(fabs(Pacing::period - 1000.0 / PACING_DEFAULT) < 1e-9);
+	}
+
+	// The whole-millisecond steps handed to the game must add up to the exact timeline
+	VOID TestNext()
+	{
+		DWORD drifted = 0;
+		DWORD steps = 0;
+		for (DWORD r = 0; r < rateCount; ++r)
+		{
+			Load(&rates[r]);
+			DWORD low = (DWORD)Pacing::period;
+
+			DOUBLE timeline = 0.0;
+			ULONGLONG total = 0;
+			DOUBLE ahead = 0.0;
+			DOUBLE behind = 0.0;
+			for (DWORD i = 1; i <= frames; ++i)
+			{
+				DWORD step = Pacing::Next(&timeline);
+				steps += step != low && step != low + 1;
+				total += step;
+
+				// The game lags the exact timeline by the carried fraction only, and is never ahead of it
+				DOUBLE error = i * Pacing::period - total;
+				if (error > behind)
+					behind = error;
+				if (error < ahead)
+					ahead = error;
+
+				drifted += timeline < 0.0 || timeline >= 1.0;
+			}
+
+			CHECK(behind <= 1.0 + 1e-6);
+			CHECK(ahead >= -1e-6);
+			CHECK(fabs(frames * Pacing::period - (total + timeline)) < 1e-3);
+		}
+
+		CHECK(drifted == 0);
+		CHECK(steps == 0);
+	}
+
+	// A 50 ms cadence keeps its rate at any refresh, missing or repeating at most one tick
+	VOID TestElapse()
+	{
+		for (DWORD r = 0; r < rateCount; ++r)
+		{
+			Load(&rates[r]);
+
+			DOUBLE timeline = 0.0;
+			DWORD ticks = 0;
+			for (DWORD i = 0; i < frames; ++i)
+				ticks += Pacing::Elapse(&timeline, 50.0);
+
+			DOUBLE expected = frames * Pacing::period / 50.0;
+			CHECK(fabs(ticks - expected) <= 1.0);
+			CHECK(timeline >= 0.0 && timeline < 50.0);
+		}
+	}
+
+	// cursorTime is the nearest whole millisecond, so the game timers run off by at most half a millisecond per frame
+	VOID TestInterval()
+	{
+		for (DWORD r = 0; r < rateCount; ++r)
+		{
+			Load(&rates[r]);
+
+			DWORD interval = Pacing::Interval();
+			CHECK(fabs(interval - Pacing::period) <= 0.5);
+
+			DOUBLE drift = fabs(frames * (interval - Pacing::period));
+			CHECK(drift <= frames * 0.5);
+		}
+
+		Rate exact = { 125, 1 };
+		Load(&exact);
+		CHECK(Pacing::Interval() == 8);
+
+		Rate ntsc = { 60000, 1001 };
+		Load(&ntsc);
+		CHECK(Pacing::Interval() == 17);
+
+		Rate fast = { 144, 1 };
+		Load(&fast);
+		CHECK(Pacing::Interval() == 7);
+
+		Win32::dwmNumerator = 0;
+		Win32::dwmDenominator = 0;
+	}
+}
+
+INT main()
+{
+	VOID(*tests[])() = {
+		PacingTest::TestLoad,
+		PacingTest::TestNext,
+		PacingTest::TestElapse,
+		PacingTest::TestInterval
+	};
+
+	return Test::Run("PacingTest", tests, sizeof(tests) / sizeof(*tests));
+}
@@ -0,0 +1,158 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Convert.h"
+#include "Blit.h"
+
+/*
+	Throughput of the conversion and color key kernels over a full frame,
+	counted in destination bytes. A quarter of the key blit source is key.
+
+	PixelBench              640x480, 800x600, 1920x1080 and 3840x2160
+	PixelBench <w> <h>      one resolution
+*/
+
+namespace PixelBench
+{
+	const CHAR* kernels[] = { "swap", "565>rgba", "565>bgra", "palette", "key16 cpp", "key16 sse", "key32 cpp", "key32 sse" };
+
+	const DOUBLE duration = 0.2;
+
+	struct Frame
+	{
+		uint32_t width;
+		uint32_t height;
+		uint32_t* pixels;
+		uint32_t* target;
+		uint16_t* words;
+		uint16_t* wordTarget;
+		uint8_t* indices;
+		uint32_t palette[256];
+	};
+
+	// Returns the bytes written by one call
+	uint32_t Call(Frame* frame, DWORD kernel)
+	{
+		uint32_t count = frame->width * frame->height;
+		switch (kernel)
+		{
+		case 0:
+			SwapRedBlue(frame->pixels, frame->target, count);
+			return count * sizeof(uint32_t);
+
+		case 1:
+			Rgb565ToRgba(frame->words, frame->target, count);
+			return count * sizeof(uint32_t);
+
+		case 2:
+			Rgb565ToBgra(frame->words, frame->target, count);
+			return count * sizeof(uint32_t);
+
+		case 3:
+			ExpandPalette(frame->indices, frame->target, count, frame->palette);
+			return count * sizeof(uint32_t);
+
+		case 4:
+			CPP::KeyBlit(frame->words, frame->width, frame->wordTarget, frame->width, frame->width, frame->height, 0);
+			return count * sizeof(uint16_t);
+
+		case 5:
+			SSE::KeyBlit(frame->words, frame->width, frame->wordTarget, frame->width, frame->width, frame->height, 0);
+			return count * sizeof(uint16_t);
+
+		case 6:
+			CPP::KeyBlit(frame->pixels, frame->width, frame->target, frame->width, frame->width, frame->height, 0);
+			return count * sizeof(uint32_t);
+
+		default:
+			SSE::KeyBlit(frame->pixels, frame->width, frame->target, frame->width, frame->width, frame->height, 0);
+			return count * sizeof(uint32_t);
+		}
+	}
+
+	VOID Run(uint32_t width, uint32_t height)
+	{
+		Frame frame;
+		frame.width = width;
+		frame.height = height;
+
+		uint32_t count = width * height;
+		frame.pixels = (uint32_t*)AlignedAlloc(count * sizeof(uint32_t));
+		frame.target = (uint32_t*)AlignedAlloc(count * sizeof(uint32_t));
+		frame.words = (uint16_t*)AlignedAlloc(count * sizeof(uint16_t));
+		frame.wordTarget = (uint16_t*)AlignedAlloc(count * sizeof(uint16_t));
+		frame.indices = (uint8_t*)AlignedAlloc(count);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			uint32_t value = i * 2654435761u;
+			frame.pixels[i] = value & 3 ? value : 0;
+			frame.words[i] = value & 3 ? uint16_t(value >> 16) : 0;
+			frame.indices[i] = uint8_t(value >> 24);
+		}
+
+		for (DWORD i = 0; i < 256; ++i)
+			frame.palette[i] = i * 0x010101;
+
+		printf("%4ux%-4u", width, height);
+		for (DWORD k = 0; k < sizeof(kernels) / sizeof(*kernels); ++k)
+		{
+			DOUBLE bytes = 0.0;
+			DOUBLE start = Test::Seconds(), elapsed;
+			do
+				bytes += Call(&frame, k);
+			while ((elapsed = Test::Seconds() - start) < duration);
+
+			printf("  %s %6.2f GB/s", kernels[k], bytes / elapsed / 1e9);
+		}
+
+		printf("\n");
+
+		AlignedFree(frame.pixels);
+		AlignedFree(frame.target);
+		AlignedFree(frame.words);
+		AlignedFree(frame.wordTarget);
+		AlignedFree(frame.indices);
+	}
+}
+
+INT main(INT argc, CHAR** argv)
+{
+	if (argc == 3)
+		PixelBench::Run(atoi(argv[1]), atoi(argv[2]));
+	else if (argc == 1)
+	{
+		const uint32_t sizes[][2] = { { 640, 480 }, { 800, 600 }, { 1920, 1080 }, { 3840, 2160 } };
+		for (DWORD i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i)
+			PixelBench::Run(sizes[i][0], sizes[i][1]);
+	}
+	else
+	{
+		fprintf(stderr, "Usage: %s [<width> <height>]\n", argv[0]);
+		return 2;
+	}
+
+	return 0;
+}
@@ -0,0 +1,282 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include <dirent.h>
+#include "Recorder.h"
+#include "Config.h"
+
+ConfigItems config;
+
+namespace RecorderTest
+{
+	CHAR dir[MAX_PATH];
+
+	struct Track
+	{
+		DWORD index;
+		DWORD width;
+		DWORD height;
+		DWORD pitch;
+		BOOL isTrue;
+		GLenum format;
+		DWORD* source;
+		BYTE** frames;
+	};
+
+	DWORD seed = 1;
+
+	DWORD Next()
+	{
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	VOID Snapshot(Track* track, DWORD frame)
+	{
+		BYTE* dst = (BYTE*)malloc(track->width * track->height * 3);
+		track->frames[frame] = dst;
+
+		for (DWORD y = 0; y < track->height; ++y)
+		{
+			if (track->isTrue)
+			{
+				const BYTE* src = (const BYTE*)(track->source + y * track->pitch);
+				for (DWORD x = 0; x < track->width; ++x, src += 4)
+				{
+					if (track->format == GL_BGRA_EXT)
+					{
+						*dst++ = src[2];
+						*dst++ = src[1];
+						*dst++ = src[0];
+					}
+					else
+					{
+						*dst++ = src[0];
+						*dst++ = src[1];
+						*dst++ = src[2];
+					}
+				}
+			}
+			else
+			{
+				const WORD* src = (const WORD*)(track->source + y * track->pitch);
+				for (DWORD x = 0; x < track->width; ++x)
+				{
+					WORD c = *src++;
+					*dst++ = BYTE(((c >> 11) & 0x1F) * 255 / 31);
+					*dst++ = BYTE(((c >> 5) & 0x3F) * 255 / 63);
+					*dst++ = BYTE((c & 0x1F) * 255 / 31);
+				}
+			}
+		}
+	}
+
+	VOID Open(Track* track, DWORD width, DWORD height, BOOL isTrue, GLenum format, DWORD frames)
+	{
+		track->width = width;
+		track->height = height;
+		track->isTrue = isTrue;
+		track->format = format;
+		track->pitch = isTrue ? width : (width + 1) >> 1;
+		track->source = (DWORD*)calloc(track->pitch * height, sizeof(DWORD));
+		track->frames = (BYTE**)calloc(frames, sizeof(BYTE*));
+		track->index = Recorder::Open(width, height, isTrue, format, isTrue ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT_5_6_5);
+	}
+
+	VOID Paint(Track* track, DWORD frame)
+	{
+		DWORD count = frame ? Next() % 4 : 1;
+		while (count--)
+		{
+			Rect rect;
+			if (!frame)
+			{
+				rect.x = 0;
+				rect.y = 0;
+				rect.width = track->width;
+				rect.height = track->height;
+			}
+			else
+			{
+				rect.x = Next() % track->width;
+				rect.y = Next() % track->height;
+				rect.width = 1 + Next() % (track->width - rect.x);
+				rect.height = 1 + Next() % (track->height - rect.y);
+				if (!track->isTrue)
+				{
+					rect.x &= ~1;
+					rect.width = (rect.width + 1) & ~1;
+					if (rect.x + rect.width > (INT)track->width)
+						rect.width = track->width - rect.x;
+				}
+			}
+
+			for (INT y = rect.y; y < rect.y + rect.height; ++y)
+				for (INT x = rect.x; x < rect.x + rect.width; ++x)
+				{
+					if (track->isTrue)
+						track->source[y * track->pitch + x] = Next();
+					else
+						((WORD*)(track->source + y * track->pitch))[x] = WORD(Next());
+				}
+
+			const VOID* ptr = track->isTrue
+				? (const VOID*)(track->source + rect.y * track->pitch + rect.x)
+				: (const VOID*)((const WORD*)(track->source + rect.y * track->pitch) + rect.x);
+
+			Recorder::AddRect(track->index, &rect, ptr, track->pitch);
+		}
+
+		Rect empty = { 3, 4, 5, 0 };
+		Recorder::AddRect(track->index, &empty, track->source, track->pitch);
+		Rect thin = { 3, 4, 0, 5 };
+		Recorder::AddRect(track->index, &thin, track->source, track->pitch);
+
+		CHECK(!Recorder::Commit(track->index));
+		Snapshot(track, frame);
+	}
+
+	BOOL FindRecord(CHAR* path)
+	{
+		CHAR records[MAX_PATH];
+		StrPrint(records, "%s/%s", dir, RECORD_DIR);
+
+		BOOL isFound = FALSE;
+		DIR* handle = opendir(records);
+		if (handle)
+		{
+			dirent* entry;
+			while ((entry = readdir(handle)) != NULL)
+			{
+				const CHAR* dot = StrLastChar(entry->d_name, '.');
+				if (dot && !StrCompare(dot, ".hrec"))
+				{
+					StrPrint(path, "%s/%s", records, entry->d_name);
+					isFound = TRUE;
+				}
+			}
+
+			closedir(handle);
+		}
+
+		return isFound;
+	}
+
+	BOOL Compare(Track* track, DWORD frame, const CHAR* ppm)
+	{
+		DWORD size;
+		BYTE* data = Test::ReadAll(ppm, &size);
+		if (!data)
+			return FALSE;
+
+		CHAR header[64];
+		INT length = StrPrint(header, "P6\n%u %u\n255\n", track->width, track->height);
+		DWORD pixels = track->width * track->height * 3;
+
+		BOOL isEqual = size == length + pixels
+			&& !MemoryCompare(data, header, length)
+			&& !MemoryCompare(data + length, track->frames[frame], pixels);
+
+		free(data);
+		return isEqual;
+	}
+
+	VOID TestRoundTrip()
+	{
+		const DWORD frames = 40;
+
+		Recorder::Create();
+
+		Track tracks[3];
+		Open(&tracks[0], 64, 48, TRUE, GL_RGBA, frames);
+		Open(&tracks[1], 40, 30, FALSE, GL_RGB, frames);
+		Open(&tracks[2], 33, 17, TRUE, GL_BGRA_EXT, frames);
+		CHECK(tracks[0].index && tracks[1].index && tracks[2].index);
+
+		for (DWORD i = 0; i < frames; ++i)
+			for (DWORD t = 0; t < 3; ++t)
+				Paint(&tracks[t], i);
+
+		Recorder::Release();
+
+		CHAR record[MAX_PATH];
+		CHECK(FindRecord(record));
+
+		const CHAR* decoder = getenv("RECORD_DECODER");
+		CHECK(decoder != NULL);
+		if (decoder)
+		{
+			CHAR command[MAX_PATH * 3];
+			StrPrint(command, "%s %s > /dev/null", decoder, record);
+			CHECK(system(command) == 0);
+
+			CHAR out[MAX_PATH];
+			StrPrint(out, "%s/frames", dir);
+			StrPrint(command, "%s %s -ppm %s", decoder, record, out);
+			CHECK(system(command) == 0);
+
+			DWORD mismatches = 0;
+			for (DWORD t = 0; t < 3; ++t)
+				for (DWORD i = 0; i < frames; ++i)
+				{
+					CHAR ppm[MAX_PATH * 2];
+					StrPrint(ppm, "%s/track%03u_%06u.ppm", out, tracks[t].index, i);
+					mismatches += !Compare(&tracks[t], i, ppm);
+				}
+
+			CHECK(mismatches == 0);
+
+			CHAR header[64];
+			INT skip = StrPrint(header, "P6\n%u %u\n255\n", tracks[0].width, tracks[0].height);
+			StrPrint(command, "%s %s -raw -track %u 2> /dev/null | cmp -s -n %u -i 0:%d - %s/track%03u_%06u.ppm",
+				decoder, record, tracks[0].index, tracks[0].width * tracks[0].height * 3, skip, out, tracks[0].index, 0);
+			CHECK(system(command) == 0);
+		}
+
+		for (DWORD t = 0; t < 3; ++t)
+		{
+			for (DWORD i = 0; i < frames; ++i)
+				free(tracks[t].frames[i]);
+
+			free(tracks[t].frames);
+			free(tracks[t].source);
+		}
+	}
+}
+
+INT main()
+{
+	Test::TempDir(RecorderTest::dir, "recorder");
+	StrPrint(config.file, "%s\\config.ini", RecorderTest::dir);
+	config.record = TRUE;
+
+	VOID(*tests[])() = {
+		RecorderTest::TestRoundTrip
+	};
+
+	INT result = Test::Run("RecorderTest", tests, sizeof(tests) / sizeof(*tests));
+	Test::RemoveDir(RecorderTest::dir);
+	return result;
+}
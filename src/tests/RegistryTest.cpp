@@ -0,0 +1,201 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Ini.h"
+#include "Registry.h"
+#include "Config.h"
+
+ConfigItems config;
+
+namespace RegistryTest
+{
+	CHAR dir[MAX_PATH];
+	CHAR path[MAX_PATH];
+
+	VOID Open(const CHAR* text)
+	{
+		FILE* file = fopen(path, "wb");
+		fputs("[Application]\r\n", file);
+		fputs(text, file);
+		fclose(file);
+
+		Ini::Load(path);
+	}
+
+	BOOL IsText(const CHAR* name, const CHAR* expected)
+	{
+		CHAR text[64];
+		Ini::Get(CONFIG_APP, name, "", text, sizeof(text));
+		return !StrCompare(text, expected);
+	}
+
+	VOID TestLegacy()
+	{
+		Open("Player Name=123\r\nShow Intro=1\r\nLast Map=abcd\r\nVolume=-20\r\n");
+
+		CHAR text[64];
+		DWORD type, size = sizeof(text);
+		CHECK(Registry::Query("Player Name", &type, (BYTE*)text, &size) == ERROR_SUCCESS);
+		CHECK(type == REG_SZ && size == 4 && !StrCompare(text, "123"));
+
+		size = 0;
+		CHECK(Registry::Query("Show Intro", &type, NULL, &size) == ERROR_SUCCESS);
+		CHECK(type == REG_SZ && size == 2);
+
+		DWORD number = 0;
+		size = sizeof(number);
+		CHECK(Registry::Query("Show Intro", &type, (BYTE*)&number, &size) == ERROR_SUCCESS);
+		CHECK(type == REG_DWORD && size == sizeof(DWORD) && number == 1);
+
+		size = sizeof(number);
+		CHECK(Registry::Query("Volume", &type, (BYTE*)&number, &size) == ERROR_SUCCESS);
+		CHECK(type == REG_DWORD && (INT)number == -20);
+
+		size = sizeof(number);
+		CHECK(Registry::Query("Last Map", &type, (BYTE*)text, &size) == ERROR_MORE_DATA);
+		CHECK(type == REG_SZ && size == 5);
+
+		size = sizeof(text);
+		CHECK(Registry::Query("Missing", &type, (BYTE*)text, &size) == ERROR_FILE_NOT_FOUND);
+
+		Ini::Stop();
+		Ini::Release();
+	}
+
+	VOID TestTyped()
+	{
+		Open("Count=dword:-3\r\nCode=sz:4242\r\nKey=hex:01,ff,7a\r\nLabel=sz:hex:x\r\n");
+
+		BYTE data[64];
+		DWORD type, size = sizeof(data);
+		CHECK(Registry::Query("Count", &type, data, &size) == ERROR_SUCCESS);
+		CHECK(type == REG_DWORD && size == sizeof(DWORD) && *(INT*)data == -3);
+
+		size = sizeof(DWORD);
+		CHECK(Registry::Query("Code", &type, data, &size) == ERROR_MORE_DATA);
+		CHECK(type == REG_SZ && size == 5);
+
+		size = 0;
+		CHECK(Registry::Query("Key", &type, NULL, &size) == ERROR_SUCCESS);
+		CHECK(type == REG_BINARY && size == 3);
+		CHECK(Registry::Query("Key", &type, data, &size) == ERROR_SUCCESS);
+		CHECK(data[0] == 0x01 && data[1] == 0xFF && data[2] == 0x7A);
+
+		size = sizeof(data);
+		CHECK(Registry::Query("Label", &type, data, &size) == ERROR_SUCCESS);
+		CHECK(type == REG_SZ && !StrCompare((CHAR*)data, "hex:x"));
+
+		Ini::Stop();
+		Ini::Release();
+	}
+
+	VOID TestWrite()
+	{
+		Open("");
+
+		INT number = 7;
+		Registry::Set("Speed", REG_DWORD, (BYTE*)&number, sizeof(number));
+		Registry::Set("Hero", REG_SZ, (const BYTE*)"88", 3);
+		Registry::Set("Town", REG_SZ, (const BYTE*)"Castle", 7);
+		Registry::Set("Tag", REG_SZ, (const BYTE*)"dword:1", 8);
+		Registry::Set("Empty", REG_SZ, NULL, 0);
+
+		BYTE blob[3] = { 0x00, 0x10, 0xAB };
+		Registry::Set("Blob", REG_BINARY, blob, sizeof(blob));
+
+		CHECK(IsText("Speed", "7"));
+		CHECK(Ini::Get(CONFIG_APP, "Speed", 0) == 7);
+		CHECK(IsText("Hero", "sz:88"));
+		CHECK(IsText("Town", "Castle"));
+		CHECK(IsText("Tag", "sz:dword:1"));
+		CHECK(IsText("Empty", ""));
+		CHECK(IsText("Blob", "hex:00,10,ab"));
+
+		number = -12;
+		Registry::Set("Speed", REG_DWORD, (BYTE*)&number, sizeof(number));
+		CHECK(Ini::Get(CONFIG_APP, "Speed", 0) == -12);
+
+		DWORD type, size = sizeof(number);
+		CHECK(Registry::Query("Speed", &type, (BYTE*)&number, &size) == ERROR_SUCCESS);
+		CHECK(type == REG_DWORD && number == -12);
+
+		Ini::Stop();
+		Ini::Release();
+	}
+
+	VOID TestLargeBinary()
+	{
+		const DWORD count = 4000;
+		BYTE* blob = (BYTE*)malloc(count);
+		for (DWORD i = 0; i < count; ++i)
+			blob[i] = BYTE(i * 7 + (i >> 8));
+
+		CHAR* text = (CHAR*)malloc(count * 3 + 64);
+		CHAR* ptr = text + sprintf(text, "Saved=hex:");
+		for (DWORD i = 0; i < count; ++i)
+			ptr += sprintf(ptr, i ? ",%02x" : "%02x", blob[i]);
+		StrCopy(ptr, "\r\n");
+
+		Open(text);
+
+		BYTE* data = (BYTE*)malloc(count);
+		DWORD type, size = count;
+		CHECK(Registry::Query("Saved", &type, data, &size) == ERROR_SUCCESS);
+		CHECK(type == REG_BINARY && size == count && !MemoryCompare(data, blob, count));
+
+		blob[count - 1] ^= 0xFF;
+		Registry::Set("Copy", REG_BINARY, blob, count);
+
+		DWORD length = count * 3 + 8;
+		CHAR* written = (CHAR*)malloc(length);
+		CHECK(Ini::Get(CONFIG_APP, "Copy", "", written, length) == count * 3 + 3);
+
+		Ini::Stop();
+		Ini::Release();
+		free(written);
+		free(data);
+		free(text);
+		free(blob);
+	}
+}
+
+INT main()
+{
+	Test::TempDir(RegistryTest::dir, "registry");
+	StrPrint(RegistryTest::path, "%s/config.ini", RegistryTest::dir);
+
+	Registry::Create();
+
+	VOID(*tests[])() = {
+		RegistryTest::TestLegacy,
+		RegistryTest::TestTyped,
+		RegistryTest::TestWrite,
+		RegistryTest::TestLargeBinary
+	};
+
+	INT result = Test::Run("RegistryTest", tests, sizeof(tests) / sizeof(*tests));
+	Test::RemoveDir(RegistryTest::dir);
+	return result;
+}
@@ -0,0 +1,558 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "GLib.h"
+#include "Egl.h"
+#include "ShaderGroup.h"
+#include "Resampler.h"
+#include "Resource.h"
+#include "Config.h"
+
+ConfigItems config;
+
+// The single-pass xBRZ shaders from before the edge classification pass, kept in tests/glsl as the reference
+#define IDR_REFERENCE_XBRZ_2X 1002
+
+namespace GL
+{
+	struct ShaderFile
+	{
+		DWORD name;
+		const CHAR* path;
+	};
+
+	const ShaderFile shaderFiles[] = {
+		{ IDR_LINEAR_VERTEX, "../glsl/linear/vertex.glsl" },
+		{ IDR_CUBIC_FRAGMENT, "../glsl/cubic/fragment.glsl" },
+		{ IDR_LANCZOS_FRAGMENT, "../glsl/lanczos/fragment.glsl" },
+		{ IDR_CUBIC_FRAGMENT_HORIZONTAL, "../glsl/cubic/fragment_horizontal.glsl" },
+		{ IDR_CUBIC_FRAGMENT_VERTICAL, "../glsl/cubic/fragment_vertical.glsl" },
+		{ IDR_LANCZOS_FRAGMENT_HORIZONTAL, "../glsl/lanczos/fragment_horizontal.glsl" },
+		{ IDR_LANCZOS_FRAGMENT_VERTICAL, "../glsl/lanczos/fragment_vertical.glsl" },
+		{ IDR_XBRZ_FRAGMENT_2X, "../glsl/xbrz/fragment_2x.glsl" },
+		{ IDR_XBRZ_FRAGMENT_3X, "../glsl/xbrz/fragment_3x.glsl" },
+		{ IDR_XBRZ_FRAGMENT_4X, "../glsl/xbrz/fragment_4x.glsl" },
+		{ IDR_XBRZ_FRAGMENT_5X, "../glsl/xbrz/fragment_5x.glsl" },
+		{ IDR_XBRZ_FRAGMENT_6X, "../glsl/xbrz/fragment_6x.glsl" },
+		{ IDR_XBRZ_FRAGMENT_EDGE, "../glsl/xbrz/fragment_edge.glsl" },
+		{ IDR_REFERENCE_XBRZ_2X, "glsl/xbrz/fragment_2x.glsl" },
+		{ IDR_REFERENCE_XBRZ_2X + 1, "glsl/xbrz/fragment_3x.glsl" },
+		{ IDR_REFERENCE_XBRZ_2X + 2, "glsl/xbrz/fragment_4x.glsl" },
+		{ IDR_REFERENCE_XBRZ_2X + 3, "glsl/xbrz/fragment_5x.glsl" },
+		{ IDR_REFERENCE_XBRZ_2X + 4, "glsl/xbrz/fragment_6x.glsl" }
+	};
+
+	// The module resources are read from the glsl folders, otherwise the same as in GLib.cpp
+	GLuint CompileShaderSource(DWORD name, CHAR* prefix, GLenum type)
+	{
+		const CHAR* path = NULL;
+		for (DWORD i = 0; i < sizeof(shaderFiles) / sizeof(*shaderFiles); ++i)
+			if (shaderFiles[i].name == name)
+				path = shaderFiles[i].path;
+
+		DWORD length = 0;
+		BYTE* data = path ? Test::ReadAll(path, &length) : NULL;
+		CHECK(data != NULL);
+
+		DWORD pre = StrLength(prefix);
+		CHAR* source = (CHAR*)MemoryAlloc(pre + length + 1);
+		MemoryCopy(source, prefix, pre);
+		if (data)
+			MemoryCopy(source + pre, data, length);
+		source[pre + length] = NULL;
+		free(data);
+
+		GLuint shader = GLCreateShader(type);
+		const GLchar* srcData[] = { source };
+		GLShaderSource(shader, 1, srcData, NULL);
+		MemoryFree(source);
+
+		GLint result;
+		GLCompileShader(shader);
+		GLGetShaderiv(shader, GL_COMPILE_STATUS, &result);
+		CHECK(result);
+		if (!result)
+		{
+			CHAR log[1024];
+			GLGetShaderInfoLog(shader, sizeof(log), NULL, log);
+			printf("%s: %s\n", path, log);
+		}
+
+		return shader;
+	}
+}
+
+namespace ShaderTest
+{
+	struct Target
+	{
+		GLuint texId;
+		GLuint fboId;
+		DWORD width;
+		DWORD height;
+	};
+
+	DWORD seed = 1;
+
+	DWORD Next()
+	{
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	VOID SetParameters(GLint filter)
+	{
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+		GLTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	}
+
+	// Render target standing in for the window, cleared so both pipelines start from the same pixels
+	VOID Open(Target* target, DWORD width, DWORD height)
+	{
+		target->width = width;
+		target->height = height;
+
+		GLGenTextures(1, &target->texId);
+		GLBindTexture(GL_TEXTURE_2D, target->texId);
+		SetParameters(GL_NEAREST);
+		GLTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, GL_NONE, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+		GLGenFramebuffers(1, &target->fboId);
+		GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, target->fboId);
+		GLFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target->texId, 0);
+
+		GLViewport(0, 0, width, height);
+		GLClear(GL_COLOR_BUFFER_BIT);
+	}
+
+	VOID Close(Target* target)
+	{
+		GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, NULL);
+		GLDeleteFramebuffers(1, &target->fboId);
+		GLDeleteTextures(1, &target->texId);
+	}
+
+	VOID Bind(Target* target)
+	{
+		GLBindFramebuffer(GL_DRAW_FRAMEBUFFER, target->fboId);
+		GLViewport(0, 0, target->width, target->height);
+	}
+
+	DWORD* Read(Target* target)
+	{
+		DWORD* pixels = (DWORD*)MemoryAlloc(target->width * target->height * sizeof(DWORD));
+		GLActiveTexture(GL_TEXTURE0);
+		GLBindTexture(GL_TEXTURE_2D, target->texId);
+		GLGetTexImage(GL_TEXTURE_2D, 0, GL_BGRA_EXT, GL_UNSIGNED_BYTE, pixels);
+		return pixels;
+	}
+
+	DWORD Difference(DWORD a, DWORD b)
+	{
+		DWORD max = 0;
+		for (DWORD i = 0; i < 32; i += 8)
+		{
+			INT diff = INT((a >> i) & 0xFF) - INT((b >> i) & 0xFF);
+			DWORD value = diff < 0 ? -diff : diff;
+			if (max < value)
+				max = value;
+		}
+
+		return max;
+	}
+
+	// Same quads and projection as RenderNew: 0 source, 4 flipped FBO, 8 edge pass, 12 and 16 the separable passes
+	VOID SetQuads(DWORD width, DWORD height, DWORD maxTexSize)
+	{
+		FLOAT texWidth = width == maxTexSize ? 1.0f : (FLOAT)width / maxTexSize;
+		FLOAT texHeight = height == maxTexSize ? 1.0f : (FLOAT)height / maxTexSize;
+
+		FLOAT buffer[20][8] = {
+			{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+			{ (FLOAT)width, 0.0f, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
+			{ (FLOAT)width, (FLOAT)height, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
+			{ 0.0f, (FLOAT)height, 0.0f, 1.0f, 0.0f, texHeight, 0.0f, 0.0f },
+
+			{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+			{ (FLOAT)width, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
+			{ (FLOAT)width, (FLOAT)height, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, (FLOAT)height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+
+			{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, texHeight, 0.0f, 0.0f },
+			{ (FLOAT)width, 0.0f, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
+			{ (FLOAT)width, (FLOAT)height, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, (FLOAT)height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+
+			{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, texHeight, 0.0f, 0.0f },
+			{ (FLOAT)width, 0.0f, 0.0f, 1.0f, texWidth, texHeight, 0.0f, 0.0f },
+			{ (FLOAT)width, (FLOAT)height, 0.0f, 1.0f, texWidth, 0.0f, 0.0f, 0.0f },
+			{ 0.0f, (FLOAT)height, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+
+			{ 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+			{ (FLOAT)width, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+			{ (FLOAT)width, (FLOAT)height, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f },
+			{ 0.0f, (FLOAT)height, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f }
+		};
+
+		FLOAT mvp[4][4] = {
+			{ FLOAT(2.0f / width), 0.0f, 0.0f, 0.0f },
+			{ 0.0f, FLOAT(-2.0f / height), 0.0f, 0.0f },
+			{ 0.0f, 0.0f, 2.0f, 0.0f },
+			{ -1.0f, 1.0f, -1.0f, 1.0f }
+		};
+
+		for (DWORD i = 0; i < 20; ++i)
+		{
+			FLOAT* vector = &buffer[i][0];
+			for (DWORD j = 0; j < 4; ++j)
+			{
+				FLOAT sum = 0.0f;
+				for (DWORD v = 0; v < 4; ++v)
+					sum += mvp[v][j] * vector[v];
+
+				vector[j] = sum;
+			}
+		}
+
+		GLBufferData(GL_ARRAY_BUFFER, sizeof(buffer), buffer, GL_STATIC_DRAW);
+	}
+
+	// Flat tiles, shallow and steep lines, a gradient and scattered noise, so every xBRZ corner rule fires somewhere
+	VOID Paint(DWORD* frame, DWORD width, DWORD height)
+	{
+		for (DWORD y = 0; y < height; ++y)
+			for (DWORD x = 0; x < width; ++x)
+			{
+				DWORD color;
+				if ((x + y * 3) % 29 < 2)
+					color = 0xFF202020;
+				else if ((x * 3 + y) % 31 == 0)
+					color = 0xFFE0C040;
+				else if (((x >> 4) + (y >> 4)) & 1)
+					color = 0xFF3060A0;
+				else
+					color = 0xFF000040 | ((x * 255 / width) << 16) | ((y * 255 / height) << 8);
+
+				if (!(Next() % 41))
+					color = 0xFF000000 | Next();
+
+				frame[y * width + x] = color;
+			}
+	}
+
+	// A sprite moving over the frame and a few single pixels, the way a game damages its frame between presents
+	VOID Move(DWORD* frame, DWORD width, DWORD height, DWORD step)
+	{
+		DWORD left = 7 + step * 13;
+		DWORD top = 5 + step * 9;
+		for (DWORD y = top; y < top + 24 && y < height; ++y)
+			for (DWORD x = left; x < left + 16 && x < width; ++x)
+				frame[y * width + x] = (x - left + y - top) & 4 ? 0xFFF0F0F0 : 0xFF802010;
+
+		for (DWORD i = 0; i < 20; ++i)
+			frame[Next() % (width * height)] = 0xFF000000 | Next();
+	}
+
+	VOID Upload(GLuint texId, const DWORD* frame, DWORD width, DWORD height)
+	{
+		GLBindTexture(GL_TEXTURE_2D, texId);
+		GLTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_BGRA_EXT, GL_UNSIGNED_BYTE, frame);
+	}
+
+	// Runs a sequence of partially changed frames through the single-pass shader and through the edge and
+	// scaling passes as RenderNew draws them, the outputs must be identical after every frame
+	VOID TestXbrz()
+	{
+		const DWORD width = 160;
+		const DWORD height = 120;
+		const DWORD maxTexSize = 256;
+		const DWORD texSize = (maxTexSize & 0xFFFF) | (maxTexSize << 16);
+		const DWORD frames = 5;
+
+		SetQuads(width, height, maxTexSize);
+
+		DWORD* frame = (DWORD*)MemoryAlloc(width * height * sizeof(DWORD));
+		DWORD* empty = (DWORD*)MemoryAlloc(maxTexSize * maxTexSize * sizeof(DWORD));
+
+		GLuint texIds[2];
+		GLGenTextures(2, texIds);
+		for (DWORD i = 0; i < 2; ++i)
+		{
+			GLBindTexture(GL_TEXTURE_2D, texIds[i]);
+			SetParameters(GL_LINEAR);
+			GLTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, maxTexSize, maxTexSize, GL_NONE, GL_BGRA_EXT, GL_UNSIGNED_BYTE, NULL);
+		}
+
+		Target edge;
+		Open(&edge, width, height);
+
+		for (DWORD scale = 2; scale <= 6; ++scale)
+		{
+			ShaderGroup* reference = new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_REFERENCE_XBRZ_2X + scale - 2, SHADER_TEXSIZE);
+			ShaderGroup* classify = new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_EDGE, SHADER_TEXSIZE);
+			ShaderGroup* upscale = new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, IDR_XBRZ_FRAGMENT_2X + scale - 2, SHADER_TEXSIZE);
+
+			// Both source textures start out empty as after the FBO is created, the edge texture holds garbage
+			MemoryZero(empty, maxTexSize * maxTexSize * sizeof(DWORD));
+			Upload(texIds[0], empty, maxTexSize, maxTexSize);
+			Upload(texIds[1], empty, maxTexSize, maxTexSize);
+
+			for (DWORD i = 0; i < width * height; ++i)
+				empty[i] = Next();
+			Upload(edge.texId, empty, width, height);
+
+			GLActiveTexture(GL_TEXTURE2);
+			GLBindTexture(GL_TEXTURE_2D, edge.texId);
+			GLActiveTexture(GL_TEXTURE0);
+
+			Target single, split;
+			Open(&single, width * scale, height * scale);
+			Open(&split, width * scale, height * scale);
+
+			DWORD mismatches = 0;
+			BOOL activeIndex = TRUE;
+			Paint(frame, width, height);
+			for (DWORD step = 0; step < frames; ++step)
+			{
+				// The last frame repeats the previous one, every pixel is discarded and the output must stay
+				if (step && step < frames - 1)
+					Move(frame, width, height, step);
+
+				GLActiveTexture(GL_TEXTURE1);
+				GLBindTexture(GL_TEXTURE_2D, texIds[activeIndex]);
+				activeIndex = !activeIndex;
+
+				GLActiveTexture(GL_TEXTURE0);
+				Upload(texIds[activeIndex], frame, width, height);
+
+				Bind(&single);
+				reference->Use(texSize);
+				GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+				Bind(&edge);
+				classify->Use(texSize);
+				GLDrawArrays(GL_TRIANGLE_FAN, 8, 4);
+
+				Bind(&split);
+				upscale->Use(texSize);
+				GLDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+				DWORD* expected = Read(&single);
+				DWORD* actual = Read(&split);
+				for (DWORD i = 0; i < single.width * single.height; ++i)
+					mismatches += expected[i] != actual[i];
+
+				MemoryFree(expected);
+				MemoryFree(actual);
+			}
+
+			printf("xBRZ %ux: %u pixels differ over %u frames\n", scale, mismatches, frames);
+			CHECK(mismatches == 0);
+
+			Close(&single);
+			Close(&split);
+
+			delete reference;
+			delete classify;
+			delete upscale;
+		}
+
+		Close(&edge);
+		GLDeleteTextures(2, texIds);
+
+		MemoryFree(empty);
+		MemoryFree(frame);
+	}
+
+	struct Geometry
+	{
+		DWORD width;
+		DWORD height;
+		DWORD outWidth;
+		DWORD outHeight;
+	};
+
+	// Up- and downscaled output, with the frame smaller than its texture and filling it
+	const Geometry geometries[] = {
+		{ 200, 150, 333, 250 },
+		{ 200, 150, 150, 112 },
+		{ 256, 256, 400, 400 }
+	};
+
+	// Brightness, saturation and hue shifted off the defaults so the vertical pass builds its levels variant
+	Adjustment GetLevels()
+	{
+		Adjustment colors = defaultColors;
+		colors.satHue.hueShift = 0.55f;
+		colors.satHue.saturation = 0.65f;
+		colors.gamma.rgb = 0.6f;
+		colors.input.right.rgb = 0.9f;
+		colors.output.left.rgb = 0.05f;
+		return colors;
+	}
+
+	// Compares the separable passes with the single-pass kernel. The source is either the frame in its
+	// power-of-two texture (direct) or an exactly sized upscaled texture (upscaled), as in RenderNew
+	DWORD Compare(InterpolationFilter filter, const Geometry* geometry, BOOL isUpscaled, BOOL isLevels)
+	{
+		DWORD maxTexSize = 256;
+		DWORD sourceWidth = isUpscaled ? geometry->width : maxTexSize;
+		DWORD sourceHeight = isUpscaled ? geometry->height : maxTexSize;
+		DWORD texSize = (sourceWidth & 0xFFFF) | (sourceHeight << 16);
+
+		SetQuads(geometry->width, geometry->height, maxTexSize);
+
+		Adjustment colors = isLevels ? GetLevels() : defaultColors;
+		config.colors.current = &colors;
+
+		BOOL isCubic = filter == InterpolateCubic;
+		ShaderGroup* single = new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, isCubic ? IDR_CUBIC_FRAGMENT : IDR_LANCZOS_FRAGMENT, SHADER_TEXSIZE | SHADER_LEVELS);
+		ShaderGroup* horizontal = new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, isCubic ? IDR_CUBIC_FRAGMENT_HORIZONTAL : IDR_LANCZOS_FRAGMENT_HORIZONTAL, SHADER_TEXSIZE);
+		ShaderGroup* vertical = new ShaderGroup(GLSL_VER_1_30, IDR_LINEAR_VERTEX, isCubic ? IDR_CUBIC_FRAGMENT_VERTICAL : IDR_LANCZOS_FRAGMENT_VERTICAL, SHADER_TEXSIZE | SHADER_LEVELS);
+		Resampler* resampler = new Resampler();
+
+		DWORD* frame = (DWORD*)MemoryAlloc(geometry->width * geometry->height * sizeof(DWORD));
+		Paint(frame, geometry->width, geometry->height);
+
+		GLuint texId;
+		GLGenTextures(1, &texId);
+		GLActiveTexture(GL_TEXTURE0);
+		GLBindTexture(GL_TEXTURE_2D, texId);
+		SetParameters(GL_NEAREST);
+		GLTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, sourceWidth, sourceHeight, GL_NONE, GL_BGRA_EXT, GL_UNSIGNED_BYTE, NULL);
+		Upload(texId, frame, geometry->width, geometry->height);
+
+		Target expected, actual;
+		Open(&expected, geometry->outWidth, geometry->outHeight);
+		Open(&actual, geometry->outWidth, geometry->outHeight);
+
+		DWORD first = isUpscaled ? 4 : 0;
+		GLBindTexture(GL_TEXTURE_2D, texId);
+		Bind(&expected);
+		single->Use(texSize);
+		GLDrawArrays(GL_TRIANGLE_FAN, first, 4);
+
+		resampler->Begin(filter, geometry->outWidth, geometry->height);
+		horizontal->Use(texSize);
+		GLDrawArrays(GL_TRIANGLE_FAN, isUpscaled ? 4 : 12, 4);
+
+		DWORD passSize = resampler->End();
+		Bind(&actual);
+		vertical->Use(passSize);
+		GLDrawArrays(GL_TRIANGLE_FAN, isUpscaled ? 4 : 16, 4);
+
+		// A frame smaller than its texture differs in the bottom rows only: the single pass reads rows past the
+		// frame there, the intermediate clamps to its last row. Rows within the widest kernel of either edge are skipped
+		BOOL isClamped = !isUpscaled && geometry->height != maxTexSize;
+
+		DWORD* expectedPixels = Read(&expected);
+		DWORD* actualPixels = Read(&actual);
+		DWORD max = 0;
+		for (DWORD y = 0; y < geometry->outHeight; ++y)
+		{
+			FLOAT source = (y + 0.5f) * geometry->height / geometry->outHeight;
+			if (isClamped && (source < 4.0f || source > geometry->height - 4.0f))
+				continue;
+
+			for (DWORD x = 0; x < geometry->outWidth; ++x)
+			{
+				DWORD diff = Difference(expectedPixels[y * geometry->outWidth + x], actualPixels[y * geometry->outWidth + x]);
+				if (max < diff)
+					max = diff;
+			}
+		}
+
+		MemoryFree(expectedPixels);
+		MemoryFree(actualPixels);
+
+		Close(&expected);
+		Close(&actual);
+		GLDeleteTextures(1, &texId);
+		MemoryFree(frame);
+
+		delete resampler;
+		delete single;
+		delete horizontal;
+		delete vertical;
+
+		printf("%s %s %ux%u -> %ux%u%s: %u LSB\n", isCubic ? "Cubic" : "Lanczos", isUpscaled ? "upscaled" : "direct",
+			geometry->width, geometry->height, geometry->outWidth, geometry->outHeight, isLevels ? " levels" : "", max);
+
+		return max;
+	}
+
+	// The half float intermediate rounds to 11 bits, a steep levels curve can stretch that into a second LSB
+	VOID TestSeparable()
+	{
+		for (DWORD i = 0; i < sizeof(geometries) / sizeof(*geometries); ++i)
+			for (DWORD mode = 0; mode < 8; ++mode)
+			{
+				InterpolationFilter filter = mode & 1 ? InterpolateLanczos : InterpolateCubic;
+				BOOL isLevels = mode & 4;
+				CHECK(Compare(filter, &geometries[i], mode & 2, isLevels) <= (isLevels ? 2 : 1));
+			}
+	}
+}
+
+INT main()
+{
+	if (!Egl::Create())
+	{
+		printf("ShaderTest: no surfaceless EGL context with desktop GL 3.0\n");
+		return 1;
+	}
+
+	printf("ShaderTest: %s\n", Egl::GetRenderer());
+
+	GLuint arrayName, bufferName;
+	GLGenVertexArrays(1, &arrayName);
+	GLBindVertexArray(arrayName);
+	GLGenBuffers(1, &bufferName);
+	GLBindBuffer(GL_ARRAY_BUFFER, bufferName);
+
+	GLEnableVertexAttribArray(0);
+	GLVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 32, (GLvoid*)0);
+	GLEnableVertexAttribArray(1);
+	GLVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 32, (GLvoid*)16);
+
+	GLClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+	VOID(*tests[])() = {
+		ShaderTest::TestXbrz,
+		ShaderTest::TestSeparable
+	};
+
+	INT result = Test::Run("ShaderTest", tests, sizeof(tests) / sizeof(*tests));
+
+	GLDeleteBuffers(1, &bufferName);
+	GLDeleteVertexArrays(1, &arrayName);
+	Egl::Release();
+
+	return result;
+}
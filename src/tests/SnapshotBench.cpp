@@ -0,0 +1,142 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include "Snapshot.h"
+#include "Config.h"
+
+ConfigItems config;
+
+namespace SnapshotBench
+{
+	CHAR dir[MAX_PATH];
+
+	VOID Fill(DWORD* dst, DWORD width, DWORD height)
+	{
+		DWORD seed = 1;
+		for (DWORD y = 0; y < height; ++y)
+			for (DWORD x = 0; x < width; ++x)
+			{
+				DWORD tile = (x / 32) * 7 + (y / 32) * 13;
+				DWORD px = tile % 5 ? 0x3C6E28 + ((x * y) % 9) * 0x010101 : (seed = seed * 1103515245 + 12345) >> 8;
+				if (y >= height - 48 || x >= width - 160)
+					px = 0x202020 + ((x + y) & 0x0F) * 0x010101;
+
+				*dst++ = px;
+			}
+	}
+
+	DWORD OutputSize(DWORD* count)
+	{
+		CHAR path[MAX_PATH];
+		StrPrint(path, "%s/%s", dir, SNAPSHOT_DIR);
+
+		DWORD total = 0;
+		*count = 0;
+
+		DIR* handle = opendir(path);
+		if (handle)
+		{
+			dirent* entry;
+			while ((entry = readdir(handle)) != NULL)
+			{
+				if (*entry->d_name == '.')
+					continue;
+
+				CHAR file[MAX_PATH * 2];
+				StrPrint(file, "%s/%s", path, entry->d_name);
+
+				struct stat st;
+				if (!stat(file, &st))
+				{
+					total += (DWORD)st.st_size;
+					++*count;
+				}
+			}
+
+			closedir(handle);
+		}
+
+		Test::RemoveDir(path);
+		return total;
+	}
+
+	VOID Run(SnapshotType type, const CHAR* name, DWORD width, DWORD height, DWORD frames)
+	{
+		DWORD size = width * height * sizeof(DWORD);
+		DWORD* source = (DWORD*)malloc(size);
+		Fill(source, width, height);
+
+		config.snapshot = type;
+		Snapshot::Create();
+
+		DOUBLE handoff = 0.0;
+		DOUBLE start = Test::Seconds();
+		for (DWORD i = 0; i < frames; ++i)
+		{
+			DOUBLE begin = Test::Seconds();
+			SnapshotFrame* frame = Snapshot::Acquire(width, height);
+			if (frame)
+			{
+				MemoryCopy(frame->data, source, size);
+				Snapshot::Commit(frame);
+			}
+			handoff += Test::Seconds() - begin;
+		}
+
+		Snapshot::Stop();
+		Snapshot::Release();
+		DOUBLE total = Test::Seconds() - start;
+
+		DWORD files;
+		DWORD written = OutputSize(&files);
+
+		printf("%-4s %4ux%-4u  handoff %6.3f ms/frame  encode %7.2f ms/frame  %7.1f MB/s  ratio %5.1f%%\n",
+			name, width, height,
+			handoff * 1000.0 / frames,
+			total > 0.0 ? total * 1000.0 / frames : 0.0,
+			total > 0.0 ? (DOUBLE)size * frames / total / (1 << 20) : 0.0,
+			files ? written * 100.0 / files / (width * height * 3) : 0.0);
+
+		free(source);
+	}
+}
+
+INT main(INT argc, CHAR** argv)
+{
+	DWORD frames = argc > 1 ? atoi(argv[1]) : 16;
+
+	Test::TempDir(SnapshotBench::dir, "snapshot");
+	StrPrint(config.file, "%s\\config.ini", SnapshotBench::dir);
+
+	SnapshotBench::Run(SnapshotPng, "png", 800, 600, frames);
+	SnapshotBench::Run(SnapshotQoi, "qoi", 800, 600, frames);
+	SnapshotBench::Run(SnapshotPng, "png", 1920, 1080, frames);
+	SnapshotBench::Run(SnapshotQoi, "qoi", 1920, 1080, frames);
+
+	Test::RemoveDir(SnapshotBench::dir);
+	return 0;
+}
@@ -0,0 +1,427 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "zlib.h"
+#include <dirent.h>
+#include "Snapshot.h"
+#include "Config.h"
+
+ConfigItems config;
+
+namespace SnapshotTest
+{
+	CHAR dir[MAX_PATH];
+
+	DWORD GetLong(const BYTE* src)
+	{
+		return (src[0] << 24) | (src[1] << 16) | (src[2] << 8) | src[3];
+	}
+
+	VOID Fill(SnapshotFrame* frame, DWORD seed)
+	{
+		DWORD* dst = frame->data;
+		for (DWORD y = 0; y < frame->height; ++y)
+			for (DWORD x = 0; x < frame->width; ++x)
+			{
+				DWORD px;
+				switch ((x / 16 + y / 16 + seed) % 4)
+				{
+				case 0:
+					px = 0x00204080;
+					break;
+				case 1:
+					px = (x * 3) | (y << 8) | ((x ^ y) << 16);
+					break;
+				case 2:
+					seed = seed * 1103515245 + 12345;
+					px = seed >> 8;
+					break;
+				default:
+					px = ((x + y) & 0xFF) * 0x010101;
+					break;
+				}
+
+				*dst++ = px | (seed << 24);
+			}
+	}
+
+	DWORD Expected(SnapshotFrame* frame, DWORD x, DWORD y)
+	{
+		DWORD row = frame->isFlipped ? frame->height - 1 - y : y;
+		return frame->data[row * frame->width + x] & 0x00FFFFFF;
+	}
+
+	BYTE* TakeFile(const CHAR* ext, DWORD* size)
+	{
+		CHAR path[MAX_PATH];
+		StrPrint(path, "%s/%s", dir, SNAPSHOT_DIR);
+
+		DIR* handle = opendir(path);
+		if (!handle)
+			return NULL;
+
+		BYTE* data = NULL;
+		DWORD found = 0;
+		dirent* entry;
+		while ((entry = readdir(handle)) != NULL)
+		{
+			const CHAR* dot = StrLastChar(entry->d_name, '.');
+			if (!dot || StrCompare(dot, ext))
+				continue;
+
+			++found;
+			CHAR file[MAX_PATH * 2];
+			StrPrint(file, "%s/%s", path, entry->d_name);
+			data = Test::ReadAll(file, size);
+			unlink(file);
+		}
+		closedir(handle);
+
+		CHECK(found == 1);
+		return data;
+	}
+
+	BOOL DecodePng(const BYTE* data, DWORD size, DWORD** pixels, DWORD* width, DWORD* height)
+	{
+		static const BYTE signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		if (size < 8 || MemoryCompare(data, signature, 8))
+			return FALSE;
+
+		BYTE* idat = NULL;
+		DWORD idatSize = 0;
+		BOOL isEnd = FALSE;
+
+		const BYTE* ptr = data + 8;
+		const BYTE* end = data + size;
+		while (ptr + 12 <= end && !isEnd)
+		{
+			DWORD length = GetLong(ptr);
+			const BYTE* type = ptr + 4;
+			const BYTE* body = ptr + 8;
+			if (body + length + 4 > end)
+				return FALSE;
+
+			if (GetLong(body + length) != crc32(0, type, length + 4))
+				return FALSE;
+
+			if (!MemoryCompare(type, "IHDR", 4))
+			{
+				*width = GetLong(body);
+				*height = GetLong(body + 4);
+				if (body[8] != 8 || body[9] != 2 || body[12])
+					return FALSE;
+			}
+			else if (!MemoryCompare(type, "IDAT", 4))
+			{
+				idat = (BYTE*)realloc(idat, idatSize + length);
+				MemoryCopy(idat + idatSize, body, length);
+				idatSize += length;
+			}
+			else if (!MemoryCompare(type, "IEND", 4))
+				isEnd = TRUE;
+
+			ptr = body + length + 4;
+		}
+
+		if (!isEnd || !idat)
+		{
+			free(idat);
+			return FALSE;
+		}
+
+		DWORD stride = *width * 3 + 1;
+		uLongf rawSize = stride * *height;
+		BYTE* raw = (BYTE*)malloc(rawSize);
+		BOOL isValid = uncompress(raw, &rawSize, idat, idatSize) == Z_OK && rawSize == stride * *height;
+		free(idat);
+
+		if (isValid)
+		{
+			*pixels = (DWORD*)malloc(*width * *height * sizeof(DWORD));
+			BYTE* prev = NULL;
+			for (DWORD y = 0; y < *height && isValid; ++y)
+			{
+				BYTE* line = raw + y * stride;
+				BYTE filter = *line++;
+				for (DWORD i = 0; i < stride - 1; ++i)
+				{
+					INT a = i >= 3 ? line[i - 3] : 0;
+					INT b = prev ? prev[i] : 0;
+					INT c = prev && i >= 3 ? prev[i - 3] : 0;
+					switch (filter)
+					{
+					case 0:
+						break;
+					case 1:
+						line[i] += a;
+						break;
+					case 2:
+						line[i] += b;
+						break;
+					case 3:
+						line[i] += (a + b) >> 1;
+						break;
+					case 4:
+					{
+						INT p = a + b - c;
+						INT pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+						line[i] += pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+						break;
+					}
+					default:
+						isValid = FALSE;
+						break;
+					}
+				}
+
+				DWORD* dst = *pixels + y * *width;
+				for (DWORD x = 0; x < *width; ++x)
+					dst[x] = (line[x * 3] << 16) | (line[x * 3 + 1] << 8) | line[x * 3 + 2];
+
+				prev = line;
+			}
+
+			if (!isValid)
+				free(*pixels);
+		}
+
+		free(raw);
+		return isValid;
+	}
+
+	BOOL DecodeQoi(const BYTE* data, DWORD size, DWORD** pixels, DWORD* width, DWORD* height)
+	{
+		static const BYTE padding[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+		if (size < 22 || MemoryCompare(data, "qoif", 4) || MemoryCompare(data + size - 8, padding, 8))
+			return FALSE;
+
+		*width = GetLong(data + 4);
+		*height = GetLong(data + 8);
+		if (data[12] != 3 || data[13])
+			return FALSE;
+
+		DWORD count = *width * *height;
+		*pixels = (DWORD*)malloc(count * sizeof(DWORD));
+
+		BYTE index[64][3];
+		MemoryZero(index, sizeof(index));
+
+		INT r = 0, g = 0, b = 0;
+		DWORD run = 0;
+		const BYTE* ptr = data + 14;
+		const BYTE* end = data + size - 8;
+		for (DWORD i = 0; i < count; ++i)
+		{
+			if (run)
+				--run;
+			else
+			{
+				if (ptr >= end)
+				{
+					free(*pixels);
+					return FALSE;
+				}
+
+				BYTE op = *ptr++;
+				if (op == 0xFE)
+				{
+					r = ptr[0];
+					g = ptr[1];
+					b = ptr[2];
+					ptr += 3;
+				}
+				else if ((op & 0xC0) == 0x00)
+				{
+					r = index[op][0];
+					g = index[op][1];
+					b = index[op][2];
+				}
+				else if ((op & 0xC0) == 0x40)
+				{
+					r = (r + ((op >> 4) & 3) - 2) & 0xFF;
+					g = (g + ((op >> 2) & 3) - 2) & 0xFF;
+					b = (b + (op & 3) - 2) & 0xFF;
+				}
+				else if ((op & 0xC0) == 0x80)
+				{
+					INT vg = (op & 0x3F) - 32;
+					BYTE next = *ptr++;
+					r = (r + vg - 8 + (next >> 4)) & 0xFF;
+					g = (g + vg) & 0xFF;
+					b = (b + vg - 8 + (next & 0x0F)) & 0xFF;
+				}
+				else
+					run = op & 0x3F;
+
+				DWORD hash = (r * 3 + g * 5 + b * 7 + 255 * 11) & 63;
+				index[hash][0] = (BYTE)r;
+				index[hash][1] = (BYTE)g;
+				index[hash][2] = (BYTE)b;
+			}
+
+			(*pixels)[i] = (r << 16) | (g << 8) | b;
+		}
+
+		return ptr == end;
+	}
+
+	VOID RoundTrip(SnapshotType type, DWORD width, DWORD height, BOOL isFlipped, DWORD seed)
+	{
+		config.snapshot = type;
+		Snapshot::Create();
+
+		SnapshotFrame* frame = Snapshot::Acquire(width, height);
+		CHECK(frame != NULL);
+		if (!frame)
+			return Snapshot::Release();
+
+		frame->isFlipped = isFlipped;
+		Fill(frame, seed);
+
+		SnapshotFrame copy = *frame;
+		copy.data = (DWORD*)malloc(width * height * sizeof(DWORD));
+		MemoryCopy(copy.data, frame->data, width * height * sizeof(DWORD));
+
+		Snapshot::Commit(frame);
+		Snapshot::Stop();
+		Snapshot::Release();
+
+		DWORD size = 0;
+		BYTE* data = TakeFile(type == SnapshotQoi ? ".qoi" : ".png", &size);
+		CHECK(data != NULL);
+		if (data)
+		{
+			DWORD* pixels = NULL;
+			DWORD w = 0, h = 0;
+			BOOL isDecoded = type == SnapshotQoi ? DecodeQoi(data, size, &pixels, &w, &h) : DecodePng(data, size, &pixels, &w, &h);
+			CHECK(isDecoded);
+			if (isDecoded)
+			{
+				CHECK(w == width && h == height);
+
+				DWORD mismatches = 0;
+				for (DWORD y = 0; y < height; ++y)
+					for (DWORD x = 0; x < width; ++x)
+						mismatches += pixels[y * width + x] != Expected(&copy, x, y);
+				CHECK(mismatches == 0);
+
+				free(pixels);
+			}
+
+			free(data);
+		}
+
+		free(copy.data);
+	}
+
+	VOID TestPng()
+	{
+		RoundTrip(SnapshotPng, 1, 1, FALSE, 1);
+		RoundTrip(SnapshotPng, 7, 5, TRUE, 2);
+		RoundTrip(SnapshotPng, 640, 480, FALSE, 3);
+		RoundTrip(SnapshotPng, 801, 603, TRUE, 4);
+	}
+
+	VOID TestQoi()
+	{
+		RoundTrip(SnapshotQoi, 1, 1, FALSE, 1);
+		RoundTrip(SnapshotQoi, 7, 5, TRUE, 2);
+		RoundTrip(SnapshotQoi, 640, 480, FALSE, 3);
+		RoundTrip(SnapshotQoi, 801, 603, TRUE, 4);
+
+		config.snapshot = SnapshotQoi;
+		Snapshot::Create();
+		SnapshotFrame* frame = Snapshot::Acquire(300, 1);
+		MemoryZero(frame->data, 300 * sizeof(DWORD));
+		Snapshot::Commit(frame);
+		Snapshot::Stop();
+		Snapshot::Release();
+
+		DWORD size;
+		BYTE* data = TakeFile(".qoi", &size);
+		CHECK(data && size == 14 + 5 + 8);
+		free(data);
+	}
+
+	VOID TestAcquire()
+	{
+		Snapshot::Create();
+
+		CHECK(Snapshot::Acquire(0, 10) == NULL);
+		CHECK(Snapshot::Acquire(10, 0) == NULL);
+
+		Win32::allocBudget = 0;
+		CHECK(Snapshot::Acquire(16, 16) == NULL);
+
+		Win32::allocBudget = 1;
+		CHECK(Snapshot::Acquire(16, 16) == NULL);
+		Win32::allocBudget = -1;
+
+		config.snapshot = SnapshotQoi;
+		for (DWORD i = 0; i < SNAPSHOT_POOL + 2; ++i)
+		{
+			SnapshotFrame* frame = Snapshot::Acquire(32 + i, 32);
+			CHECK(frame && frame->data && frame->width == 32 + i && !frame->isFlipped);
+			if (frame)
+			{
+				Fill(frame, i);
+				Snapshot::Commit(frame);
+			}
+		}
+
+		Snapshot::Stop();
+
+		SnapshotFrame* frame = Snapshot::Acquire(64, 64);
+		CHECK(frame && frame->data && frame->capacity >= 64 * 64 * sizeof(DWORD));
+		if (frame)
+		{
+			Fill(frame, 7);
+			Snapshot::Commit(frame);
+		}
+
+		Snapshot::Stop();
+		Snapshot::Release();
+
+		CHAR path[MAX_PATH];
+		StrPrint(path, "%s/%s", dir, SNAPSHOT_DIR);
+		Test::RemoveDir(path);
+	}
+}
+
+INT main()
+{
+	Test::TempDir(SnapshotTest::dir, "snapshot");
+	StrPrint(config.file, "%s\\config.ini", SnapshotTest::dir);
+
+	VOID(*tests[])() = {
+		SnapshotTest::TestPng,
+		SnapshotTest::TestQoi,
+		SnapshotTest::TestAcquire
+	};
+
+	INT result = Test::Run("SnapshotTest", tests, sizeof(tests) / sizeof(*tests));
+	Test::RemoveDir(SnapshotTest::dir);
+	return result;
+}
@@ -0,0 +1,117 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include <dirent.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/stat.h>
+
+namespace Test
+{
+	DWORD checks;
+	DWORD failures;
+
+	VOID Check(BOOL passed, const CHAR* expr, const CHAR* file, INT line)
+	{
+		++checks;
+		if (!passed)
+		{
+			++failures;
+			fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+		}
+	}
+
+	INT Run(const CHAR* name, VOID(*tests[])(), DWORD count)
+	{
+		for (DWORD i = 0; i < count; ++i)
+			tests[i]();
+
+		printf("%s: %u checks, %u failures\n", name, checks, failures);
+		return failures ? 1 : 0;
+	}
+
+	DOUBLE Seconds()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec + ts.tv_nsec * 1e-9;
+	}
+
+	VOID TempDir(CHAR* path, const CHAR* prefix)
+	{
+		StrPrint(path, "/tmp/%sXXXXXX", prefix);
+		if (!mkdtemp(path))
+			*path = '\0';
+	}
+
+	VOID RemoveDir(const CHAR* path)
+	{
+		DIR* dir = opendir(path);
+		if (!dir)
+			return;
+
+		dirent* entry;
+		while ((entry = readdir(dir)) != NULL)
+		{
+			if (!StrCompare(entry->d_name, ".") || !StrCompare(entry->d_name, ".."))
+				continue;
+
+			CHAR child[MAX_PATH];
+			StrPrint(child, "%s/%s", path, entry->d_name);
+
+			struct stat st;
+			if (!stat(child, &st) && S_ISDIR(st.st_mode))
+				RemoveDir(child);
+			else
+				unlink(child);
+		}
+
+		closedir(dir);
+		rmdir(path);
+	}
+
+	BYTE* ReadAll(const CHAR* path, DWORD* size)
+	{
+		FILE* file = fopen(path, "rb");
+		if (!file)
+			return NULL;
+
+		fseek(file, 0, SEEK_END);
+		*size = (DWORD)ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		BYTE* data = (BYTE*)malloc(*size + 1);
+		if (fread(data, 1, *size, file) != *size)
+		{
+			free(data);
+			data = NULL;
+		}
+		else
+			data[*size] = 0;
+
+		fclose(file);
+		return data;
+	}
+}
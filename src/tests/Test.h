@@ -0,0 +1,42 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include "stdafx.h"
+
+#define CHECK(expr) Test::Check((expr) ? TRUE : FALSE, #expr, __FILE__, __LINE__)
+
+namespace Test
+{
+	extern DWORD checks;
+	extern DWORD failures;
+
+	VOID Check(BOOL passed, const CHAR* expr, const CHAR* file, INT line);
+	INT Run(const CHAR* name, VOID(*tests[])(), DWORD count);
+
+	DOUBLE Seconds();
+	VOID TempDir(CHAR* path, const CHAR* prefix);
+	VOID RemoveDir(const CHAR* path);
+	BYTE* ReadAll(const CHAR* path, DWORD* size);
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "GLMock.h"
+#include "PixelBuffer.h"
+#include "Config.h"
+
+ConfigItems config;
+
+/*
+	Runs the startup self-benchmark of PixelBuffer::Tune outside the game.
+
+	TuneBench                            the resolutions the games switch to
+	TuneBench <width> <height> <16|32>   one resolution
+
+	Uploads go to the software texture of the GL mock, so the numbers cover
+	the compare kernels and the row copies but not the driver. Every mode is
+	measured several times and the best round is kept.
+*/
+
+namespace TuneBench
+{
+	const CHAR* names[] = { "none", "sse", "cpp", "asm" };
+
+	const DWORD rounds = 5;
+
+	VOID Run(DWORD width, DWORD height, BOOL isTrue)
+	{
+		LARGE_INTEGER freq;
+		QueryPerformanceFrequency(&freq);
+
+		printf("%4ux%-4u %ubpp", width, height, isTrue ? 32 : 16);
+
+		// Rows are padded to 16 bytes like the surface pitch the games tune with
+		DWORD depth = isTrue ? sizeof(DWORD) : sizeof(WORD);
+		width = ((width * depth + 15) & ~15) / depth;
+
+		UpdateMode best = UpdateNone;
+		LONGLONG bestTime = 0;
+		for (DWORD i = UpdateNone; i < UpdateAuto; ++i)
+		{
+			UpdateMode mode = (UpdateMode)i;
+
+#ifndef _M_IX86
+			if (mode == UpdateASM)
+				continue;
+#endif
+
+			LONGLONG time = 0;
+			for (DWORD r = 0; r < rounds; ++r)
+			{
+				LONGLONG round = PixelBuffer::Measure(width, height, isTrue, isTrue ? GL_RGBA : GL_RGB, mode);
+				if (!time || round < time)
+					time = round;
+			}
+
+			printf("  %s %8.1f us", names[i], time * 1e6 / freq.QuadPart / TUNE_FRAMES);
+
+			if (!bestTime || time < bestTime)
+			{
+				bestTime = time;
+				best = mode;
+			}
+		}
+
+		printf("  -> %s\n", names[best]);
+	}
+}
+
+INT main(INT argc, CHAR** argv)
+{
+	config.isSSE2 = TRUE;
+
+	if (argc == 4)
+	{
+		DWORD bpp = atoi(argv[3]);
+		if (bpp != 16 && bpp != 32)
+		{
+			fprintf(stderr, "Usage: %s [<width> <height> <16|32>]\n", argv[0]);
+			return 2;
+		}
+
+		TuneBench::Run(atoi(argv[1]), atoi(argv[2]), bpp == 32);
+	}
+	else if (argc == 1)
+	{
+		const DWORD sizes[][2] = { { 640, 480 }, { 800, 600 }, { 1024, 768 }, { 1280, 1024 }, { 1920, 1080 } };
+		for (DWORD i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i)
+		{
+			TuneBench::Run(sizes[i][0], sizes[i][1], FALSE);
+			TuneBench::Run(sizes[i][0], sizes[i][1], TRUE);
+		}
+	}
+	else
+	{
+		fprintf(stderr, "Usage: %s [<width> <height> <16|32>]\n", argv[0]);
+		return 2;
+	}
+
+	GLMock::Release();
+	return 0;
+}
@@ -0,0 +1,235 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "Test.h"
+#include "Videos.h"
+#include "Config.h"
+#include <dirent.h>
+#include <sys/time.h>
+
+ConfigItems config;
+
+namespace Videos
+{
+	extern VideoIndex* indexList;
+}
+
+namespace VideosTest
+{
+	CHAR dir[MAX_PATH];
+
+	struct Clip
+	{
+		const CHAR* name;
+		BOOL isBink;
+	};
+
+	const Clip clips[] = {
+		{ "INTRO.BIK", TRUE },
+		{ "credits.bik", FALSE },
+		{ "Lose.bik", TRUE },
+		{ "other.smk", FALSE }
+	};
+
+	const DWORD clipCount = sizeof(clips) / sizeof(*clips);
+
+	VOID GetPath(CHAR* path, const CHAR* folder, CHAR separator)
+	{
+		StrPrint(path, "%s%c%s%cvideo.vid", dir, separator, folder, separator);
+	}
+
+	// Writes a container with the clip table up front and a 16-byte payload per clip,
+	// bink payloads start with the signature Build looks for
+	VOID Write(const CHAR* folder, BOOL isBink, LONG seconds)
+	{
+		CHAR path[MAX_PATH];
+		StrPrint(path, "%s\\%s", dir, folder);
+		CreateDirectory(path, NULL);
+
+		BYTE data[sizeof(DWORD) + clipCount * (sizeof(VideoFile) + 16)];
+		MemoryZero(data, sizeof(data));
+		*(DWORD*)data = clipCount;
+
+		VideoFile* file = (VideoFile*)(data + sizeof(DWORD));
+		DWORD stride = sizeof(DWORD) + clipCount * sizeof(VideoFile);
+		for (DWORD i = 0; i < clipCount; ++i, ++file, stride += 16)
+		{
+			StrCopy(file->name, clips[i].name);
+			file->stride = stride;
+			MemoryCopy(data + stride, clips[i].isBink && isBink ? "BIKb" : "SMK2", 4);
+		}
+
+		GetPath(path, folder, '\\');
+		HANDLE hFile = CreateFile(path, GENERIC_WRITE, NULL, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		DWORD written;
+		WriteFile(hFile, data, sizeof(data), &written, NULL);
+		CloseHandle(hFile);
+
+		GetPath(path, folder, '/');
+		timeval times[2] = { { seconds, 0 }, { seconds, 0 } };
+		utimes(path, times);
+	}
+
+	// Matches the game table against the container, the way the CreateFile hook does on open
+	DWORD Load(const CHAR* folder, VideoInfo* gameInfo)
+	{
+		CHAR* names[] = { "intro", "credits", "lose", "other", "missing" };
+		DWORD count = sizeof(names) / sizeof(*names);
+
+		MemoryZero(gameInfo, count * sizeof(VideoInfo));
+		for (DWORD i = 0; i < count; ++i)
+			gameInfo[i].fileName = names[i];
+
+		CHAR path[MAX_PATH];
+		GetPath(path, folder, '\\');
+		HANDLE hFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		CHECK(hFile != INVALID_HANDLE_VALUE);
+		if (hFile == INVALID_HANDLE_VALUE)
+			return 0;
+
+		Videos::Load(hFile, path, gameInfo, count);
+
+		// The game reads the container from the start after the hook
+		CHECK(SetFilePointer(hFile, 0, NULL, FILE_CURRENT) == 0);
+		CloseHandle(hFile);
+
+		DWORD mask = 0;
+		for (DWORD i = 0; i < count; ++i)
+			mask |= (gameInfo[i].bink ? 1 : 0) << i;
+
+		return mask;
+	}
+
+	// Drops the in-memory indexes, so the next Load goes through the cache file as after a restart
+	VOID Forget()
+	{
+		while (Videos::indexList)
+		{
+			VideoIndex* index = Videos::indexList;
+			Videos::indexList = index->next;
+
+			MemoryFree(index->buckets);
+			MemoryFree(index->entries);
+			MemoryFree(index);
+		}
+	}
+
+	DWORD CountCache()
+	{
+		CHAR path[MAX_PATH];
+		StrPrint(path, "%s/%s", dir, VIDEO_DIR);
+
+		DWORD count = 0;
+		DIR* handle = opendir(path);
+		if (handle)
+		{
+			dirent* entry;
+			while ((entry = readdir(handle)) != NULL)
+			{
+				const CHAR* dot = StrLastChar(entry->d_name, '.');
+				count += dot && !StrCompare(dot, ".idx");
+			}
+
+			closedir(handle);
+		}
+
+		return count;
+	}
+
+	// Bits follow the game table in Load: intro, credits, lose, other, missing
+	const DWORD binkMask = 0x5;
+
+	VOID TestBuild()
+	{
+		Write("Build", TRUE, 1000000);
+
+		VideoInfo gameInfo[5];
+		CHECK(Load("Build", gameInfo) == binkMask);
+		CHECK(CountCache() == 1);
+
+		CHECK(Load("Build", gameInfo) == binkMask);
+		CHECK(CountCache() == 1);
+
+		Forget();
+	}
+
+	VOID TestCache()
+	{
+		Write("Cache", TRUE, 2000000);
+
+		VideoInfo gameInfo[5];
+		CHECK(Load("Cache", gameInfo) == binkMask);
+		Forget();
+
+		// Same size and time: the index is taken from the cache without reading the clips again
+		Write("Cache", FALSE, 2000000);
+		CHECK(Load("Cache", gameInfo) == binkMask);
+		Forget();
+
+		// A newer container rejects the stale cache and rebuilds it
+		Write("Cache", FALSE, 2000100);
+		CHECK(Load("Cache", gameInfo) == 0);
+		Forget();
+
+		CHECK(Load("Cache", gameInfo) == 0);
+		Forget();
+	}
+
+	VOID TestFullPath()
+	{
+		DWORD cached = CountCache();
+
+		Write("First", TRUE, 3000000);
+		Write("Second", FALSE, 3000000);
+
+		VideoInfo gameInfo[5];
+		CHECK(Load("First", gameInfo) == binkMask);
+		CHECK(Load("Second", gameInfo) == 0);
+		CHECK(CountCache() == cached + 2);
+		Forget();
+
+		// Both caches survive side by side, each answering for its own container
+		Write("First", FALSE, 3000000);
+		Write("Second", TRUE, 3000000);
+		CHECK(Load("First", gameInfo) == binkMask);
+		CHECK(Load("Second", gameInfo) == 0);
+		Forget();
+	}
+}
+
+INT main()
+{
+	Test::TempDir(VideosTest::dir, "videos");
+	StrPrint(config.file, "%s\\config.ini", VideosTest::dir);
+
+	VOID(*tests[])() = {
+		VideosTest::TestBuild,
+		VideosTest::TestCache,
+		VideosTest::TestFullPath
+	};
+
+	INT result = Test::Run("VideosTest", tests, sizeof(tests) / sizeof(*tests));
+	Test::RemoveDir(VideosTest::dir);
+	return result;
+}
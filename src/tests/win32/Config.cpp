@@ -0,0 +1,85 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "Config.h"
+#include "Ini.h"
+
+// Config.cpp pulls in the whole wrapper, the harness only needs the ini accessors and the neutral colors
+const Adjustment defaultColors = {
+	0.5f,
+	0.5f,
+
+	0.0f,
+	0.0f,
+	0.0f,
+	0.0f,
+
+	1.0f,
+	1.0f,
+	1.0f,
+	1.0f,
+
+	0.5f,
+	0.5f,
+	0.5f,
+	0.5f,
+
+	0.0f,
+	0.0f,
+	0.0f,
+	0.0f,
+
+	1.0f,
+	1.0f,
+	1.0f,
+	1.0f
+};
+
+namespace Config
+{
+	INT Get(const CHAR* app, const CHAR* key, INT defValue)
+	{
+		return Ini::Get(app, key, defValue);
+	}
+
+	DWORD Get(const CHAR* app, const CHAR* key, const CHAR* defValue, CHAR* returnString, DWORD nSize)
+	{
+		return Ini::Get(app, key, defValue, returnString, nSize);
+	}
+
+	BOOL Set(const CHAR* app, const CHAR* key, INT value)
+	{
+		CHAR res[20];
+		StrFromInt(value, res, 10);
+		Ini::Set(app, key, res);
+		return TRUE;
+	}
+
+	BOOL Set(const CHAR* app, const CHAR* key, CHAR* value)
+	{
+		Ini::Set(app, key, value);
+		return TRUE;
+	}
+}
@@ -0,0 +1,204 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "GLib.h"
+#include "Egl.h"
+
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+GLGETSTRING GLGetString;
+GLVIEWPORT GLViewport;
+GLFINISH GLFinish;
+GLFENCESYNC GLFenceSync;
+GLCLIENTWAITSYNC GLClientWaitSync;
+GLDELETESYNC GLDeleteSync;
+GLENABLE GLEnable;
+GLBINDTEXTURE GLBindTexture;
+GLDELETETEXTURES GLDeleteTextures;
+GLTEXPARAMETERI GLTexParameteri;
+GLGETTEXIMAGE GLGetTexImage;
+GLTEXIMAGE1D GLTexImage1D;
+GLTEXIMAGE2D GLTexImage2D;
+GLTEXSUBIMAGE2D GLTexSubImage2D;
+GLGENTEXTURES GLGenTextures;
+GLGETINTEGERV GLGetIntegerv;
+GLCLEAR GLClear;
+GLCLEARCOLOR GLClearColor;
+GLPIXELSTOREI GLPixelStorei;
+
+GLACTIVETEXTURE GLActiveTexture;
+GLGENBUFFERS GLGenBuffers;
+GLDELETEBUFFERS GLDeleteBuffers;
+GLBINDBUFFER GLBindBuffer;
+GLBUFFERDATA GLBufferData;
+GLBUFFERSUBDATA GLBufferSubData;
+GLDRAWARRAYS GLDrawArrays;
+
+GLENABLEVERTEXATTRIBARRAY GLEnableVertexAttribArray;
+GLVERTEXATTRIBPOINTER GLVertexAttribPointer;
+
+GLCREATESHADER GLCreateShader;
+GLDELETESHADER GLDeleteShader;
+GLCREATEPROGRAM GLCreateProgram;
+GLDELETEPROGRAM GLDeleteProgram;
+GLSHADERSOURCE GLShaderSource;
+GLCOMPILESHADER GLCompileShader;
+GLATTACHSHADER GLAttachShader;
+GLDETACHSHADER GLDetachShader;
+GLLINKPROGRAM GLLinkProgram;
+GLUSEPROGRAM GLUseProgram;
+GLGETSHADERIV GLGetShaderiv;
+GLGETSHADERINFOLOG GLGetShaderInfoLog;
+
+GLBINDATTRIBLOCATION GLBindAttribLocation;
+GLGETUNIFORMLOCATION GLGetUniformLocation;
+
+GLUNIFORM1I GLUniform1i;
+GLUNIFORM2F GLUniform2f;
+GLUNIFORM4F GLUniform4f;
+
+GLGENVERTEXARRAYS GLGenVertexArrays;
+GLBINDVERTEXARRAY GLBindVertexArray;
+GLDELETEVERTEXARRAYS GLDeleteVertexArrays;
+
+GLGENFRAMEBUFFERS GLGenFramebuffers;
+GLDELETEFRAMEBUFFERS GLDeleteFramebuffers;
+GLBINDFRAMEBUFFER GLBindFramebuffer;
+GLFRAMEBUFFERTEXTURE2D GLFramebufferTexture2D;
+
+namespace Egl
+{
+	EGLDisplay display;
+	EGLContext context;
+
+	struct Function
+	{
+		const CHAR* name;
+		VOID* address;
+	};
+
+	const Function functions[] = {
+		{ "glGetString", &GLGetString },
+		{ "glViewport", &GLViewport },
+		{ "glFinish", &GLFinish },
+		{ "glFenceSync", &GLFenceSync },
+		{ "glClientWaitSync", &GLClientWaitSync },
+		{ "glDeleteSync", &GLDeleteSync },
+		{ "glEnable", &GLEnable },
+		{ "glBindTexture", &GLBindTexture },
+		{ "glDeleteTextures", &GLDeleteTextures },
+		{ "glTexParameteri", &GLTexParameteri },
+		{ "glGetTexImage", &GLGetTexImage },
+		{ "glTexImage1D", &GLTexImage1D },
+		{ "glTexImage2D", &GLTexImage2D },
+		{ "glTexSubImage2D", &GLTexSubImage2D },
+		{ "glGenTextures", &GLGenTextures },
+		{ "glGetIntegerv", &GLGetIntegerv },
+		{ "glClear", &GLClear },
+		{ "glClearColor", &GLClearColor },
+		{ "glPixelStorei", &GLPixelStorei },
+		{ "glActiveTexture", &GLActiveTexture },
+		{ "glGenBuffers", &GLGenBuffers },
+		{ "glDeleteBuffers", &GLDeleteBuffers },
+		{ "glBindBuffer", &GLBindBuffer },
+		{ "glBufferData", &GLBufferData },
+		{ "glBufferSubData", &GLBufferSubData },
+		{ "glDrawArrays", &GLDrawArrays },
+		{ "glEnableVertexAttribArray", &GLEnableVertexAttribArray },
+		{ "glVertexAttribPointer", &GLVertexAttribPointer },
+		{ "glCreateShader", &GLCreateShader },
+		{ "glDeleteShader", &GLDeleteShader },
+		{ "glCreateProgram", &GLCreateProgram },
+		{ "glDeleteProgram", &GLDeleteProgram },
+		{ "glShaderSource", &GLShaderSource },
+		{ "glCompileShader", &GLCompileShader },
+		{ "glAttachShader", &GLAttachShader },
+		{ "glDetachShader", &GLDetachShader },
+		{ "glLinkProgram", &GLLinkProgram },
+		{ "glUseProgram", &GLUseProgram },
+		{ "glGetShaderiv", &GLGetShaderiv },
+		{ "glGetShaderInfoLog", &GLGetShaderInfoLog },
+		{ "glBindAttribLocation", &GLBindAttribLocation },
+		{ "glGetUniformLocation", &GLGetUniformLocation },
+		{ "glUniform1i", &GLUniform1i },
+		{ "glUniform2f", &GLUniform2f },
+		{ "glUniform4f", &GLUniform4f },
+		{ "glGenVertexArrays", &GLGenVertexArrays },
+		{ "glBindVertexArray", &GLBindVertexArray },
+		{ "glDeleteVertexArrays", &GLDeleteVertexArrays },
+		{ "glGenFramebuffers", &GLGenFramebuffers },
+		{ "glDeleteFramebuffers", &GLDeleteFramebuffers },
+		{ "glBindFramebuffer", &GLBindFramebuffer },
+		{ "glFramebufferTexture2D", &GLFramebufferTexture2D }
+	};
+
+	BOOL Create()
+	{
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if (!getPlatformDisplay)
+			return FALSE;
+
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+		if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL))
+			return FALSE;
+
+		// The wrapper asks WGL for a 3.0 context, the compatibility profile keeps its legacy entry points
+		const EGLint attributes[] = { EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 0, EGL_NONE };
+		if (!eglBindAPI(EGL_OPENGL_API) || (context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes)) == EGL_NO_CONTEXT)
+		{
+			eglTerminate(display);
+			return FALSE;
+		}
+
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+
+		const Function* function = functions;
+		for (DWORD i = 0; i < sizeof(functions) / sizeof(*functions); ++i, ++function)
+		{
+			*(VOID**)function->address = (VOID*)eglGetProcAddress(function->name);
+			if (!*(VOID**)function->address)
+			{
+				Release();
+				return FALSE;
+			}
+		}
+
+		return TRUE;
+	}
+
+	VOID Release()
+	{
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		eglDestroyContext(display, context);
+		eglTerminate(display);
+	}
+
+	const CHAR* GetRenderer()
+	{
+		return (const CHAR*)GLGetString(GL_RENDERER);
+	}
+}
@@ -0,0 +1,52 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include "windows.h"
+#include "GL/gl.h"
+
+/*
+	Recording stand-in for the GL entry points of GLib.h. Uploads are applied
+	to a software copy of the bound texture so a test can compare it with the
+	frame that was supposed to be presented. TexImage2D reallocates that copy,
+	texture names are only counted.
+*/
+
+namespace GLMock
+{
+	extern DWORD binds;
+	extern DWORD uploads;
+	extern DWORD finishes;
+	extern DWORD errors;
+	extern RECT uploaded;
+	extern POINT origin;
+	extern GLuint bound;
+	extern DWORD textures;
+	extern GLint maxSize;
+
+	VOID Create(DWORD width, DWORD height, DWORD depth);
+	VOID Release();
+	VOID Reset();
+	const BYTE* GetTexture();
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "GLib.h"
+#include "GLMock.h"
+
+namespace GLMock
+{
+	DWORD binds;
+	DWORD uploads;
+	DWORD finishes;
+	DWORD errors;
+	RECT uploaded;
+	POINT origin;
+	GLuint bound;
+	GLuint names;
+	DWORD textures;
+	GLint maxSize = 4096;
+
+	BYTE* texture;
+	DWORD texWidth;
+	DWORD texHeight;
+	DWORD texDepth;
+	GLint rowLength;
+
+	VOID Allocate(DWORD width, DWORD height, DWORD depth)
+	{
+		Release();
+
+		texture = (BYTE*)calloc(width * height, depth);
+		texWidth = width;
+		texHeight = height;
+		texDepth = depth;
+	}
+
+	VOID Create(DWORD width, DWORD height, DWORD depth)
+	{
+		Allocate(width, height, depth);
+		Reset();
+	}
+
+	VOID Release()
+	{
+		free(texture);
+		texture = NULL;
+	}
+
+	VOID Reset()
+	{
+		binds = 0;
+		uploads = 0;
+		finishes = 0;
+		errors = 0;
+		SetRectEmpty(&uploaded);
+	}
+
+	const BYTE* GetTexture()
+	{
+		return texture;
+	}
+
+	VOID __stdcall Finish()
+	{
+		++finishes;
+	}
+
+	VOID __stdcall BindTexture(GLenum target, GLuint id)
+	{
+		++binds;
+		bound = id;
+	}
+
+	GLenum __stdcall GenTextures(GLsizei n, GLuint* ids)
+	{
+		while (n--)
+		{
+			*ids++ = ++names;
+			++textures;
+		}
+
+		return GL_NO_ERROR;
+	}
+
+	VOID __stdcall DeleteTextures(GLsizei n, const GLuint* ids)
+	{
+		while (n--)
+		{
+			if (*ids == bound)
+				bound = 0;
+
+			if (*ids++)
+				--textures;
+		}
+	}
+
+	VOID __stdcall GetIntegerv(GLenum pname, GLint* data)
+	{
+		switch (pname)
+		{
+		case GL_MAX_TEXTURE_SIZE:
+			*data = maxSize;
+			break;
+
+		case GL_TEXTURE_BINDING_2D:
+			*data = bound;
+			break;
+
+		default:
+			*data = 0;
+			break;
+		}
+	}
+
+	VOID __stdcall TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels)
+	{
+		if (!bound || width > maxSize || height > maxSize)
+		{
+			++errors;
+			return;
+		}
+
+		Allocate(width, height, type == GL_UNSIGNED_SHORT_5_6_5 ? sizeof(WORD) : sizeof(DWORD));
+	}
+
+	VOID __stdcall PixelStorei(GLenum pname, GLint param)
+	{
+		if (pname == GL_UNPACK_ROW_LENGTH)
+			rowLength = param;
+	}
+
+	VOID __stdcall TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels)
+	{
+		++uploads;
+
+		xoffset += origin.x;
+		yoffset += origin.y;
+
+		RECT rc = { xoffset, yoffset, xoffset + width, yoffset + height };
+		UnionRect(&uploaded, &uploaded, &rc);
+
+		DWORD depth = type == GL_UNSIGNED_SHORT_5_6_5 ? sizeof(WORD) : sizeof(DWORD);
+		if (!texture || depth != texDepth || xoffset < 0 || yoffset < 0 || DWORD(xoffset + width) > texWidth || DWORD(yoffset + height) > texHeight)
+		{
+			++errors;
+			return;
+		}
+
+		DWORD stride = (rowLength ? rowLength : width) * depth;
+		const BYTE* src = (const BYTE*)pixels;
+		BYTE* dst = texture + (yoffset * texWidth + xoffset) * depth;
+		for (GLsizei y = 0; y < height; ++y, src += stride, dst += texWidth * depth)
+			MemoryCopy(dst, src, width * depth);
+	}
+}
+
+GLFINISH GLFinish = GLMock::Finish;
+GLBINDTEXTURE GLBindTexture = GLMock::BindTexture;
+GLGENTEXTURES GLGenTextures = GLMock::GenTextures;
+GLDELETETEXTURES GLDeleteTextures = GLMock::DeleteTextures;
+GLGETINTEGERV GLGetIntegerv = GLMock::GetIntegerv;
+GLTEXIMAGE2D GLTexImage2D = GLMock::TexImage2D;
+GLPIXELSTOREI GLPixelStorei = GLMock::PixelStorei;
+GLTEXSUBIMAGE2D GLTexSubImage2D = GLMock::TexSubImage2D;
@@ -0,0 +1,589 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "dwmapi.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+
+HMODULE hDllModule;
+
+namespace Win32
+{
+	LONG allocBudget = -1;
+	DWORD waitMask;
+	DWORD waitFlags;
+	UINT dwmNumerator;
+	UINT dwmDenominator;
+	DWORD displayFrequency;
+
+	VOID* Alloc(size_t size)
+	{
+		if (!allocBudget)
+			return NULL;
+
+		if (allocBudget > 0)
+			--allocBudget;
+
+		return malloc(size);
+	}
+
+	enum ObjectType
+	{
+		ObjectEvent = 1,
+		ObjectThread,
+		ObjectFile
+	};
+
+	struct Object
+	{
+		ObjectType type;
+		pthread_mutex_t mutex;
+		pthread_cond_t cond;
+		BOOL isManual;
+		BOOL isSignaled;
+		pthread_t thread;
+		LPTHREAD_START_ROUTINE start;
+		LPVOID parameter;
+		INT fd;
+	};
+
+	Object* New(ObjectType type)
+	{
+		Object* obj = (Object*)calloc(1, sizeof(Object));
+		obj->type = type;
+		pthread_mutex_init(&obj->mutex, NULL);
+		pthread_cond_init(&obj->cond, NULL);
+		obj->fd = -1;
+		return obj;
+	}
+
+	VOID Signal(Object* obj)
+	{
+		pthread_mutex_lock(&obj->mutex);
+		obj->isSignaled = TRUE;
+		if (obj->isManual)
+			pthread_cond_broadcast(&obj->cond);
+		else
+			pthread_cond_signal(&obj->cond);
+		pthread_mutex_unlock(&obj->mutex);
+	}
+
+	VOID* ThreadStart(VOID* parameter)
+	{
+		Object* obj = (Object*)parameter;
+		obj->start(obj->parameter);
+		Signal(obj);
+		return NULL;
+	}
+
+	VOID ToPath(CHAR* dst, LPCSTR src)
+	{
+		do
+			*dst++ = *src == '\\' ? '/' : *src;
+		while (*src++);
+	}
+
+	ULONGLONG Nanoseconds()
+	{
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (ULONGLONG)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+	}
+}
+
+VOID InitializeCriticalSection(CRITICAL_SECTION* section)
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+
+	pthread_mutex_t* mutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
+	pthread_mutex_init(mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	section->lock = mutex;
+}
+
+VOID DeleteCriticalSection(CRITICAL_SECTION* section)
+{
+	pthread_mutex_destroy((pthread_mutex_t*)section->lock);
+	free(section->lock);
+	section->lock = NULL;
+}
+
+VOID EnterCriticalSection(CRITICAL_SECTION* section)
+{
+	pthread_mutex_lock((pthread_mutex_t*)section->lock);
+}
+
+VOID LeaveCriticalSection(CRITICAL_SECTION* section)
+{
+	pthread_mutex_unlock((pthread_mutex_t*)section->lock);
+}
+
+HANDLE CreateEvent(SECURITY_ATTRIBUTES* attributes, BOOL manualReset, BOOL initialState, LPCSTR name)
+{
+	Win32::Object* obj = Win32::New(Win32::ObjectEvent);
+	obj->isManual = manualReset;
+	obj->isSignaled = initialState;
+	return obj;
+}
+
+BOOL SetEvent(HANDLE hEvent)
+{
+	Win32::Signal((Win32::Object*)hEvent);
+	return TRUE;
+}
+
+BOOL ResetEvent(HANDLE hEvent)
+{
+	Win32::Object* obj = (Win32::Object*)hEvent;
+	pthread_mutex_lock(&obj->mutex);
+	obj->isSignaled = FALSE;
+	pthread_mutex_unlock(&obj->mutex);
+	return TRUE;
+}
+
+DWORD WaitForSingleObject(HANDLE hHandle, DWORD milliseconds)
+{
+	Win32::Object* obj = (Win32::Object*)hHandle;
+
+	timespec deadline;
+	if (milliseconds != INFINITE)
+	{
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		ULONGLONG nsec = deadline.tv_nsec + (ULONGLONG)milliseconds * 1000000ull;
+		deadline.tv_sec += nsec / 1000000000ull;
+		deadline.tv_nsec = nsec % 1000000000ull;
+	}
+
+	DWORD result = WAIT_OBJECT_0;
+	pthread_mutex_lock(&obj->mutex);
+	{
+		while (!obj->isSignaled)
+		{
+			if (milliseconds == INFINITE)
+				pthread_cond_wait(&obj->cond, &obj->mutex);
+			else if (pthread_cond_timedwait(&obj->cond, &obj->mutex, &deadline) == ETIMEDOUT)
+			{
+				result = WAIT_TIMEOUT;
+				break;
+			}
+		}
+
+		if (result == WAIT_OBJECT_0 && !obj->isManual)
+			obj->isSignaled = FALSE;
+	}
+	pthread_mutex_unlock(&obj->mutex);
+
+	return result;
+}
+
+BOOL CloseHandle(HANDLE hObject)
+{
+	Win32::Object* obj = (Win32::Object*)hObject;
+	if (!obj || obj == INVALID_HANDLE_VALUE)
+		return FALSE;
+
+	if (obj->type == Win32::ObjectThread)
+		pthread_join(obj->thread, NULL);
+	else if (obj->type == Win32::ObjectFile)
+		close(obj->fd);
+
+	pthread_cond_destroy(&obj->cond);
+	pthread_mutex_destroy(&obj->mutex);
+	free(obj);
+	return TRUE;
+}
+
+HANDLE CreateThread(SECURITY_ATTRIBUTES* attributes, SIZE_T stackSize, LPTHREAD_START_ROUTINE start, LPVOID parameter, DWORD flags, DWORD* threadId)
+{
+	Win32::Object* obj = Win32::New(Win32::ObjectThread);
+	obj->isManual = TRUE;
+	obj->start = start;
+	obj->parameter = parameter;
+
+	if (pthread_create(&obj->thread, NULL, Win32::ThreadStart, obj))
+	{
+		free(obj);
+		return NULL;
+	}
+
+	if (threadId)
+		*threadId = (DWORD)(ULONG_PTR)obj;
+
+	return obj;
+}
+
+BOOL SetThreadPriority(HANDLE hThread, INT priority)
+{
+	return TRUE;
+}
+
+HANDLE CreateFile(LPCSTR fileName, DWORD access, DWORD shareMode, SECURITY_ATTRIBUTES* attributes, DWORD disposition, DWORD flags, HANDLE hTemplate)
+{
+	CHAR path[MAX_PATH];
+	Win32::ToPath(path, fileName);
+
+	INT mode = (access & GENERIC_WRITE) ? ((access & GENERIC_READ) ? O_RDWR : O_WRONLY) : O_RDONLY;
+	switch (disposition)
+	{
+	case CREATE_NEW:
+		mode |= O_CREAT | O_EXCL;
+		break;
+	case CREATE_ALWAYS:
+		mode |= O_CREAT | O_TRUNC;
+		break;
+	case OPEN_ALWAYS:
+		mode |= O_CREAT;
+		break;
+	default:
+		break;
+	}
+
+	INT fd = open(path, mode, 0644);
+	if (fd < 0)
+		return INVALID_HANDLE_VALUE;
+
+	Win32::Object* obj = Win32::New(Win32::ObjectFile);
+	obj->fd = fd;
+	return obj;
+}
+
+BOOL ReadFile(HANDLE hFile, LPVOID buffer, DWORD size, DWORD* read, LPVOID overlapped)
+{
+	ssize_t count = ::read(((Win32::Object*)hFile)->fd, buffer, size);
+	*read = count > 0 ? (DWORD)count : 0;
+	return count >= 0;
+}
+
+BOOL WriteFile(HANDLE hFile, LPCVOID buffer, DWORD size, DWORD* written, LPVOID overlapped)
+{
+	ssize_t count = ::write(((Win32::Object*)hFile)->fd, buffer, size);
+	*written = count > 0 ? (DWORD)count : 0;
+	return count == (ssize_t)size;
+}
+
+BOOL FlushFileBuffers(HANDLE hFile)
+{
+	return !fsync(((Win32::Object*)hFile)->fd);
+}
+
+DWORD GetFileSize(HANDLE hFile, DWORD* high)
+{
+	struct stat st;
+	if (fstat(((Win32::Object*)hFile)->fd, &st))
+		return INVALID_FILE_SIZE;
+
+	if (high)
+		*high = (DWORD)((ULONGLONG)st.st_size >> 32);
+
+	return (DWORD)st.st_size;
+}
+
+DWORD SetFilePointer(HANDLE hFile, LONG distance, LONG* distanceHigh, DWORD method)
+{
+	off_t offset = lseek(((Win32::Object*)hFile)->fd, distance, method == FILE_BEGIN ? SEEK_SET : SEEK_CUR);
+	return offset < 0 ? INVALID_SET_FILE_POINTER : (DWORD)offset;
+}
+
+BOOL GetFileTime(HANDLE hFile, FILETIME* creation, FILETIME* access, FILETIME* write)
+{
+	struct stat st;
+	if (fstat(((Win32::Object*)hFile)->fd, &st))
+		return FALSE;
+
+	ULONGLONG stamp = (ULONGLONG)st.st_mtim.tv_sec * 10000000ull + st.st_mtim.tv_nsec / 100;
+	if (write)
+	{
+		write->dwLowDateTime = (DWORD)stamp;
+		write->dwHighDateTime = (DWORD)(stamp >> 32);
+	}
+
+	return TRUE;
+}
+
+DWORD GetFullPathName(LPCSTR fileName, DWORD size, LPSTR buffer, LPSTR* filePart)
+{
+	CHAR path[MAX_PATH];
+	if (*fileName == '/' || *fileName == '\\')
+		StrCopy(path, fileName);
+	else if (getcwd(path, MAX_PATH))
+		StrPrint(path + StrLength(path), "\\%s", fileName);
+	else
+		return 0;
+
+	DWORD length = StrLength(path);
+	if (length >= size)
+		return length + 1;
+
+	StrCopy(buffer, path);
+	if (filePart)
+	{
+		CHAR* name = StrLastChar(buffer, '\\');
+		*filePart = name ? name + 1 : buffer;
+	}
+
+	return length;
+}
+
+BOOL CreateDirectory(LPCSTR path, SECURITY_ATTRIBUTES* attributes)
+{
+	CHAR dir[MAX_PATH];
+	Win32::ToPath(dir, path);
+	return !mkdir(dir, 0755);
+}
+
+BOOL MoveFileEx(LPCSTR existing, LPCSTR target, DWORD flags)
+{
+	CHAR src[MAX_PATH], dst[MAX_PATH];
+	Win32::ToPath(src, existing);
+	Win32::ToPath(dst, target);
+	return !rename(src, dst);
+}
+
+BOOL DeleteFile(LPCSTR fileName)
+{
+	CHAR path[MAX_PATH];
+	Win32::ToPath(path, fileName);
+	return !unlink(path);
+}
+
+VOID Sleep(DWORD milliseconds)
+{
+	if (milliseconds)
+		usleep(milliseconds * 1000);
+	else
+		sched_yield();
+}
+
+DWORD GetTickCount()
+{
+	return (DWORD)(Win32::Nanoseconds() / 1000000ull);
+}
+
+DWORD timeGetTime()
+{
+	return (DWORD)(Win32::Nanoseconds() / 1000000ull);
+}
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* counter)
+{
+	counter->QuadPart = (LONGLONG)(Win32::Nanoseconds() / 100ull);
+	return TRUE;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency)
+{
+	frequency->QuadPart = 10000000;
+	return TRUE;
+}
+
+VOID GetLocalTime(SYSTEMTIME* time)
+{
+	timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+
+	tm local;
+	localtime_r(&ts.tv_sec, &local);
+
+	time->wYear = WORD(local.tm_year + 1900);
+	time->wMonth = WORD(local.tm_mon + 1);
+	time->wDayOfWeek = WORD(local.tm_wday);
+	time->wDay = WORD(local.tm_mday);
+	time->wHour = WORD(local.tm_hour);
+	time->wMinute = WORD(local.tm_min);
+	time->wSecond = WORD(local.tm_sec);
+	time->wMilliseconds = WORD(ts.tv_nsec / 1000000);
+}
+
+// DWMAPI.dll is there only while a DWM rate is set, EnumDisplaySettings reports displayFrequency
+HRESULT __stdcall DwmGetCompositionTimingInfo(HWND hWnd, DWM_TIMING_INFO* timingInfo)
+{
+	timingInfo->rateRefresh.uiNumerator = Win32::dwmNumerator;
+	timingInfo->rateRefresh.uiDenominator = Win32::dwmDenominator;
+	return S_OK;
+}
+
+HMODULE LoadLibrary(LPCSTR fileName)
+{
+	return !strcasecmp(fileName, "DWMAPI.dll") && Win32::dwmDenominator ? (HMODULE)DwmGetCompositionTimingInfo : NULL;
+}
+
+FARPROC GetProcAddress(HMODULE hModule, LPCSTR procName)
+{
+	return hModule == (HMODULE)DwmGetCompositionTimingInfo && !StrCompare(procName, "DwmGetCompositionTimingInfo") ? (FARPROC)DwmGetCompositionTimingInfo : NULL;
+}
+
+BOOL FreeLibrary(HMODULE hModule)
+{
+	return TRUE;
+}
+
+BOOL EnumDisplaySettings(LPCSTR deviceName, DWORD modeNum, DEVMODE* devMode)
+{
+	devMode->dmDisplayFrequency = Win32::displayFrequency;
+	return Win32::displayFrequency != 0;
+}
+
+VOID OutputDebugString(LPCSTR message)
+{
+	if (getenv("WIN32_DEBUG"))
+		fputs(message, stderr);
+}
+
+BOOL OpenClipboard(HWND hWnd)
+{
+	return FALSE;
+}
+
+BOOL EmptyClipboard()
+{
+	return FALSE;
+}
+
+HANDLE SetClipboardData(UINT format, HANDLE hMem)
+{
+	return NULL;
+}
+
+BOOL CloseClipboard()
+{
+	return FALSE;
+}
+
+HGLOBAL GlobalAlloc(UINT flags, SIZE_T size)
+{
+	return malloc(size);
+}
+
+LPVOID GlobalLock(HGLOBAL hMem)
+{
+	return hMem;
+}
+
+BOOL GlobalUnlock(HGLOBAL hMem)
+{
+	return TRUE;
+}
+
+HGLOBAL GlobalFree(HGLOBAL hMem)
+{
+	free(hMem);
+	return NULL;
+}
+
+BOOL SetRect(RECT* rect, INT left, INT top, INT right, INT bottom)
+{
+	rect->left = left;
+	rect->top = top;
+	rect->right = right;
+	rect->bottom = bottom;
+	return TRUE;
+}
+
+BOOL SetRectEmpty(RECT* rect)
+{
+	return SetRect(rect, 0, 0, 0, 0);
+}
+
+BOOL IsRectEmpty(const RECT* rect)
+{
+	return rect->left >= rect->right || rect->top >= rect->bottom;
+}
+
+BOOL EqualRect(const RECT* rect1, const RECT* rect2)
+{
+	return rect1->left == rect2->left && rect1->top == rect2->top && rect1->right == rect2->right && rect1->bottom == rect2->bottom;
+}
+
+BOOL IntersectRect(RECT* dst, const RECT* src1, const RECT* src2)
+{
+	RECT rc = {
+		src1->left > src2->left ? src1->left : src2->left,
+		src1->top > src2->top ? src1->top : src2->top,
+		src1->right < src2->right ? src1->right : src2->right,
+		src1->bottom < src2->bottom ? src1->bottom : src2->bottom
+	};
+
+	if (IsRectEmpty(&rc))
+	{
+		SetRectEmpty(dst);
+		return FALSE;
+	}
+
+	*dst = rc;
+	return TRUE;
+}
+
+BOOL UnionRect(RECT* dst, const RECT* src1, const RECT* src2)
+{
+	if (IsRectEmpty(src1))
+	{
+		if (IsRectEmpty(src2))
+			return SetRectEmpty(dst), FALSE;
+
+		*dst = *src2;
+		return TRUE;
+	}
+
+	if (IsRectEmpty(src2))
+	{
+		*dst = *src1;
+		return TRUE;
+	}
+
+	RECT rc = {
+		src1->left < src2->left ? src1->left : src2->left,
+		src1->top < src2->top ? src1->top : src2->top,
+		src1->right > src2->right ? src1->right : src2->right,
+		src1->bottom > src2->bottom ? src1->bottom : src2->bottom
+	};
+
+	*dst = rc;
+	return TRUE;
+}
+
+BOOL OffsetRect(RECT* rect, INT dx, INT dy)
+{
+	rect->left += dx;
+	rect->right += dx;
+	rect->top += dy;
+	rect->bottom += dy;
+	return TRUE;
+}
+
+DWORD MsgWaitForMultipleObjectsEx(DWORD count, const HANDLE* handles, DWORD milliseconds, DWORD wakeMask, DWORD flags)
+{
+	Win32::waitMask = wakeMask;
+	Win32::waitFlags = flags;
+
+	Sleep(milliseconds);
+	return WAIT_TIMEOUT;
+}
@@ -0,0 +1,77 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+#include "windows.h"
+#include "ExtraTypes.h"
+
+#define MemoryAlloc(size) Win32::Alloc(size)
+#define MemoryFree(block) free(block)
+#define MemorySet(dst, val, size) memset(dst, val, size)
+#define MemoryZero(dst, size) memset(dst, 0, size)
+#define MemoryCopy(dst, src, size) memcpy(dst, src, size)
+#define MemoryCompare(buf1, buf2, size) memcmp(buf1, buf2, size)
+#define MathCeil(x) ceil(x)
+#define MathFloor(x) floor(x)
+#define MathPower(a, b) pow(a, b)
+#define MathSinus(x) sin(x)
+#define MathCosinus(x) cos(x)
+#define StrPrint(buf, fmt, ...) sprintf(buf, fmt, __VA_ARGS__)
+#define StrCompare(str1, str2) strcmp(str1, str2)
+#define StrCompareInsensitive(str1, str2) strcasecmp(str1, str2)
+#define StrCopy(dst, src) strcpy(dst, src)
+#define StrCat(dst, src) strcat(dst, src)
+#define StrChar(str, ch) strchr(str, ch)
+#define StrLastChar(str, ch) strrchr(str, ch)
+#define StrStr(str, substr) strstr(str, substr)
+#define StrDuplicate(str) strdup(str)
+#define StrFromInt(val, str, radix) sprintf(str, "%d", val)
+#define StrLength(str) strlen(str)
+#define StrToDouble(str) atof(str);
+#define Random() rand()
+#define SeedRandom(seed) srand(seed)
+#define Exit(code) exit(code)
+
+#define ALIGNED_BOUNDARY 64
+#define ALIGNED_CLASS 0x10000
+#define ALIGNED_SLOTS 8
+#define ALIGNED_LIMIT (64 << 20)
+
+VOID* AlignedAlloc(size_t);
+VOID AlignedFree(VOID*);
+VOID AlignedRelease();
+
+extern HMODULE hDllModule;
+
+namespace Win32
+{
+	extern LONG allocBudget;
+	extern DWORD waitMask;
+	extern DWORD waitFlags;
+	extern UINT dwmNumerator;
+	extern UINT dwmDenominator;
+	extern DWORD displayFrequency;
+
+	VOID* Alloc(size_t size);
+}
\ No newline at end of file
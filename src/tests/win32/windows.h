@@ -0,0 +1,349 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <math.h>
+
+#define WINAPI
+#define APIENTRY
+#define CALLBACK
+#define __stdcall
+#define __fastcall
+#define __cdecl
+#define _W64
+#define __int64 long long
+#define ptrdiff_t ptrdiff_t
+
+typedef void VOID;
+typedef char CHAR;
+typedef wchar_t WCHAR;
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef int32_t BOOL;
+typedef int32_t INT;
+typedef uint32_t UINT;
+typedef int32_t LONG;
+typedef uint32_t ULONG;
+typedef int16_t SHORT;
+typedef uint16_t USHORT;
+typedef int64_t LONGLONG;
+typedef uint64_t ULONGLONG;
+typedef uint64_t DWORD64;
+typedef float FLOAT;
+typedef double DOUBLE;
+typedef intptr_t LONG_PTR;
+typedef uintptr_t ULONG_PTR;
+typedef uintptr_t DWORD_PTR;
+typedef uintptr_t UINT_PTR;
+typedef size_t SIZE_T;
+typedef LONG HRESULT;
+typedef LONG LSTATUS;
+typedef DWORD LCID;
+typedef DWORD COLORREF;
+typedef WORD ATOM;
+
+typedef VOID* LPVOID;
+typedef const VOID* LPCVOID;
+typedef CHAR* LPSTR;
+typedef const CHAR* LPCSTR;
+typedef BYTE* LPBYTE;
+typedef DWORD* LPDWORD;
+typedef LONG* PLONG;
+
+typedef VOID* HANDLE;
+typedef HANDLE HMODULE;
+typedef HANDLE HINSTANCE;
+typedef HANDLE HWND;
+typedef HANDLE HDC;
+typedef HANDLE HGLRC;
+typedef HANDLE HKEY;
+typedef HANDLE HMENU;
+typedef HANDLE HICON;
+typedef HANDLE HCURSOR;
+typedef HANDLE HFONT;
+typedef HANDLE HBITMAP;
+typedef HANDLE HBRUSH;
+typedef HANDLE HPEN;
+typedef HANDLE HRGN;
+typedef HANDLE HGDIOBJ;
+typedef HANDLE HPALETTE;
+typedef HANDLE HGLOBAL;
+typedef HANDLE HMONITOR;
+
+typedef UINT_PTR WPARAM;
+typedef LONG_PTR LPARAM;
+typedef LONG_PTR LRESULT;
+
+#define TRUE 1
+#define FALSE 0
+#define MAX_PATH 260
+#define INFINITE 0xFFFFFFFF
+
+#define LOBYTE(w) ((BYTE)(((DWORD_PTR)(w)) & 0xFF))
+#define HIBYTE(w) ((BYTE)((((DWORD_PTR)(w)) >> 8) & 0xFF))
+#define LOWORD(l) ((WORD)(((DWORD_PTR)(l)) & 0xFFFF))
+#define HIWORD(l) ((WORD)((((DWORD_PTR)(l)) >> 16) & 0xFFFF))
+#define MAKELONG(a, b) ((LONG)(((WORD)(a)) | ((DWORD)((WORD)(b))) << 16))
+#define RGB(r, g, b) ((COLORREF)(((BYTE)(r) | ((WORD)((BYTE)(g)) << 8)) | (((DWORD)(BYTE)(b)) << 16)))
+
+typedef union _LARGE_INTEGER {
+	struct {
+		DWORD LowPart;
+		LONG HighPart;
+	};
+	LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+typedef struct tagPOINT {
+	LONG x;
+	LONG y;
+} POINT;
+
+typedef struct tagSIZE {
+	LONG cx;
+	LONG cy;
+} SIZE;
+
+typedef struct tagRECT {
+	LONG left;
+	LONG top;
+	LONG right;
+	LONG bottom;
+} RECT, *LPRECT;
+
+typedef struct _POINTFLOAT {
+	FLOAT x;
+	FLOAT y;
+} POINTFLOAT;
+
+typedef struct _FILETIME {
+	DWORD dwLowDateTime;
+	DWORD dwHighDateTime;
+} FILETIME;
+
+typedef struct _SYSTEMTIME {
+	WORD wYear;
+	WORD wMonth;
+	WORD wDayOfWeek;
+	WORD wDay;
+	WORD wHour;
+	WORD wMinute;
+	WORD wSecond;
+	WORD wMilliseconds;
+} SYSTEMTIME;
+
+typedef struct _SECURITY_ATTRIBUTES {
+	DWORD nLength;
+	LPVOID lpSecurityDescriptor;
+	BOOL bInheritHandle;
+} SECURITY_ATTRIBUTES;
+
+typedef struct _CRITICAL_SECTION {
+	VOID* lock;
+} CRITICAL_SECTION;
+
+typedef struct tagMSG {
+	HWND hwnd;
+	UINT message;
+	WPARAM wParam;
+	LPARAM lParam;
+	DWORD time;
+	POINT pt;
+} MSG;
+
+typedef struct _RGNDATAHEADER {
+	DWORD dwSize;
+	DWORD iType;
+	DWORD nCount;
+	DWORD nRgnSize;
+	RECT rcBound;
+} RGNDATAHEADER;
+
+typedef struct tagBITMAPINFOHEADER {
+	DWORD biSize;
+	LONG biWidth;
+	LONG biHeight;
+	WORD biPlanes;
+	WORD biBitCount;
+	DWORD biCompression;
+	DWORD biSizeImage;
+	LONG biXPelsPerMeter;
+	LONG biYPelsPerMeter;
+	DWORD biClrUsed;
+	DWORD biClrImportant;
+} BITMAPINFOHEADER;
+
+typedef struct tagPIXELFORMATDESCRIPTOR {
+	WORD nSize;
+	WORD nVersion;
+	DWORD dwFlags;
+	BYTE iPixelType;
+	BYTE cColorBits;
+	BYTE reserved[28];
+} PIXELFORMATDESCRIPTOR;
+
+typedef DWORD(__stdcall* LPTHREAD_START_ROUTINE)(LPVOID);
+typedef LONG_PTR(__stdcall* FARPROC)();
+
+typedef struct _devicemode {
+	WORD dmSize;
+	DWORD dmDisplayFrequency;
+} DEVMODE;
+
+#define INVALID_HANDLE_VALUE ((HANDLE)(LONG_PTR)-1)
+#define INVALID_FILE_SIZE ((DWORD)0xFFFFFFFF)
+
+#define GENERIC_READ 0x80000000
+#define GENERIC_WRITE 0x40000000
+#define FILE_SHARE_READ 0x00000001
+#define FILE_SHARE_WRITE 0x00000002
+#define CREATE_NEW 1
+#define CREATE_ALWAYS 2
+#define OPEN_EXISTING 3
+#define OPEN_ALWAYS 4
+#define FILE_ATTRIBUTE_NORMAL 0x00000080
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000
+#define FILE_FLAG_WRITE_THROUGH 0x80000000
+#define MOVEFILE_REPLACE_EXISTING 0x00000001
+#define MOVEFILE_WRITE_THROUGH 0x00000008
+#define FILE_BEGIN 0
+#define FILE_CURRENT 1
+#define INVALID_SET_FILE_POINTER ((DWORD)-1)
+
+#define S_OK 0
+#define ENUM_CURRENT_SETTINGS ((DWORD)-1)
+
+#define WAIT_OBJECT_0 0x00000000
+#define WAIT_TIMEOUT 0x00000102
+#define WAIT_FAILED 0xFFFFFFFF
+
+#define NORMAL_PRIORITY_CLASS 0x00000020
+#define THREAD_PRIORITY_BELOW_NORMAL -1
+#define THREAD_PRIORITY_ABOVE_NORMAL 1
+
+#define QS_ALLINPUT 0x04FF
+#define MWMO_INPUTAVAILABLE 0x0004
+#define PM_NOREMOVE 0x0000
+#define PM_REMOVE 0x0001
+
+#define ERROR_SUCCESS 0
+#define ERROR_FILE_NOT_FOUND 2
+#define ERROR_MORE_DATA 234
+
+#define REG_NONE 0
+#define REG_SZ 1
+#define REG_EXPAND_SZ 2
+#define REG_BINARY 3
+#define REG_DWORD 4
+
+#define GMEM_MOVEABLE 0x0002
+#define CF_DIB 8
+#define BI_RGB 0
+
+#define SRCCOPY 0x00CC0020
+
+#define WM_PAINT 0x000F
+#define WM_ERASEBKGND 0x0014
+#define WM_ACTIVATE 0x0006
+#define WM_ACTIVATEAPP 0x001C
+
+#define InterlockedExchange(target, value) __atomic_exchange_n((target), (value), __ATOMIC_SEQ_CST)
+#define InterlockedIncrement(target) __atomic_add_fetch((target), 1, __ATOMIC_SEQ_CST)
+#define InterlockedDecrement(target) __atomic_sub_fetch((target), 1, __ATOMIC_SEQ_CST)
+#define InterlockedCompareExchange(target, value, comparand) __sync_val_compare_and_swap((target), (comparand), (value))
+
+VOID InitializeCriticalSection(CRITICAL_SECTION* section);
+VOID DeleteCriticalSection(CRITICAL_SECTION* section);
+VOID EnterCriticalSection(CRITICAL_SECTION* section);
+VOID LeaveCriticalSection(CRITICAL_SECTION* section);
+
+HANDLE CreateEvent(SECURITY_ATTRIBUTES* attributes, BOOL manualReset, BOOL initialState, LPCSTR name);
+BOOL SetEvent(HANDLE hEvent);
+BOOL ResetEvent(HANDLE hEvent);
+DWORD WaitForSingleObject(HANDLE hHandle, DWORD milliseconds);
+BOOL CloseHandle(HANDLE hObject);
+
+HANDLE CreateThread(SECURITY_ATTRIBUTES* attributes, SIZE_T stackSize, LPTHREAD_START_ROUTINE start, LPVOID parameter, DWORD flags, DWORD* threadId);
+BOOL SetThreadPriority(HANDLE hThread, INT priority);
+
+HANDLE CreateFile(LPCSTR fileName, DWORD access, DWORD shareMode, SECURITY_ATTRIBUTES* attributes, DWORD disposition, DWORD flags, HANDLE hTemplate);
+BOOL ReadFile(HANDLE hFile, LPVOID buffer, DWORD size, DWORD* read, LPVOID overlapped);
+BOOL WriteFile(HANDLE hFile, LPCVOID buffer, DWORD size, DWORD* written, LPVOID overlapped);
+BOOL FlushFileBuffers(HANDLE hFile);
+DWORD GetFileSize(HANDLE hFile, DWORD* high);
+DWORD SetFilePointer(HANDLE hFile, LONG distance, LONG* distanceHigh, DWORD method);
+BOOL GetFileTime(HANDLE hFile, FILETIME* creation, FILETIME* access, FILETIME* write);
+DWORD GetFullPathName(LPCSTR fileName, DWORD size, LPSTR buffer, LPSTR* filePart);
+BOOL CreateDirectory(LPCSTR path, SECURITY_ATTRIBUTES* attributes);
+BOOL MoveFileEx(LPCSTR existing, LPCSTR target, DWORD flags);
+BOOL DeleteFile(LPCSTR fileName);
+
+VOID Sleep(DWORD milliseconds);
+DWORD GetTickCount();
+DWORD timeGetTime();
+BOOL QueryPerformanceCounter(LARGE_INTEGER* counter);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency);
+VOID GetLocalTime(SYSTEMTIME* time);
+
+HMODULE LoadLibrary(LPCSTR fileName);
+FARPROC GetProcAddress(HMODULE hModule, LPCSTR procName);
+BOOL FreeLibrary(HMODULE hModule);
+BOOL EnumDisplaySettings(LPCSTR deviceName, DWORD modeNum, DEVMODE* devMode);
+
+VOID OutputDebugString(LPCSTR message);
+
+BOOL OpenClipboard(HWND hWnd);
+BOOL EmptyClipboard();
+HANDLE SetClipboardData(UINT format, HANDLE hMem);
+BOOL CloseClipboard();
+HGLOBAL GlobalAlloc(UINT flags, SIZE_T size);
+LPVOID GlobalLock(HGLOBAL hMem);
+BOOL GlobalUnlock(HGLOBAL hMem);
+HGLOBAL GlobalFree(HGLOBAL hMem);
+
+BOOL SetRect(RECT* rect, INT left, INT top, INT right, INT bottom);
+BOOL SetRectEmpty(RECT* rect);
+BOOL IsRectEmpty(const RECT* rect);
+BOOL EqualRect(const RECT* rect1, const RECT* rect2);
+BOOL IntersectRect(RECT* dst, const RECT* src1, const RECT* src2);
+BOOL UnionRect(RECT* dst, const RECT* src1, const RECT* src2);
+BOOL OffsetRect(RECT* rect, INT dx, INT dy);
+
+DWORD MsgWaitForMultipleObjectsEx(DWORD count, const HANDLE* handles, DWORD milliseconds, DWORD wakeMask, DWORD flags);
+
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
\ No newline at end of file
@@ -0,0 +1,400 @@
+/*
+	MIT License
+
+	Copyright (c) 2020 Oleksiy Ryabchun
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "stdafx.h"
+#include "zlib.h"
+#include <sys/stat.h>
+#include "Recorder.h"
+
+/*
+	Decodes a session recorded by Recorder (see Recorder.h for the layout).
+
+	RecordDecoder <file.hrec>                          list tracks and frames
+	RecordDecoder <file.hrec> -ppm <dir> [-track N]    write every frame as PPM
+	RecordDecoder <file.hrec> -raw [-track N] [-fps R] write rgb24 frames to stdout
+
+	The raw stream is meant for ffmpeg, the geometry is printed to stderr:
+		RecordDecoder a.hrec -raw -fps 60 | ffmpeg -f rawvideo -pix_fmt rgb24 -s WxH -r 60 -i - a.mp4
+*/
+
+namespace RecordDecoder
+{
+	enum OutputMode
+	{
+		OutputInfo,
+		OutputPpm,
+		OutputRaw
+	};
+
+	struct Track
+	{
+		DWORD width;
+		DWORD height;
+		GLenum format;
+		GLenum type;
+		DWORD bpp;
+		BYTE* canvas;
+		BYTE* rgb;
+		DWORD frames;
+		DWORD rects;
+		ULONGLONG pixels;
+		DWORD firstTick;
+		DWORD lastTick;
+	};
+
+	struct {
+		OutputMode mode;
+		const CHAR* dir;
+		DWORD track;
+		DWORD fps;
+	} options;
+
+	Track tracks[256];
+
+	struct {
+		DWORD track;
+		DWORD tick;
+		DWORD emitted;
+	} video;
+
+	VOID Convert(Track* track)
+	{
+		DWORD count = track->width * track->height;
+		const BYTE* src = track->canvas;
+		BYTE* dst = track->rgb;
+
+		if (track->type == GL_UNSIGNED_SHORT_5_6_5)
+		{
+			const WORD* px = (const WORD*)src;
+			do
+			{
+				WORD c = *px++;
+				*dst++ = BYTE(((c >> 11) & 0x1F) * 255 / 31);
+				*dst++ = BYTE(((c >> 5) & 0x3F) * 255 / 63);
+				*dst++ = BYTE((c & 0x1F) * 255 / 31);
+			} while (--count);
+		}
+		else if (track->format == GL_BGRA_EXT)
+		{
+			do
+			{
+				*dst++ = src[2];
+				*dst++ = src[1];
+				*dst++ = src[0];
+				src += 4;
+			} while (--count);
+		}
+		else
+		{
+			do
+			{
+				*dst++ = src[0];
+				*dst++ = src[1];
+				*dst++ = src[2];
+				src += 4;
+			} while (--count);
+		}
+	}
+
+	BOOL WritePpm(DWORD index, Track* track)
+	{
+		CHAR path[MAX_PATH];
+		StrPrint(path, "%s/track%03u_%06u.ppm", options.dir, index, track->frames - 1);
+
+		FILE* file = fopen(path, "wb");
+		if (!file)
+		{
+			fprintf(stderr, "Cannot write %s\n", path);
+			return FALSE;
+		}
+
+		fprintf(file, "P6\n%u %u\n255\n", track->width, track->height);
+		fwrite(track->rgb, 3, track->width * track->height, file);
+		fclose(file);
+
+		return TRUE;
+	}
+
+	VOID WriteRaw(Track* track, DWORD tick)
+	{
+		DWORD count = 1;
+		if (options.fps)
+		{
+			if (!video.emitted)
+				video.tick = tick;
+
+			DOUBLE due = (tick - video.tick) * options.fps / 1000.0;
+			count = due >= video.emitted ? DWORD(due) - video.emitted + 1 : 0;
+		}
+
+		while (count--)
+		{
+			fwrite(track->rgb, 3, track->width * track->height, stdout);
+			++video.emitted;
+		}
+	}
+
+	BOOL ParseTrack(const BYTE* ptr)
+	{
+		DWORD index = ptr[1];
+		const DWORD* data = (const DWORD*)(ptr + 4);
+
+		Track* track = &tracks[index];
+		free(track->canvas);
+		free(track->rgb);
+		MemoryZero(track, sizeof(Track));
+
+		track->width = data[0];
+		track->height = data[1];
+		track->format = data[2];
+		track->type = data[3];
+		track->bpp = track->type == GL_UNSIGNED_SHORT_5_6_5 ? sizeof(WORD) : sizeof(DWORD);
+		track->canvas = (BYTE*)calloc(track->width * track->height, track->bpp);
+		track->rgb = (BYTE*)malloc(track->width * track->height * 3);
+
+		if (!track->canvas || !track->rgb)
+			return FALSE;
+
+		if (options.mode == OutputInfo)
+			printf("track %u: %ux%u, %s\n", index, track->width, track->height,
+				track->bpp == sizeof(WORD) ? "rgb565" : (track->format == GL_BGRA_EXT ? "bgra" : "rgba"));
+
+		if (options.mode == OutputRaw && (options.track ? options.track == index : !video.track))
+		{
+			video.track = index;
+			fprintf(stderr, "%ux%u\n", track->width, track->height);
+		}
+
+		return TRUE;
+	}
+
+	const BYTE* ParseFrame(const BYTE* ptr, const BYTE* end)
+	{
+		DWORD index = ptr[1];
+		DWORD count = *(const WORD*)(ptr + 2);
+		DWORD tick = *(const DWORD*)(ptr + 4);
+		ptr += 2 * sizeof(DWORD);
+
+		Track* track = &tracks[index];
+		if (!track->canvas)
+			return NULL;
+
+		while (count--)
+		{
+			if (ptr + 4 * sizeof(WORD) > end)
+				return NULL;
+
+			const WORD* header = (const WORD*)ptr;
+			DWORD x = header[0];
+			DWORD y = header[1];
+			DWORD width = header[2];
+			DWORD height = header[3];
+			ptr += 4 * sizeof(WORD);
+
+			DWORD length = width * track->bpp;
+			if (x + width > track->width || y + height > track->height || ptr + length * height > end)
+				return NULL;
+
+			BYTE* dst = track->canvas + (y * track->width + x) * track->bpp;
+			for (DWORD i = 0; i < height; ++i)
+			{
+				MemoryCopy(dst, ptr, length);
+				dst += track->width * track->bpp;
+				ptr += length;
+			}
+
+			++track->rects;
+			track->pixels += width * height;
+		}
+
+		if (!track->frames)
+			track->firstTick = tick;
+		track->lastTick = tick;
+		++track->frames;
+
+		if (options.mode == OutputPpm && (!options.track || options.track == index))
+		{
+			Convert(track);
+			if (!WritePpm(index, track))
+				return NULL;
+		}
+		else if (options.mode == OutputRaw && video.track == index)
+		{
+			Convert(track);
+			WriteRaw(track, tick);
+		}
+
+		return ptr;
+	}
+
+	BOOL ParseChunk(const BYTE* ptr, DWORD size)
+	{
+		const BYTE* end = ptr + size;
+		while (ptr < end)
+		{
+			switch (*ptr)
+			{
+			case RecordTrack:
+				if (ptr + 5 * sizeof(DWORD) > end || !ParseTrack(ptr))
+					return FALSE;
+
+				ptr += 5 * sizeof(DWORD);
+				break;
+
+			case RecordFrame:
+				if (ptr + 2 * sizeof(DWORD) > end)
+					return FALSE;
+
+				ptr = ParseFrame(ptr, end);
+				if (!ptr)
+					return FALSE;
+
+				break;
+
+			default:
+				return FALSE;
+			}
+		}
+
+		return TRUE;
+	}
+
+	INT Decode(const CHAR* path)
+	{
+		FILE* file = fopen(path, "rb");
+		if (!file)
+		{
+			fprintf(stderr, "Cannot open %s\n", path);
+			return 1;
+		}
+
+		DWORD header[2];
+		if (fread(header, sizeof(header), 1, file) != 1 || header[0] != 'CERH' || header[1] != RECORD_VERSION)
+		{
+			fprintf(stderr, "%s is not a version %u session record\n", path, RECORD_VERSION);
+			fclose(file);
+			return 1;
+		}
+
+		INT result = 0;
+		DWORD chunks = 0;
+		ULONGLONG packedTotal = 0, rawTotal = 0;
+
+		DWORD capacity = 0;
+		BYTE* packed = NULL;
+		BYTE* raw = NULL;
+
+		DWORD sizes[2];
+		while (fread(sizes, sizeof(sizes), 1, file) == 1)
+		{
+			if (capacity < sizes[0] || capacity < sizes[1])
+			{
+				capacity = sizes[0] > sizes[1] ? sizes[0] : sizes[1];
+				free(packed);
+				free(raw);
+				packed = (BYTE*)malloc(capacity);
+				raw = (BYTE*)malloc(capacity);
+			}
+
+			uLongf rawSize = sizes[0];
+			if (!packed || !raw || fread(packed, 1, sizes[1], file) != sizes[1]
+				|| uncompress(raw, &rawSize, packed, sizes[1]) != Z_OK || rawSize != sizes[0])
+			{
+				fprintf(stderr, "Chunk %u is truncated or corrupt\n", chunks);
+				result = 1;
+				break;
+			}
+
+			if (!ParseChunk(raw, sizes[0]))
+			{
+				fprintf(stderr, "Chunk %u has malformed records\n", chunks);
+				result = 1;
+				break;
+			}
+
+			++chunks;
+			packedTotal += sizes[1];
+			rawTotal += sizes[0];
+		}
+
+		free(packed);
+		free(raw);
+		fclose(file);
+
+		if (options.mode == OutputInfo)
+		{
+			for (DWORD i = 0; i < 256; ++i)
+			{
+				Track* track = &tracks[i];
+				if (track->canvas)
+					printf("track %u: %u frames, %u rects, %.1f%% of pixels changed, %u ms\n", i,
+						track->frames, track->rects,
+						track->frames ? track->pixels * 100.0 / ((ULONGLONG)track->width * track->height * track->frames) : 0.0,
+						track->lastTick - track->firstTick);
+			}
+
+			printf("%u chunks, %llu bytes packed from %llu\n", chunks, packedTotal, rawTotal);
+		}
+
+		for (DWORD i = 0; i < 256; ++i)
+		{
+			free(tracks[i].canvas);
+			free(tracks[i].rgb);
+		}
+
+		return result;
+	}
+}
+
+INT main(INT argc, CHAR** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <file.hrec> [-ppm <dir> | -raw [-fps N]] [-track N]\n", argv[0]);
+		return 2;
+	}
+
+	for (INT i = 2; i < argc; ++i)
+	{
+		if (!StrCompare(argv[i], "-ppm") && i + 1 < argc)
+		{
+			RecordDecoder::options.mode = RecordDecoder::OutputPpm;
+			RecordDecoder::options.dir = argv[++i];
+			mkdir(RecordDecoder::options.dir, 0755);
+		}
+		else if (!StrCompare(argv[i], "-raw"))
+			RecordDecoder::options.mode = RecordDecoder::OutputRaw;
+		else if (!StrCompare(argv[i], "-track") && i + 1 < argc)
+			RecordDecoder::options.track = atoi(argv[++i]);
+		else if (!StrCompare(argv[i], "-fps") && i + 1 < argc)
+			RecordDecoder::options.fps = atoi(argv[++i]);
+		else
+		{
+			fprintf(stderr, "Unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	return RecordDecoder::Decode(argv[1]);
+}